@@ -7,6 +7,16 @@ SamplerComparisonState shadowSampler : register(s12);
 //
 // Shader Math
 //
+// 八面体符号化した単位ベクトルを戻す（VertexCompression::OctDecodeと同じ計算）
+float3 OctDecode(float2 e)
+{
+    float3 v = float3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = saturate(-v.z);
+    v.x += v.x >= 0.0 ? -t : t;
+    v.y += v.y >= 0.0 ? -t : t;
+    return normalize(v);
+}
+
 float Pow5(float x)
 {
     float xSq = x * x;
@@ -11,6 +11,12 @@ cbuffer GlobalConstants : register(b1)
     float4x4 ViewProjMatrix;
 }
 
+cbuffer PositionDequantization : register(b3)
+{
+    float4 PositionScale;   // 16bitに量子化した位置の復元（サブメッシュごと）
+    float4 PositionOffset;
+};
+
 #ifdef ENABLE_SKINNING
 struct Joint
 {
@@ -23,11 +29,7 @@ StructuredBuffer<Joint> Joints : register(t20);
 
 struct VSInput
 {
-    float3 position : POSITION;
-    float2 texcoord : TEXCOORD0;
-    float3 normal : NORMAL;
-    float3 tangent : TANGENT;
-    float3 bitangent : BITTANGENT;
+    float4 position : POSITION;
 #ifdef ENABLE_SKINNING
     float4 jointWeights : WEIGHT;
     uint4 jointIndices : INDEX;
@@ -43,10 +45,11 @@ VSOutput main(VSInput input)
 {
     VSOutput vsOutput;
 
-    float4 position = float4(input.position, 1.0);
+    float4 position = input.position * PositionScale + PositionOffset;
 
 #ifdef ENABLE_SKINNING
-     float4 weights = input.jointWeights / dot(input.jointWeights, 1.0f);
+    // ウェイトはインポート時に和が1になるよう量子化してある（SkinPacking）
+    float4 weights = input.jointWeights;
     
     float4 skinnedPos = mul(position, Joints[input.jointIndices.x].PosMatrix) * weights.x;
     skinnedPos += mul(position, Joints[input.jointIndices.y].PosMatrix) * weights.y;
@@ -15,6 +15,12 @@ cbuffer GlobalConstants : register(b1)
     float3 SunIntensity;
 }
 
+cbuffer PositionDequantization : register(b3)
+{
+    float4 PositionScale;   // 16bitに量子化した位置の復元（サブメッシュごと）
+    float4 PositionOffset;
+};
+
 #ifdef ENABLE_SKINNING
 struct Joint
 {
@@ -27,11 +33,10 @@ StructuredBuffer<Joint> Joints : register(t20);
 
 struct VSInput
 {
-    float3 position : POSITION;
+    float4 position : POSITION;
     float2 texcoord : TEXCOORD0;
-    float3 normal : NORMAL;
-    float3 tangent : TANGENT;
-    float3 bitangent : BITTANGENT;
+    float2 normal : NORMAL;     // 八面体符号化
+    float4 tangent : TANGENT;   // xy: 八面体符号化, w: 利き手（1なら+1、0なら-1）
 #ifdef ENABLE_SKINNING
     float4 jointWeights : WEIGHT;
     uint4 jointIndices : INDEX;
@@ -54,13 +59,14 @@ VSOutput main(VSInput input)
 {
     VSOutput vsOutput;
 
-    float4 position = float4(input.position, 1.0f);
-    float3 normal = input.normal;
-    float3 tangent = input.tangent;
-    float3 bitangent = input.bitangent;
+    float4 position = input.position * PositionScale + PositionOffset;
+    float3 normal = OctDecode(input.normal);
+    float3 tangent = OctDecode(input.tangent.xy * 2.0 - 1.0);
+    float handedness = input.tangent.w * 2.0 - 1.0;
     
 #ifdef ENABLE_SKINNING
-    float4 weights = input.jointWeights / dot(input.jointWeights, 1.0f);
+    // ウェイトはインポート時に和が1になるよう量子化してある（SkinPacking）
+    float4 weights = input.jointWeights;
     
     float4 skinnedPos = mul(position, Joints[input.jointIndices.x].PosMatrix) * weights.x;
     skinnedPos += mul(position, Joints[input.jointIndices.y].PosMatrix) * weights.y;
@@ -71,22 +77,21 @@ VSOutput main(VSInput input)
     float3 skinnedNor = mul(normal, (float3x3) Joints[input.jointIndices.x].NrmMatrix) * weights.x;
     skinnedNor += mul(normal, (float3x3) Joints[input.jointIndices.y].NrmMatrix) * weights.y;
     skinnedNor += mul(normal, (float3x3) Joints[input.jointIndices.z].NrmMatrix) * weights.z;
+    skinnedNor += mul(normal, (float3x3) Joints[input.jointIndices.w].NrmMatrix) * weights.w;
     normal = skinnedNor;
     
     float3 skinnedTangent = mul(tangent.xyz, (float3x3) Joints[input.jointIndices.x].NrmMatrix) * weights.x;
     skinnedTangent += mul(tangent.xyz, (float3x3) Joints[input.jointIndices.y].NrmMatrix) * weights.y;
     skinnedTangent += mul(tangent.xyz, (float3x3) Joints[input.jointIndices.z].NrmMatrix) * weights.z;
+    skinnedTangent += mul(tangent.xyz, (float3x3) Joints[input.jointIndices.w].NrmMatrix) * weights.w;
     
     tangent.xyz = skinnedTangent;
-
-    float3 skinnedBitangent = mul(bitangent.xyz, (float3x3) Joints[input.jointIndices.x].NrmMatrix) * weights.x;
-    skinnedBitangent += mul(bitangent.xyz, (float3x3) Joints[input.jointIndices.y].NrmMatrix) * weights.y;
-    skinnedBitangent += mul(bitangent.xyz, (float3x3) Joints[input.jointIndices.z].NrmMatrix) * weights.z;
-    
-    bitangent.xyz = skinnedBitangent;
     
 #endif
 
+    // 従法線は持たず、法線と接線から求める
+    float3 bitangent = cross(normal, tangent) * handedness;
+
     vsOutput.worldPos = mul(position, WorldMatrix).xyz;
     vsOutput.position = mul(float4(vsOutput.worldPos, 1.0), ViewProjMatrix);
     vsOutput.texcoord = input.texcoord;
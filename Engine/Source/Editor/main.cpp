@@ -1,6 +1,11 @@
 #include "Runtime/Function/Render/WindowManager.h"
 #include "Runtime/EngineCore.h"
 #include "Game/Game.h"
+#include "Runtime/Core/Math/MathBenchmark.h"
+#include "Runtime/Function/Framework/ECS/WorldBenchmark.h"
+#include "Runtime/Function/Animation/AnimationBenchmark.h"
+#include "Runtime/Resource/MeshletBenchmark.h"
+#include <cstring>
 
 int WINAPI WinMain(
 	_In_ HINSTANCE hInstance,
@@ -11,6 +16,16 @@ int WINAPI WinMain(
 
 	Engine::AtomEngine engine;
 
+	// 数学ライブラリ・エンジン各部のベンチマークと検証だけを実行して終了する
+	if (lpCmdLine && std::strstr(lpCmdLine, "--math-benchmark"))
+	{
+		AtomEngine::MathBenchmark::Run();
+		AtomEngine::WorldBenchmark::Run();
+		AtomEngine::AnimationBenchmark::Run();
+		AtomEngine::MeshletBenchmark::Run();
+		return engine.Shutdown();
+	}
+
 	Game game;
 
 	engine.Run(game);
@@ -8,6 +8,11 @@ std::unique_ptr<AtomEngine::Scene> CreateGameScene(const std::string& name, Atom
 	return std::make_unique<GameScene>(name, manager);
 }
 
+std::vector<AtomEngine::ModelFuture> PreloadGameScene()
+{
+	return GameScene::PreloadModels();
+}
+
 std::unique_ptr<AtomEngine::Scene> CreateTitleScene(const std::string& name, AtomEngine::SceneManager& manager)
 {
 	return std::make_unique<TitleScene>(name, manager);
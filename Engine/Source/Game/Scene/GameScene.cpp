@@ -11,6 +11,7 @@
 #include "../Component/GoalComponent.h"
 #include "../Component/VoxelColliderComponent.h"
 #include "../Component/PlatformComponent.h"
+#include "../Component/ColliderComponent.h"
 #include "../System/ItemSystem.h"
 #include "../System/GoalSystem.h"
 #include "../System/SoundManaged.h"
@@ -29,6 +30,9 @@ namespace
 	Color kLightColor = Color(0.5f, 0.5f, 0.5f);
 	Vector3 lightPosition = Vector3::ZERO;
 	float lightRadius = 8.0f;
+
+	const wchar_t* kStageModelPath = L"Asset/Models/Stage/stage.obj";
+	const wchar_t* kPlayerModelPath = L"Asset/Models/panda/panda.gltf";
 }
 
 GameScene::GameScene(std::string_view name, SceneManager& manager)
@@ -36,6 +40,15 @@ GameScene::GameScene(std::string_view name, SceneManager& manager)
 {
 }
 
+std::vector<ModelFuture> GameScene::PreloadModels()
+{
+	return
+	{
+		AssetManager::LoadModelAsync(kStageModelPath),
+		AssetManager::LoadModelAsync(kPlayerModelPath),
+	};
+}
+
 bool GameScene::Initialize()
 {
 	mCamera = &mGameCamera;
@@ -54,15 +67,15 @@ bool GameScene::Initialize()
 	InitSystems();
 
 	// ステージ
-	auto model = AssetManager::LoadModel(L"Asset/Models/Stage/stage.obj");
+	auto model = AssetManager::LoadModel(kStageModelPath);
 	auto obj = mWorld.CreateGameObject("stage");
 	obj->AddComponent<MaterialComponent>(model);
 	obj->AddComponent<MeshComponent>(model);
 	obj->AddComponent<TransformComponent>(Vector3::ZERO, Quaternion::IDENTITY, kWorldScale);
-	AddGameObject(std::move(obj));
+	AddGameObject(obj);
 
 	// プレイヤー
-	auto playerModel = AssetManager::LoadModel(L"Asset/Models/panda/panda.gltf");
+	auto playerModel = AssetManager::LoadModel(kPlayerModelPath);
 	auto player = mWorld.CreateGameObject("player");
 	player->AddComponent<MaterialComponent>(playerModel);
 	player->AddComponent<MeshComponent>(playerModel);
@@ -77,7 +90,7 @@ bool GameScene::Initialize()
 	playerCollider.groundCheckDistance = 0.1f;
 	player->AddComponent<VoxelColliderComponent>(playerCollider);
 	mPlayerEntity = player->GetHandle();
-	AddGameObject(std::move(player));
+	AddGameObject(player);
 
 	// Voxel World
 	VoxelWorldComponent voxelComp{};
@@ -87,7 +100,7 @@ bool GameScene::Initialize()
 	auto voxel = mWorld.CreateGameObject("voxel_world");
 	voxel->AddComponent<VoxelWorldComponent>(std::move(voxelComp));
 	mVoxelWorldEntity = voxel->GetHandle();
-	AddGameObject(std::move(voxel));
+	AddGameObject(voxel);
 
 	if (mWorld.HasComponent<VoxelWorldComponent>(mVoxelWorldEntity))
 	{
@@ -148,16 +161,8 @@ void GameScene::Update(float deltaTime)
 		mInGameCameraController->Update(deltaTime);
 	}
 
-	mPlayerSystem->Update(mWorld, mGameCamera, deltaTime);
-
-	// システム更新
-	mPlatformSystem->Update(mWorld, deltaTime);
-	mLadderSystem->Update(mWorld, deltaTime);
-	mItemSystem->Update(mWorld, deltaTime);
-	mGoalSystem->Update(mWorld, deltaTime);
-	mVoxelCollisionSystem->Update(mWorld, deltaTime);
-
-	mMoveSystem->Update(mWorld, deltaTime);
+	// システム更新（InitSystemsで宣言した読み書きに従って並行実行）
+	mWorld.UpdateSystems(deltaTime);
 
 	// ゴール判定
 	if (!mIsGameClear && mGoalSystem->IsGoalReached())
@@ -277,23 +282,26 @@ void GameScene::OnGameClear()
 	RequestReplaceScene(std::move(clearScene));
 }
 
-void GameScene::AddGameObject(std::unique_ptr<GameObject>&& object)
+void GameScene::AddGameObject(GameObject* object)
 {
 	auto entity = object->GetHandle();
-	mGameObjects.insert(std::make_pair(entity, std::move(object)));
+	mGameObjects.insert(std::make_pair(entity, object));
 }
 
 void GameScene::DestroyGameObject()
 {
+	// 走査中に破棄しないよう、コマンドバッファに記録してからまとめて反映する
+	auto& commands = mWorld.GetCommandBuffer();
 	auto view = mWorld.View<DeathFlag>();
 	view.each([&](auto entity, DeathFlag& flag)
 		{
 			if (flag.isDead)
 			{
-				mGameObjects[entity]->Destroy();
+				commands.DestroyGameObject(entity);
 				mGameObjects.erase(entity);
 			}
 		});
+	mWorld.PlaybackCommands();
 }
 
 void GameScene::InitSystems()
@@ -301,6 +309,8 @@ void GameScene::InitSystems()
 	mPlayerSystem.reset(new PlayerSystem());
 	mMoveSystem.reset(new MoveSystem());
 	mVoxelCollisionSystem.reset(new VoxelCollisionSystem());
+	// コライダーの追加を受け取るため、オブジェクトを生成する前に作る
+	mCollisionSystem.reset(new CollisionSystem(mWorld));
 
 	mPlatformSystem.reset(new PlatformSystem());
 	mPlatformEditor.reset(new PlatformEditor());
@@ -311,9 +321,9 @@ void GameScene::InitSystems()
 	mLadderEditor->SetLadderSystem(mLadderSystem.get());
 
 	mItemSystem.reset(new ItemSystem());
-	mItemSystem->SetAddGameObjectCallback([this](std::unique_ptr<GameObject>&& obj)
+	mItemSystem->SetAddGameObjectCallback([this](GameObject* obj)
 		{
-			AddGameObject(std::move(obj));
+			AddGameObject(obj);
 		});
 
 	mGoalSystem.reset(new GoalSystem());
@@ -321,6 +331,44 @@ void GameScene::InitSystems()
 	mItemGoalEditor.reset(new ItemGoalEditor());
 	mItemGoalEditor->SetItemSystem(mItemSystem.get());
 	mItemGoalEditor->SetGoalSystem(mGoalSystem.get());
+
+	// 登録順が衝突するシステム間の実行順になる
+	// Input・Audio・gSoundMapはスレッドセーフでないので、それらを使うシステムはメインスレッドで実行する
+	auto& scheduler = mWorld.GetScheduler();
+	scheduler.Clear();
+	scheduler.AddSystem("PlayerSystem",
+		SystemAccess().Read<VoxelColliderComponent, PlayerTag>()
+		.Write<TransformComponent, VelocityComponent, MeshComponent>().MainThread(),
+		[this](World& world, float dt) { mPlayerSystem->Update(world, mGameCamera, dt); });
+	scheduler.AddSystem("PlatformSystem",
+		SystemAccess().Write<TransformComponent, PlatformComponent, DynamicVoxelBodyComponent>(),
+		[this](World& world, float dt) { mPlatformSystem->Update(world, dt); });
+	// 登り状態コンポーネントの追加・削除を行うため排他
+	scheduler.AddSystem("LadderSystem", SystemAccess().Exclusive(),
+		[this](World& world, float dt) { mLadderSystem->Update(world, dt); });
+	// 取得済みアイテムへのDeathFlag付与はコマンドバッファ経由
+	scheduler.AddSystem("ItemSystem",
+		SystemAccess().Read<VoxelColliderComponent, PlayerTag, ItemTag>()
+		.Write<TransformComponent, ItemComponent, DeathFlag>().MainThread(),
+		[this](World& world, float dt) { mItemSystem->Update(world, dt); });
+	scheduler.AddSystem("GoalSystem",
+		SystemAccess().Read<TransformComponent, VoxelColliderComponent, PlayerTag, GoalTag>()
+		.Write<GoalComponent>().MainThread(),
+		[this](World& world, float dt) { mGoalSystem->Update(world, dt); });
+	// レジストリを直接参照するため排他
+	scheduler.AddSystem("VoxelCollisionSystem", SystemAccess().Exclusive(),
+		[this](World& world, float dt) { mVoxelCollisionSystem->Update(world, dt); });
+	scheduler.AddSystem("MoveSystem",
+		SystemAccess().Read<VelocityComponent, VoxelColliderComponent>().Write<TransformComponent>(),
+		[this](World& world, float dt) { mMoveSystem->Update(world, dt); });
+	// 移動後のワールド行列で判定するので、階層を更新してから行う（排他）
+	// CollisionEventはその場で発行されるのでメインスレッドで実行する
+	scheduler.AddSystem("CollisionSystem", SystemAccess().Exclusive().MainThread(),
+		[this](World& world, float)
+		{
+			world.UpdateTransforms();
+			mCollisionSystem->Update();
+		});
 }
 
 void GameScene::CreateTestPlatforms()
@@ -424,6 +472,15 @@ void GameScene::ImGuiHandleObjects()
 		mItemGoalEditor->RenderUI(mWorld, mGameCamera);
 	}
 
+	ImGui::Begin("Systems");
+	const auto& scheduler = mWorld.GetScheduler();
+	ImGui::Text("Total: %.3f ms", scheduler.GetTotalMilliseconds());
+	for (const auto& timing : scheduler.GetTimings())
+	{
+		ImGui::Text("%-22s %.3f ms (worker %d)", timing.name.c_str(), timing.milliseconds, timing.workerIndex);
+	}
+	ImGui::End();
+
 	ImGui::Begin("Editor Controls");
 	ImGui::Checkbox("Show Platform Editor", &mShowPlatformEditor);
 	ImGui::Checkbox("Show Item/Goal Editor", &mShowItemGoalEditor);
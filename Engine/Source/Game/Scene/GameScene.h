@@ -20,6 +20,10 @@ class GameScene : public Scene
 {
 public:
 	GameScene(std::string_view name, AtomEngine::SceneManager& manager);
+
+	// シーンで使うモデルの読み込みを始める（前のシーンから呼んで切り替え時の停止をなくす）
+	static std::vector<ModelFuture> PreloadModels();
+
 	bool Initialize() override;
 	void Update(float deltaTime) override;
 	void Render() override;
@@ -27,12 +31,13 @@ public:
 	bool Exit() override;
 
 private:
-	std::unordered_map<Entity, std::unique_ptr<GameObject>> mGameObjects;
+	std::unordered_map<Entity, GameObject*> mGameObjects;
 	Camera mGameCamera;
 
 	std::unique_ptr<PlayerSystem> mPlayerSystem;
 	std::unique_ptr<MoveSystem> mMoveSystem;
 	std::unique_ptr<VoxelCollisionSystem> mVoxelCollisionSystem;
+	std::unique_ptr<CollisionSystem> mCollisionSystem;
 	std::unique_ptr<PlatformSystem> mPlatformSystem;
 	std::unique_ptr<PlatformEditor> mPlatformEditor;
 	std::unique_ptr<LadderSystem> mLadderSystem;
@@ -56,7 +61,7 @@ private:
 	float mClearDelayTimer{ 0.0f };
 	
 private:
-	void AddGameObject(std::unique_ptr<GameObject>&& object);
+	void AddGameObject(GameObject* object);
 	void DestroyGameObject();
 	void ImGuiHandleObjects();
 
@@ -3,6 +3,7 @@
 #include "Runtime/Function/Global/GlobalContext.h"
 #include "../System/SoundManaged.h"
 #include <imgui.h>
+#include <algorithm>
 #include <cmath>
 
 
@@ -24,6 +25,9 @@ bool TitleScene::Initialize()
 	Audio::GetInstance()->Play(Sound::gSoundMap["bgm"], true);
 	Audio::GetInstance()->SetVolume(Sound::gSoundMap["bgm"], 0.5f);
 
+	extern std::vector<ModelFuture> PreloadGameScene();
+	mPreloadModels = PreloadGameScene();
+
 	return Scene::Initialize();
 }
 
@@ -36,8 +40,8 @@ void TitleScene::Update(float deltaTime)
 	{
 		mFadeOutTimer += deltaTime;
 
-		// フェードアウト後にゲームシーンへ
-		if (mFadeOutTimer > 0.5f)
+		// フェードアウト後、モデルの読み込みが終わっていればゲームシーンへ
+		if (mFadeOutTimer > 0.5f && IsPreloadFinished())
 		{
 			extern std::unique_ptr<Scene> CreateGameScene(const std::string & name, SceneManager & manager);
 			RequestReplaceScene(CreateGameScene("Game", mManager));
@@ -119,7 +123,7 @@ void TitleScene::Render()
 		else
 		{
 			// スタート後のフェードアウト効果
-			float fadeAlpha = 1.0f - (mFadeOutTimer / 0.5f);
+			float fadeAlpha = std::max(0.0f, 1.0f - (mFadeOutTimer / 0.5f));
 			ImVec4 fadeColor = ImVec4(1.0f, 1.0f, 1.0f, fadeAlpha);
 
 			ImGui::SetWindowFontScale(2.0f);
@@ -141,6 +145,9 @@ void TitleScene::Render()
 
 void TitleScene::Shutdown()
 {
+	// 読み込んだモデルはAssetManagerのキャッシュに残る
+	mPreloadModels.clear();
+
 	if (Audio::GetInstance()->IsPlaying(Sound::gSoundMap["bgm"]))
 		Audio::GetInstance()->Stop(Sound::gSoundMap["bgm"]);
 }
@@ -148,4 +155,14 @@ void TitleScene::Shutdown()
 bool TitleScene::Exit()
 {
 	return false;
+}
+
+bool TitleScene::IsPreloadFinished() const
+{
+	for (const ModelFuture& future : mPreloadModels)
+	{
+		if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return false;
+	}
+	return true;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Runtime/Function/Scene/Scene.h"
 #include "Runtime/Function/Input/Input.h"
 #include "Runtime/Function/Camera/CameraBase.h"
+#include "Runtime/Resource/AssetManager.h"
 
 class TitleScene : public AtomEngine::Scene
 {
@@ -21,5 +22,10 @@ private:
 	float mTitleAnimTime{ 0.0f };
 	bool mStartPressed{ false };
 	float mFadeOutTimer{ 0.0f };
+
+	// ゲームシーンのモデル（タイトル表示中にバックグラウンドで読み込む）
+	std::vector<AtomEngine::ModelFuture> mPreloadModels;
+
+	bool IsPreloadFinished() const;
 };
 
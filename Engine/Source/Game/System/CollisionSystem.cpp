@@ -10,9 +10,18 @@ CollisionSystem::CollisionSystem(AtomEngine::World& world)
  : mWorld(world){
 
 	world.GetDispatcher().sink<ComponentAddedEvent>().connect<&CollisionSystem::OnColliderAdded>(this);
+	world.GetDispatcher().sink<ComponentBatchAddedEvent>().connect<&CollisionSystem::OnCollidersAdded>(this);
 	world.GetDispatcher().sink<ComponentRemovedEvent>().connect<&CollisionSystem::OnColliderRemoved>(this);
 }
 
+CollisionSystem::~CollisionSystem()
+{
+	// シーンの再初期化で作り直されるので、Worldより先に破棄されても通知が残らないようにする
+	mWorld.GetDispatcher().sink<ComponentAddedEvent>().disconnect(this);
+	mWorld.GetDispatcher().sink<ComponentBatchAddedEvent>().disconnect(this);
+	mWorld.GetDispatcher().sink<ComponentRemovedEvent>().disconnect(this);
+}
+
 void CollisionSystem::Update()
 {
 	UpdateAABBCollider();
@@ -29,16 +38,28 @@ void CollisionSystem::Update()
 
 void CollisionSystem::OnColliderAdded(const ComponentAddedEvent& ev)
 {
-	if (ev.type == std::type_index(typeid(AABBCollider)))
+	InsertCollider(ev.entity, ev.type);
+}
+
+void CollisionSystem::OnCollidersAdded(const ComponentBatchAddedEvent& ev)
+{
+	// コマンドバッファの反映で追加されたコライダーはまとめて通知される
+	if (ev.type != std::type_index(typeid(AABBCollider)) && ev.type != std::type_index(typeid(SphereCollider)))
+		return;
+	for (Entity e : *ev.entities)
+		InsertCollider(e, ev.type);
+}
+
+void CollisionSystem::InsertCollider(Entity e, std::type_index type)
+{
+	if (type == std::type_index(typeid(AABBCollider)))
 	{
-		Entity e = ev.entity;
 		GameObject* obj = mWorld.GetGameObject(e);
 		auto& collider = mWorld.GetComponent<AABBCollider>(e);
 		mBVH.Insert(obj, collider.bound);
 	}
-	else if (ev.type == std::type_index(typeid(SphereCollider)))
+	else if (type == std::type_index(typeid(SphereCollider)))
 	{
-		Entity e = ev.entity;
 		GameObject* obj = mWorld.GetGameObject(e);
 		auto sph = mWorld.GetComponent<SphereCollider>(e).bound;
 		Collision::AABB aabb;
@@ -63,15 +84,15 @@ void CollisionSystem::OnColliderRemoved(const ComponentRemovedEvent& ev)
 
 void CollisionSystem::UpdateAABBCollider()
 {
-	auto view = mWorld.View<AABBCollider, TransformComponent>();
+	auto view = mWorld.View<AABBCollider, const TransformComponent>();
 
 	for (auto entity : view)
 	{
 		auto& collider = view.get<AABBCollider>(entity);
-		auto& transform = view.get<TransformComponent>(entity);
+		const auto& transform = view.get<const TransformComponent>(entity);
 
-		auto size = transform.GetMatrix().GetScale() * (collider.bound.max - collider.bound.min);
-		const auto& center = transform.GetMatrix().GetTrans();
+		auto size = transform.GetWorldMatrix().GetScale() * (collider.bound.max - collider.bound.min);
+		const auto& center = transform.GetWorldMatrix().GetTrans();
 		collider.bound.min = center - size * 0.5f;
 		collider.bound.max = center + size * 0.5f;
 
@@ -83,17 +104,17 @@ void CollisionSystem::UpdateAABBCollider()
 
 void CollisionSystem::UpdateSphereCollider()
 {
-	auto view = mWorld.View<SphereCollider, TransformComponent>();
+	auto view = mWorld.View<SphereCollider, const TransformComponent>();
 
 	for (auto entity : view)
 	{
 		auto& collider = view.get<SphereCollider>(entity);
-		auto& transform = view.get<TransformComponent>(entity);
+		const auto& transform = view.get<const TransformComponent>(entity);
 
-		const auto& s = transform.GetMatrix().GetScale();
+		const auto& s = transform.GetWorldMatrix().GetScale();
 		float scale = Math::Max(Math::Max(s.x, s.y), s.z);
 		float radius = collider.bound.radius * scale;
-		const auto& center = transform.GetMatrix().GetTrans();
+		const auto& center = transform.GetWorldMatrix().GetTrans();
 		collider.bound.center = center;
 		collider.bound.radius = radius;
 
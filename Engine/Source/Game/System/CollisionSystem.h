@@ -12,6 +12,7 @@ class CollisionSystem
 {
 public:
 	CollisionSystem(AtomEngine::World& world);
+	~CollisionSystem();
 	void Update();
 
 private:
@@ -22,6 +23,8 @@ private:
 	void UpdateSphereCollider();
 
 	void OnColliderAdded(const AtomEngine::ComponentAddedEvent& ev);
+	void OnCollidersAdded(const AtomEngine::ComponentBatchAddedEvent& ev);
+	void InsertCollider(AtomEngine::Entity e, std::type_index type);
 	void OnColliderRemoved(const AtomEngine::ComponentRemovedEvent& ev);
 	void BroadPhase(std::vector<std::pair<AtomEngine::Entity, AtomEngine::Entity>>& pairs);
 
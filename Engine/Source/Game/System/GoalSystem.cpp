@@ -35,11 +35,9 @@ void GoalSystem::Update(World& world, float deltaTime)
 
 void GoalSystem::CheckGoalCollision(World& world)
 {
-	auto& registry = world.GetRegistry();
+	auto playerView = world.View<const TransformComponent, const VoxelColliderComponent, const PlayerTag>();
 
-	auto playerView = registry.view<TransformComponent, VoxelColliderComponent, PlayerTag>();
-
-	auto goalView = registry.view<TransformComponent, GoalComponent, GoalTag>();
+	auto goalView = world.View<const TransformComponent, GoalComponent, const GoalTag>();
 
 	for (auto playerEntity : playerView)
 	{
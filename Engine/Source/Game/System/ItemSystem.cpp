@@ -35,10 +35,8 @@ void ItemSystem::Update(World& world, float deltaTime)
 
 void ItemSystem::CheckItemCollisions(World& world)
 {
-	auto& registry = world.GetRegistry();
-
-	auto playerView = registry.view<TransformComponent, VoxelColliderComponent, PlayerTag>();
-	auto itemView = registry.view<TransformComponent, ItemComponent, ItemTag>();
+	auto playerView = world.View<const TransformComponent, const VoxelColliderComponent, const PlayerTag>();
+	auto itemView = world.View<const TransformComponent, ItemComponent, const ItemTag>();
 
 	for (auto playerEntity : playerView)
 	{
@@ -75,8 +73,7 @@ void ItemSystem::CheckItemCollisions(World& world)
 
 void ItemSystem::UpdateItemAnimations(World& world, float deltaTime)
 {
-	auto& registry = world.GetRegistry();
-	auto view = registry.view<TransformComponent, ItemComponent>();
+	auto view = world.View<TransformComponent, ItemComponent>();
 
 	for (auto entity : view)
 	{
@@ -129,7 +126,7 @@ Entity ItemSystem::CreateItem(World& world, const ItemCreateInfo& info)
 
 	if (mAddGameObjectCallback)
 	{
-		mAddGameObjectCallback(std::move(itemObj));
+		mAddGameObjectCallback(itemObj);
 	}
 
 	return entity;
@@ -137,14 +134,14 @@ Entity ItemSystem::CreateItem(World& world, const ItemCreateInfo& info)
 
 void ItemSystem::DestroyItem(World& world, Entity entity)
 {
-	auto& registry = world.GetRegistry();
-	if (!registry.any_of<DeathFlag>(entity))
+	// 走査中に呼ばれるため、DeathFlagがない場合は追加を遅延する
+	if (auto* flag = world.TryGet<DeathFlag>(entity))
 	{
-		registry.emplace<DeathFlag>(entity, DeathFlag{ true });
+		flag->isDead = true;
 	}
 	else
 	{
-		registry.get<DeathFlag>(entity).isDead = true;
+		world.GetCommandBuffer().AddComponent<DeathFlag>(entity, DeathFlag{ true });
 	}
 }
 
@@ -17,7 +17,7 @@ struct ItemCollectedEvent
 	int itemId;
 };
 
-using AddGameObjectCallback = std::function<void(std::unique_ptr<GameObject>&&)>;
+using AddGameObjectCallback = std::function<void(GameObject*)>;
 
 class ItemSystem
 {
@@ -7,7 +7,7 @@ using namespace AtomEngine;
 
 void MoveSystem::Update(World& world, float deltaTime)
 {
-	auto view = world.View<TransformComponent, VelocityComponent>();
+	auto view = world.View<TransformComponent, const VelocityComponent>();
 
 	for (auto entity : view)
 	{
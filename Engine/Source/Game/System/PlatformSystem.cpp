@@ -49,8 +49,7 @@ void PlatformSystem::Initialize(World& world, const std::string& configPath)
 
 void PlatformSystem::Update(World& world, float deltaTime)
 {
-	auto& registry = world.GetRegistry();
-	auto view = registry.view<TransformComponent, PlatformComponent, DynamicVoxelBodyComponent>();
+	auto view = world.View<TransformComponent, PlatformComponent, DynamicVoxelBodyComponent>();
 
 	for (auto entity : view)
 	{
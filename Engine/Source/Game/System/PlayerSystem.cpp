@@ -20,7 +20,7 @@ namespace
 
 void PlayerSystem::Update(World& world, const Camera& camera, float dt)
 {
-	auto view = world.View<TransformComponent, VelocityComponent, MeshComponent, VoxelColliderComponent, PlayerTag>();
+	auto view = world.View<TransformComponent, VelocityComponent, MeshComponent, const VoxelColliderComponent, const PlayerTag>();
 	auto* input = Input::GetInstance();
 
 	for (auto entity : view)
@@ -58,19 +58,20 @@ void PlayerSystem::Update(World& world, const Camera& camera, float dt)
 
 			Quaternion targetRot = Quaternion::GetQuaternionFromAngleAxis(Radian(angleY + Math::PI), Vector3::UP);
 			transform.rotation = Slerp(transform.rotation, targetRot, 0.1f, true);
-			mesh.PlayAnimation(2, true);
+			// 移動・待機・落下の切り替えはクロスフェードする
+			mesh.PlayAnimation(2, MeshComponent::kDefaultCrossFadeTime, true);
 			if (!isPlaySe)
 				Audio::GetInstance()->Play(Sound::gSoundMap["moveSe"]);
 		}
 		else
 		{
-			mesh.PlayAnimation(1, true);
+			mesh.PlayAnimation(1, MeshComponent::kDefaultCrossFadeTime, true);
 			if (isPlaySe)
 				Audio::GetInstance()->Stop(Sound::gSoundMap["moveSe"]);
 		}
 		if (isFall)
 		{
-			mesh.PlayAnimation(0, false);
+			mesh.PlayAnimation(0, MeshComponent::kDefaultCrossFadeTime, false);
 			if (isPlaySe)
 				Audio::GetInstance()->Stop(Sound::gSoundMap["moveSe"]);
 		}
@@ -0,0 +1,539 @@
+#include "JobSystem.h"
+#include "Runtime/Core/LogSystem/LogSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AtomEngine
+{
+	struct Job
+	{
+		std::function<void()> function;
+		Job* parent = nullptr;
+		std::atomic<int32_t> unfinishedJobs{ 0 };       ///< 自身と未完了の子ジョブの数
+		std::atomic<int32_t> pendingDependencies{ 0 };  ///< 未完了の依存ジョブ数（+Run前の1）
+
+		std::atomic<uint32_t> generation{ 0 };         ///< 確保のたびに進める（ハンドルの照合用）
+		std::atomic<bool> inUse{ false };               ///< 確保からFinishJobの後処理が終わるまでtrue
+
+		std::atomic_flag continuationLock;              ///< 後続ジョブと世代の変更を守る
+		bool continuationsClosed = false;
+		uint32_t continuationCount = 0;
+		Job* continuations[JobSystem::kMaxContinuations] = {};
+	};
+
+	namespace
+	{
+		constexpr size_t kCacheLineSize = 64;
+
+		// 自分のキューにこの数以上のジョブがあれば、範囲をそれ以上分割しない
+		constexpr int64_t kSplitQueueThreshold = 4;
+
+		// 眠る前にジョブを探し直す回数
+		constexpr uint32_t kSpinCount = 64;
+
+		/**
+		 * Chase-Lev両端キュー
+		 * 所有ワーカーはbottom側でPush/Popし、他のワーカーはtop側からStealする。
+		 */
+		class WorkQueue
+		{
+		public:
+			bool Push(Job* job)
+			{
+				const int64_t bottom = mBottom.load(std::memory_order_relaxed);
+				const int64_t top = mTop.load(std::memory_order_acquire);
+				if (bottom - top >= static_cast<int64_t>(JobSystem::kQueueCapacity))
+					return false;
+
+				mJobs[bottom & kMask].store(job, std::memory_order_release);
+				mBottom.store(bottom + 1, std::memory_order_release);
+				return true;
+			}
+
+			Job* Pop()
+			{
+				const int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+				mBottom.store(bottom, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				int64_t top = mTop.load(std::memory_order_relaxed);
+
+				if (top > bottom)
+				{
+					mBottom.store(bottom + 1, std::memory_order_relaxed);
+					return nullptr;
+				}
+
+				Job* job = mJobs[bottom & kMask].load(std::memory_order_relaxed);
+				if (top == bottom)
+				{
+					// 最後の1つはStealと競合するのでCASで取り合う
+					if (!mTop.compare_exchange_strong(top, top + 1,
+						std::memory_order_seq_cst, std::memory_order_relaxed))
+					{
+						job = nullptr;
+					}
+					mBottom.store(bottom + 1, std::memory_order_relaxed);
+				}
+				return job;
+			}
+
+			Job* Steal()
+			{
+				int64_t top = mTop.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				const int64_t bottom = mBottom.load(std::memory_order_acquire);
+				if (top >= bottom)
+					return nullptr;
+
+				Job* job = mJobs[top & kMask].load(std::memory_order_acquire);
+				if (!mTop.compare_exchange_strong(top, top + 1,
+					std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					return nullptr;
+				}
+				return job;
+			}
+
+			int64_t Size() const
+			{
+				return mBottom.load(std::memory_order_relaxed) - mTop.load(std::memory_order_relaxed);
+			}
+
+		private:
+			static constexpr int64_t kMask = JobSystem::kQueueCapacity - 1;
+
+			alignas(kCacheLineSize) std::atomic<int64_t> mTop{ 0 };
+			alignas(kCacheLineSize) std::atomic<int64_t> mBottom{ 0 };
+			alignas(kCacheLineSize) std::atomic<Job*> mJobs[JobSystem::kQueueCapacity] = {};
+		};
+
+		Job sJobPool[JobSystem::kMaxJobCount];
+		std::atomic<uint32_t> sNextJob{ 0 };
+
+		uint32_t sWorkerCount = 1;
+		std::unique_ptr<WorkQueue[]> sQueues;
+		std::vector<std::thread> sThreads;
+
+		// ワーカー以外のスレッドから投入されたジョブ
+		std::mutex sGlobalQueueMutex;
+		std::deque<Job*> sGlobalQueue;
+
+		// バックグラウンド処理（メインスレッド以外のワーカーだけが取り出す）
+		std::mutex sBackgroundMutex;
+		std::deque<std::function<void()>> sBackgroundTasks;
+		std::atomic<int32_t> sBackgroundTaskCount{ 0 };
+		std::atomic<uint32_t> sRunningBackgroundTasks{ 0 };
+
+		std::atomic<int32_t> sQueuedJobCount{ 0 };
+		std::atomic<int32_t> sSleepingWorkers{ 0 };
+		std::atomic<bool> sQuit{ false };
+		std::mutex sWakeMutex;
+		std::condition_variable sWakeCondition;
+
+		thread_local int32_t tWorkerIndex = -1;
+		thread_local uint32_t tRandomState = 0x9E3779B9u;
+
+		void LockContinuations(Job* job)
+		{
+			while (job->continuationLock.test_and_set(std::memory_order_acquire))
+				std::this_thread::yield();
+		}
+
+		void UnlockContinuations(Job* job)
+		{
+			job->continuationLock.clear(std::memory_order_release);
+		}
+
+		JobHandle AllocateJob()
+		{
+			// リングの次の位置から空いているスロットを探す（長く生きているジョブは飛ばす）
+			for (uint32_t attempt = 0; attempt < JobSystem::kMaxJobCount; ++attempt)
+			{
+				const uint32_t index = sNextJob.fetch_add(1, std::memory_order_relaxed) & (JobSystem::kMaxJobCount - 1);
+				Job* job = &sJobPool[index];
+				bool expected = false;
+				if (job->inUse.load(std::memory_order_relaxed) ||
+					!job->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+				{
+					continue;
+				}
+
+				job->parent = nullptr;
+				job->unfinishedJobs.store(1, std::memory_order_relaxed);
+				job->pendingDependencies.store(1, std::memory_order_relaxed);
+
+				// 古いハンドルからのAddDependencyと競合しないよう、世代は後続ジョブと同じロックで変える
+				LockContinuations(job);
+				const uint32_t generation = job->generation.load(std::memory_order_relaxed) + 1;
+				job->generation.store(generation, std::memory_order_release);
+				job->continuationsClosed = false;
+				job->continuationCount = 0;
+				UnlockContinuations(job);
+				return { job, generation };
+			}
+
+			// 上書きすると実行中のジョブが壊れるので続行しない
+			Log("[JobSystem]:job pool exhausted (%u jobs in flight)\n", JobSystem::kMaxJobCount);
+			std::abort();
+		}
+
+		void WakeWorker()
+		{
+			if (sSleepingWorkers.load() > 0)
+			{
+				std::lock_guard<std::mutex> lock(sWakeMutex);
+				sWakeCondition.notify_one();
+			}
+		}
+
+		void Execute(Job* job);
+
+		void PushJob(Job* job)
+		{
+			const int32_t worker = tWorkerIndex;
+			if (worker >= 0)
+			{
+				if (!sQueues[worker].Push(job))
+				{
+					// キューが一杯の場合はその場で実行する
+					Execute(job);
+					return;
+				}
+			}
+			else
+			{
+				std::lock_guard<std::mutex> lock(sGlobalQueueMutex);
+				sGlobalQueue.push_back(job);
+			}
+
+			sQueuedJobCount.fetch_add(1);
+			WakeWorker();
+		}
+
+		Job* GetJob()
+		{
+			Job* job = nullptr;
+			const int32_t worker = tWorkerIndex;
+			if (worker >= 0)
+				job = sQueues[worker].Pop();
+
+			if (!job)
+			{
+				std::lock_guard<std::mutex> lock(sGlobalQueueMutex);
+				if (!sGlobalQueue.empty())
+				{
+					job = sGlobalQueue.front();
+					sGlobalQueue.pop_front();
+				}
+			}
+
+			if (!job && sWorkerCount > 1)
+			{
+				// xorshiftで盗む相手の開始位置を散らす
+				tRandomState ^= tRandomState << 13;
+				tRandomState ^= tRandomState >> 17;
+				tRandomState ^= tRandomState << 5;
+				const uint32_t start = tRandomState % sWorkerCount;
+				for (uint32_t i = 0; i < sWorkerCount && !job; ++i)
+				{
+					const uint32_t victim = (start + i) % sWorkerCount;
+					if (static_cast<int32_t>(victim) != worker)
+						job = sQueues[victim].Steal();
+				}
+			}
+
+			if (job)
+				sQueuedJobCount.fetch_sub(1);
+			return job;
+		}
+
+		void FinishJob(Job* job)
+		{
+			if (job->unfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+				return;
+
+			LockContinuations(job);
+			job->continuationsClosed = true;
+			const uint32_t count = job->continuationCount;
+			UnlockContinuations(job);
+
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				Job* continuation = job->continuations[i];
+				if (continuation->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					PushJob(continuation);
+			}
+
+			if (job->parent)
+				FinishJob(job->parent);
+
+			// 後続ジョブと親を処理し終えてから再利用できるようにする
+			job->inUse.store(false, std::memory_order_release);
+		}
+
+		void Execute(Job* job)
+		{
+			if (job->function)
+			{
+				job->function();
+				job->function = nullptr;    // キャプチャはスロットの再利用を待たずに解放する
+			}
+			FinishJob(job);
+		}
+
+		uint32_t GetBackgroundTaskLimit()
+		{
+			return std::max(1u, (sWorkerCount - 1) / 2);
+		}
+
+		bool HasRunnableBackgroundTask()
+		{
+			return sBackgroundTaskCount.load() > 0 && sRunningBackgroundTasks.load() < GetBackgroundTaskLimit();
+		}
+
+		/// バックグラウンド処理を1つ実行する（同時実行数の上限に達していれば何もしない）
+		bool RunBackgroundTask()
+		{
+			if (sBackgroundTaskCount.load() <= 0)
+				return false;
+
+			uint32_t running = sRunningBackgroundTasks.load();
+			do
+			{
+				if (running >= GetBackgroundTaskLimit())
+					return false;
+			} while (!sRunningBackgroundTasks.compare_exchange_weak(running, running + 1));
+
+			std::function<void()> task;
+			{
+				std::lock_guard<std::mutex> lock(sBackgroundMutex);
+				if (!sBackgroundTasks.empty())
+				{
+					task = std::move(sBackgroundTasks.front());
+					sBackgroundTasks.pop_front();
+					sBackgroundTaskCount.fetch_sub(1);
+				}
+			}
+
+			if (task)
+				task();
+			sRunningBackgroundTasks.fetch_sub(1);
+
+			// 上限で待っていた処理があれば、眠っているワーカーに渡す
+			if (task && sBackgroundTaskCount.load() > 0)
+				WakeWorker();
+			return static_cast<bool>(task);
+		}
+
+		void WorkerMain(int32_t workerIndex)
+		{
+			tWorkerIndex = workerIndex;
+			tRandomState ^= static_cast<uint32_t>(workerIndex + 1) * 0x85EBCA6Bu;
+
+			while (!sQuit.load(std::memory_order_relaxed))
+			{
+				Job* job = nullptr;
+				for (uint32_t spin = 0; spin < kSpinCount && !job; ++spin)
+				{
+					job = GetJob();
+					if (!job) std::this_thread::yield();
+				}
+
+				if (job)
+				{
+					Execute(job);
+					continue;
+				}
+
+				// フレームのジョブがないときだけバックグラウンド処理を進める
+				if (RunBackgroundTask())
+					continue;
+
+				std::unique_lock<std::mutex> lock(sWakeMutex);
+				sSleepingWorkers.fetch_add(1);
+				sWakeCondition.wait(lock, []
+					{
+						return sQueuedJobCount.load() > 0 || HasRunnableBackgroundTask() || sQuit.load();
+					});
+				sSleepingWorkers.fetch_sub(1);
+			}
+		}
+
+		void SplitRange(JobHandle root, uint32_t begin, uint32_t end, uint32_t grain, const JobRangeFunction& function)
+		{
+			const int32_t worker = tWorkerIndex;
+			while (end - begin > grain)
+			{
+				// 自分のキューに盗まれ待ちのジョブが十分あれば、これ以上分割しない
+				if (worker >= 0 && sQueues[worker].Size() >= kSplitQueueThreshold)
+					break;
+
+				const uint32_t mid = begin + (end - begin) / 2;
+				JobHandle child = JobSystem::CreateChildJob(root, [root, mid, end, grain, &function]
+					{
+						SplitRange(root, mid, end, grain, function);
+					});
+				JobSystem::Run(child);
+				end = mid;
+			}
+			function(begin, end);
+		}
+	}
+
+	void JobSystem::Initialize(uint32_t workerCount)
+	{
+		if (workerCount == 0)
+			workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+		sWorkerCount = workerCount;
+		sQueues = std::make_unique<WorkQueue[]>(workerCount);
+		sQuit.store(false);
+
+		// メインスレッドはワーカー0
+		tWorkerIndex = 0;
+		for (uint32_t i = 1; i < workerCount; ++i)
+			sThreads.emplace_back(WorkerMain, static_cast<int32_t>(i));
+	}
+
+	void JobSystem::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sWakeMutex);
+			sQuit.store(true);
+		}
+		sWakeCondition.notify_all();
+
+		for (auto& thread : sThreads)
+			thread.join();
+		sThreads.clear();
+
+		sGlobalQueue.clear();
+		sBackgroundTasks.clear();
+		sBackgroundTaskCount.store(0);
+		sQueues.reset();
+		sQueuedJobCount.store(0);
+		sWorkerCount = 1;
+		tWorkerIndex = -1;
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return sWorkerCount;
+	}
+
+	int32_t JobSystem::GetWorkerIndex()
+	{
+		return tWorkerIndex;
+	}
+
+	JobHandle JobSystem::CreateJob(std::function<void()> function)
+	{
+		JobHandle handle = AllocateJob();
+		handle.job->function = std::move(function);
+		return handle;
+	}
+
+	JobHandle JobSystem::CreateChildJob(JobHandle parent, std::function<void()> function)
+	{
+		assert(parent.job->generation.load(std::memory_order_relaxed) == parent.generation && "JobSystem: stale parent handle");
+		parent.job->unfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+
+		JobHandle handle = AllocateJob();
+		handle.job->parent = parent.job;
+		handle.job->function = std::move(function);
+		return handle;
+	}
+
+	void JobSystem::AddDependency(JobHandle job, JobHandle dependsOn)
+	{
+		Job* target = dependsOn.job;
+		LockContinuations(target);
+		// 世代が違えば依存先は完了してスロットが再利用されている
+		if (target->generation.load(std::memory_order_relaxed) == dependsOn.generation && !target->continuationsClosed)
+		{
+			assert(target->continuationCount < kMaxContinuations && "JobSystem: too many continuations");
+			job.job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+			target->continuations[target->continuationCount++] = job.job;
+		}
+		UnlockContinuations(target);
+	}
+
+	void JobSystem::Run(JobHandle job)
+	{
+		if (job.job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			PushJob(job.job);
+	}
+
+	JobHandle JobSystem::Schedule(std::function<void()> function, std::initializer_list<JobHandle> dependencies)
+	{
+		JobHandle job = CreateJob(std::move(function));
+		for (JobHandle dependency : dependencies)
+		{
+			if (dependency) AddDependency(job, dependency);
+		}
+		Run(job);
+		return job;
+	}
+
+	bool JobSystem::IsFinished(JobHandle job)
+	{
+		// スロットが再利用された後は、新しいジョブの状態を読まないよう世代を前後で確かめる
+		if (job.job->generation.load(std::memory_order_acquire) != job.generation)
+			return true;
+		const bool finished = job.job->unfinishedJobs.load(std::memory_order_acquire) == 0;
+		return finished || job.job->generation.load(std::memory_order_acquire) != job.generation;
+	}
+
+	void JobSystem::Wait(JobHandle job)
+	{
+		while (!IsFinished(job))
+		{
+			if (Job* other = GetJob())
+				Execute(other);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, const JobRangeFunction& function, uint32_t minBatchSize)
+	{
+		if (count == 0) return;
+
+		// 各ワーカーが数回ずつ盗める程度の粒度を下限とする
+		const uint32_t grain = std::max({ 1u, minBatchSize, count / (sWorkerCount * 8) });
+		if (sWorkerCount <= 1 || count <= grain)
+		{
+			function(0, count);
+			return;
+		}
+
+		JobHandle root = CreateJob(nullptr);
+		SplitRange(root, 0, count, grain, function);
+		FinishJob(root.job);
+		Wait(root);
+	}
+
+	void JobSystem::ScheduleBackground(std::function<void()> function)
+	{
+		if (sWorkerCount <= 1)
+		{
+			function();
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(sBackgroundMutex);
+			sBackgroundTasks.push_back(std::move(function));
+		}
+		sBackgroundTaskCount.fetch_add(1);
+		WakeWorker();
+	}
+}
@@ -0,0 +1,160 @@
+/**
+ * @file JobSystem.h
+ * @brief ワークスティーリング型のジョブシステム
+ *
+ * 固定数のワーカースレッドがそれぞれChase-Lev両端キューを持ち、
+ * 自分のキューが空になると他ワーカーのキューからジョブを盗んで実行する。
+ * メインスレッドはワーカー0として扱い、Wait中はジョブの実行を手伝う。
+ * ジョブは固定サイズのプールから確保するのでJob自体の確保は発生しないが、
+ * 処理（std::function）のキャプチャが小さなバッファ（実装依存）に収まらない場合はヒープ確保される。
+ * 大きな状態は構造体にまとめ、そのポインタだけをキャプチャすること。
+ */
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+
+namespace AtomEngine
+{
+	struct Job;
+
+	/**
+	 * @struct JobHandle
+	 * @brief 世代付きのジョブハンドル
+	 *
+	 * ジョブのスロットは完了後に再利用される。世代が変わったハンドルは完了済みのジョブとして扱う。
+	 */
+	struct JobHandle
+	{
+		Job* job = nullptr;
+		uint32_t generation = 0;
+
+		explicit operator bool() const { return job != nullptr; }
+	};
+
+	/// ParallelForに渡す範囲関数 [begin, end)
+	using JobRangeFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+	/**
+	 * @class JobSystem
+	 * @brief ジョブの生成・依存関係管理・実行を行う
+	 *
+	 * 使用例:
+	 * @code
+	 * JobHandle a = JobSystem::Schedule([] { UpdateA(); });
+	 * JobHandle b = JobSystem::Schedule([] { UpdateB(); }, { a });
+	 * JobSystem::ParallelFor(count, [&](uint32_t begin, uint32_t end) { ... });
+	 * JobSystem::Wait(b);
+	 * @endcode
+	 */
+	class JobSystem
+	{
+	public:
+		/// 同時に存在できるジョブ数（完了したスロットを再利用する。使い切るとログを出して終了する）
+		static constexpr uint32_t kMaxJobCount = 1 << 14;
+		/// 各ワーカーの両端キューの容量
+		static constexpr uint32_t kQueueCapacity = 1 << 12;
+		/// 1ジョブに登録できる後続ジョブ数
+		static constexpr uint32_t kMaxContinuations = 16;
+
+		/**
+		 * @brief ワーカースレッドを起動する（メインスレッドから呼ぶ）
+		 * @param workerCount メインスレッドを含むワーカー数（0ならハードウェアスレッド数）
+		 */
+		static void Initialize(uint32_t workerCount = 0);
+
+		/**
+		 * @brief ワーカースレッドを停止する
+		 */
+		static void Shutdown();
+
+		/**
+		 * @brief メインスレッドを含むワーカー数を取得
+		 */
+		static uint32_t GetWorkerCount();
+
+		/**
+		 * @brief 現在のスレッドのワーカー番号を取得
+		 * @return ワーカー番号（ワーカー以外のスレッドでは-1）
+		 */
+		static int32_t GetWorkerIndex();
+
+		/**
+		 * @brief ジョブを生成する（Runを呼ぶまで実行されない）
+		 * @param function 実行する処理
+		 * @return ジョブハンドル
+		 */
+		static JobHandle CreateJob(std::function<void()> function);
+
+		/**
+		 * @brief 子ジョブを生成する
+		 *
+		 * 親ジョブは全ての子ジョブが完了するまで完了扱いにならない。
+		 * @param parent 親ジョブ
+		 * @param function 実行する処理
+		 * @return ジョブハンドル
+		 */
+		static JobHandle CreateChildJob(JobHandle parent, std::function<void()> function);
+
+		/**
+		 * @brief 依存関係を追加する（Run前に呼ぶ）
+		 * @param job 後から実行するジョブ
+		 * @param dependsOn 先に完了している必要があるジョブ（完了済みなら何もしない）
+		 */
+		static void AddDependency(JobHandle job, JobHandle dependsOn);
+
+		/**
+		 * @brief ジョブを実行キューに投入する
+		 *
+		 * 未完了の依存ジョブがある場合は、それらが全て完了した時点で投入される。
+		 * @param job ジョブハンドル
+		 */
+		static void Run(JobHandle job);
+
+		/**
+		 * @brief ジョブを生成して即座に投入する
+		 * @param function 実行する処理
+		 * @param dependencies 先に完了している必要があるジョブ
+		 * @return ジョブハンドル
+		 */
+		static JobHandle Schedule(std::function<void()> function, std::initializer_list<JobHandle> dependencies = {});
+
+		/**
+		 * @brief ジョブが完了したか判定
+		 * @param job ジョブハンドル
+		 * @return 完了していればtrue
+		 */
+		static bool IsFinished(JobHandle job);
+
+		/**
+		 * @brief ジョブの完了を待つ
+		 *
+		 * 待機中は他のジョブを実行するため、ワーカー上から呼んでもデッドロックしない。
+		 * @param job ジョブハンドル
+		 */
+		static void Wait(JobHandle job);
+
+		/**
+		 * @brief インデックス範囲を分割して並列実行し、完了まで待つ
+		 *
+		 * 範囲は実行中に二分割され、自分のキューが空いている間だけ
+		 * 盗まれる用の後半を子ジョブとして投入する。
+		 * @param count 要素数
+		 * @param function 範囲関数 [begin, end)
+		 * @param minBatchSize 1回の呼び出しで処理する最小要素数
+		 */
+		static void ParallelFor(uint32_t count, const JobRangeFunction& function, uint32_t minBatchSize = 1);
+
+		/**
+		 * @brief 時間のかかる処理（ファイル読み込みなど）をバックグラウンドで実行する
+		 *
+		 * ジョブプールは使わず、メインスレッド以外のワーカーが手の空いたときにだけ取り出す。
+		 * Wait中のメインスレッドは実行しないので、フレームの処理が止まることはない。
+		 * 同時に実行するのはワーカースレッド数の半分まで（残りはフレームのジョブ用）。
+		 * 完了の通知は処理の中で行うこと。ワーカースレッドがなければその場で実行する。
+		 * @param function 実行する処理
+		 */
+		static void ScheduleBackground(std::function<void()> function);
+	};
+}
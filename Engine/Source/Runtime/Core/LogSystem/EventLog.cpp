@@ -0,0 +1,119 @@
+#include "EventLog.h"
+
+#if ENABLE_EVENT_LOG
+#include "LogSystem.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		struct EventRingBuffer
+		{
+			std::array<EventRecord, EventLog::kRingBufferSize> records;
+			std::atomic<uint64_t> writeCount{ 0 };
+			uint32_t threadIndex = 0;
+		};
+
+		std::atomic<uint32_t> sFrame{ 0 };
+
+		std::mutex sBufferMutex;
+		// スレッド終了後もDumpできるよう、バッファはここで保持し続ける
+		std::vector<std::unique_ptr<EventRingBuffer>> sBuffers;
+		std::unordered_map<uint32_t, const char*> sTypeNames;
+
+		thread_local EventRingBuffer* tBuffer = nullptr;
+
+		EventRingBuffer* GetThreadBuffer()
+		{
+			if (!tBuffer)
+			{
+				std::lock_guard<std::mutex> lock(sBufferMutex);
+				auto buffer = std::make_unique<EventRingBuffer>();
+				buffer->threadIndex = static_cast<uint32_t>(sBuffers.size());
+				tBuffer = buffer.get();
+				sBuffers.push_back(std::move(buffer));
+			}
+			return tBuffer;
+		}
+
+		const char* GetEventName(EventLogType type)
+		{
+			switch (type)
+			{
+			case EventLogType::ObjectCreated:    return "Object Added";
+			case EventLogType::ObjectDestroyed:  return "Object Destroyed";
+			case EventLogType::ComponentAdded:   return "Component Added";
+			case EventLogType::ComponentRemoved: return "Component Removed";
+			}
+			return "Unknown";
+		}
+	}
+
+	uint32_t EventLog::RegisterTypeName(const char* name)
+	{
+		// FNV-1a: 実行ごとに同じ値となるよう型名から求める
+		uint32_t hash = 2166136261U;
+		for (const char* c = name; *c; ++c)
+			hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619U;
+
+		std::lock_guard<std::mutex> lock(sBufferMutex);
+		sTypeNames.emplace(hash, name);
+		return hash;
+	}
+
+	void EventLog::Record(EventLogType type, uint32_t typeHash, uint32_t entity)
+	{
+		EventRingBuffer* buffer = GetThreadBuffer();
+		const uint64_t index = buffer->writeCount.load(std::memory_order_relaxed);
+
+		EventRecord& record = buffer->records[index & (kRingBufferSize - 1)];
+		record.typeHash = typeHash;
+		record.entity = entity;
+		record.frame = sFrame.load(std::memory_order_relaxed);
+		record.type = type;
+
+		buffer->writeCount.store(index + 1, std::memory_order_release);
+	}
+
+	void EventLog::NextFrame()
+	{
+		sFrame.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void EventLog::Dump()
+	{
+		std::lock_guard<std::mutex> lock(sBufferMutex);
+
+		for (const auto& buffer : sBuffers)
+		{
+			const uint64_t written = buffer->writeCount.load(std::memory_order_acquire);
+			const uint64_t count = written < kRingBufferSize ? written : kRingBufferSize;
+
+			Log("[EventLog]:Thread(%u) %llu records (%llu dropped)\n",
+				buffer->threadIndex, count, written - count);
+
+			for (uint64_t i = written - count; i < written; ++i)
+			{
+				const EventRecord& record = buffer->records[i & (kRingBufferSize - 1)];
+				if (record.typeHash == 0)
+				{
+					Log("[%s]:Entity(%u) Frame(%u)\n",
+						GetEventName(record.type), record.entity, record.frame);
+					continue;
+				}
+
+				auto it = sTypeNames.find(record.typeHash);
+				const char* typeName = it != sTypeNames.end() ? it->second : "?";
+				Log("[%s]:%s -> Entity(%u) Frame(%u)\n",
+					GetEventName(record.type), typeName, record.entity, record.frame);
+			}
+		}
+	}
+}
+#endif
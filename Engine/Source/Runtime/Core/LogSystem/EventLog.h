@@ -0,0 +1,108 @@
+/**
+ * @file EventLog.h
+ * @brief バイナリ形式のイベントログ
+ *
+ * 固定長レコード（型ハッシュ・エンティティ・フレーム番号）をスレッドごとの
+ * リングバッファに記録し、Dump時にのみ文字列へ整形する。
+ * ENABLE_EVENT_LOG を 0 にするとマクロごと完全に除去される。
+ */
+
+#pragma once
+#include <cstdint>
+#include <typeinfo>
+
+// 既定ではデバッグビルドのみ有効
+#ifndef ENABLE_EVENT_LOG
+#ifdef _DEBUG
+#define ENABLE_EVENT_LOG 1
+#else
+#define ENABLE_EVENT_LOG 0
+#endif
+#endif
+
+namespace AtomEngine
+{
+	/**
+	 * @enum EventLogType
+	 * @brief 記録するイベントの種類
+	 */
+	enum class EventLogType : uint8_t
+	{
+		ObjectCreated,
+		ObjectDestroyed,
+		ComponentAdded,
+		ComponentRemoved,
+	};
+
+	/**
+	 * @struct EventRecord
+	 * @brief 1イベント分の固定長レコード
+	 */
+	struct EventRecord
+	{
+		uint32_t typeHash;   ///< コンポーネント型のハッシュ（オブジェクトイベントは0）
+		uint32_t entity;     ///< 対象エンティティ
+		uint32_t frame;      ///< 記録時のフレーム番号
+		EventLogType type;   ///< イベントの種類
+	};
+
+	namespace EventLog
+	{
+		/// スレッドごとのリングバッファの容量（レコード数、2の累乗）
+		static constexpr uint32_t kRingBufferSize = 1 << 14;
+
+#if ENABLE_EVENT_LOG
+		/**
+		 * @brief 型名を登録し、そのハッシュを返す
+		 * @param name 型名（静的な寿命を持つ文字列）
+		 * @return 型名のハッシュ
+		 */
+		uint32_t RegisterTypeName(const char* name);
+
+		/**
+		 * @brief 型ごとのハッシュを取得（初回のみ型名を登録）
+		 * @tparam T コンポーネントの型
+		 * @return 型ハッシュ
+		 */
+		template<typename T>
+		uint32_t TypeHash()
+		{
+			static const uint32_t hash = RegisterTypeName(typeid(T).name());
+			return hash;
+		}
+
+		/**
+		 * @brief 現在のスレッドのリングバッファにイベントを記録
+		 * @param type イベントの種類
+		 * @param typeHash 型ハッシュ
+		 * @param entity 対象エンティティ
+		 */
+		void Record(EventLogType type, uint32_t typeHash, uint32_t entity);
+
+		/**
+		 * @brief フレーム番号を進める（1フレームに1回呼ぶ）
+		 */
+		void NextFrame();
+
+		/**
+		 * @brief 記録済みのイベントを整形してログへ出力
+		 *
+		 * 他スレッドが記録中でない同期点で呼ぶこと。
+		 */
+		void Dump();
+#else
+		inline void NextFrame() {}
+		inline void Dump() {}
+#endif
+	}
+}
+
+#if ENABLE_EVENT_LOG
+#define EVENT_LOG_OBJECT(eventType, entity) \
+	::AtomEngine::EventLog::Record(eventType, 0, static_cast<uint32_t>(entity))
+#define EVENT_LOG_COMPONENT(eventType, T, entity) \
+	::AtomEngine::EventLog::Record(eventType, ::AtomEngine::EventLog::TypeHash<T>(), static_cast<uint32_t>(entity))
+#else
+#define EVENT_LOG_OBJECT(eventType, entity) ((void)0)
+#define EVENT_LOG_COMPONENT(eventType, T, entity) ((void)0)
+#endif
@@ -0,0 +1,417 @@
+#include "BatchTransform.h"
+#include "SIMD.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace AtomEngine
+{
+	// AoSの配列をfloatの並びとして読み書きするので、メンバ以外を持たないことを確認しておく
+	static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must be tightly packed");
+	static_assert(sizeof(AxisAlignedBox) == sizeof(float) * 6, "AxisAlignedBox must be (min, max)");
+	static_assert(sizeof(BoundingSphere) == sizeof(float) * 4, "BoundingSphere must be (center, radius)");
+
+	namespace
+	{
+		using SIMD::Float4;
+
+		/// 行列の上4x3を要素ごとに複製したもの
+		struct SplatMatrix
+		{
+			Float4 m[4][3];
+			Float4 abs[3][3];
+
+			explicit SplatMatrix(const Matrix4x4& mat)
+			{
+				for (int r = 0; r < 4; ++r)
+					for (int c = 0; c < 3; ++c)
+						m[r][c] = SIMD::Splat(mat.mat[r][c]);
+				for (int r = 0; r < 3; ++r)
+					for (int c = 0; c < 3; ++c)
+						abs[r][c] = SIMD::Splat(std::fabs(mat.mat[r][c]));
+			}
+		};
+
+		/// 4要素分の(x, y, z)
+		struct Float4x3
+		{
+			Float4 x, y, z;
+		};
+
+		// 加算順序はスカラー版（x * m0 + y * m1 + z * m2 + m3）と揃えてあり、端数処理と結果が一致する
+		inline Float4x3 TransformPoint4(const SplatMatrix& s, const Float4x3& v)
+		{
+			Float4x3 r;
+			r.x = SIMD::Add(SIMD::Add(SIMD::Add(SIMD::Mul(v.x, s.m[0][0]), SIMD::Mul(v.y, s.m[1][0])), SIMD::Mul(v.z, s.m[2][0])), s.m[3][0]);
+			r.y = SIMD::Add(SIMD::Add(SIMD::Add(SIMD::Mul(v.x, s.m[0][1]), SIMD::Mul(v.y, s.m[1][1])), SIMD::Mul(v.z, s.m[2][1])), s.m[3][1]);
+			r.z = SIMD::Add(SIMD::Add(SIMD::Add(SIMD::Mul(v.x, s.m[0][2]), SIMD::Mul(v.y, s.m[1][2])), SIMD::Mul(v.z, s.m[2][2])), s.m[3][2]);
+			return r;
+		}
+
+		inline Float4x3 TransformDirection4(const SplatMatrix& s, const Float4x3& v)
+		{
+			Float4x3 r;
+			r.x = SIMD::Add(SIMD::Add(SIMD::Mul(v.x, s.m[0][0]), SIMD::Mul(v.y, s.m[1][0])), SIMD::Mul(v.z, s.m[2][0]));
+			r.y = SIMD::Add(SIMD::Add(SIMD::Mul(v.x, s.m[0][1]), SIMD::Mul(v.y, s.m[1][1])), SIMD::Mul(v.z, s.m[2][1]));
+			r.z = SIMD::Add(SIMD::Add(SIMD::Mul(v.x, s.m[0][2]), SIMD::Mul(v.y, s.m[1][2])), SIMD::Mul(v.z, s.m[2][2]));
+			return r;
+		}
+
+		inline Float4x3 TransformExtent4(const SplatMatrix& s, const Float4x3& e)
+		{
+			Float4x3 r;
+			r.x = SIMD::Add(SIMD::Add(SIMD::Mul(e.x, s.abs[0][0]), SIMD::Mul(e.y, s.abs[1][0])), SIMD::Mul(e.z, s.abs[2][0]));
+			r.y = SIMD::Add(SIMD::Add(SIMD::Mul(e.x, s.abs[0][1]), SIMD::Mul(e.y, s.abs[1][1])), SIMD::Mul(e.z, s.abs[2][1]));
+			r.z = SIMD::Add(SIMD::Add(SIMD::Mul(e.x, s.abs[0][2]), SIMD::Mul(e.y, s.abs[1][2])), SIMD::Mul(e.z, s.abs[2][2]));
+			return r;
+		}
+
+		inline Vector3 TransformPoint(const Matrix4x4& m, const Vector3& v)
+		{
+			return Vector3(
+				v.x * m.mat[0][0] + v.y * m.mat[1][0] + v.z * m.mat[2][0] + m.mat[3][0],
+				v.x * m.mat[0][1] + v.y * m.mat[1][1] + v.z * m.mat[2][1] + m.mat[3][1],
+				v.x * m.mat[0][2] + v.y * m.mat[1][2] + v.z * m.mat[2][2] + m.mat[3][2]);
+		}
+
+		inline Vector3 TransformDirection(const Matrix4x4& m, const Vector3& v)
+		{
+			return Vector3(
+				v.x * m.mat[0][0] + v.y * m.mat[1][0] + v.z * m.mat[2][0],
+				v.x * m.mat[0][1] + v.y * m.mat[1][1] + v.z * m.mat[2][1],
+				v.x * m.mat[0][2] + v.y * m.mat[1][2] + v.z * m.mat[2][2]);
+		}
+
+		inline Vector3 TransformExtent(const Matrix4x4& m, const Vector3& e)
+		{
+			return Vector3(
+				e.x * std::fabs(m.mat[0][0]) + e.y * std::fabs(m.mat[1][0]) + e.z * std::fabs(m.mat[2][0]),
+				e.x * std::fabs(m.mat[0][1]) + e.y * std::fabs(m.mat[1][1]) + e.z * std::fabs(m.mat[2][1]),
+				e.x * std::fabs(m.mat[0][2]) + e.y * std::fabs(m.mat[1][2]) + e.z * std::fabs(m.mat[2][2]));
+		}
+
+		/**
+		 * @brief 上3x3が単位球を引き伸ばす最大の倍率（最大特異値）
+		 *
+		 * スケールと回転の掛ける順序やせん断に関係なく球を覆えるよう、MᵀMの最大固有値を閉形式で求める。
+		 * 行列ごとに1回しか呼ばないのでdoubleで計算し、丸めの分だけわずかに大きくする。
+		 */
+		inline float GetMaxAxisScale(const Matrix4x4& m)
+		{
+			double a[3][3];
+			for (int r = 0; r < 3; ++r)
+				for (int c = 0; c < 3; ++c)
+					a[r][c] = double(m.mat[0][r]) * m.mat[0][c] + double(m.mat[1][r]) * m.mat[1][c] + double(m.mat[2][r]) * m.mat[2][c];
+
+			const double q = (a[0][0] + a[1][1] + a[2][2]) / 3.0;
+			const double p1 = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+			const double p2 = (a[0][0] - q) * (a[0][0] - q) + (a[1][1] - q) * (a[1][1] - q) + (a[2][2] - q) * (a[2][2] - q) + 2.0 * p1;
+
+			double maxEigen = q;
+			if (p2 > 0.0)
+			{
+				const double p = std::sqrt(p2 / 6.0);
+				double b[3][3];
+				for (int r = 0; r < 3; ++r)
+					for (int c = 0; c < 3; ++c)
+						b[r][c] = (a[r][c] - (r == c ? q : 0.0)) / p;
+				const double det =
+					b[0][0] * (b[1][1] * b[2][2] - b[1][2] * b[2][1]) -
+					b[0][1] * (b[1][0] * b[2][2] - b[1][2] * b[2][0]) +
+					b[0][2] * (b[1][0] * b[2][1] - b[1][1] * b[2][0]);
+				const double phi = std::acos(std::clamp(det * 0.5, -1.0, 1.0)) / 3.0;
+				maxEigen = q + 2.0 * p * std::cos(phi);
+			}
+			return static_cast<float>(std::sqrt(std::max(maxEigen, 0.0)) * (1.0 + 1e-6));
+		}
+
+		/**
+		 * @brief (x0 y0 z0 x1)(y1 z1 x2 y2)(z2 x3 y3 z3)の並びを成分ごとに分ける
+		 */
+		inline Float4x3 LoadInterleaved(const float* p)
+		{
+			const Float4 a = SIMD::Load(p + 0);
+			const Float4 b = SIMD::Load(p + 4);
+			const Float4 c = SIMD::Load(p + 8);
+
+			Float4x3 r;
+			r.x = SIMD::Shuffle<0, 3, 1, 2>(a, SIMD::Shuffle<2, 2, 1, 1>(b, c));
+			r.y = SIMD::Shuffle<0, 2, 0, 2>(SIMD::Shuffle<1, 1, 0, 0>(a, b), SIMD::Shuffle<3, 3, 2, 2>(b, c));
+			r.z = SIMD::Shuffle<0, 2, 0, 2>(SIMD::Shuffle<2, 2, 1, 1>(a, b), SIMD::Shuffle<0, 0, 3, 3>(c, c));
+			return r;
+		}
+
+		/// LoadInterleavedの逆
+		inline void StoreInterleaved(float* p, const Float4x3& v)
+		{
+			SIMD::Store(p + 0, SIMD::Shuffle<0, 2, 0, 2>(SIMD::Shuffle<0, 0, 0, 0>(v.x, v.y), SIMD::Shuffle<0, 0, 1, 1>(v.z, v.x)));
+			SIMD::Store(p + 4, SIMD::Shuffle<0, 2, 0, 2>(SIMD::Shuffle<1, 1, 1, 1>(v.y, v.z), SIMD::Shuffle<2, 2, 2, 2>(v.x, v.y)));
+			SIMD::Store(p + 8, SIMD::Shuffle<0, 2, 0, 2>(SIMD::Shuffle<2, 2, 3, 3>(v.z, v.x), SIMD::Shuffle<3, 3, 3, 3>(v.y, v.z)));
+		}
+
+		inline Float4x3 LoadArrays(ConstVector3Arrays a, size_t i)
+		{
+			return { SIMD::Load(a.x + i), SIMD::Load(a.y + i), SIMD::Load(a.z + i) };
+		}
+
+		inline void StoreArrays(Vector3Arrays a, size_t i, const Float4x3& v)
+		{
+			SIMD::Store(a.x + i, v.x);
+			SIMD::Store(a.y + i, v.y);
+			SIMD::Store(a.z + i, v.z);
+		}
+	}
+
+	void BatchTransform::TransformPoints(const Matrix4x4& mat, const Vector3* in, Vector3* out, size_t count)
+	{
+		const SplatMatrix s(mat);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			StoreInterleaved(&out[i].x, TransformPoint4(s, LoadInterleaved(&in[i].x)));
+		for (; i < count; ++i)
+			out[i] = TransformPoint(mat, in[i]);
+	}
+
+	void BatchTransform::TransformPoints(const Matrix4x4& mat, ConstVector3Arrays in, Vector3Arrays out, size_t count)
+	{
+		const SplatMatrix s(mat);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			StoreArrays(out, i, TransformPoint4(s, LoadArrays(in, i)));
+		for (; i < count; ++i)
+		{
+			const Vector3 v = TransformPoint(mat, Vector3(in.x[i], in.y[i], in.z[i]));
+			out.x[i] = v.x;
+			out.y[i] = v.y;
+			out.z[i] = v.z;
+		}
+	}
+
+	void BatchTransform::TransformDirections(const Matrix4x4& mat, const Vector3* in, Vector3* out, size_t count)
+	{
+		const SplatMatrix s(mat);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			StoreInterleaved(&out[i].x, TransformDirection4(s, LoadInterleaved(&in[i].x)));
+		for (; i < count; ++i)
+			out[i] = TransformDirection(mat, in[i]);
+	}
+
+	void BatchTransform::TransformDirections(const Matrix4x4& mat, ConstVector3Arrays in, Vector3Arrays out, size_t count)
+	{
+		const SplatMatrix s(mat);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			StoreArrays(out, i, TransformDirection4(s, LoadArrays(in, i)));
+		for (; i < count; ++i)
+		{
+			const Vector3 v = TransformDirection(mat, Vector3(in.x[i], in.y[i], in.z[i]));
+			out.x[i] = v.x;
+			out.y[i] = v.y;
+			out.z[i] = v.z;
+		}
+	}
+
+	void BatchTransform::TransformAABBs(const Matrix4x4& mat, const AxisAlignedBox* in, AxisAlignedBox* out, size_t count)
+	{
+		const SplatMatrix s(mat);
+		const Float4 half = SIMD::Splat(0.5f);
+		const Float4 emptyMin = SIMD::Splat(FLT_MAX);
+		const Float4 emptyMax = SIMD::Splat(-FLT_MAX);
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			// (min0 max0 min1 max1)と(min2 max2 min3 max3)を読んで、minとmaxに分ける
+			const float* src = reinterpret_cast<const float*>(in + i);
+			const Float4x3 lo = LoadInterleaved(src);
+			const Float4x3 hi = LoadInterleaved(src + 12);
+			const Float4x3 boxMin = {
+				SIMD::Shuffle<0, 2, 0, 2>(lo.x, hi.x), SIMD::Shuffle<0, 2, 0, 2>(lo.y, hi.y), SIMD::Shuffle<0, 2, 0, 2>(lo.z, hi.z) };
+			const Float4x3 boxMax = {
+				SIMD::Shuffle<1, 3, 1, 3>(lo.x, hi.x), SIMD::Shuffle<1, 3, 1, 3>(lo.y, hi.y), SIMD::Shuffle<1, 3, 1, 3>(lo.z, hi.z) };
+
+			const Float4 empty = SIMD::Or(SIMD::Or(SIMD::CmpGT(boxMin.x, boxMax.x), SIMD::CmpGT(boxMin.y, boxMax.y)), SIMD::CmpGT(boxMin.z, boxMax.z));
+
+			const Float4x3 center = TransformPoint4(s, {
+				SIMD::Mul(SIMD::Add(boxMin.x, boxMax.x), half), SIMD::Mul(SIMD::Add(boxMin.y, boxMax.y), half), SIMD::Mul(SIMD::Add(boxMin.z, boxMax.z), half) });
+			const Float4x3 extent = TransformExtent4(s, {
+				SIMD::Mul(SIMD::Sub(boxMax.x, boxMin.x), half), SIMD::Mul(SIMD::Sub(boxMax.y, boxMin.y), half), SIMD::Mul(SIMD::Sub(boxMax.z, boxMin.z), half) });
+
+			const Float4x3 newMin = {
+				SIMD::Select(SIMD::Sub(center.x, extent.x), emptyMin, empty),
+				SIMD::Select(SIMD::Sub(center.y, extent.y), emptyMin, empty),
+				SIMD::Select(SIMD::Sub(center.z, extent.z), emptyMin, empty) };
+			const Float4x3 newMax = {
+				SIMD::Select(SIMD::Add(center.x, extent.x), emptyMax, empty),
+				SIMD::Select(SIMD::Add(center.y, extent.y), emptyMax, empty),
+				SIMD::Select(SIMD::Add(center.z, extent.z), emptyMax, empty) };
+
+			// min, maxを交互に並べ直して書き戻す
+			float* dst = reinterpret_cast<float*>(out + i);
+			StoreInterleaved(dst, {
+				SIMD::Swizzle<0, 2, 1, 3>(SIMD::Shuffle<0, 1, 0, 1>(newMin.x, newMax.x)),
+				SIMD::Swizzle<0, 2, 1, 3>(SIMD::Shuffle<0, 1, 0, 1>(newMin.y, newMax.y)),
+				SIMD::Swizzle<0, 2, 1, 3>(SIMD::Shuffle<0, 1, 0, 1>(newMin.z, newMax.z)) });
+			StoreInterleaved(dst + 12, {
+				SIMD::Swizzle<0, 2, 1, 3>(SIMD::Shuffle<2, 3, 2, 3>(newMin.x, newMax.x)),
+				SIMD::Swizzle<0, 2, 1, 3>(SIMD::Shuffle<2, 3, 2, 3>(newMin.y, newMax.y)),
+				SIMD::Swizzle<0, 2, 1, 3>(SIMD::Shuffle<2, 3, 2, 3>(newMin.z, newMax.z)) });
+		}
+		for (; i < count; ++i)
+		{
+			const Vector3 boxMin = in[i].GetMin();
+			const Vector3 boxMax = in[i].GetMax();
+			if (boxMin.x > boxMax.x || boxMin.y > boxMax.y || boxMin.z > boxMax.z)
+			{
+				out[i] = AxisAlignedBox();
+				continue;
+			}
+
+			const Vector3 center = TransformPoint(mat, Vector3(
+				(boxMin.x + boxMax.x) * 0.5f, (boxMin.y + boxMax.y) * 0.5f, (boxMin.z + boxMax.z) * 0.5f));
+			const Vector3 extent = TransformExtent(mat, Vector3(
+				(boxMax.x - boxMin.x) * 0.5f, (boxMax.y - boxMin.y) * 0.5f, (boxMax.z - boxMin.z) * 0.5f));
+			out[i] = AxisAlignedBox(center - extent, center + extent);
+		}
+	}
+
+	void BatchTransform::TransformAABBs(const Matrix4x4& mat, ConstVector3Arrays centers, ConstVector3Arrays extents,
+		Vector3Arrays outCenters, Vector3Arrays outExtents, size_t count)
+	{
+		const SplatMatrix s(mat);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const Float4x3 center = TransformPoint4(s, LoadArrays(centers, i));
+			const Float4x3 extent = TransformExtent4(s, LoadArrays(extents, i));
+			StoreArrays(outCenters, i, center);
+			StoreArrays(outExtents, i, extent);
+		}
+		for (; i < count; ++i)
+		{
+			const Vector3 center = TransformPoint(mat, Vector3(centers.x[i], centers.y[i], centers.z[i]));
+			const Vector3 extent = TransformExtent(mat, Vector3(extents.x[i], extents.y[i], extents.z[i]));
+			outCenters.x[i] = center.x;
+			outCenters.y[i] = center.y;
+			outCenters.z[i] = center.z;
+			outExtents.x[i] = extent.x;
+			outExtents.y[i] = extent.y;
+			outExtents.z[i] = extent.z;
+		}
+	}
+
+	void BatchTransform::TransformAABBs(const Matrix4x4* matrices, const uint32_t* matrixIndices, const AxisAlignedBox* in,
+		Vector3Arrays outCenters, Vector3Arrays outExtents, size_t count)
+	{
+		// 行列が要素ごとに違うので、1要素をFloat4の1行で計算し、4要素分を転置してSoAにする
+		const Float4 half = SIMD::Splat(0.5f);
+		const Float4 one = SIMD::Splat(1.0f);
+		const Float4 xyzMask = SIMD::CmpLT(SIMD::Set(0.0f, 0.0f, 0.0f, 1.0f), half);
+
+		for (size_t base = 0; base < count; base += 4)
+		{
+			const size_t groupCount = std::min<size_t>(4, count - base);
+			Float4 center[4];
+			Float4 extent[4];
+			for (size_t k = 0; k < 4; ++k)
+			{
+				// 端数は最後の要素を繰り返して埋める
+				const size_t i = base + std::min(k, groupCount - 1);
+				const float* m = &matrices[matrixIndices[i]].mat[0][0];
+				const float* box = reinterpret_cast<const float*>(in + i);
+				const Float4 boxMin = SIMD::Load3(box);
+				const Float4 boxMax = SIMD::Load3(box + 3);
+
+				// (cx, cy, cz, 1)として行列を掛ける
+				const Float4 c = SIMD::Select(one, SIMD::Mul(SIMD::Add(boxMin, boxMax), half), xyzMask);
+				const Float4 e = SIMD::Mul(SIMD::Sub(boxMax, boxMin), half);
+				center[k] = SIMD::TransformRow(c, m);
+				extent[k] = SIMD::Add(SIMD::Add(
+					SIMD::Mul(SIMD::SplatLane<0>(e), SIMD::Abs(SIMD::Load(m + 0))),
+					SIMD::Mul(SIMD::SplatLane<1>(e), SIMD::Abs(SIMD::Load(m + 4)))),
+					SIMD::Mul(SIMD::SplatLane<2>(e), SIMD::Abs(SIMD::Load(m + 8))));
+			}
+
+			SIMD::Transpose(center[0], center[1], center[2], center[3]);
+			SIMD::Transpose(extent[0], extent[1], extent[2], extent[3]);
+
+			if (groupCount == 4)
+			{
+				StoreArrays(outCenters, base, { center[0], center[1], center[2] });
+				StoreArrays(outExtents, base, { extent[0], extent[1], extent[2] });
+				continue;
+			}
+
+			alignas(16) float temp[6][4];
+			for (int c = 0; c < 3; ++c)
+			{
+				SIMD::Store(temp[c], center[c]);
+				SIMD::Store(temp[c + 3], extent[c]);
+			}
+			for (size_t k = 0; k < groupCount; ++k)
+			{
+				outCenters.x[base + k] = temp[0][k];
+				outCenters.y[base + k] = temp[1][k];
+				outCenters.z[base + k] = temp[2][k];
+				outExtents.x[base + k] = temp[3][k];
+				outExtents.y[base + k] = temp[4][k];
+				outExtents.z[base + k] = temp[5][k];
+			}
+		}
+	}
+
+	void BatchTransform::TransformSpheres(const Matrix4x4& mat, const BoundingSphere* in, BoundingSphere* out, size_t count)
+	{
+		const SplatMatrix s(mat);
+		const float scale = GetMaxAxisScale(mat);
+		const Float4 scale4 = SIMD::Splat(scale);
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			// (x, y, z, r)の4つを転置して成分ごとに処理する
+			const float* src = reinterpret_cast<const float*>(in + i);
+			Float4 r0 = SIMD::Load(src + 0), r1 = SIMD::Load(src + 4), r2 = SIMD::Load(src + 8), r3 = SIMD::Load(src + 12);
+			SIMD::Transpose(r0, r1, r2, r3);
+
+			const Float4x3 center = TransformPoint4(s, { r0, r1, r2 });
+			r0 = center.x;
+			r1 = center.y;
+			r2 = center.z;
+			r3 = SIMD::Mul(r3, scale4);
+			SIMD::Transpose(r0, r1, r2, r3);
+
+			float* dst = reinterpret_cast<float*>(out + i);
+			SIMD::Store(dst + 0, r0);
+			SIMD::Store(dst + 4, r1);
+			SIMD::Store(dst + 8, r2);
+			SIMD::Store(dst + 12, r3);
+		}
+		for (; i < count; ++i)
+			out[i] = BoundingSphere(TransformPoint(mat, in[i].GetCenter()), in[i].GetRadius() * scale);
+	}
+
+	void BatchTransform::TransformSpheres(const Matrix4x4& mat, ConstVector3Arrays centers, const float* radii,
+		Vector3Arrays outCenters, float* outRadii, size_t count)
+	{
+		const SplatMatrix s(mat);
+		const float scale = GetMaxAxisScale(mat);
+		const Float4 scale4 = SIMD::Splat(scale);
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			StoreArrays(outCenters, i, TransformPoint4(s, LoadArrays(centers, i)));
+			SIMD::Store(outRadii + i, SIMD::Mul(SIMD::Load(radii + i), scale4));
+		}
+		for (; i < count; ++i)
+		{
+			const Vector3 center = TransformPoint(mat, Vector3(centers.x[i], centers.y[i], centers.z[i]));
+			outCenters.x[i] = center.x;
+			outCenters.y[i] = center.y;
+			outCenters.z[i] = center.z;
+			outRadii[i] = radii[i] * scale;
+		}
+	}
+}
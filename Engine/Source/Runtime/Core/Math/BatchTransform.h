@@ -0,0 +1,130 @@
+/**
+ * @file BatchTransform.h
+ * @brief 点・方向・AABB・球をまとめて行列変換するカーネル
+ *
+ * AoS（Vector3、AxisAlignedBox、BoundingSphereの配列）とSoA（成分ごとの配列）の両方を受け付け、
+ * 4個ずつSIMDで処理して端数はスカラーで処理する。入力と出力に同じ配列を渡してもよい。
+ * 行列は行ベクトル規約（v * M）で、点と境界ボリュームの変換はアフィン行列を前提とする。
+ */
+
+#pragma once
+#include "Vector3.h"
+#include "Matrix4x4.h"
+#include "BoundingBox.h"
+#include "BoundingSphere.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace AtomEngine
+{
+	/**
+	 * @struct Vector3Arrays
+	 * @brief Vector3のSoA配列（書き込み用）
+	 */
+	struct Vector3Arrays
+	{
+		float* x = nullptr;
+		float* y = nullptr;
+		float* z = nullptr;
+	};
+
+	/**
+	 * @struct ConstVector3Arrays
+	 * @brief Vector3のSoA配列（読み込み用）
+	 */
+	struct ConstVector3Arrays
+	{
+		const float* x = nullptr;
+		const float* y = nullptr;
+		const float* z = nullptr;
+
+		ConstVector3Arrays() = default;
+		ConstVector3Arrays(const float* x_, const float* y_, const float* z_) : x(x_), y(y_), z(z_) {}
+		ConstVector3Arrays(const Vector3Arrays& arrays) : x(arrays.x), y(arrays.y), z(arrays.z) {}
+	};
+
+	/**
+	 * @class BatchTransform
+	 * @brief 配列単位の変換処理
+	 *
+	 * 使用例:
+	 * @code
+	 * BatchTransform::TransformPoints(world, positions.data(), positions.data(), positions.size());
+	 * @endcode
+	 */
+	class BatchTransform
+	{
+	public:
+		/**
+		 * @brief 点を変換する（平行移動を含む）
+		 * @param mat アフィン行列
+		 * @param in 入力
+		 * @param out 出力（inと同じでもよい）
+		 * @param count 要素数
+		 */
+		static void TransformPoints(const Matrix4x4& mat, const Vector3* in, Vector3* out, size_t count);
+		static void TransformPoints(const Matrix4x4& mat, ConstVector3Arrays in, Vector3Arrays out, size_t count);
+
+		/**
+		 * @brief 方向を変換する（平行移動を含まない、正規化はしない）
+		 * @param mat 変換行列（上3x3のみ使用）
+		 * @param in 入力
+		 * @param out 出力（inと同じでもよい）
+		 * @param count 要素数
+		 */
+		static void TransformDirections(const Matrix4x4& mat, const Vector3* in, Vector3* out, size_t count);
+		static void TransformDirections(const Matrix4x4& mat, ConstVector3Arrays in, Vector3Arrays out, size_t count);
+
+		/**
+		 * @brief AABBを変換して、変換後の箱を囲むAABBを求める（Arvoの方法）
+		 *
+		 * 中心をアフィン変換し、半分の大きさを行列の各要素の絶対値で変換する。
+		 * 8頂点を変換して囲む場合と同じ結果になる。空の箱は空のまま出力する。
+		 * @param mat アフィン行列
+		 * @param in 入力
+		 * @param out 出力（inと同じでもよい）
+		 * @param count 要素数
+		 */
+		static void TransformAABBs(const Matrix4x4& mat, const AxisAlignedBox* in, AxisAlignedBox* out, size_t count);
+
+		/**
+		 * @brief 中心と半分の大きさで表したAABBを変換する（Arvoの方法）
+		 * @param mat アフィン行列
+		 * @param centers 中心
+		 * @param extents 半分の大きさ（0以上）
+		 * @param outCenters 変換後の中心（centersと同じでもよい）
+		 * @param outExtents 変換後の半分の大きさ（extentsと同じでもよい）
+		 * @param count 要素数
+		 */
+		static void TransformAABBs(const Matrix4x4& mat, ConstVector3Arrays centers, ConstVector3Arrays extents,
+			Vector3Arrays outCenters, Vector3Arrays outExtents, size_t count);
+
+		/**
+		 * @brief AABBをそれぞれ別の行列で変換し、中心と半分の大きさのSoAで出力する
+		 *
+		 * インスタンスごとのワールド行列でローカル境界を変換し、そのままカリングに渡す用途向け。
+		 * 空の箱の結果は不定なので、呼び出し側で判定から外すこと。
+		 * @param matrices 行列の配列
+		 * @param matrixIndices 要素ごとに使う行列の番号
+		 * @param in ローカル空間のAABB
+		 * @param outCenters 変換後の中心
+		 * @param outExtents 変換後の半分の大きさ
+		 * @param count 要素数
+		 */
+		static void TransformAABBs(const Matrix4x4* matrices, const uint32_t* matrixIndices, const AxisAlignedBox* in,
+			Vector3Arrays outCenters, Vector3Arrays outExtents, size_t count);
+
+		/**
+		 * @brief 球を変換する
+		 *
+		 * 半径は行列が最も引き伸ばす方向の倍率で拡大するので、非一様スケールやせん断があっても元の球を覆う。
+		 * @param mat アフィン行列
+		 * @param in 入力
+		 * @param out 出力（inと同じでもよい）
+		 * @param count 要素数
+		 */
+		static void TransformSpheres(const Matrix4x4& mat, const BoundingSphere* in, BoundingSphere* out, size_t count);
+		static void TransformSpheres(const Matrix4x4& mat, ConstVector3Arrays centers, const float* radii,
+			Vector3Arrays outCenters, float* outRadii, size_t count);
+	};
+}
@@ -34,6 +34,25 @@ namespace AtomEngine
 		}
 		void Transform(const Matrix4x4& mat)
 		{
+			if (mMin.x > mMax.x || mMin.y > mMax.y || mMin.z > mMax.z)
+				return;
+
+			// アフィン変換なら中心と半分の大きさを変換すれば8頂点を囲む箱と一致する（Arvoの方法）
+			if (mat.IsAffine())
+			{
+				const Vector3 c = GetCenter();
+				const Vector3 e = (mMax - mMin) * 0.5f;
+				Vector3 center, extent;
+				for (int j = 0; j < 3; ++j)
+				{
+					center[j] = c.x * mat.mat[0][j] + c.y * mat.mat[1][j] + c.z * mat.mat[2][j] + mat.mat[3][j];
+					extent[j] = e.x * std::fabs(mat.mat[0][j]) + e.y * std::fabs(mat.mat[1][j]) + e.z * std::fabs(mat.mat[2][j]);
+				}
+				mMin = center - extent;
+				mMax = center + extent;
+				return;
+			}
+
 			Vector3 corners[8] = {
 				{mMin.x, mMin.y, mMin.z},
 				{mMax.x, mMin.y, mMin.z},
@@ -85,6 +104,10 @@ namespace AtomEngine
 
 		Vector3 GetDimensions() const { return mBasis.GetX() + mBasis.GetY() + mBasis.GetZ(); }
 		Vector3 GetCenter() const { return mTranslation + GetDimensions() * 0.5f; }
+		/// 各行が箱の辺（向きと長さ）
+		const Matrix3x3& GetBasis() const { return mBasis; }
+		/// 辺の始まる角
+		const Vector3& GetTranslation() const { return mTranslation; }
 
 	private:
 		Matrix3x3 mBasis;
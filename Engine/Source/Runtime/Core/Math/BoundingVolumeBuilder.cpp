@@ -0,0 +1,532 @@
+#include "BoundingVolumeBuilder.h"
+#include "Runtime/Core/Job/JobSystem.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		/// EPOSで両端の点を探す方向の数（3軸・6つの面の対角線・4つの立体の対角線）
+		constexpr uint32_t kExtremalDirectionCount = 13;
+		constexpr float kExtremalDirections[kExtremalDirectionCount][3] =
+		{
+			{ 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 },
+			{ 1, 1, 0 }, { 1, -1, 0 }, { 1, 0, 1 }, { 1, 0, -1 }, { 0, 1, 1 }, { 0, 1, -1 },
+			{ 1, 1, 1 }, { 1, 1, -1 }, { 1, -1, 1 }, { 1, -1, -1 },
+		};
+
+		/// 球を広げる回数の上限（超えたら最も遠い点までの距離を半径にする）
+		constexpr uint32_t kMaxGrowPasses = 8;
+
+		/// 点が球の外にあるとみなす距離の2乗の比（丸め誤差で広げ続けないように）
+		constexpr float kGrowTolerance = 1e-6f;
+
+		/// 点の配列を区切った範囲
+		struct Batch
+		{
+			const PointArray* points;
+			size_t begin;
+			size_t end;
+		};
+
+		/**
+		 * @brief 全ての点をkBatchSizeずつに区切り、区切りごとにprocessを呼ぶ
+		 * @param results 区切りごとの結果（区切りの数に広げ、初期値で埋める）
+		 * @param process (const Batch&, T&)
+		 */
+		template<typename T, typename Process>
+		void ForEachBatch(const PointArray* arrays, size_t arrayCount, const T& initial, std::vector<T>& results, const Process& process)
+		{
+			std::vector<Batch> batches;
+			size_t total = 0;
+			for (size_t a = 0; a < arrayCount; ++a)
+			{
+				const PointArray& points = arrays[a];
+				for (size_t begin = 0; begin < points.count; begin += BoundingVolumeBuilder::kBatchSize)
+					batches.push_back({ &points, begin, std::min(begin + BoundingVolumeBuilder::kBatchSize, points.count) });
+				total += points.count;
+			}
+			results.assign(batches.size(), initial);
+
+			auto run = [&](uint32_t first, uint32_t last)
+				{
+					for (uint32_t b = first; b < last; ++b)
+						process(batches[b], results[b]);
+				};
+			const uint32_t batchCount = static_cast<uint32_t>(batches.size());
+			if (total >= BoundingVolumeBuilder::kParallelThreshold && batchCount > 1 && JobSystem::GetWorkerCount() > 1)
+				JobSystem::ParallelFor(batchCount, run);
+			else
+				run(0, batchCount);
+		}
+
+		/// 各方向で射影が最小・最大になる点
+		struct Extremes
+		{
+			float minProjection[kExtremalDirectionCount];
+			float maxProjection[kExtremalDirectionCount];
+			Vector3 minPoint[kExtremalDirectionCount];
+			Vector3 maxPoint[kExtremalDirectionCount];
+
+			Extremes()
+			{
+				std::fill(std::begin(minProjection), std::end(minProjection), FLT_MAX);
+				std::fill(std::begin(maxProjection), std::end(maxProjection), -FLT_MAX);
+			}
+
+			void Add(const Vector3& p)
+			{
+				for (uint32_t d = 0; d < kExtremalDirectionCount; ++d)
+				{
+					const float projection = p.x * kExtremalDirections[d][0] + p.y * kExtremalDirections[d][1] + p.z * kExtremalDirections[d][2];
+					if (projection < minProjection[d])
+					{
+						minProjection[d] = projection;
+						minPoint[d] = p;
+					}
+					if (projection > maxProjection[d])
+					{
+						maxProjection[d] = projection;
+						maxPoint[d] = p;
+					}
+				}
+			}
+
+			/// 先の区切りの結果を優先してまとめる
+			void Merge(const Extremes& other)
+			{
+				for (uint32_t d = 0; d < kExtremalDirectionCount; ++d)
+				{
+					if (other.minProjection[d] < minProjection[d])
+					{
+						minProjection[d] = other.minProjection[d];
+						minPoint[d] = other.minPoint[d];
+					}
+					if (other.maxProjection[d] > maxProjection[d])
+					{
+						maxProjection[d] = other.maxProjection[d];
+						maxPoint[d] = other.maxPoint[d];
+					}
+				}
+			}
+		};
+
+		/// 中心から最も遠い点
+		struct Farthest
+		{
+			float distanceSqr = -1.0f;
+			Vector3 point;
+		};
+
+		//------------------------------------------------------------------
+		// 少ない点の最小包含球（倍精度）
+		//------------------------------------------------------------------
+
+		struct Double3
+		{
+			double x, y, z;
+		};
+
+		inline Double3 operator+(const Double3& a, const Double3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+		inline Double3 operator-(const Double3& a, const Double3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+		inline Double3 operator*(const Double3& a, double s) { return { a.x * s, a.y * s, a.z * s }; }
+		inline double Dot(const Double3& a, const Double3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+		inline Double3 Cross(const Double3& a, const Double3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+
+		struct DoubleSphere
+		{
+			Double3 center{ 0.0, 0.0, 0.0 };
+			double radiusSqr = -1.0;    ///< 負なら空
+
+			bool Contains(const Double3& p) const
+			{
+				const Double3 d = p - center;
+				return Dot(d, d) <= radiusSqr * (1.0 + 1e-10) + 1e-20;
+			}
+		};
+
+		DoubleSphere SphereFromTwo(const Double3& a, const Double3& b)
+		{
+			const Double3 d = b - a;
+			return { (a + b) * 0.5, Dot(d, d) * 0.25 };
+		}
+
+		/// 2点ずつの球のうち、残りの点も含む最も小さいもの（縮退した3点・4点用）
+		DoubleSphere SphereFromPairs(const Double3* points, uint32_t count)
+		{
+			DoubleSphere best;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				for (uint32_t j = i + 1; j < count; ++j)
+				{
+					const DoubleSphere sphere = SphereFromTwo(points[i], points[j]);
+					if (best.radiusSqr >= 0.0 && sphere.radiusSqr >= best.radiusSqr)
+						continue;
+					bool containsAll = true;
+					for (uint32_t k = 0; k < count && containsAll; ++k)
+						containsAll = sphere.Contains(points[k]);
+					if (containsAll)
+						best = sphere;
+				}
+			}
+			return best;
+		}
+
+		DoubleSphere SphereFromThree(const Double3& a, const Double3& b, const Double3& c)
+		{
+			const Double3 ab = b - a;
+			const Double3 ac = c - a;
+			const Double3 normal = Cross(ab, ac);
+			const double denominator = 2.0 * Dot(normal, normal);
+			if (denominator <= 1e-12 * Dot(ab, ab) * Dot(ac, ac) || denominator == 0.0)
+			{
+				const Double3 points[3] = { a, b, c };
+				return SphereFromPairs(points, 3);
+			}
+			const Double3 offset = (Cross(normal, ab) * Dot(ac, ac) + Cross(ac, normal) * Dot(ab, ab)) * (1.0 / denominator);
+			return { a + offset, Dot(offset, offset) };
+		}
+
+		DoubleSphere SphereFromFour(const Double3& a, const Double3& b, const Double3& c, const Double3& d)
+		{
+			const Double3 ab = b - a;
+			const Double3 ac = c - a;
+			const Double3 ad = d - a;
+			const double determinant = Dot(ab, Cross(ac, ad));
+			const double scale = std::sqrt(Dot(ab, ab) * Dot(ac, ac) * Dot(ad, ad));
+			if (std::fabs(determinant) <= 1e-12 * scale)
+			{
+				// 同一平面上。3点ずつの球のうち、4点とも含む最も小さいもの
+				const Double3 points[4] = { a, b, c, d };
+				DoubleSphere best;
+				for (uint32_t skip = 0; skip < 4; ++skip)
+				{
+					Double3 three[3];
+					for (uint32_t i = 0, n = 0; i < 4; ++i)
+					{
+						if (i != skip)
+							three[n++] = points[i];
+					}
+					const DoubleSphere sphere = SphereFromThree(three[0], three[1], three[2]);
+					if (sphere.radiusSqr >= 0.0 && sphere.Contains(points[skip]) &&
+						(best.radiusSqr < 0.0 || sphere.radiusSqr < best.radiusSqr))
+						best = sphere;
+				}
+				return best.radiusSqr >= 0.0 ? best : SphereFromPairs(points, 4);
+			}
+			const Double3 offset = (Cross(ac, ad) * Dot(ab, ab) + Cross(ad, ab) * Dot(ac, ac) + Cross(ab, ac) * Dot(ad, ad)) * (0.5 / determinant);
+			return { a + offset, Dot(offset, offset) };
+		}
+
+		DoubleSphere SphereFromSupport(const Double3* support, uint32_t count)
+		{
+			switch (count)
+			{
+			case 0: return {};
+			case 1: return { support[0], 0.0 };
+			case 2: return SphereFromTwo(support[0], support[1]);
+			case 3: return SphereFromThree(support[0], support[1], support[2]);
+			default: return SphereFromFour(support[0], support[1], support[2], support[3]);
+			}
+		}
+
+		/// Welzlの方法。points[0, count)とsupportの点を囲む最小の球
+		DoubleSphere Welzl(const Double3* points, size_t count, Double3* support, uint32_t supportCount)
+		{
+			if (count == 0 || supportCount == 4)
+				return SphereFromSupport(support, supportCount);
+
+			const Double3& p = points[count - 1];
+			const DoubleSphere sphere = Welzl(points, count - 1, support, supportCount);
+			if (sphere.radiusSqr >= 0.0 && sphere.Contains(p))
+				return sphere;
+
+			support[supportCount] = p;
+			return Welzl(points, count - 1, support, supportCount + 1);
+		}
+
+		//------------------------------------------------------------------
+		// 主成分
+		//------------------------------------------------------------------
+
+		/// 共分散の計算用の和（中心をずらして桁落ちを防ぐ）
+		struct Moments
+		{
+			double count = 0.0;
+			double sum[3] = {};
+			double products[6] = {};    ///< xx, xy, xz, yy, yz, zz
+
+			void Add(const Vector3& p, const Vector3& origin)
+			{
+				const double x = p.x - origin.x, y = p.y - origin.y, z = p.z - origin.z;
+				count += 1.0;
+				sum[0] += x; sum[1] += y; sum[2] += z;
+				products[0] += x * x; products[1] += x * y; products[2] += x * z;
+				products[3] += y * y; products[4] += y * z; products[5] += z * z;
+			}
+
+			void Merge(const Moments& other)
+			{
+				count += other.count;
+				for (int i = 0; i < 3; ++i)
+					sum[i] += other.sum[i];
+				for (int i = 0; i < 6; ++i)
+					products[i] += other.products[i];
+			}
+		};
+
+		/// 対称行列の固有ベクトル（ヤコビ法）。vectors[i]がi番目の固有ベクトル
+		void SymmetricEigenvectors(double a[3][3], double vectors[3][3])
+		{
+			for (int i = 0; i < 3; ++i)
+				for (int j = 0; j < 3; ++j)
+					vectors[i][j] = i == j ? 1.0 : 0.0;
+
+			for (int sweep = 0; sweep < 32; ++sweep)
+			{
+				const double offDiagonal = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+				const double diagonal = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+				if (offDiagonal <= 1e-24 * diagonal || offDiagonal == 0.0)
+					break;
+
+				for (int p = 0; p < 2; ++p)
+				{
+					for (int q = p + 1; q < 3; ++q)
+					{
+						if (a[p][q] == 0.0)
+							continue;
+						const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+						const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+						const double c = 1.0 / std::sqrt(t * t + 1.0);
+						const double s = t * c;
+
+						// a = J^T a J
+						for (int k = 0; k < 3; ++k)
+						{
+							const double akp = a[k][p], akq = a[k][q];
+							a[k][p] = c * akp - s * akq;
+							a[k][q] = s * akp + c * akq;
+						}
+						for (int k = 0; k < 3; ++k)
+						{
+							const double apk = a[p][k], aqk = a[q][k];
+							a[p][k] = c * apk - s * aqk;
+							a[q][k] = s * apk + c * aqk;
+						}
+						for (int k = 0; k < 3; ++k)
+						{
+							const double vpk = vectors[p][k], vqk = vectors[q][k];
+							vectors[p][k] = c * vpk - s * vqk;
+							vectors[q][k] = s * vpk + c * vqk;
+						}
+					}
+				}
+			}
+		}
+
+		/// 3軸への射影の範囲
+		struct Projections
+		{
+			float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+			float maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		};
+	}
+
+	AxisAlignedBox BoundingVolumeBuilder::ComputeBox(const PointArray* arrays, size_t arrayCount)
+	{
+		std::vector<AxisAlignedBox> results;
+		ForEachBatch(arrays, arrayCount, AxisAlignedBox(), results, [](const Batch& batch, AxisAlignedBox& box)
+			{
+				for (size_t i = batch.begin; i < batch.end; ++i)
+					box.AddPoint(batch.points->Get(i));
+			});
+
+		AxisAlignedBox box;
+		for (const AxisAlignedBox& result : results)
+			box = box.Union(result);
+		return box;
+	}
+
+	BoundingSphere BoundingVolumeBuilder::ComputeSphere(const PointArray* arrays, size_t arrayCount)
+	{
+		std::vector<Extremes> extremes;
+		ForEachBatch(arrays, arrayCount, Extremes(), extremes, [](const Batch& batch, Extremes& result)
+			{
+				for (size_t i = batch.begin; i < batch.end; ++i)
+					result.Add(batch.points->Get(i));
+			});
+		if (extremes.empty())
+			return BoundingSphere(Vector3::ZERO, 0.0f);
+
+		// 両端の点を囲む最小の球から始める。点が両端の点の数より少なければ、全ての点で求める
+		Vector3 initialPoints[kExtremalDirectionCount * 2];
+		size_t initialCount = 0;
+		size_t total = 0;
+		for (size_t a = 0; a < arrayCount; ++a)
+			total += arrays[a].count;
+		if (total <= kExtremalDirectionCount * 2)
+		{
+			for (size_t a = 0; a < arrayCount; ++a)
+			{
+				for (size_t i = 0; i < arrays[a].count; ++i)
+					initialPoints[initialCount++] = arrays[a].Get(i);
+			}
+		}
+		else
+		{
+			Extremes merged;
+			for (const Extremes& result : extremes)
+				merged.Merge(result);
+			for (uint32_t d = 0; d < kExtremalDirectionCount; ++d)
+			{
+				initialPoints[initialCount++] = merged.minPoint[d];
+				initialPoints[initialCount++] = merged.maxPoint[d];
+			}
+		}
+		const BoundingSphere initial = ComputeMinimumSphere(initialPoints, initialCount);
+		Vector3 center = initial.GetCenter();
+		float radius = initial.GetRadius();
+
+		// 外に出ている最も遠い点を含むように広げる（Ritter）
+		std::vector<Farthest> farthest;
+		for (uint32_t pass = 0; pass < kMaxGrowPasses; ++pass)
+		{
+			ForEachBatch(arrays, arrayCount, Farthest(), farthest, [&center](const Batch& batch, Farthest& result)
+				{
+					for (size_t i = batch.begin; i < batch.end; ++i)
+					{
+						const Vector3 p = batch.points->Get(i);
+						const float distanceSqr = (p - center).LengthSqr();
+						if (distanceSqr > result.distanceSqr)
+						{
+							result.distanceSqr = distanceSqr;
+							result.point = p;
+						}
+					}
+				});
+
+			Farthest outermost;
+			for (const Farthest& result : farthest)
+			{
+				if (result.distanceSqr > outermost.distanceSqr)
+					outermost = result;
+			}
+
+			const float distance = std::sqrt(std::max(outermost.distanceSqr, 0.0f));
+			if (outermost.distanceSqr <= radius * radius * (1.0f + kGrowTolerance) || pass + 1 == kMaxGrowPasses)
+			{
+				radius = std::max(radius, distance);
+				break;
+			}
+
+			const float newRadius = (radius + distance) * 0.5f;
+			center = center + (outermost.point - center) * ((newRadius - radius) / distance);
+			radius = newRadius;
+		}
+		return BoundingSphere(center, radius);
+	}
+
+	OrientedBox BoundingVolumeBuilder::ComputeOrientedBox(const PointArray* arrays, size_t arrayCount)
+	{
+		const AxisAlignedBox box = ComputeBox(arrays, arrayCount);
+		const Vector3 boxMin = box.GetMin();
+		const Vector3 boxMax = box.GetMax();
+		if (boxMin.x > boxMax.x)
+			return OrientedBox(AxisAlignedBox(Vector3::ZERO, Vector3::ZERO));
+
+		const Vector3 origin = box.GetCenter();
+		std::vector<Moments> moments;
+		ForEachBatch(arrays, arrayCount, Moments(), moments, [&origin](const Batch& batch, Moments& result)
+			{
+				for (size_t i = batch.begin; i < batch.end; ++i)
+					result.Add(batch.points->Get(i), origin);
+			});
+
+		Moments total;
+		for (const Moments& result : moments)
+			total.Merge(result);
+
+		const double inverseCount = 1.0 / total.count;
+		const double mean[3] = { total.sum[0] * inverseCount, total.sum[1] * inverseCount, total.sum[2] * inverseCount };
+		double covariance[3][3];
+		covariance[0][0] = total.products[0] * inverseCount - mean[0] * mean[0];
+		covariance[0][1] = covariance[1][0] = total.products[1] * inverseCount - mean[0] * mean[1];
+		covariance[0][2] = covariance[2][0] = total.products[2] * inverseCount - mean[0] * mean[2];
+		covariance[1][1] = total.products[3] * inverseCount - mean[1] * mean[1];
+		covariance[1][2] = covariance[2][1] = total.products[4] * inverseCount - mean[1] * mean[2];
+		covariance[2][2] = total.products[5] * inverseCount - mean[2] * mean[2];
+
+		double eigenvectors[3][3];
+		SymmetricEigenvectors(covariance, eigenvectors);
+
+		Vector3 axes[3];
+		for (int i = 0; i < 2; ++i)
+		{
+			axes[i] = Vector3(static_cast<float>(eigenvectors[i][0]), static_cast<float>(eigenvectors[i][1]), static_cast<float>(eigenvectors[i][2]));
+			axes[i].Normalize();
+		}
+		axes[2] = axes[0].Cross(axes[1]);
+		axes[2].Normalize();
+
+		std::vector<Projections> projections;
+		ForEachBatch(arrays, arrayCount, Projections(), projections, [&axes](const Batch& batch, Projections& result)
+			{
+				for (size_t i = batch.begin; i < batch.end; ++i)
+				{
+					const Vector3 p = batch.points->Get(i);
+					for (int a = 0; a < 3; ++a)
+					{
+						const float projection = p.Dot(axes[a]);
+						result.minimum[a] = std::min(result.minimum[a], projection);
+						result.maximum[a] = std::max(result.maximum[a], projection);
+					}
+				}
+			});
+
+		Projections range;
+		for (const Projections& result : projections)
+		{
+			for (int a = 0; a < 3; ++a)
+			{
+				range.minimum[a] = std::min(range.minimum[a], result.minimum[a]);
+				range.maximum[a] = std::max(range.maximum[a], result.maximum[a]);
+			}
+		}
+
+		// 主成分の軸がAABBより大きくなる形（AABBに沿った箱など）はAABBを返す
+		const Vector3 boxSize = box.GetDimensions();
+		const float boxVolume = boxSize.x * boxSize.y * boxSize.z;
+		float volume = 1.0f;
+		for (int a = 0; a < 3; ++a)
+			volume *= range.maximum[a] - range.minimum[a];
+		if (volume >= boxVolume)
+			return OrientedBox(box);
+
+		const Matrix3x3 basis(
+			axes[0] * (range.maximum[0] - range.minimum[0]),
+			axes[1] * (range.maximum[1] - range.minimum[1]),
+			axes[2] * (range.maximum[2] - range.minimum[2]));
+		const Vector3 corner = axes[0] * range.minimum[0] + axes[1] * range.minimum[1] + axes[2] * range.minimum[2];
+		return OrientedBox(basis, corner);
+	}
+
+	BoundingSphere BoundingVolumeBuilder::ComputeMinimumSphere(const Vector3* points, size_t count)
+	{
+		if (count == 0)
+			return BoundingSphere(Vector3::ZERO, 0.0f);
+
+		std::vector<Double3> converted(count);
+		for (size_t i = 0; i < count; ++i)
+			converted[i] = { points[i].x, points[i].y, points[i].z };
+
+		Double3 support[4];
+		const DoubleSphere sphere = Welzl(converted.data(), count, support, 0);
+		return BoundingSphere(
+			Vector3(static_cast<float>(sphere.center.x), static_cast<float>(sphere.center.y), static_cast<float>(sphere.center.z)),
+			static_cast<float>(std::sqrt(std::max(sphere.radiusSqr, 0.0))));
+	}
+}
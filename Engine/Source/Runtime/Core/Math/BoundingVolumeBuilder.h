@@ -0,0 +1,95 @@
+/**
+ * @file BoundingVolumeBuilder.h
+ * @brief 点の集まりから境界ボリューム（AABB・球・OBB）を求める
+ *
+ * 点は頂点配列などをストライド付きでそのまま読み、必要なら行列で変換しながら使う（コピーしない）。
+ * - AABB: 全ての点の最小・最大（厳密）
+ * - 球: EPOS法。13方向の両端の点（最大26個）を厳密に囲む最小の球から始め、
+ *   外に出ている最も遠い点を含むようにRitterの方法で広げる
+ * - OBB: 点の共分散行列の固有ベクトル（主成分）を軸にする。AABBより大きくなる場合はAABBを返す
+ * 点が多い場合は区切ってJobSystemで並列に処理する。区切りごとの結果は常に同じ順にまとめるので、
+ * 並列に処理してもしなくても同じ結果になる。
+ */
+
+#pragma once
+#include "Vector3.h"
+#include "Matrix4x4.h"
+#include "BoundingBox.h"
+#include "BoundingSphere.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace AtomEngine
+{
+	/**
+	 * @struct PointArray
+	 * @brief ストライド付きの点の配列（読み込み用）
+	 */
+	struct PointArray
+	{
+		const uint8_t* data = nullptr;      ///< 最初の点
+		size_t stride = sizeof(Vector3);    ///< 点の間隔（バイト）
+		size_t count = 0;
+		const Matrix4x4* transform = nullptr;   ///< 読んだ点に掛けるアフィン行列（nullptrならそのまま）
+
+		PointArray() = default;
+		PointArray(const Vector3* points, size_t count_, const Matrix4x4* transform_ = nullptr)
+			: data(reinterpret_cast<const uint8_t*>(points)), count(count_), transform(transform_) {}
+		/// 構造体の配列のメンバーを読む（例: PointArray(&vertices[0].position, sizeof(Vertex), vertices.size())）
+		PointArray(const Vector3* first, size_t stride_, size_t count_, const Matrix4x4* transform_ = nullptr)
+			: data(reinterpret_cast<const uint8_t*>(first)), stride(stride_), count(count_), transform(transform_) {}
+
+		Vector3 Get(size_t i) const
+		{
+			const Vector3 p = *reinterpret_cast<const Vector3*>(data + i * stride);
+			if (!transform)
+				return p;
+			const Matrix4x4& m = *transform;
+			return Vector3(
+				p.x * m.mat[0][0] + p.y * m.mat[1][0] + p.z * m.mat[2][0] + m.mat[3][0],
+				p.x * m.mat[0][1] + p.y * m.mat[1][1] + p.z * m.mat[2][1] + m.mat[3][1],
+				p.x * m.mat[0][2] + p.y * m.mat[1][2] + p.z * m.mat[2][2] + m.mat[3][2]);
+		}
+	};
+
+	/**
+	 * @class BoundingVolumeBuilder
+	 * @brief 境界ボリュームの計算
+	 *
+	 * 複数の配列を渡すと、全ての点をまとめて囲む（ノードごとに行列の違うメッシュをまとめる場合など）。
+	 * 点がなければ空のAABB、中心が原点で半径0の球を返す。
+	 *
+	 * 使用例:
+	 * @code
+	 * const PointArray points(&vertices[0].position, sizeof(Vertex), vertices.size());
+	 * AxisAlignedBox box = BoundingVolumeBuilder::ComputeBox(points);
+	 * BoundingSphere sphere = BoundingVolumeBuilder::ComputeSphere(points);
+	 * @endcode
+	 */
+	class BoundingVolumeBuilder
+	{
+	public:
+		/// 1回の範囲関数で処理する点の数
+		static constexpr uint32_t kBatchSize = 1 << 14;
+		/// 点の数がこれ以上なら並列に処理する
+		static constexpr size_t kParallelThreshold = 1 << 16;
+
+		static AxisAlignedBox ComputeBox(const PointArray& points) { return ComputeBox(&points, 1); }
+		static AxisAlignedBox ComputeBox(const PointArray* arrays, size_t arrayCount);
+
+		static BoundingSphere ComputeSphere(const PointArray& points) { return ComputeSphere(&points, 1); }
+		static BoundingSphere ComputeSphere(const PointArray* arrays, size_t arrayCount);
+
+		static OrientedBox ComputeOrientedBox(const PointArray& points) { return ComputeOrientedBox(&points, 1); }
+		static OrientedBox ComputeOrientedBox(const PointArray* arrays, size_t arrayCount);
+
+		/**
+		 * @brief 点を厳密に囲む最小の球（Welzlの方法）
+		 *
+		 * 計算量が点の数に対して線形ではないので、少ない点（EPOSの両端の点など）に使う。
+		 * @param points 点
+		 * @param count 点の数（64以下を想定）
+		 */
+		static BoundingSphere ComputeMinimumSphere(const Vector3* points, size_t count);
+	};
+}
@@ -76,8 +76,9 @@ namespace AtomEngine
 		for (int i = 0; i < 8; ++i)
 			result.m_FrustumCorners[i] = xform.rotation * frustum.m_FrustumCorners[i] + xform.transition;
 
+		const Matrix4x4 xformMatrix = xform.GetMatrix();
 		for (int i = 0; i < 6; ++i)
-			result.m_FrustumPlanes[i] = xform.GetMatrix() * frustum.m_FrustumPlanes[i];
+			result.m_FrustumPlanes[i] = xformMatrix * frustum.m_FrustumPlanes[i];
 
 		return result;
 	}
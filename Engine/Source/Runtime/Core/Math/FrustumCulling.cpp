@@ -0,0 +1,200 @@
+#include "FrustumCulling.h"
+#include "SIMD.h"
+
+#include <bit>
+#include <cstring>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		/// 1回の判定で処理する要素数（Float4を2本使う）
+		constexpr uint32_t kGroupSize = 8;
+
+		struct Group
+		{
+			SIMD::Float4 lo;
+			SIMD::Float4 hi;
+		};
+
+		/// 8要素を読み込む（末尾の足りない分は0で埋める）
+		Group LoadGroup(const float* p, uint32_t index, uint32_t count)
+		{
+			if (index + kGroupSize <= count)
+				return { SIMD::Load(p + index), SIMD::Load(p + index + 4) };
+
+			float padded[kGroupSize] = {};
+			std::memcpy(padded, p + index, (count - index) * sizeof(float));
+			return { SIMD::Load(padded), SIMD::Load(padded + 4) };
+		}
+
+		/// 平面の成分を各要素に複製したもの
+		struct SplatPlanes
+		{
+			SIMD::Float4 nx[CullingPlanes::kMaxPlanes];
+			SIMD::Float4 ny[CullingPlanes::kMaxPlanes];
+			SIMD::Float4 nz[CullingPlanes::kMaxPlanes];
+			SIMD::Float4 d[CullingPlanes::kMaxPlanes];
+		};
+
+		/**
+		 * @brief 8個ずつ判定してビットマスクを書き出す共通部分
+		 * @param testGroup (先頭番号, 判定する平面の開始番号) → 可視の8ビット
+		 */
+		template<typename TestGroup>
+		uint32_t CullGroups(uint32_t count, uint32_t* visibility, const uint32_t* inputMask, TestGroup&& testGroup)
+		{
+			std::memset(visibility, 0, CullingPlanes::GetMaskWordCount(count) * sizeof(uint32_t));
+
+			uint32_t visibleCount = 0;
+			uint32_t firstPlane = 0;
+			for (uint32_t i = 0; i < count; i += kGroupSize)
+			{
+				uint32_t bits = inputMask ? (inputMask[i >> 5] >> (i & 31)) & 0xFF : 0xFF;
+				if (count - i < kGroupSize)
+					bits &= (1u << (count - i)) - 1;
+				if (bits == 0) continue;
+
+				bits &= testGroup(i, firstPlane);
+				visibility[i >> 5] |= bits << (i & 31);
+				visibleCount += static_cast<uint32_t>(std::popcount(bits));
+			}
+			return visibleCount;
+		}
+	}
+
+	CullingPlanes::CullingPlanes(const Frustum& frustum)
+	{
+		for (int i = 0; i < 6; ++i)
+			AddPlane(Vector4(frustum.GetFrustumPlane(static_cast<Frustum::PlaneID>(i))));
+	}
+
+	CullingPlanes::CullingPlanes(const Matrix4x4& viewProj, uint32_t planeBits)
+	{
+		// clip = p * M なので、列jがクリップ座標のj成分になる
+		auto column = [&](int j)
+			{
+				return Vector4(viewProj.mat[0][j], viewProj.mat[1][j], viewProj.mat[2][j], viewProj.mat[3][j]);
+			};
+		const Vector4 x = column(0), y = column(1), z = column(2), w = column(3);
+
+		if (planeBits & kLeftPlaneBit)   AddPlane(w + x);   // -w <= x
+		if (planeBits & kRightPlaneBit)  AddPlane(w - x);   //  x <= w
+		if (planeBits & kBottomPlaneBit) AddPlane(w + y);   // -w <= y
+		if (planeBits & kTopPlaneBit)    AddPlane(w - y);   //  y <= w
+		if (planeBits & kNearPlaneBit)   AddPlane(z);       //  0 <= z
+		if (planeBits & kFarPlaneBit)    AddPlane(w - z);   //  z <= w
+	}
+
+	void CullingPlanes::AddPlane(const Vector4& plane)
+	{
+		assert(mPlaneCount < kMaxPlanes);
+
+		// 無限遠の平面など法線がない平面は判定に寄与しない
+		const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length < 1e-6f)
+			return;
+
+		const float invLength = 1.0f / length;
+		mNormalX[mPlaneCount] = plane.x * invLength;
+		mNormalY[mPlaneCount] = plane.y * invLength;
+		mNormalZ[mPlaneCount] = plane.z * invLength;
+		mDistance[mPlaneCount] = plane.w * invLength;
+		++mPlaneCount;
+	}
+
+	uint32_t CullingPlanes::CullSpheres(const SphereArrays& spheres, uint32_t count, uint32_t* visibility, const uint32_t* inputMask) const
+	{
+		SplatPlanes planes;
+		for (uint32_t p = 0; p < mPlaneCount; ++p)
+		{
+			planes.nx[p] = SIMD::Splat(mNormalX[p]);
+			planes.ny[p] = SIMD::Splat(mNormalY[p]);
+			planes.nz[p] = SIMD::Splat(mNormalZ[p]);
+			planes.d[p] = SIMD::Splat(mDistance[p]);
+		}
+		const SIMD::Float4 zero = SIMD::Zero();
+		const uint32_t planeCount = mPlaneCount;
+
+		return CullGroups(count, visibility, inputMask, [&](uint32_t index, uint32_t& firstPlane) -> uint32_t
+			{
+				const Group x = LoadGroup(spheres.centerX, index, count);
+				const Group y = LoadGroup(spheres.centerY, index, count);
+				const Group z = LoadGroup(spheres.centerZ, index, count);
+				const Group r = LoadGroup(spheres.radius, index, count);
+
+				uint32_t bits = 0xFF;
+				for (uint32_t n = 0; n < planeCount; ++n)
+				{
+					// 直前のグループを棄却した平面から判定する（近い物体は同じ平面で外れやすい）
+					const uint32_t p = (firstPlane + n) % planeCount;
+
+					SIMD::Float4 lo = SIMD::Add(SIMD::Mul(planes.nx[p], x.lo), SIMD::Mul(planes.ny[p], y.lo));
+					lo = SIMD::Add(SIMD::Add(lo, SIMD::Mul(planes.nz[p], z.lo)), SIMD::Add(planes.d[p], r.lo));
+					SIMD::Float4 hi = SIMD::Add(SIMD::Mul(planes.nx[p], x.hi), SIMD::Mul(planes.ny[p], y.hi));
+					hi = SIMD::Add(SIMD::Add(hi, SIMD::Mul(planes.nz[p], z.hi)), SIMD::Add(planes.d[p], r.hi));
+
+					bits &= SIMD::MoveMask(SIMD::CmpGE(lo, zero)) | (SIMD::MoveMask(SIMD::CmpGE(hi, zero)) << 4);
+					if (bits == 0)
+					{
+						firstPlane = p;
+						break;
+					}
+				}
+				return bits;
+			});
+	}
+
+	uint32_t CullingPlanes::CullBoxes(const BoxArrays& boxes, uint32_t count, uint32_t* visibility, const uint32_t* inputMask) const
+	{
+		// AABBは法線の絶対値で半分の大きさを射影した分だけ平面から離れられる
+		SplatPlanes planes;
+		SplatPlanes absPlanes;
+		for (uint32_t p = 0; p < mPlaneCount; ++p)
+		{
+			planes.nx[p] = SIMD::Splat(mNormalX[p]);
+			planes.ny[p] = SIMD::Splat(mNormalY[p]);
+			planes.nz[p] = SIMD::Splat(mNormalZ[p]);
+			planes.d[p] = SIMD::Splat(mDistance[p]);
+			absPlanes.nx[p] = SIMD::Splat(std::fabs(mNormalX[p]));
+			absPlanes.ny[p] = SIMD::Splat(std::fabs(mNormalY[p]));
+			absPlanes.nz[p] = SIMD::Splat(std::fabs(mNormalZ[p]));
+		}
+		const SIMD::Float4 zero = SIMD::Zero();
+		const uint32_t planeCount = mPlaneCount;
+
+		return CullGroups(count, visibility, inputMask, [&](uint32_t index, uint32_t& firstPlane) -> uint32_t
+			{
+				const Group cx = LoadGroup(boxes.centerX, index, count);
+				const Group cy = LoadGroup(boxes.centerY, index, count);
+				const Group cz = LoadGroup(boxes.centerZ, index, count);
+				const Group ex = LoadGroup(boxes.extentX, index, count);
+				const Group ey = LoadGroup(boxes.extentY, index, count);
+				const Group ez = LoadGroup(boxes.extentZ, index, count);
+
+				uint32_t bits = 0xFF;
+				for (uint32_t n = 0; n < planeCount; ++n)
+				{
+					const uint32_t p = (firstPlane + n) % planeCount;
+
+					SIMD::Float4 lo = SIMD::Add(SIMD::Mul(planes.nx[p], cx.lo), SIMD::Mul(planes.ny[p], cy.lo));
+					lo = SIMD::Add(SIMD::Add(lo, SIMD::Mul(planes.nz[p], cz.lo)), planes.d[p]);
+					SIMD::Float4 loRadius = SIMD::Add(SIMD::Mul(absPlanes.nx[p], ex.lo), SIMD::Mul(absPlanes.ny[p], ey.lo));
+					lo = SIMD::Add(lo, SIMD::Add(loRadius, SIMD::Mul(absPlanes.nz[p], ez.lo)));
+
+					SIMD::Float4 hi = SIMD::Add(SIMD::Mul(planes.nx[p], cx.hi), SIMD::Mul(planes.ny[p], cy.hi));
+					hi = SIMD::Add(SIMD::Add(hi, SIMD::Mul(planes.nz[p], cz.hi)), planes.d[p]);
+					SIMD::Float4 hiRadius = SIMD::Add(SIMD::Mul(absPlanes.nx[p], ex.hi), SIMD::Mul(absPlanes.ny[p], ey.hi));
+					hi = SIMD::Add(hi, SIMD::Add(hiRadius, SIMD::Mul(absPlanes.nz[p], ez.hi)));
+
+					bits &= SIMD::MoveMask(SIMD::CmpGE(lo, zero)) | (SIMD::MoveMask(SIMD::CmpGE(hi, zero)) << 4);
+					if (bits == 0)
+					{
+						firstPlane = p;
+						break;
+					}
+				}
+				return bits;
+			});
+	}
+}
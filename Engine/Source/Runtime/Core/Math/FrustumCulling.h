@@ -0,0 +1,136 @@
+/**
+ * @file FrustumCulling.h
+ * @brief SoA配列の境界ボリュームを視錐台でまとめて判定するカリング
+ *
+ * 平面セットは事前に正規化・展開しておき、8個ずつSIMDで判定して可視ビットマスクを書き出す。
+ * メインビュー、シャドウなど視点ごとに平面セットを1つ作って使い回す。
+ */
+
+#pragma once
+#include "Frustum.h"
+#include <cstdint>
+
+namespace AtomEngine
+{
+	/**
+	 * @struct SphereArrays
+	 * @brief 球のSoA配列（中心と半径）
+	 */
+	struct SphereArrays
+	{
+		const float* centerX = nullptr;
+		const float* centerY = nullptr;
+		const float* centerZ = nullptr;
+		const float* radius = nullptr;
+	};
+
+	/**
+	 * @struct BoxArrays
+	 * @brief AABBのSoA配列（中心と半分の大きさ）
+	 */
+	struct BoxArrays
+	{
+		const float* centerX = nullptr;
+		const float* centerY = nullptr;
+		const float* centerZ = nullptr;
+		const float* extentX = nullptr;
+		const float* extentY = nullptr;
+		const float* extentZ = nullptr;
+	};
+
+	/**
+	 * @class CullingPlanes
+	 * @brief カリング用の平面セット（法線は内側向きに正規化済み）
+	 *
+	 * 使用例:
+	 * @code
+	 * CullingPlanes planes(camera.GetViewProjMatrix());
+	 * std::vector<uint32_t> visibility(CullingPlanes::GetMaskWordCount(count));
+	 * planes.CullBoxes(boxes, count, visibility.data());
+	 * @endcode
+	 */
+	class CullingPlanes
+	{
+	public:
+		/// 保持できる平面の最大数
+		static constexpr uint32_t kMaxPlanes = 8;
+
+		/// 行列から作る場合の平面の選択ビット
+		enum PlaneBits : uint32_t
+		{
+			kLeftPlaneBit = 1 << 0,
+			kRightPlaneBit = 1 << 1,
+			kBottomPlaneBit = 1 << 2,
+			kTopPlaneBit = 1 << 3,
+			kNearPlaneBit = 1 << 4,
+			kFarPlaneBit = 1 << 5,
+			kAllPlaneBits = 0x3F,
+		};
+
+		CullingPlanes() = default;
+
+		/**
+		 * @brief 視錐台の6平面から作る
+		 * @param frustum 判定に使う空間の視錐台
+		 */
+		explicit CullingPlanes(const Frustum& frustum);
+
+		/**
+		 * @brief ビュープロジェクション行列（行ベクトル規約、クリップzは0～w）から平面を抽出する
+		 *
+		 * リバースZや無限遠のプロジェクションにも対応する（法線が0になる平面は追加しない）。
+		 * @param viewProj ビュープロジェクション行列（ワールド空間で判定する場合）
+		 * @param planeBits 使用する平面（シャドウキャスターなら近平面を外すなど）
+		 */
+		explicit CullingPlanes(const Matrix4x4& viewProj, uint32_t planeBits = kAllPlaneBits);
+
+		/**
+		 * @brief 平面を追加（法線は内側向き、正規化される）
+		 * @param plane (nx, ny, nz, d)。n・p + d >= 0が内側
+		 */
+		void AddPlane(const Vector4& plane);
+
+		uint32_t GetPlaneCount() const { return mPlaneCount; }
+
+		/**
+		 * @brief 球を判定して可視ビットマスクを書き出す
+		 * @param spheres 判定する球
+		 * @param count 要素数
+		 * @param visibility 出力（GetMaskWordCount(count)要素、i番目の可視でビットiが1）
+		 * @param inputMask 判定対象のビットマスク（nullptrなら全て。0のビットは不可視になり、8個全て0なら判定を省略）
+		 * @return 可視の数
+		 */
+		uint32_t CullSpheres(const SphereArrays& spheres, uint32_t count, uint32_t* visibility, const uint32_t* inputMask = nullptr) const;
+
+		/**
+		 * @brief AABBを判定して可視ビットマスクを書き出す
+		 * @param boxes 判定するAABB
+		 * @param count 要素数
+		 * @param visibility 出力（GetMaskWordCount(count)要素、i番目の可視でビットiが1）
+		 * @param inputMask 判定対象のビットマスク（nullptrなら全て。0のビットは不可視になり、8個全て0なら判定を省略）
+		 * @return 可視の数
+		 */
+		uint32_t CullBoxes(const BoxArrays& boxes, uint32_t count, uint32_t* visibility, const uint32_t* inputMask = nullptr) const;
+
+		/**
+		 * @brief 要素数に必要なビットマスクのワード数
+		 */
+		static uint32_t GetMaskWordCount(uint32_t count) { return (count + 31) / 32; }
+
+		/**
+		 * @brief ビットマスクのi番目が立っているか
+		 */
+		static bool IsVisible(const uint32_t* visibility, uint32_t index)
+		{
+			return (visibility[index >> 5] >> (index & 31)) & 1;
+		}
+
+	private:
+		// 平面ごとの成分（SoA）
+		float mNormalX[kMaxPlanes] = {};
+		float mNormalY[kMaxPlanes] = {};
+		float mNormalZ[kMaxPlanes] = {};
+		float mDistance[kMaxPlanes] = {};
+		uint32_t mPlaneCount = 0;
+	};
+}
@@ -0,0 +1,417 @@
+#include "MathBenchmark.h"
+#include "Matrix4x4.h"
+#include "Quaternion.h"
+#include "BatchTransform.h"
+#include "RandomGenerator.h"
+#include "SIMD.h"
+#include "Runtime/Core/LogSystem/LogSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		constexpr size_t kElementCount = 4096;
+
+		// 比較用のスカラー実装（SIMD化する前の実装と同じ計算）
+		namespace Reference
+		{
+			Matrix4x4 Multiply(const Matrix4x4& a, const Matrix4x4& b)
+			{
+				Matrix4x4 r;
+				for (int i = 0; i < 4; ++i)
+				{
+					for (int j = 0; j < 4; ++j)
+						r.mat[i][j] = a.mat[i][0] * b.mat[0][j] + a.mat[i][1] * b.mat[1][j] + a.mat[i][2] * b.mat[2][j] + a.mat[i][3] * b.mat[3][j];
+				}
+				return r;
+			}
+
+			Matrix4x4 Inverse(const Matrix4x4& m)
+			{
+				float m00 = m.mat[0][0], m01 = m.mat[0][1], m02 = m.mat[0][2], m03 = m.mat[0][3];
+				float m10 = m.mat[1][0], m11 = m.mat[1][1], m12 = m.mat[1][2], m13 = m.mat[1][3];
+				float m20 = m.mat[2][0], m21 = m.mat[2][1], m22 = m.mat[2][2], m23 = m.mat[2][3];
+				float m30 = m.mat[3][0], m31 = m.mat[3][1], m32 = m.mat[3][2], m33 = m.mat[3][3];
+
+				float v0 = m20 * m31 - m21 * m30;
+				float v1 = m20 * m32 - m22 * m30;
+				float v2 = m20 * m33 - m23 * m30;
+				float v3 = m21 * m32 - m22 * m31;
+				float v4 = m21 * m33 - m23 * m31;
+				float v5 = m22 * m33 - m23 * m32;
+
+				float t00 = +(v5 * m11 - v4 * m12 + v3 * m13);
+				float t10 = -(v5 * m10 - v2 * m12 + v1 * m13);
+				float t20 = +(v4 * m10 - v2 * m11 + v0 * m13);
+				float t30 = -(v3 * m10 - v1 * m11 + v0 * m12);
+
+				float invDet = 1 / (t00 * m00 + t10 * m01 + t20 * m02 + t30 * m03);
+
+				float d00 = t00 * invDet;
+				float d10 = t10 * invDet;
+				float d20 = t20 * invDet;
+				float d30 = t30 * invDet;
+
+				float d01 = -(v5 * m01 - v4 * m02 + v3 * m03) * invDet;
+				float d11 = +(v5 * m00 - v2 * m02 + v1 * m03) * invDet;
+				float d21 = -(v4 * m00 - v2 * m01 + v0 * m03) * invDet;
+				float d31 = +(v3 * m00 - v1 * m01 + v0 * m02) * invDet;
+
+				v0 = m10 * m31 - m11 * m30;
+				v1 = m10 * m32 - m12 * m30;
+				v2 = m10 * m33 - m13 * m30;
+				v3 = m11 * m32 - m12 * m31;
+				v4 = m11 * m33 - m13 * m31;
+				v5 = m12 * m33 - m13 * m32;
+
+				float d02 = +(v5 * m01 - v4 * m02 + v3 * m03) * invDet;
+				float d12 = -(v5 * m00 - v2 * m02 + v1 * m03) * invDet;
+				float d22 = +(v4 * m00 - v2 * m01 + v0 * m03) * invDet;
+				float d32 = -(v3 * m00 - v1 * m01 + v0 * m02) * invDet;
+
+				v0 = m21 * m10 - m20 * m11;
+				v1 = m22 * m10 - m20 * m12;
+				v2 = m23 * m10 - m20 * m13;
+				v3 = m22 * m11 - m21 * m12;
+				v4 = m23 * m11 - m21 * m13;
+				v5 = m23 * m12 - m22 * m13;
+
+				float d03 = -(v5 * m01 - v4 * m02 + v3 * m03) * invDet;
+				float d13 = +(v5 * m00 - v2 * m02 + v1 * m03) * invDet;
+				float d23 = -(v4 * m00 - v2 * m01 + v0 * m03) * invDet;
+				float d33 = +(v3 * m00 - v1 * m01 + v0 * m02) * invDet;
+
+				return Matrix4x4(d00, d01, d02, d03, d10, d11, d12, d13, d20, d21, d22, d23, d30, d31, d32, d33);
+			}
+
+			Matrix4x4 MakeAffine(const Vector3& scale, const Quaternion& orientation, const Vector3& position)
+			{
+				Quaternion r = orientation;
+				r.Normalize();
+
+				float xx = r.x * r.x, yy = r.y * r.y, zz = r.z * r.z, ww = r.w * r.w;
+				float xy = r.x * r.y, xz = r.x * r.z, yz = r.y * r.z;
+				float wx = r.w * r.x, wy = r.w * r.y, wz = r.w * r.z;
+
+				return Matrix4x4(
+					scale.x * (ww + xx - yy - zz), scale.y * 2.0f * (xy + wz), scale.z * 2.0f * (xz - wy), 0.0f,
+					scale.x * 2.0f * (xy - wz), scale.y * (ww - xx + yy - zz), scale.z * 2.0f * (yz + wx), 0.0f,
+					scale.x * 2.0f * (xz + wy), scale.y * 2.0f * (yz - wx), scale.z * (ww - xx - yy + zz), 0.0f,
+					position.x, position.y, position.z, 1.0f);
+			}
+
+			Quaternion Multiply(const Quaternion& a, const Quaternion& b)
+			{
+				Vector3 v1(a.x, a.y, a.z);
+				Vector3 v2(b.x, b.y, b.z);
+				Vector3 v = v1.Cross(v2) + v1 * b.w + v2 * a.w;
+				return Quaternion(v.x, v.y, v.z, a.w * b.w - v1.Dot(v2));
+			}
+
+			Vector3 Rotate(const Quaternion& q, const Vector3& v)
+			{
+				Quaternion r = Multiply(Multiply(q, Quaternion(v.x, v.y, v.z, 0.0f)), q.Conjugate());
+				return Vector3(r.x, r.y, r.z);
+			}
+
+			AxisAlignedBox TransformAABB(const AxisAlignedBox& box, const Matrix4x4& mat)
+			{
+				const Vector3 boxMin = box.GetMin(), boxMax = box.GetMax();
+				AxisAlignedBox result;
+				for (int i = 0; i < 8; ++i)
+				{
+					const Vector3 corner((i & 1) ? boxMax.x : boxMin.x, (i & 2) ? boxMax.y : boxMin.y, (i & 4) ? boxMax.z : boxMin.z);
+					result.AddPoint(Math::TransformCoord(corner, mat));
+				}
+				return result;
+			}
+
+			Quaternion Slerp(const Quaternion& q1, const Quaternion& q2, float t)
+			{
+				float dot = std::clamp(q1.Dot(q2), -1.0f, 1.0f);
+				float theta = std::acos(dot) * t;
+				Quaternion rel = (q2 - q1 * dot).NormalizeCopy();
+				return q1 * std::cos(theta) + rel * std::sin(theta);
+			}
+		}
+
+		template<typename Func>
+		double MeasureMilliseconds(int iterations, Func&& func)
+		{
+			using namespace std::chrono;
+			const auto start = steady_clock::now();
+			for (int i = 0; i < iterations; ++i)
+				func();
+			return duration<double, std::milli>(steady_clock::now() - start).count();
+		}
+
+		/// 最大誤差（絶対値が1を超える要素は相対誤差）
+		float MaxError(const float* a, const float* b, size_t count)
+		{
+			float error = 0.0f;
+			for (size_t i = 0; i < count; ++i)
+				error = std::max(error, std::fabs(a[i] - b[i]) / std::max(1.0f, std::fabs(a[i])));
+			return error;
+		}
+
+		/// 平均値の期待値からのずれ
+		float MeanError(const float* values, size_t count, float expectedMean)
+		{
+			double sum = 0.0;
+			for (size_t i = 0; i < count; ++i)
+				sum += values[i];
+			return static_cast<float>(std::fabs(sum / static_cast<double>(count) - expectedMean));
+		}
+
+		bool Report(const char* name, double scalarMs, double simdMs, float error, float tolerance)
+		{
+			const bool passed = error <= tolerance;
+			Log("[MathBenchmark]:%-18s scalar %8.3f ms  simd %8.3f ms  x%5.2f  max error %.3g%s\n",
+				name, scalarMs, simdMs, scalarMs / std::max(simdMs, 1e-6), error, passed ? "" : "  (NG)");
+			return passed;
+		}
+	}
+
+	bool MathBenchmark::Run(int iterations)
+	{
+		std::mt19937 engine(12345);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> positive(0.5f, 2.0f);
+
+		auto randomQuaternion = [&]()
+			{
+				Quaternion q(unit(engine), unit(engine), unit(engine), unit(engine));
+				q.Normalize();
+				return q;
+			};
+
+		std::vector<Vector3> positions(kElementCount), scales(kElementCount), vectors(kElementCount);
+		std::vector<Quaternion> rotations(kElementCount), targets(kElementCount);
+		std::vector<float> times(kElementCount);
+		std::vector<Matrix4x4> matrices(kElementCount);
+		for (size_t i = 0; i < kElementCount; ++i)
+		{
+			positions[i] = Vector3(unit(engine), unit(engine), unit(engine)) * 100.0f;
+			scales[i] = Vector3(positive(engine), positive(engine), positive(engine));
+			vectors[i] = Vector3(unit(engine), unit(engine), unit(engine)) * 10.0f;
+			rotations[i] = randomQuaternion();
+			targets[i] = randomQuaternion();
+			times[i] = 0.5f * (unit(engine) + 1.0f);
+			matrices[i] = Reference::MakeAffine(scales[i], rotations[i], positions[i]);
+		}
+
+		Log("[MathBenchmark]:backend %s, %zu elements x %d iterations\n", SIMD::GetBackendName(), kElementCount, iterations);
+		bool passed = true;
+
+		{
+			std::vector<Matrix4x4> expected(kElementCount), actual(kElementCount);
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i + 1 < kElementCount; ++i)
+						expected[i] = Reference::Multiply(matrices[i], matrices[i + 1]);
+				});
+			const double simdMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i + 1 < kElementCount; ++i)
+						actual[i] = matrices[i] * matrices[i + 1];
+				});
+			passed &= Report("Matrix4x4 Multiply", scalarMs, simdMs,
+				MaxError(&expected[0].mat[0][0], &actual[0].mat[0][0], kElementCount * 16), 1e-6f);
+		}
+
+		{
+			std::vector<Matrix4x4> expected(kElementCount), actual(kElementCount);
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						expected[i] = Reference::Inverse(matrices[i]);
+				});
+			const double simdMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						actual[i] = matrices[i].Inverse();
+				});
+			passed &= Report("Matrix4x4 Inverse", scalarMs, simdMs,
+				MaxError(&expected[0].mat[0][0], &actual[0].mat[0][0], kElementCount * 16), 1e-5f);
+		}
+
+		{
+			std::vector<Matrix4x4> expected(kElementCount), actual(kElementCount);
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						expected[i] = Reference::MakeAffine(scales[i], rotations[i], positions[i]);
+				});
+			const double simdMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						actual[i].MakeAffine(scales[i], rotations[i], positions[i]);
+				});
+			passed &= Report("MakeAffine", scalarMs, simdMs,
+				MaxError(&expected[0].mat[0][0], &actual[0].mat[0][0], kElementCount * 16), 1e-5f);
+		}
+
+		{
+			std::vector<Quaternion> expected(kElementCount), actual(kElementCount);
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						expected[i] = Reference::Multiply(rotations[i], targets[i]);
+				});
+			const double simdMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						actual[i] = rotations[i] * targets[i];
+				});
+			passed &= Report("Quaternion Multiply", scalarMs, simdMs,
+				MaxError(expected[0].ptr(), actual[0].ptr(), kElementCount * 4), 1e-6f);
+		}
+
+		{
+			std::vector<Vector3> expected(kElementCount), actual(kElementCount);
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						expected[i] = Reference::Rotate(rotations[i], vectors[i]);
+				});
+			const double simdMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						actual[i] = rotations[i] * vectors[i];
+				});
+			passed &= Report("Quaternion Rotate", scalarMs, simdMs,
+				MaxError(&expected[0].x, &actual[0].x, kElementCount * 3), 1e-5f);
+		}
+
+		{
+			std::vector<Quaternion> expected(kElementCount), actual(kElementCount);
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						expected[i] = Reference::Slerp(rotations[i], targets[i], times[i]);
+				});
+			const double simdMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						actual[i] = Quaternion::Slerp(rotations[i], targets[i], times[i]);
+				});
+			passed &= Report("Quaternion Slerp", scalarMs, simdMs,
+				MaxError(expected[0].ptr(), actual[0].ptr(), kElementCount * 4), 1e-5f);
+		}
+
+		{
+			// 丸め誤差で内積が1を超える組と、ほぼ反対向き（q1≒-q0）の組
+			// 結果が単位長で、両端がq0とq1（反対向きは同じ回転の-q0）になることを確認する
+			// 反対向きは一定の速さで半周するので、q0となす角がtπになることも確認する
+			// 反対向きの線形補間はt=0.5で0になるので、その時刻も含める
+			std::vector<Quaternion> from(kElementCount), to(kElementCount), actual(kElementCount);
+			std::vector<float> edgeTimes(kElementCount);
+			for (size_t i = 0; i < kElementCount; ++i)
+			{
+				from[i] = rotations[i];
+				edgeTimes[i] = (i % 6 == 1) ? 0.5f : times[i];
+				switch (i % 3)
+				{
+				case 0: to[i] = rotations[i] * (1.0f + 1e-6f); break;
+				case 1: to[i] = -rotations[i]; break;
+				default: to[i] = -(rotations[i] + Quaternion(1e-7f, -1e-7f, 1e-7f, 0.0f)); break;
+				}
+			}
+
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						actual[i] = Reference::Slerp(from[i], to[i], edgeTimes[i]);
+				});
+			const double simdMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						actual[i] = Quaternion::Slerp(from[i], to[i], edgeTimes[i]);
+				});
+
+			float error = 0.0f;
+			for (size_t i = 0; i < kElementCount; ++i)
+			{
+				const Quaternion start = Quaternion::Slerp(from[i], to[i], 0.0f);
+				const Quaternion end = Slerp(from[i], to[i], 1.0f);
+				const float angle = (i % 3 == 0) ? 0.0f : actual[i].Dot(from[i]) - std::cos(edgeTimes[i] * Math::PI);
+				const float values[] = {
+					actual[i].Length() - 1.0f,
+					(start - from[i]).Length(),
+					(end - to[i]).Length(),
+					angle,
+				};
+				for (float value : values)
+					error = std::isnan(value) ? 1.0f : std::max(error, std::fabs(value));
+			}
+			passed &= Report("Slerp Edge", scalarMs, simdMs, error, 1e-5f);
+		}
+
+		{
+			std::vector<Vector3> expected(kElementCount), actual(kElementCount);
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						expected[i] = Math::TransformCoord(vectors[i], matrices[0]);
+				});
+			const double simdMs = MeasureMilliseconds(iterations, [&]()
+				{
+					BatchTransform::TransformPoints(matrices[0], vectors.data(), actual.data(), kElementCount);
+				});
+			passed &= Report("TransformPoints", scalarMs, simdMs,
+				MaxError(&expected[0].x, &actual[0].x, kElementCount * 3), 1e-6f);
+		}
+
+		{
+			// 8頂点を変換して囲む従来の方法と比較する
+			// 座標が100程度で0付近の値は桁落ちするので、誤差の許容値は他より大きくする
+			std::vector<AxisAlignedBox> boxes(kElementCount), expected(kElementCount), actual(kElementCount);
+			for (size_t i = 0; i < kElementCount; ++i)
+				boxes[i] = AxisAlignedBox(positions[i], positions[i] + scales[i]);
+
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						expected[i] = Reference::TransformAABB(boxes[i], matrices[0]);
+				});
+			const double simdMs = MeasureMilliseconds(iterations, [&]()
+				{
+					BatchTransform::TransformAABBs(matrices[0], boxes.data(), actual.data(), kElementCount);
+				});
+			passed &= Report("TransformAABBs", scalarMs, simdMs,
+				MaxError(reinterpret_cast<const float*>(expected.data()), reinterpret_cast<const float*>(actual.data()), kElementCount * 6), 1e-4f);
+		}
+
+		{
+			// 従来のRandomと同じく、mt19937で呼び出しごとに分布オブジェクトを作る方法と比較する
+			// 誤差は平均値の0.5からのずれ
+			std::vector<float> expected(kElementCount), actual(kElementCount);
+			std::mt19937 reference(12345);
+			RandomGenerator generator(12345);
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						expected[i] = std::uniform_real_distribution<float>(-1.0f, 1.0f)(reference);
+				});
+			const double simdMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (size_t i = 0; i < kElementCount; ++i)
+						actual[i] = generator.NextFloat(-1.0f, 1.0f);
+				});
+			passed &= Report("Random Uniform", scalarMs, simdMs, MeanError(actual.data(), kElementCount, 0.0f), 0.05f);
+
+			const double fillMs = MeasureMilliseconds(iterations, [&]()
+				{
+					generator.Fill(actual.data(), kElementCount, -1.0f, 1.0f);
+				});
+			passed &= Report("Random Fill", scalarMs, fillMs, MeanError(actual.data(), kElementCount, 0.0f), 0.05f);
+		}
+
+		return passed;
+	}
+}
@@ -0,0 +1,27 @@
+/**
+ * @file MathBenchmark.h
+ * @brief 数学ライブラリのSIMD実装とスカラー実装の比較ベンチマーク
+ *
+ * エディタを --math-benchmark 引数付きで起動すると実行され、結果をログに出力する。
+ * 乱数は従来のRandomと同じmt19937での生成と比較する（scalarの欄が従来の方法）。
+ */
+
+#pragma once
+
+namespace AtomEngine
+{
+	/**
+	 * @class MathBenchmark
+	 * @brief 行列・四元数演算の速度と誤差の計測
+	 */
+	class MathBenchmark
+	{
+	public:
+		/**
+		 * @brief 全ての計測を行い、処理時間と最大誤差をログに出力する
+		 * @param iterations 各計測の繰り返し回数
+		 * @return 全ての最大誤差が許容範囲内ならtrue
+		 */
+		static bool Run(int iterations = 200);
+	};
+}
@@ -52,35 +52,23 @@ namespace AtomEngine
 
 	void Matrix4x4::MakeAffine(const Vector3& scale, const Quaternion& orientation, const Vector3& position)
 	{
-		// orientation をローカルコピーして正規化（ガード）
-		Quaternion q = orientation;
-		if (q.IsNaN())
-		{
-			q = Quaternion::IDENTITY;
-		}
-		q.Normalize();
-
-		Matrix4x4 rot(q);
-
-		mat[0][0] = scale.x * rot.mat[0][0];
-		mat[0][1] = scale.y * rot.mat[0][1];
-		mat[0][2] = scale.z * rot.mat[0][2];
-		mat[0][3] = 0.0f;
-
-		mat[1][0] = scale.x * rot.mat[1][0];
-		mat[1][1] = scale.y * rot.mat[1][1];
-		mat[1][2] = scale.z * rot.mat[1][2];
-		mat[1][3] = 0.0f;
-
-		mat[2][0] = scale.x * rot.mat[2][0];
-		mat[2][1] = scale.y * rot.mat[2][1];
-		mat[2][2] = scale.z * rot.mat[2][2];
-		mat[2][3] = 0.0f;
-
-		mat[3][0] = position.x;
-		mat[3][1] = position.y;
-		mat[3][2] = position.z;
-		mat[3][3] = 1.0f;
+		// orientation を正規化（NaNや長さ0は単位四元数として扱う）
+		SIMD::Float4 q = SIMD::Load(orientation.ptr());
+		const float length = std::sqrt(SIMD::GetX(SIMD::Dot4(q, q)));
+		if (length > 1e-6f)
+			q = SIMD::Mul(q, SIMD::Splat(1.0f / length));
+		else
+			q = SIMD::Set(0.0f, 0.0f, 0.0f, 1.0f);
+
+		SIMD::Float4 row0, row1, row2;
+		SIMD::QuaternionToRows(q, row0, row1, row2);
+
+		// 列ごとにスケールを掛ける（w列は0のまま）
+		const SIMD::Float4 s = SIMD::Set(scale.x, scale.y, scale.z, 0.0f);
+		SIMD::Store(mat[0], SIMD::Mul(row0, s));
+		SIMD::Store(mat[1], SIMD::Mul(row1, s));
+		SIMD::Store(mat[2], SIMD::Mul(row2, s));
+		SIMD::Store(mat[3], SIMD::Set(position.x, position.y, position.z, 1.0f));
 	}
 
 	void Matrix4x4::MakeAffine(const Vector3& scale, const Vector3& orientation, const Vector3& position)
@@ -145,9 +133,8 @@ namespace AtomEngine
 
 	Vector4 operator*(const Vector4& v, const Matrix4x4& mat)
 	{
-		return Vector4(v.x * mat[0][0] + v.y * mat[1][0] + v.z * mat[2][0] + v.w * mat[3][0],
-			v.x * mat[0][1] + v.y * mat[1][1] + v.z * mat[2][1] + v.w * mat[3][1],
-			v.x * mat[0][2] + v.y * mat[1][2] + v.z * mat[2][2] + v.w * mat[3][2],
-			v.x * mat[0][3] + v.y * mat[1][3] + v.z * mat[2][3] + v.w * mat[3][3]);
+		Vector4 result;
+		SIMD::Store(&result.x, SIMD::TransformRow(SIMD::Load(&v.x), &mat.mat[0][0]));
+		return result;
 	}
 }
\ No newline at end of file
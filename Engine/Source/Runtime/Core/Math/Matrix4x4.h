@@ -4,6 +4,7 @@
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Matrix3x3.h"
+#include "SIMD.h"
 
 namespace AtomEngine
 {
@@ -285,26 +286,7 @@ namespace AtomEngine
 		Matrix4x4 operator*(const Matrix4x4& m2) const
 		{
 			Matrix4x4 result;
-			result.mat[0][0] = mat[0][0] * m2.mat[0][0] + mat[0][1] * m2.mat[1][0] + mat[0][2] * m2.mat[2][0] + mat[0][3] * m2.mat[3][0];
-			result.mat[0][1] = mat[0][0] * m2.mat[0][1] + mat[0][1] * m2.mat[1][1] + mat[0][2] * m2.mat[2][1] + mat[0][3] * m2.mat[3][1];
-			result.mat[0][2] = mat[0][0] * m2.mat[0][2] + mat[0][1] * m2.mat[1][2] + mat[0][2] * m2.mat[2][2] + mat[0][3] * m2.mat[3][2];
-			result.mat[0][3] = mat[0][0] * m2.mat[0][3] + mat[0][1] * m2.mat[1][3] + mat[0][2] * m2.mat[2][3] + mat[0][3] * m2.mat[3][3];
-
-			result.mat[1][0] = mat[1][0] * m2.mat[0][0] + mat[1][1] * m2.mat[1][0] + mat[1][2] * m2.mat[2][0] + mat[1][3] * m2.mat[3][0];
-			result.mat[1][1] = mat[1][0] * m2.mat[0][1] + mat[1][1] * m2.mat[1][1] + mat[1][2] * m2.mat[2][1] + mat[1][3] * m2.mat[3][1];
-			result.mat[1][2] = mat[1][0] * m2.mat[0][2] + mat[1][1] * m2.mat[1][2] + mat[1][2] * m2.mat[2][2] + mat[1][3] * m2.mat[3][2];
-			result.mat[1][3] = mat[1][0] * m2.mat[0][3] + mat[1][1] * m2.mat[1][3] + mat[1][2] * m2.mat[2][3] + mat[1][3] * m2.mat[3][3];
-
-			result.mat[2][0] = mat[2][0] * m2.mat[0][0] + mat[2][1] * m2.mat[1][0] + mat[2][2] * m2.mat[2][0] + mat[2][3] * m2.mat[3][0];
-			result.mat[2][1] = mat[2][0] * m2.mat[0][1] + mat[2][1] * m2.mat[1][1] + mat[2][2] * m2.mat[2][1] + mat[2][3] * m2.mat[3][1];
-			result.mat[2][2] = mat[2][0] * m2.mat[0][2] + mat[2][1] * m2.mat[1][2] + mat[2][2] * m2.mat[2][2] + mat[2][3] * m2.mat[3][2];
-			result.mat[2][3] = mat[2][0] * m2.mat[0][3] + mat[2][1] * m2.mat[1][3] + mat[2][2] * m2.mat[2][3] + mat[2][3] * m2.mat[3][3];
-
-			result.mat[3][0] = mat[3][0] * m2.mat[0][0] + mat[3][1] * m2.mat[1][0] + mat[3][2] * m2.mat[2][0] + mat[3][3] * m2.mat[3][0];
-			result.mat[3][1] = mat[3][0] * m2.mat[0][1] + mat[3][1] * m2.mat[1][1] + mat[3][2] * m2.mat[2][1] + mat[3][3] * m2.mat[3][1];
-			result.mat[3][2] = mat[3][0] * m2.mat[0][2] + mat[3][1] * m2.mat[1][2] + mat[3][2] * m2.mat[2][2] + mat[3][3] * m2.mat[3][2];
-			result.mat[3][3] = mat[3][0] * m2.mat[0][3] + mat[3][1] * m2.mat[1][3] + mat[3][2] * m2.mat[2][3] + mat[3][3] * m2.mat[3][3];
-
+			SIMD::MultiplyMatrix(&mat[0][0], &m2.mat[0][0], &result.mat[0][0]);
 			return result;
 		}
 
@@ -406,22 +388,18 @@ namespace AtomEngine
 
 		Matrix4x4 Transpose() const
 		{
-			return Matrix4x4(mat[0][0],
-				mat[1][0],
-				mat[2][0],
-				mat[3][0],
-				mat[0][1],
-				mat[1][1],
-				mat[2][1],
-				mat[3][1],
-				mat[0][2],
-				mat[1][2],
-				mat[2][2],
-				mat[3][2],
-				mat[0][3],
-				mat[1][3],
-				mat[2][3],
-				mat[3][3]);
+			SIMD::Float4 r0 = SIMD::Load(mat[0]);
+			SIMD::Float4 r1 = SIMD::Load(mat[1]);
+			SIMD::Float4 r2 = SIMD::Load(mat[2]);
+			SIMD::Float4 r3 = SIMD::Load(mat[3]);
+			SIMD::Transpose(r0, r1, r2, r3);
+
+			Matrix4x4 result;
+			SIMD::Store(result.mat[0], r0);
+			SIMD::Store(result.mat[1], r1);
+			SIMD::Store(result.mat[2], r2);
+			SIMD::Store(result.mat[3], r3);
+			return result;
 		}
 
 		void setTrans(const Vector3& v)
@@ -695,10 +673,9 @@ namespace AtomEngine
 		{
 			assert(IsAffine());
 
-			return Vector3(
-				mat[0][0] * v.x + mat[1][0] * v.y + mat[2][0] * v.z + mat[3][0],
-				mat[0][1] * v.x + mat[1][1] * v.y + mat[2][1] * v.z + mat[3][1],
-				mat[0][2] * v.x + mat[1][2] * v.y + mat[2][2] * v.z + mat[3][2]);
+			Vector3 result;
+			SIMD::Store3(&result.x, SIMD::TransformRow(SIMD::Set(v.x, v.y, v.z, 1.0f), &mat[0][0]));
+			return result;
 		}
 
 		Vector4 TransformAffine(const Vector4& v) const
@@ -724,6 +701,11 @@ namespace AtomEngine
 
 		Matrix4x4 Inverse() const
 		{
+#if !MATH_SIMD_SCALAR
+			Matrix4x4 result;
+			SIMD::InverseMatrix(&mat[0][0], &result.mat[0][0]);
+			return result;
+#else
 			float m00 = mat[0][0], m01 = mat[0][1], m02 = mat[0][2], m03 = mat[0][3];
 			float m10 = mat[1][0], m11 = mat[1][1], m12 = mat[1][2], m13 = mat[1][3];
 			float m20 = mat[2][0], m21 = mat[2][1], m22 = mat[2][2], m23 = mat[2][3];
@@ -778,6 +760,7 @@ namespace AtomEngine
 			float d33 = +(v3 * m00 - v1 * m01 + v0 * m02) * invDet;
 
 			return Matrix4x4(d00, d01, d02, d03, d10, d11, d12, d13, d20, d21, d22, d23, d30, d31, d32, d33);
+#endif
 		}
 
 		const Vector3 GetX() const { return Vector3(mat[0]); }
@@ -854,27 +837,7 @@ namespace AtomEngine
 
 	inline Matrix4x4 Math::Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
 	{
-		Matrix4x4 result;
-		result.mat[0][0] = m1.mat[0][0] * m2.mat[0][0] + m1.mat[0][1] * m2.mat[1][0] + m1.mat[0][2] * m2.mat[2][0] + m1.mat[0][3] * m2.mat[3][0];
-		result.mat[0][1] = m1.mat[0][0] * m2.mat[0][1] + m1.mat[0][1] * m2.mat[1][1] + m1.mat[0][2] * m2.mat[2][1] + m1.mat[0][3] * m2.mat[3][1];
-		result.mat[0][2] = m1.mat[0][0] * m2.mat[0][2] + m1.mat[0][1] * m2.mat[1][2] + m1.mat[0][2] * m2.mat[2][2] + m1.mat[0][3] * m2.mat[3][2];
-		result.mat[0][3] = m1.mat[0][0] * m2.mat[0][3] + m1.mat[0][1] * m2.mat[1][3] + m1.mat[0][2] * m2.mat[2][3] + m1.mat[0][3] * m2.mat[3][3];
-
-		result.mat[1][0] = m1.mat[1][0] * m2.mat[0][0] + m1.mat[1][1] * m2.mat[1][0] + m1.mat[1][2] * m2.mat[2][0] + m1.mat[1][3] * m2.mat[3][0];
-		result.mat[1][1] = m1.mat[1][0] * m2.mat[0][1] + m1.mat[1][1] * m2.mat[1][1] + m1.mat[1][2] * m2.mat[2][1] + m1.mat[1][3] * m2.mat[3][1];
-		result.mat[1][2] = m1.mat[1][0] * m2.mat[0][2] + m1.mat[1][1] * m2.mat[1][2] + m1.mat[1][2] * m2.mat[2][2] + m1.mat[1][3] * m2.mat[3][2];
-		result.mat[1][3] = m1.mat[1][0] * m2.mat[0][3] + m1.mat[1][1] * m2.mat[1][3] + m1.mat[1][2] * m2.mat[2][3] + m1.mat[1][3] * m2.mat[3][3];
-
-		result.mat[2][0] = m1.mat[2][0] * m2.mat[0][0] + m1.mat[2][1] * m2.mat[1][0] + m1.mat[2][2] * m2.mat[2][0] + m1.mat[2][3] * m2.mat[3][0];
-		result.mat[2][1] = m1.mat[2][0] * m2.mat[0][1] + m1.mat[2][1] * m2.mat[1][1] + m1.mat[2][2] * m2.mat[2][1] + m1.mat[2][3] * m2.mat[3][1];
-		result.mat[2][2] = m1.mat[2][0] * m2.mat[0][2] + m1.mat[2][1] * m2.mat[1][2] + m1.mat[2][2] * m2.mat[2][2] + m1.mat[2][3] * m2.mat[3][2];
-		result.mat[2][3] = m1.mat[2][0] * m2.mat[0][3] + m1.mat[2][1] * m2.mat[1][3] + m1.mat[2][2] * m2.mat[2][3] + m1.mat[2][3] * m2.mat[3][3];
-
-		result.mat[3][0] = m1.mat[3][0] * m2.mat[0][0] + m1.mat[3][1] * m2.mat[1][0] + m1.mat[3][2] * m2.mat[2][0] + m1.mat[3][3] * m2.mat[3][0];
-		result.mat[3][1] = m1.mat[3][0] * m2.mat[0][1] + m1.mat[3][1] * m2.mat[1][1] + m1.mat[3][2] * m2.mat[2][1] + m1.mat[3][3] * m2.mat[3][1];
-		result.mat[3][2] = m1.mat[3][0] * m2.mat[0][2] + m1.mat[3][1] * m2.mat[1][2] + m1.mat[3][2] * m2.mat[2][2] + m1.mat[3][3] * m2.mat[3][2];
-		result.mat[3][3] = m1.mat[3][0] * m2.mat[0][3] + m1.mat[3][1] * m2.mat[1][3] + m1.mat[3][2] * m2.mat[2][3] + m1.mat[3][3] * m2.mat[3][3];
-		return result;
+		return m1 * m2;
 	}
 };
 
@@ -2,26 +2,60 @@
 #include "Vector3.h"
 #include "Matrix3x3.h"
 #include "Matrix4x4.h"
+#include "SIMD.h"
 
 namespace AtomEngine
 {
 	const Quaternion Quaternion::ZERO(0, 0, 0, 0);
 	const Quaternion Quaternion::IDENTITY(0, 0, 0, 1);
 
-	Quaternion Quaternion::operator*(const Quaternion& q) const
+	namespace
 	{
-		Vector3 v1 = Vector3(x, y, z);
-		Vector3 v2 = Vector3(q.x, q.y, q.z);
-
-		float w1 = w;
-		float w2 = q.w;
-
-		float dot = Math::Dot(v1, v2);
-		Vector3 cross = Math::Cross(v1, v2);
+		/**
+		 * @brief 球面線形補間（q0とq1のなす角はcosThetaで渡す）
+		 *
+		 * 3つのsinを1回のSIMD演算でまとめて求める。角度がほぼ0の場合は正規化した線形補間。
+		 * ほぼπ（q1≒-q0）の場合は線形補間がほぼ0になり正規化できないので、
+		 * q0に直交する向きを経由して補間する。
+		 */
+		Quaternion Interpolate(const Quaternion& q0, const Quaternion& q1, float cosTheta, float t)
+		{
+			// 丸め誤差で範囲外になるとacosがNaNになる
+			cosTheta = std::clamp(cosTheta, -1.0f, 1.0f);
+
+			if (cosTheta >= 1 - Math::Epsilon)
+			{
+				Quaternion r = (1.0f - t) * q0 + t * q1;
+				r.Normalize();
+				return r;
+			}
+
+			if (cosTheta <= -1 + Math::Epsilon)
+			{
+				const Quaternion perpendicular(-q0.y, q0.x, -q0.w, q0.z);
+				return std::sin((0.5f - t) * Math::PI) * q0 + std::sin(t * Math::PI) * perpendicular;
+			}
+
+			// (sin((1-t)θ), sin(tθ), sinθ) / sinθ
+			const float theta = std::acos(cosTheta);
+			SIMD::Float4 weights = SIMD::Sin(SIMD::Set((1.0f - t) * theta, t * theta, theta, theta));
+			weights = SIMD::Div(weights, SIMD::SplatLane<2>(weights));
+
+			const SIMD::Float4 r = SIMD::Add(
+				SIMD::Mul(SIMD::Load(q0.ptr()), SIMD::SplatLane<0>(weights)),
+				SIMD::Mul(SIMD::Load(q1.ptr()), SIMD::SplatLane<1>(weights)));
+
+			Quaternion result;
+			SIMD::Store(result.ptr(), r);
+			return result;
+		}
+	}
 
-		float w_ = w1 * w2 - dot;
-		Vector3 v = cross + v1 * w2 + v2 * w1;
-		return Quaternion(v.x, v.y, v.z, w_);
+	Quaternion Quaternion::operator*(const Quaternion& q) const
+	{
+		Quaternion result;
+		SIMD::Store(result.ptr(), SIMD::QuaternionMultiply(SIMD::Load(ptr()), SIMD::Load(q.ptr())));
+		return result;
 	}
 
 	void Quaternion::FromRotationMatrix(const Matrix3x3& rotation)
@@ -105,11 +139,7 @@ namespace AtomEngine
 
 	Quaternion Quaternion::Slerp(const Quaternion& q1, const Quaternion& q2, float t)
 	{
-		float dot = q1.Dot(q2);
-		dot = std::clamp(dot, -1.0f, 1.0f);
-		float theta = Math::acos(dot) * t;
-		Quaternion rel = (q2 - q1 * dot).NormalizeCopy();
-		return q1 * Math::cos(theta) + rel * Math::sin(theta);
+		return Interpolate(q1, q2, q1.Dot(q2), t);
 	}
 
 	Quaternion Quaternion::LookRotation(const Vector3& forward, const Vector3& up)
@@ -224,12 +254,9 @@ namespace AtomEngine
 
 	Vector3 Quaternion::operator*(const Vector3& v) const
 	{
-		Quaternion vq = Quaternion(v.x, v.y, v.z, 0);
-
-		Quaternion temp = (*this) * vq;
-		Quaternion result = temp * this->Conjugate();
-
-		return Vector3{ result.x, result.y, result.z };
+		Vector3 result;
+		SIMD::Store3(&result.x, SIMD::QuaternionRotate(SIMD::Load(ptr()), SIMD::Set(v.x, v.y, v.z, 0.0f)));
+		return result;
 	}
 
 	Radian Quaternion::Yaw(bool reprojectAxis) const
@@ -306,21 +333,7 @@ namespace AtomEngine
 			kt = kq;
 		}
 
-		if (Math::Abs(cos_v) < 1 - Math::Epsilon)
-		{
-			float  sin_v = Math::Sqrt(1 - Math::Sqr(cos_v));
-			Radian angle = Math::atan2(sin_v, cos_v);
-			float  inv_sin = 1.0f / sin_v;
-			float  coeff0 = Math::sin((1.0f - t) * angle) * inv_sin;
-			float  coeff1 = Math::sin(t * angle) * inv_sin;
-			return coeff0 * kp + coeff1 * kt;
-		}
-		else
-		{
-			Quaternion r = (1.0f - t) * kp + t * kt;
-			r.Normalize();
-			return r;
-		}
+		return Interpolate(kp, kt, cos_v, t);
 	}
 
 	Quaternion Lerp(const Quaternion& kp, const Quaternion& kq, float t, bool shortestPath)
@@ -1,7 +0,0 @@
-#include "Random.h"
-
-namespace AtomEngine
-{
-    std::mt19937 Random::randomEngine;
-
-}
\ No newline at end of file
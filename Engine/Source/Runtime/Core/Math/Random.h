@@ -1,4 +1,6 @@
 #pragma once
+#include "RandomGenerator.h"
+
 #include <random>
 #include <vector>
 #include <numeric>
@@ -20,20 +22,28 @@ example:
 	// 0.0 から 1.0 の範囲で 5 個の double をコンテナに格納
 	std::vector<double> random_doubles(5);
 	Random::fill<std::uniform_real_distribution<double>>(random_doubles, 0.0, 1.0);
+
+	呼び出したスレッドごとの生成器（RandomStreams::GetThreadGenerator）を使うので、
+	ジョブの中から呼んでもよい。リプレイで再現させたい処理は
+	RandomGenerator::CreateStreamで作ったシステムごとの生成器を使うこと。
 */
 
 namespace AtomEngine
 {
 	class Random
 	{
-	private:
-
-		static std::mt19937 randomEngine;
-
 	public:
 		static void Initialize(unsigned int seed = std::random_device()())
 		{
-			randomEngine.seed(seed);
+			RandomStreams::Initialize(seed);
+		}
+
+		/// <summary>
+		/// 呼び出したスレッドの乱数生成器を取得します
+		/// </summary>
+		static RandomGenerator& engine()
+		{
+			return RandomStreams::GetThreadGenerator();
 		}
 
 		/// <summary>
@@ -46,29 +56,40 @@ namespace AtomEngine
 		template<typename T>
 		static T uniform(T min, T max)
 		{
-			using Distribution = std::conditional_t<std::is_integral_v<T>,
-				std::uniform_int_distribution<T>,
-				std::uniform_real_distribution<T>>;
-
-			return Distribution(min, max)(randomEngine);
+			if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(int32_t) && std::is_signed_v<T>)
+			{
+				return static_cast<T>(engine().NextInt(min, max));
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				return std::uniform_int_distribution<T>(min, max)(engine());
+			}
+			else if constexpr (std::is_same_v<T, float>)
+			{
+				return engine().NextFloat(min, max);
+			}
+			else
+			{
+				return static_cast<T>(min + (max - min) * engine().NextDouble());
+			}
 		}
 
 		/// <summary>
-		/// [0, 1] の範囲で浮動小数乱数を生成します
+		/// [0, 1) の範囲で浮動小数乱数を生成します
 		/// </summary>
 		/// <returns></returns>
 		static float uniform_unit()
 		{
-			return uniform(0.f, std::nextafter(1.f, FLT_MAX));
+			return engine().NextFloat();
 		}
 
 		/// <summary>
-		/// [-1, 1] の範囲で符号を含む浮動小数乱数を生成します
+		/// [-1, 1) の範囲で符号を含む浮動小数乱数を生成します
 		/// </summary>
 		/// <returns></returns>
 		static float uniform_symmetry()
 		{
-			return uniform(-1.f, std::nextafter(1.f, FLT_MAX));
+			return engine().NextFloat(-1.0f, 1.0f);
 		}
 
 		static int32_t uniform_int(int32_t max)
@@ -83,7 +104,7 @@ namespace AtomEngine
 		/// <returns></returns>
 		static bool bernoulli(float probability)
 		{
-			return std::bernoulli_distribution(probability)(randomEngine);
+			return engine().NextBool(probability);
 		}
 
 		/// <summary>
@@ -94,7 +115,7 @@ namespace AtomEngine
 		/// <returns>生成された乱数（float）</returns>
 		static float normal(float mean, float stddev)
 		{
-			return std::normal_distribution<float>(mean, stddev)(randomEngine);
+			return engine().NextNormal(mean, stddev);
 		}
 
 		/// <summary>
@@ -109,9 +130,10 @@ namespace AtomEngine
 		static void fill(Range& range, Params&&... params)
 		{
 			Distribution dist(std::forward<Params>(params)...);
+			RandomGenerator& generator = engine();
 			std::generate(std::begin(range), std::end(range), [&]
 				{
-					return dist(randomEngine);
+					return dist(generator);
 				});
 		}
 	};
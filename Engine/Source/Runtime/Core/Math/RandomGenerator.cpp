@@ -0,0 +1,186 @@
+#include "RandomGenerator.h"
+#include "Runtime/Core/Job/JobSystem.h"
+
+#include <atomic>
+#include <cmath>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		constexpr uint64_t kJump[4] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+		constexpr uint64_t kLongJump[4] = { 0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull, 0x77710069854EE241ull, 0x39109BB02ACBE635ull };
+
+		/// ワーカー以外のスレッドに割り当てるストリーム番号の開始位置
+		constexpr uint32_t kExternalStreamBase = 256;
+
+		uint64_t SplitMix64(uint64_t& state)
+		{
+			uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		std::atomic<uint64_t> sSeed{ RandomGenerator::kDefaultSeed };
+		std::atomic<uint32_t> sGeneration{ 0 };
+		std::atomic<uint32_t> sExternalStreamCount{ 0 };
+
+		struct ThreadGenerator
+		{
+			RandomGenerator generator;
+			uint32_t generation = ~0u;
+			uint32_t externalIndex = ~0u;
+		};
+		thread_local ThreadGenerator tGenerator;
+	}
+
+	void RandomGenerator::Seed(uint64_t seed)
+	{
+		uint64_t state = seed;
+		for (uint64_t& s : mState)
+			s = SplitMix64(state);
+	}
+
+	RandomGenerator RandomGenerator::CreateStream(uint64_t seed, uint32_t streamIndex)
+	{
+		RandomGenerator generator(seed);
+		for (uint32_t i = 0; i <= streamIndex; ++i)
+			generator.LongJump();
+		return generator;
+	}
+
+	uint32_t RandomGenerator::NextBounded(uint32_t bound)
+	{
+		// 32bit乱数とboundの積の上位32bitを使い、偏りが出る範囲だけ引き直す
+		uint64_t product = static_cast<uint64_t>(NextUInt32()) * bound;
+		uint32_t low = static_cast<uint32_t>(product);
+		if (low < bound)
+		{
+			const uint32_t threshold = (0u - bound) % bound;
+			while (low < threshold)
+			{
+				product = static_cast<uint64_t>(NextUInt32()) * bound;
+				low = static_cast<uint32_t>(product);
+			}
+		}
+		return static_cast<uint32_t>(product >> 32);
+	}
+
+	int32_t RandomGenerator::NextInt(int32_t min, int32_t max)
+	{
+		if (max <= min)
+			return min;
+
+		const uint32_t span = static_cast<uint32_t>(static_cast<int64_t>(max) - min);
+		const uint32_t offset = span == ~0u ? NextUInt32() : NextBounded(span + 1);
+		return static_cast<int32_t>(static_cast<int64_t>(min) + offset);
+	}
+
+	float RandomGenerator::NextNormal(float mean, float stddev)
+	{
+		// u1は(0, 1]にしてlog(0)を避ける
+		const float u1 = 1.0f - NextFloat();
+		const float u2 = NextFloat();
+		const float radius = std::sqrt(-2.0f * std::log(u1));
+		return mean + stddev * radius * std::cos(6.28318531f * u2);
+	}
+
+	void RandomGenerator::Fill(float* out, size_t count, float min, float max)
+	{
+		const float scale = (max - min) * kFloatScale;
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			const uint64_t bits = Next();
+			out[i] = min + static_cast<float>(bits >> 40) * scale;
+			out[i + 1] = min + static_cast<float>((bits >> 8) & 0xFFFFFF) * scale;
+		}
+		if (i < count)
+			out[i] = min + static_cast<float>(Next() >> 40) * scale;
+	}
+
+	void RandomGenerator::Fill(uint32_t* out, size_t count)
+	{
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			const uint64_t bits = Next();
+			out[i] = static_cast<uint32_t>(bits >> 32);
+			out[i + 1] = static_cast<uint32_t>(bits);
+		}
+		if (i < count)
+			out[i] = NextUInt32();
+	}
+
+	void RandomGenerator::Jump()
+	{
+		ApplyJump(kJump);
+	}
+
+	void RandomGenerator::LongJump()
+	{
+		ApplyJump(kLongJump);
+	}
+
+	void RandomGenerator::ApplyJump(const uint64_t (&polynomial)[4])
+	{
+		uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+		for (uint64_t word : polynomial)
+		{
+			for (int b = 0; b < 64; ++b)
+			{
+				if (word & (1ull << b))
+				{
+					s0 ^= mState[0];
+					s1 ^= mState[1];
+					s2 ^= mState[2];
+					s3 ^= mState[3];
+				}
+				Next();
+			}
+		}
+		mState[0] = s0;
+		mState[1] = s1;
+		mState[2] = s2;
+		mState[3] = s3;
+	}
+
+	void RandomStreams::Initialize(uint64_t seed)
+	{
+		sSeed.store(seed, std::memory_order_relaxed);
+		sGeneration.fetch_add(1, std::memory_order_release);
+	}
+
+	uint64_t RandomStreams::GetSeed()
+	{
+		return sSeed.load(std::memory_order_relaxed);
+	}
+
+	RandomGenerator& RandomStreams::GetThreadGenerator()
+	{
+		ThreadGenerator& thread = tGenerator;
+		const uint32_t generation = sGeneration.load(std::memory_order_acquire);
+		if (thread.generation != generation)
+		{
+			uint32_t streamIndex;
+			const int32_t workerIndex = JobSystem::GetWorkerIndex();
+			if (workerIndex >= 0)
+			{
+				streamIndex = static_cast<uint32_t>(workerIndex);
+			}
+			else
+			{
+				if (thread.externalIndex == ~0u)
+					thread.externalIndex = sExternalStreamCount.fetch_add(1, std::memory_order_relaxed);
+				streamIndex = kExternalStreamBase + thread.externalIndex;
+			}
+
+			thread.generator.Seed(sSeed.load(std::memory_order_relaxed));
+			for (uint32_t i = 0; i < streamIndex; ++i)
+				thread.generator.Jump();
+			thread.generation = generation;
+		}
+		return thread.generator;
+	}
+}
@@ -0,0 +1,654 @@
+/**
+ * @file SIMD.h
+ * @brief 4要素浮動小数点ベクトルの移植可能なSIMD抽象化
+ *
+ * コンパイル時にバックエンドを選択する（優先順）:
+ * AVX2 → SSE4.1 → SSE2（x64は常に有効） → NEON（AArch64） → スカラー。
+ * MSVCでは /arch:AVX2 でAVX2、/arch:AVX でSSE4.1のパスが有効になる。
+ * MATH_SIMD_FORCE_SCALARを1にするとスカラー実装を強制する（比較・デバッグ用）。
+ *
+ * 演算順序はスカラー実装と同じにしてあり、FMAは使用しない。
+ * そのため加減乗除のみの処理はどのバックエンドでも同じ結果になる。
+ */
+
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+
+#ifndef MATH_SIMD_FORCE_SCALAR
+#define MATH_SIMD_FORCE_SCALAR 0
+#endif
+
+#if !MATH_SIMD_FORCE_SCALAR && defined(__AVX2__)
+#define MATH_SIMD_AVX2 1
+#else
+#define MATH_SIMD_AVX2 0
+#endif
+
+#if !MATH_SIMD_FORCE_SCALAR && (MATH_SIMD_AVX2 || defined(__AVX__) || defined(__SSE4_1__))
+#define MATH_SIMD_SSE41 1
+#else
+#define MATH_SIMD_SSE41 0
+#endif
+
+#if !MATH_SIMD_FORCE_SCALAR && (MATH_SIMD_SSE41 || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MATH_SIMD_SSE2 1
+#else
+#define MATH_SIMD_SSE2 0
+#endif
+
+#if !MATH_SIMD_FORCE_SCALAR && !MATH_SIMD_SSE2 && (defined(__aarch64__) || defined(_M_ARM64))
+#define MATH_SIMD_NEON 1
+#else
+#define MATH_SIMD_NEON 0
+#endif
+
+#define MATH_SIMD_SCALAR (!MATH_SIMD_SSE2 && !MATH_SIMD_NEON)
+
+#if MATH_SIMD_AVX2
+#include <immintrin.h>
+#elif MATH_SIMD_SSE41
+#include <smmintrin.h>
+#elif MATH_SIMD_SSE2
+#include <emmintrin.h>
+#elif MATH_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace AtomEngine
+{
+	namespace SIMD
+	{
+#if MATH_SIMD_SSE2
+		using Float4 = __m128;
+#elif MATH_SIMD_NEON
+		using Float4 = float32x4_t;
+#else
+		struct Float4
+		{
+			float v[4];
+		};
+#endif
+
+		/// 選択されたバックエンド名（ログ・ベンチマーク用）
+		inline const char* GetBackendName()
+		{
+#if MATH_SIMD_AVX2
+			return "AVX2";
+#elif MATH_SIMD_SSE41
+			return "SSE4.1";
+#elif MATH_SIMD_SSE2
+			return "SSE2";
+#elif MATH_SIMD_NEON
+			return "NEON";
+#else
+			return "Scalar";
+#endif
+		}
+
+		//------------------------------------------------------------------
+		// 読み書き
+		//------------------------------------------------------------------
+
+		/// 4要素を読み込む（アラインメント不要）
+		inline Float4 Load(const float* p)
+		{
+#if MATH_SIMD_SSE2
+			return _mm_loadu_ps(p);
+#elif MATH_SIMD_NEON
+			return vld1q_f32(p);
+#else
+			return { { p[0], p[1], p[2], p[3] } };
+#endif
+		}
+
+		/// 3要素を読み込む（wは0）
+		inline Float4 Load3(const float* p)
+		{
+#if MATH_SIMD_SSE2
+			__m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p)));
+			return _mm_movelh_ps(xy, _mm_load_ss(p + 2));
+#elif MATH_SIMD_NEON
+			return vcombine_f32(vld1_f32(p), vset_lane_f32(p[2], vdup_n_f32(0.0f), 0));
+#else
+			return { { p[0], p[1], p[2], 0.0f } };
+#endif
+		}
+
+		/// 4要素を書き込む（アラインメント不要）
+		inline void Store(float* p, Float4 v)
+		{
+#if MATH_SIMD_SSE2
+			_mm_storeu_ps(p, v);
+#elif MATH_SIMD_NEON
+			vst1q_f32(p, v);
+#else
+			p[0] = v.v[0]; p[1] = v.v[1]; p[2] = v.v[2]; p[3] = v.v[3];
+#endif
+		}
+
+		/// x,y,zの3要素を書き込む
+		inline void Store3(float* p, Float4 v)
+		{
+#if MATH_SIMD_SSE2
+			_mm_store_sd(reinterpret_cast<double*>(p), _mm_castps_pd(v));
+			_mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+#elif MATH_SIMD_NEON
+			vst1_f32(p, vget_low_f32(v));
+			vst1q_lane_f32(p + 2, v, 2);
+#else
+			p[0] = v.v[0]; p[1] = v.v[1]; p[2] = v.v[2];
+#endif
+		}
+
+		inline Float4 Set(float x, float y, float z, float w)
+		{
+#if MATH_SIMD_SSE2
+			return _mm_setr_ps(x, y, z, w);
+#elif MATH_SIMD_NEON
+			const float v[4] = { x, y, z, w };
+			return vld1q_f32(v);
+#else
+			return { { x, y, z, w } };
+#endif
+		}
+
+		inline Float4 Splat(float s)
+		{
+#if MATH_SIMD_SSE2
+			return _mm_set1_ps(s);
+#elif MATH_SIMD_NEON
+			return vdupq_n_f32(s);
+#else
+			return { { s, s, s, s } };
+#endif
+		}
+
+		inline Float4 Zero() { return Splat(0.0f); }
+
+		/// 先頭要素を取り出す
+		inline float GetX(Float4 v)
+		{
+#if MATH_SIMD_SSE2
+			return _mm_cvtss_f32(v);
+#elif MATH_SIMD_NEON
+			return vgetq_lane_f32(v, 0);
+#else
+			return v.v[0];
+#endif
+		}
+
+		//------------------------------------------------------------------
+		// 要素の並べ替え
+		//------------------------------------------------------------------
+
+		/// 結果[i] = v[インデックスi]（各インデックスは0～3）
+		template<int X, int Y, int Z, int W>
+		inline Float4 Swizzle(Float4 v)
+		{
+#if MATH_SIMD_SSE2
+			return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+#elif MATH_SIMD_NEON
+			static const uint8_t kIndices[16] = {
+				X * 4, X * 4 + 1, X * 4 + 2, X * 4 + 3, Y * 4, Y * 4 + 1, Y * 4 + 2, Y * 4 + 3,
+				Z * 4, Z * 4 + 1, Z * 4 + 2, Z * 4 + 3, W * 4, W * 4 + 1, W * 4 + 2, W * 4 + 3 };
+			return vreinterpretq_f32_u8(vqtbl1q_u8(vreinterpretq_u8_f32(v), vld1q_u8(kIndices)));
+#else
+			return { { v.v[X], v.v[Y], v.v[Z], v.v[W] } };
+#endif
+		}
+
+		/// 結果 = (a[X], a[Y], b[Z], b[W])
+		template<int X, int Y, int Z, int W>
+		inline Float4 Shuffle(Float4 a, Float4 b)
+		{
+#if MATH_SIMD_SSE2
+			return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+#elif MATH_SIMD_NEON
+			// bの要素はテーブル上で16バイト後ろにある
+			static const uint8_t kIndices[16] = {
+				X * 4, X * 4 + 1, X * 4 + 2, X * 4 + 3, Y * 4, Y * 4 + 1, Y * 4 + 2, Y * 4 + 3,
+				16 + Z * 4, 16 + Z * 4 + 1, 16 + Z * 4 + 2, 16 + Z * 4 + 3, 16 + W * 4, 16 + W * 4 + 1, 16 + W * 4 + 2, 16 + W * 4 + 3 };
+			uint8x16x2_t table = { { vreinterpretq_u8_f32(a), vreinterpretq_u8_f32(b) } };
+			return vreinterpretq_f32_u8(vqtbl2q_u8(table, vld1q_u8(kIndices)));
+#else
+			return { { a.v[X], a.v[Y], b.v[Z], b.v[W] } };
+#endif
+		}
+
+		/// 指定要素を全要素に複製
+		template<int I>
+		inline Float4 SplatLane(Float4 v)
+		{
+#if MATH_SIMD_NEON
+			return vdupq_laneq_f32(v, I);
+#else
+			return Swizzle<I, I, I, I>(v);
+#endif
+		}
+
+		/// 4x4の転置（行ベクトル4本を列ベクトル4本に並べ替える）
+		inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+		{
+#if MATH_SIMD_SSE2
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+#elif MATH_SIMD_NEON
+			float32x4x2_t t01 = vtrnq_f32(r0, r1);
+			float32x4x2_t t23 = vtrnq_f32(r2, r3);
+			r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+			r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+			r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+			r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+#else
+			const Float4 t0 = r0, t1 = r1, t2 = r2, t3 = r3;
+			r0 = { { t0.v[0], t1.v[0], t2.v[0], t3.v[0] } };
+			r1 = { { t0.v[1], t1.v[1], t2.v[1], t3.v[1] } };
+			r2 = { { t0.v[2], t1.v[2], t2.v[2], t3.v[2] } };
+			r3 = { { t0.v[3], t1.v[3], t2.v[3], t3.v[3] } };
+#endif
+		}
+
+		//------------------------------------------------------------------
+		// 算術
+		//------------------------------------------------------------------
+
+#if MATH_SIMD_SSE2
+		inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+		inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+		inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+		inline Float4 Div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+		inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+		inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+		inline Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a); }
+		inline Float4 Neg(Float4 a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+		inline Float4 Abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+#elif MATH_SIMD_NEON
+		inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+		inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+		inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+		inline Float4 Div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+		inline Float4 Min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+		inline Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+		inline Float4 Sqrt(Float4 a) { return vsqrtq_f32(a); }
+		inline Float4 Neg(Float4 a) { return vnegq_f32(a); }
+		inline Float4 Abs(Float4 a) { return vabsq_f32(a); }
+#else
+		inline Float4 Add(Float4 a, Float4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+		inline Float4 Sub(Float4 a, Float4 b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+		inline Float4 Mul(Float4 a, Float4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+		inline Float4 Div(Float4 a, Float4 b) { return { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } }; }
+		inline Float4 Min(Float4 a, Float4 b) { return { { a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1], a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3] } }; }
+		inline Float4 Max(Float4 a, Float4 b) { return { { a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1], a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3] } }; }
+		inline Float4 Sqrt(Float4 a) { return { { std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3]) } }; }
+		inline Float4 Neg(Float4 a) { return { { -a.v[0], -a.v[1], -a.v[2], -a.v[3] } }; }
+		inline Float4 Abs(Float4 a) { return { { std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]), std::fabs(a.v[3]) } }; }
+#endif
+
+		/// a * b + c（FMAは使わず、スカラーと同じ丸めになる）
+		inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return Add(Mul(a, b), c); }
+
+		/// 4要素の内積を全要素に複製して返す（((x + y) + z) + wの順に加算）
+		inline Float4 Dot4(Float4 a, Float4 b)
+		{
+			Float4 m = Mul(a, b);
+			Float4 s = Add(Add(Add(SplatLane<0>(m), SplatLane<1>(m)), SplatLane<2>(m)), SplatLane<3>(m));
+			return s;
+		}
+
+		/// x,y,zの3要素の内積を全要素に複製して返す
+		inline Float4 Dot3(Float4 a, Float4 b)
+		{
+			Float4 m = Mul(a, b);
+			return Add(Add(SplatLane<0>(m), SplatLane<1>(m)), SplatLane<2>(m));
+		}
+
+		/// x,y,zの外積（wは0）
+		inline Float4 Cross3(Float4 a, Float4 b)
+		{
+			Float4 a1 = Swizzle<1, 2, 0, 3>(a);
+			Float4 b1 = Swizzle<1, 2, 0, 3>(b);
+			Float4 c = Sub(Mul(a, b1), Mul(a1, b));
+			c = Swizzle<1, 2, 0, 3>(c);
+#if MATH_SIMD_SCALAR
+			c.v[3] = 0.0f;
+#else
+			c = Mul(c, Set(1.0f, 1.0f, 1.0f, 0.0f));
+#endif
+			return c;
+		}
+
+		//------------------------------------------------------------------
+		// 比較・マスク
+		//------------------------------------------------------------------
+
+#if MATH_SIMD_SSE2
+		inline Float4 CmpLT(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+		inline Float4 CmpLE(Float4 a, Float4 b) { return _mm_cmple_ps(a, b); }
+		inline Float4 CmpGT(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+		inline Float4 CmpGE(Float4 a, Float4 b) { return _mm_cmpge_ps(a, b); }
+		inline Float4 And(Float4 a, Float4 b) { return _mm_and_ps(a, b); }
+		inline Float4 Or(Float4 a, Float4 b) { return _mm_or_ps(a, b); }
+		inline Float4 AndNot(Float4 mask, Float4 b) { return _mm_andnot_ps(mask, b); }
+
+		/// 各要素の符号ビット（比較結果なら真の要素）をビット0～3に詰めて返す
+		inline uint32_t MoveMask(Float4 mask) { return static_cast<uint32_t>(_mm_movemask_ps(mask)); }
+
+		/// maskが真の要素はb、偽の要素はaを選ぶ
+		inline Float4 Select(Float4 a, Float4 b, Float4 mask)
+		{
+#if MATH_SIMD_SSE41
+			return _mm_blendv_ps(a, b, mask);
+#else
+			return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+#endif
+		}
+#elif MATH_SIMD_NEON
+		inline Float4 CmpLT(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+		inline Float4 CmpLE(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+		inline Float4 CmpGT(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+		inline Float4 CmpGE(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+		inline Float4 And(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+		inline Float4 Or(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+		inline Float4 AndNot(Float4 mask, Float4 b) { return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(b), vreinterpretq_u32_f32(mask))); }
+
+		inline uint32_t MoveMask(Float4 mask)
+		{
+			const int32_t shifts[4] = { 0, 1, 2, 3 };
+			uint32x4_t bits = vshlq_u32(vshrq_n_u32(vreinterpretq_u32_f32(mask), 31), vld1q_s32(shifts));
+			return vaddvq_u32(bits);
+		}
+
+		inline Float4 Select(Float4 a, Float4 b, Float4 mask)
+		{
+			return vbslq_f32(vreinterpretq_u32_f32(mask), b, a);
+		}
+#else
+		namespace Detail
+		{
+			inline float MaskValue(bool b)
+			{
+				const uint32_t bits = b ? 0xFFFFFFFFu : 0u;
+				float f;
+				std::memcpy(&f, &bits, sizeof(f));
+				return f;
+			}
+
+			inline uint32_t Bits(float f)
+			{
+				uint32_t bits;
+				std::memcpy(&bits, &f, sizeof(bits));
+				return bits;
+			}
+
+			inline float FromBits(uint32_t bits)
+			{
+				float f;
+				std::memcpy(&f, &bits, sizeof(f));
+				return f;
+			}
+		}
+
+		inline Float4 CmpLT(Float4 a, Float4 b) { return { { Detail::MaskValue(a.v[0] < b.v[0]), Detail::MaskValue(a.v[1] < b.v[1]), Detail::MaskValue(a.v[2] < b.v[2]), Detail::MaskValue(a.v[3] < b.v[3]) } }; }
+		inline Float4 CmpLE(Float4 a, Float4 b) { return { { Detail::MaskValue(a.v[0] <= b.v[0]), Detail::MaskValue(a.v[1] <= b.v[1]), Detail::MaskValue(a.v[2] <= b.v[2]), Detail::MaskValue(a.v[3] <= b.v[3]) } }; }
+		inline Float4 CmpGT(Float4 a, Float4 b) { return CmpLT(b, a); }
+		inline Float4 CmpGE(Float4 a, Float4 b) { return CmpLE(b, a); }
+
+		inline Float4 And(Float4 a, Float4 b)
+		{
+			Float4 r;
+			for (int i = 0; i < 4; ++i) r.v[i] = Detail::FromBits(Detail::Bits(a.v[i]) & Detail::Bits(b.v[i]));
+			return r;
+		}
+
+		inline Float4 Or(Float4 a, Float4 b)
+		{
+			Float4 r;
+			for (int i = 0; i < 4; ++i) r.v[i] = Detail::FromBits(Detail::Bits(a.v[i]) | Detail::Bits(b.v[i]));
+			return r;
+		}
+
+		inline Float4 AndNot(Float4 mask, Float4 b)
+		{
+			Float4 r;
+			for (int i = 0; i < 4; ++i) r.v[i] = Detail::FromBits(~Detail::Bits(mask.v[i]) & Detail::Bits(b.v[i]));
+			return r;
+		}
+
+		inline uint32_t MoveMask(Float4 mask)
+		{
+			uint32_t r = 0;
+			for (int i = 0; i < 4; ++i) r |= (Detail::Bits(mask.v[i]) >> 31) << i;
+			return r;
+		}
+
+		inline Float4 Select(Float4 a, Float4 b, Float4 mask)
+		{
+			return Or(AndNot(mask, a), And(mask, b));
+		}
+#endif
+
+		/**
+		 * @brief 各要素のsin（入力は-π～πの範囲）
+		 *
+		 * ±π/2を超える値は折り返し、11次のミニマックス多項式で近似する（誤差は1e-6程度）。
+		 */
+		inline Float4 Sin(Float4 x)
+		{
+			const Float4 pi = Splat(3.14159265f);
+			const Float4 halfPi = Splat(1.57079633f);
+
+			// sin(x) = sin(π - x) = sin(-π - x)
+			x = Select(x, Sub(pi, x), CmpGT(x, halfPi));
+			x = Select(x, Sub(Neg(pi), x), CmpLT(x, Neg(halfPi)));
+
+			const Float4 x2 = Mul(x, x);
+			Float4 r = Splat(-2.3889859e-08f);
+			r = Add(Mul(r, x2), Splat(2.7525562e-06f));
+			r = Add(Mul(r, x2), Splat(-0.00019840874f));
+			r = Add(Mul(r, x2), Splat(0.0083333310f));
+			r = Add(Mul(r, x2), Splat(-0.16666667f));
+			r = Add(Mul(r, x2), Splat(1.0f));
+			return Mul(r, x);
+		}
+
+		//------------------------------------------------------------------
+		// 4x4行列（行優先のfloat[16]）
+		//------------------------------------------------------------------
+
+		/**
+		 * @brief 行列の積 out = a * b
+		 *
+		 * 結果の各行は ((a[r][0]*b0 + a[r][1]*b1) + a[r][2]*b2) + a[r][3]*b3 で、
+		 * スカラーの行列積と同じ演算順序になる。outはaまたはbと同じでもよい。
+		 */
+		inline void MultiplyMatrix(const float* a, const float* b, float* out)
+		{
+#if MATH_SIMD_AVX2
+			// 2行ずつ処理する（bの各行を上下128bitに複製）
+			const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 0));
+			const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+			const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+			const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+			const __m256 a01 = _mm256_loadu_ps(a);
+			const __m256 a23 = _mm256_loadu_ps(a + 8);
+
+			__m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), b0);
+			r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1));
+			r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xAA), b2));
+			r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xFF), b3));
+
+			__m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x00), b0);
+			r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x55), b1));
+			r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xAA), b2));
+			r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xFF), b3));
+
+			_mm256_storeu_ps(out, r01);
+			_mm256_storeu_ps(out + 8, r23);
+#else
+			const Float4 b0 = Load(b + 0);
+			const Float4 b1 = Load(b + 4);
+			const Float4 b2 = Load(b + 8);
+			const Float4 b3 = Load(b + 12);
+			Float4 rows[4];
+			for (int r = 0; r < 4; ++r)
+			{
+				const Float4 row = Load(a + r * 4);
+				Float4 sum = Mul(SplatLane<0>(row), b0);
+				sum = Add(sum, Mul(SplatLane<1>(row), b1));
+				sum = Add(sum, Mul(SplatLane<2>(row), b2));
+				sum = Add(sum, Mul(SplatLane<3>(row), b3));
+				rows[r] = sum;
+			}
+			for (int r = 0; r < 4; ++r)
+				Store(out + r * 4, rows[r]);
+#endif
+		}
+
+		/**
+		 * @brief 行ベクトルと行列の積 v * m（mは行優先のfloat[16]）
+		 */
+		inline Float4 TransformRow(Float4 v, const float* m)
+		{
+			Float4 sum = Mul(SplatLane<0>(v), Load(m + 0));
+			sum = Add(sum, Mul(SplatLane<1>(v), Load(m + 4)));
+			sum = Add(sum, Mul(SplatLane<2>(v), Load(m + 8)));
+			return Add(sum, Mul(SplatLane<3>(v), Load(m + 12)));
+		}
+
+		namespace Detail
+		{
+			// 2x2行列（行優先で1本のFloat4に格納）の演算
+
+			/// a * b
+			inline Float4 Mat2Mul(Float4 a, Float4 b)
+			{
+				return Add(Mul(a, Swizzle<0, 3, 0, 3>(b)), Mul(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+			}
+
+			/// adj(a) * b
+			inline Float4 Mat2AdjMul(Float4 a, Float4 b)
+			{
+				return Sub(Mul(Swizzle<3, 3, 0, 0>(a), b), Mul(Swizzle<1, 1, 2, 2>(a), Swizzle<2, 3, 0, 1>(b)));
+			}
+
+			/// a * adj(b)
+			inline Float4 Mat2MulAdj(Float4 a, Float4 b)
+			{
+				return Sub(Mul(a, Swizzle<3, 0, 3, 0>(b)), Mul(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+			}
+		}
+
+		/**
+		 * @brief 一般の4x4行列の逆行列
+		 *
+		 * 2x2ブロックに分けて余因子を計算する。行列式が0の場合の結果は不定（スカラー版と同様）。
+		 * outはmと同じでもよい。
+		 */
+		inline void InverseMatrix(const float* m, float* out)
+		{
+			const Float4 r0 = Load(m + 0);
+			const Float4 r1 = Load(m + 4);
+			const Float4 r2 = Load(m + 8);
+			const Float4 r3 = Load(m + 12);
+
+			// | A B |
+			// | C D |
+			const Float4 A = Shuffle<0, 1, 0, 1>(r0, r1);
+			const Float4 B = Shuffle<2, 3, 2, 3>(r0, r1);
+			const Float4 C = Shuffle<0, 1, 0, 1>(r2, r3);
+			const Float4 D = Shuffle<2, 3, 2, 3>(r2, r3);
+
+			// (|A|, |B|, |C|, |D|)
+			const Float4 detSub = Sub(
+				Mul(Shuffle<0, 2, 0, 2>(r0, r2), Shuffle<1, 3, 1, 3>(r1, r3)),
+				Mul(Shuffle<1, 3, 1, 3>(r0, r2), Shuffle<0, 2, 0, 2>(r1, r3)));
+			const Float4 detA = SplatLane<0>(detSub);
+			const Float4 detB = SplatLane<1>(detSub);
+			const Float4 detC = SplatLane<2>(detSub);
+			const Float4 detD = SplatLane<3>(detSub);
+
+			const Float4 DC = Detail::Mat2AdjMul(D, C);
+			const Float4 AB = Detail::Mat2AdjMul(A, B);
+
+			Float4 X = Sub(Mul(detD, A), Detail::Mat2Mul(B, DC));
+			Float4 W = Sub(Mul(detA, D), Detail::Mat2Mul(C, AB));
+			Float4 Y = Sub(Mul(detB, C), Detail::Mat2MulAdj(D, AB));
+			Float4 Z = Sub(Mul(detC, B), Detail::Mat2MulAdj(A, DC));
+
+			// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+			const Float4 tr = Mul(AB, Swizzle<0, 2, 1, 3>(DC));
+			const Float4 trSum = Add(Add(Add(SplatLane<0>(tr), SplatLane<1>(tr)), SplatLane<2>(tr)), SplatLane<3>(tr));
+			const Float4 detM = Sub(Add(Mul(detA, detD), Mul(detB, detC)), trSum);
+
+			const Float4 invDet = Div(Set(1.0f, -1.0f, -1.0f, 1.0f), detM);
+			X = Mul(X, invDet);
+			Y = Mul(Y, invDet);
+			Z = Mul(Z, invDet);
+			W = Mul(W, invDet);
+
+			// 2x2ブロックの余因子の並べ替えと書き込み
+			Store(out + 0, Shuffle<3, 1, 3, 1>(X, Y));
+			Store(out + 4, Shuffle<2, 0, 2, 0>(X, Y));
+			Store(out + 8, Shuffle<3, 1, 3, 1>(Z, W));
+			Store(out + 12, Shuffle<2, 0, 2, 0>(Z, W));
+		}
+
+		/**
+		 * @brief 単位四元数(x,y,z,w)から回転行列の上3行（w列は0）を作る
+		 *
+		 * 行ベクトル規約（v * M）の回転行列で、Matrix4x4(const Quaternion&)と同じ向き。
+		 */
+		inline void QuaternionToRows(Float4 q, Float4& row0, Float4& row1, Float4& row2)
+		{
+			const Float4 q2 = Add(q, q);                      // (2x, 2y, 2z, 2w)
+			const Float4 sq = Mul(q, q2);                     // (2xx, 2yy, 2zz, 2ww)
+
+			// 対角成分 (1-2yy-2zz, 1-2xx-2zz, 1-2xx-2yy, -)
+			const Float4 diag = Sub(Sub(Splat(1.0f), Swizzle<1, 0, 0, 3>(sq)), Swizzle<2, 2, 1, 3>(sq));
+
+			const Float4 p = Mul(Swizzle<0, 0, 1, 3>(q), Swizzle<2, 1, 2, 3>(q2));    // (2xz, 2xy, 2yz, -)
+			const Float4 r = Mul(SplatLane<3>(q), Swizzle<1, 2, 0, 3>(q2));            // (2wy, 2wz, 2wx, -)
+			const Float4 sum = Add(p, r);                     // (2xz+2wy, 2xy+2wz, 2yz+2wx, -)
+			const Float4 diff = Sub(p, r);                    // (2xz-2wy, 2xy-2wz, 2yz-2wx, -)
+			const Float4 zero = Zero();
+
+			// row0 = (diag.x, sum.y, diff.x, 0)
+			row0 = Shuffle<0, 2, 0, 2>(Shuffle<0, 0, 1, 1>(diag, sum), Shuffle<0, 0, 3, 3>(diff, zero));
+			// row1 = (diff.y, diag.y, sum.z, 0)
+			row1 = Shuffle<0, 2, 0, 2>(Shuffle<1, 1, 1, 1>(diff, diag), Shuffle<2, 2, 0, 0>(sum, zero));
+			// row2 = (sum.x, diff.z, diag.z, 0)
+			row2 = Shuffle<0, 2, 0, 2>(Shuffle<0, 0, 2, 2>(sum, diff), Shuffle<2, 2, 0, 0>(diag, zero));
+		}
+
+		/**
+		 * @brief 四元数の積 a * b（Quaternion::operator*と同じ規約）
+		 */
+		inline Float4 QuaternionMultiply(Float4 a, Float4 b)
+		{
+			Float4 r = Mul(SplatLane<3>(a), b);
+			r = Add(r, Mul(Mul(SplatLane<0>(a), Swizzle<3, 2, 1, 0>(b)), Set(1.0f, -1.0f, 1.0f, -1.0f)));
+			r = Add(r, Mul(Mul(SplatLane<1>(a), Swizzle<2, 3, 0, 1>(b)), Set(1.0f, 1.0f, -1.0f, -1.0f)));
+			r = Add(r, Mul(Mul(SplatLane<2>(a), Swizzle<1, 0, 3, 2>(b)), Set(-1.0f, 1.0f, 1.0f, -1.0f)));
+			return r;
+		}
+
+		/**
+		 * @brief 四元数によるベクトルの回転 q * v * conj(q)（vのwは0）
+		 *
+		 * (w^2 - |u|^2)v + 2(u・v)u + 2w(u×v) で計算するため、単位四元数でなくても
+		 * 四元数の積による定義と一致する。
+		 */
+		inline Float4 QuaternionRotate(Float4 q, Float4 v)
+		{
+			const Float4 u = Mul(q, Set(1.0f, 1.0f, 1.0f, 0.0f));
+			const Float4 w = SplatLane<3>(q);
+			const Float4 s = Sub(Mul(w, w), Dot3(u, u));
+			const Float4 d = Dot3(u, v);
+			Float4 r = Mul(s, v);
+			r = Add(r, Mul(Add(d, d), u));
+			r = Add(r, Mul(Add(w, w), Cross3(u, v)));
+			return r;
+		}
+	}
+}
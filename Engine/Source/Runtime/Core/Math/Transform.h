@@ -11,7 +11,6 @@ namespace AtomEngine
 		Vector3 transition{ Vector3::ZERO };
 		Vector3 scale{ Vector3::UNIT_SCALE };
 		Quaternion rotation{ Quaternion::IDENTITY };
-		Transform* parent = nullptr;
 
 		Transform() = default;
 
@@ -32,18 +31,12 @@ namespace AtomEngine
 		{
 			Matrix4x4 temp;
 			temp.MakeAffine(scale, rotation, transition);
-			if (parent)
-				return temp * parent->GetMatrix();
 			return temp;
 		}
 
 		const Matrix3x3 GetMatrix3x3() const
 		{
-			Matrix4x4 temp;
-			temp.MakeAffine(scale, rotation, transition);
-			if (parent)
-				return Matrix3x3(temp) * parent->GetMatrix3x3();
-			return Matrix3x3(temp);
+			return Matrix3x3(GetMatrix());
 		}
 
 		void SetScale(float s) { scale = s; }
@@ -62,9 +55,8 @@ namespace AtomEngine
 			return BoundingSphere(*this * sphere.GetCenter(), GetScale() * sphere.GetRadius());
 		}
 
-		inline Vector3 GetWorldPosition()
+		inline Vector3 GetWorldPosition() const
 		{
-			Matrix4x4 tmp = GetMatrix();
 			return GetMatrix().GetTrans();
 		}
 	};
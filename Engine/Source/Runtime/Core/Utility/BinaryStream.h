@@ -0,0 +1,162 @@
+/**
+ * @file BinaryStream.h
+ * @brief バイト列への書き込みと読み出し
+ *
+ * キャッシュファイルなど、同じビルドで書いて読むバイナリデータ用。
+ * 値はメモリ上の表現のまま並べるので、ポインタやデストラクタを持たない型だけを扱う
+ * （Matrix4x4のようにコピーコンストラクタを定義しているだけの型は含める）。
+ * 読み出しは範囲を確認し、足りなければ以降の読み出しも全て失敗する。
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace AtomEngine
+{
+	/// バイト列としてそのまま読み書きできる型
+	template<typename T>
+	constexpr bool kIsBinaryCopyable = std::is_trivially_destructible_v<T> && std::is_standard_layout_v<T> && !std::is_pointer_v<T>;
+
+	/**
+	 * @class BinaryWriter
+	 * @brief バッファの末尾に追記する
+	 */
+	class BinaryWriter
+	{
+	public:
+		explicit BinaryWriter(std::vector<uint8_t>& buffer) : mBuffer(buffer) {}
+
+		void WriteBytes(const void* data, size_t size)
+		{
+			if (size == 0)
+				return;
+			const size_t offset = mBuffer.size();
+			mBuffer.resize(offset + size);
+			std::memcpy(mBuffer.data() + offset, data, size);
+		}
+
+		template<typename T>
+		void Write(const T& value)
+		{
+			static_assert(kIsBinaryCopyable<T>, "T must be binary copyable");
+			WriteBytes(&value, sizeof(T));
+		}
+
+		/// 要素数（uint32）に続けて要素を書く
+		template<typename T>
+		void WriteArray(const T* data, size_t count)
+		{
+			static_assert(kIsBinaryCopyable<T>, "T must be binary copyable");
+			Write(static_cast<uint32_t>(count));
+			WriteBytes(data, count * sizeof(T));
+		}
+
+		template<typename T>
+		void WriteArray(const std::vector<T>& values) { WriteArray(values.data(), values.size()); }
+
+		void WriteString(const std::string& value) { WriteArray(value.data(), value.size()); }
+		void WriteString(const std::wstring& value) { WriteArray(value.data(), value.size()); }
+
+		/**
+		 * @brief 0を詰めて位置をalignmentの倍数に揃える
+		 * @return 揃えた後の位置
+		 */
+		size_t Align(size_t alignment)
+		{
+			mBuffer.resize((mBuffer.size() + alignment - 1) / alignment * alignment, 0);
+			return mBuffer.size();
+		}
+
+		size_t GetOffset() const { return mBuffer.size(); }
+
+	private:
+		std::vector<uint8_t>& mBuffer;
+	};
+
+	/**
+	 * @class BinaryReader
+	 * @brief バイト列を先頭から読む（データはコピーしない）
+	 */
+	class BinaryReader
+	{
+	public:
+		BinaryReader() = default;
+		BinaryReader(const uint8_t* data, size_t size) : mData(data), mSize(size) {}
+
+		bool ReadBytes(void* out, size_t size)
+		{
+			if (mFailed || size > mSize - mOffset)
+			{
+				mFailed = true;
+				return false;
+			}
+			if (size > 0)
+				std::memcpy(out, mData + mOffset, size);
+			mOffset += size;
+			return true;
+		}
+
+		template<typename T>
+		bool Read(T& value)
+		{
+			static_assert(kIsBinaryCopyable<T>, "T must be binary copyable");
+			return ReadBytes(&value, sizeof(T));
+		}
+
+		/**
+		 * @brief 可変長の要素数を読む
+		 *
+		 * どの要素も1バイト以上あるので、残りのバイト数を超える数は壊れているとみなす。
+		 */
+		bool ReadCount(uint32_t& count)
+		{
+			if (!Read(count) || count > mSize - mOffset)
+			{
+				mFailed = true;
+				return false;
+			}
+			return true;
+		}
+
+		/// WriteArrayで書いた配列を読む
+		template<typename T>
+		bool ReadArray(std::vector<T>& values)
+		{
+			static_assert(kIsBinaryCopyable<T>, "T must be binary copyable");
+			uint32_t count = 0;
+			if (!Read(count) || count > (mSize - mOffset) / sizeof(T))
+			{
+				mFailed = true;
+				return false;
+			}
+			values.resize(count);
+			return ReadBytes(values.data(), count * sizeof(T));
+		}
+
+		template<typename CharT>
+		bool ReadString(std::basic_string<CharT>& value)
+		{
+			uint32_t count = 0;
+			if (!Read(count) || count > (mSize - mOffset) / sizeof(CharT))
+			{
+				mFailed = true;
+				return false;
+			}
+			value.resize(count);
+			return ReadBytes(value.data(), count * sizeof(CharT));
+		}
+
+		bool IsFailed() const { return mFailed; }
+
+	private:
+		const uint8_t* mData = nullptr;
+		size_t mSize = 0;
+		size_t mOffset = 0;
+		bool mFailed = false;
+	};
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include "Runtime/Core/Math/Math.h"
 
@@ -50,6 +52,76 @@ namespace AtomEngine
 		return HashRange((uint32_t*)StateDesc, (uint32_t*)(StateDesc + Count), Hash);
 	}
 
-}
+	/**
+	 * @brief バイト列の64ビットハッシュ（XXH64）
+	 *
+	 * ファイルの内容が変わったかどうかの判定など、衝突しにくさが必要な用途に使う。
+	 * 32バイトごとに4本の独立した累積値で処理するので、大きなデータでも速い。
+	 */
+	inline uint64_t HashBytes64(const void* Data, size_t Size, uint64_t Seed = 0)
+	{
+		constexpr uint64_t P1 = 0x9E3779B185EBCA87ull;
+		constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4Full;
+		constexpr uint64_t P3 = 0x165667B19E3779F9ull;
+		constexpr uint64_t P4 = 0x85EBCA77C2B2AE63ull;
+		constexpr uint64_t P5 = 0x27D4EB2F165667C5ull;
+
+		auto Rotl = [](uint64_t X, int R) { return (X << R) | (X >> (64 - R)); };
+		auto Read64 = [](const uint8_t* P) { uint64_t V; std::memcpy(&V, P, 8); return V; };
+		auto Read32 = [](const uint8_t* P) { uint32_t V; std::memcpy(&V, P, 4); return V; };
+		auto Round = [&](uint64_t Acc, uint64_t Input) { return Rotl(Acc + Input * P2, 31) * P1; };
+		auto Merge = [&](uint64_t Acc, uint64_t Val) { return (Acc ^ Round(0, Val)) * P1 + P4; };
+
+		const uint8_t* Iter = static_cast<const uint8_t*>(Data);
+		const uint8_t* const End = Iter + Size;
+		uint64_t Hash;
+
+		if (Size >= 32)
+		{
+			uint64_t V1 = Seed + P1 + P2;
+			uint64_t V2 = Seed + P2;
+			uint64_t V3 = Seed;
+			uint64_t V4 = Seed - P1;
+			do
+			{
+				V1 = Round(V1, Read64(Iter));
+				V2 = Round(V2, Read64(Iter + 8));
+				V3 = Round(V3, Read64(Iter + 16));
+				V4 = Round(V4, Read64(Iter + 24));
+				Iter += 32;
+			} while (Iter + 32 <= End);
+
+			Hash = Rotl(V1, 1) + Rotl(V2, 7) + Rotl(V3, 12) + Rotl(V4, 18);
+			Hash = Merge(Hash, V1);
+			Hash = Merge(Hash, V2);
+			Hash = Merge(Hash, V3);
+			Hash = Merge(Hash, V4);
+		}
+		else
+		{
+			Hash = Seed + P5;
+		}
+
+		Hash += static_cast<uint64_t>(Size);
 
+		for (; Iter + 8 <= End; Iter += 8)
+			Hash = Rotl(Hash ^ Round(0, Read64(Iter)), 27) * P1 + P4;
+
+		if (Iter + 4 <= End)
+		{
+			Hash = Rotl(Hash ^ (static_cast<uint64_t>(Read32(Iter)) * P1), 23) * P2 + P3;
+			Iter += 4;
+		}
+
+		for (; Iter < End; ++Iter)
+			Hash = Rotl(Hash ^ (*Iter * P5), 11) * P1;
+
+		Hash ^= Hash >> 33;
+		Hash *= P2;
+		Hash ^= Hash >> 29;
+		Hash *= P3;
+		Hash ^= Hash >> 32;
+		return Hash;
+	}
 
+}
\ No newline at end of file
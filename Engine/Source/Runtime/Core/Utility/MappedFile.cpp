@@ -0,0 +1,76 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#define NOMINMAX
+#include <Windows.h>
+
+namespace AtomEngine
+{
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			mFile = std::exchange(other.mFile, nullptr);
+			mMapping = std::exchange(other.mMapping, nullptr);
+			mData = std::exchange(other.mData, nullptr);
+			mSize = std::exchange(other.mSize, 0);
+		}
+		return *this;
+	}
+
+	bool MappedFile::Open(const std::wstring& filePath)
+	{
+		Close();
+
+		HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		mFile = file;
+
+		LARGE_INTEGER size = {};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+		{
+			Close();
+			return false;
+		}
+
+		mMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mMapping == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		mData = static_cast<const uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+		if (mData == nullptr)
+		{
+			Close();
+			return false;
+		}
+		mSize = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (mData)
+			UnmapViewOfFile(mData);
+		if (mMapping)
+			CloseHandle(mMapping);
+		if (mFile)
+			CloseHandle(mFile);
+
+		mFile = nullptr;
+		mMapping = nullptr;
+		mData = nullptr;
+		mSize = 0;
+	}
+}
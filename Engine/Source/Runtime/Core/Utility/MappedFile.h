@@ -0,0 +1,50 @@
+/**
+ * @file MappedFile.h
+ * @brief 読み取り専用のメモリマップトファイル
+ *
+ * ファイルの内容をコピーせずにアドレス空間へ割り当てる。実際の読み込みは
+ * アクセスしたページだけOSが行うので、大きなファイルでも開くコストはほぼ一定になる。
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace AtomEngine
+{
+	/**
+	 * @class MappedFile
+	 * @brief ファイル全体を読み取り専用で割り当てる（コピー不可、ムーブ可）
+	 */
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile() { Close(); }
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		/**
+		 * @brief ファイルを割り当てる
+		 * @param filePath ファイルパス
+		 * @return 成功したらtrue（空のファイルは失敗）
+		 */
+		bool Open(const std::wstring& filePath);
+
+		void Close();
+
+		bool IsOpen() const { return mData != nullptr; }
+		const uint8_t* GetData() const { return mData; }
+		size_t GetSize() const { return mSize; }
+
+	private:
+		void* mFile = nullptr;      ///< ファイルのハンドル
+		void* mMapping = nullptr;   ///< ファイルマッピングのハンドル
+		const uint8_t* mData = nullptr;
+		size_t mSize = 0;
+	};
+}
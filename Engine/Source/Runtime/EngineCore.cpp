@@ -1,5 +1,6 @@
 #include "EngineCore.h"
 #include "Runtime/Core/LogSystem/LogSystem.h"
+#include "Runtime/Core/LogSystem/EventLog.h"
 #include "Runtime/Function/Global/GlobalContext.h"
 #include "Runtime/Function/Render/WindowManager.h"
 #include "Runtime/Function/Input/Input.h"
@@ -55,7 +56,7 @@ namespace Engine
 
 		app.Update(deltaTime);
 
-		Renderer::Update(app.GetWorld(), deltaTime);
+		Renderer::Update(app.GetWorld(), app.GetCamera(), deltaTime);
 	}
 
 	void AtomEngine::RenderTick(GameApp& app,float deltaTime)
@@ -100,6 +101,7 @@ namespace Engine
 	void AtomEngine::Tick(GameApp& app, float deltaTime)
 	{
 		gContext.imgui->Begin();
+		EventLog::NextFrame();
 
 		LogicalTick(app,deltaTime);
 		CalculateFPS(deltaTime);
@@ -0,0 +1,644 @@
+#include "AnimationBenchmark.h"
+#include "AnimationSampler.h"
+#include "AnimationBlend.h"
+#include "Animator.h"
+#include "CpuSkinning.h"
+#include "Runtime/Resource/SkinPacking.h"
+#include "Runtime/Core/LogSystem/LogSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		/// 比較するトラック数
+		constexpr int kTrackCount = 200;
+
+		/// 1トラックあたりのサンプリング回数
+		constexpr int kSamplesPerTrack = 3000;
+
+		/// 1トラックの最大キー数
+		constexpr uint32_t kMaxKeyCount = 300;
+
+		/// 計測用クリップのカーブ数
+		constexpr uint32_t kCurveCount = 64;
+
+		/// 計測で進めるフレーム数
+		constexpr int kPlaybackFrames = 600;
+
+		constexpr float kFrameTime = 1.0f / 60.0f;
+
+		/// ブレンドの計測で混ぜるポーズ数
+		constexpr uint32_t kBlendPoseCount = 4;
+
+		/// ブレンドの計測のジョイント数
+		constexpr uint32_t kBlendJointCount = 4096;
+
+		/// Animatorの確認に使うジョイント数
+		constexpr uint32_t kAnimatorJointCount = 4;
+
+		/// スキニングの確認に使うジョイント数と頂点数（4の倍数でない端数を含める）
+		constexpr uint32_t kSkinningJointCount = 16;
+		constexpr uint32_t kSkinningVertexCount = 20003;
+
+		/// 影響の数を揃える頂点のまとまり（4頂点とも影響が少ないと影響のループを早く抜ける）
+		constexpr uint32_t kSkinningBlockSize = 64;
+
+		// 比較用のスカラー実装（SIMD化する前の計算）
+		namespace Reference
+		{
+			void Blend(const JointPose* const* poses, const float* weights, uint32_t poseCount, JointPose* out, uint32_t jointCount)
+			{
+				float totalWeight = 0.0f;
+				for (uint32_t p = 0; p < poseCount; ++p)
+					totalWeight += weights[p];
+
+				for (uint32_t j = 0; j < jointCount; ++j)
+				{
+					const Quaternion& reference = poses[0][j].rotation;
+					Quaternion rotation(0.0f, 0.0f, 0.0f, 0.0f);
+					Vector3 translation(0.0f, 0.0f, 0.0f), scale(0.0f, 0.0f, 0.0f);
+					for (uint32_t p = 0; p < poseCount; ++p)
+					{
+						const JointPose& pose = poses[p][j];
+						const float w = weights[p] / totalWeight;
+						rotation = rotation + (pose.rotation.Dot(reference) < 0.0f ? -pose.rotation : pose.rotation) * w;
+						translation += pose.translation * w;
+						scale += pose.scale * w;
+					}
+					rotation.Normalize();
+					out[j] = { rotation, translation, scale };
+				}
+			}
+
+			/// 行ベクトルの点の変換（平行移動を含む）
+			Vector3 TransformPoint(const Vector3& p, const Matrix4x4& m)
+			{
+				return Vector3(
+					p.x * m.mat[0][0] + p.y * m.mat[1][0] + p.z * m.mat[2][0] + m.mat[3][0],
+					p.x * m.mat[0][1] + p.y * m.mat[1][1] + p.z * m.mat[2][1] + m.mat[3][1],
+					p.x * m.mat[0][2] + p.y * m.mat[1][2] + p.z * m.mat[2][2] + m.mat[3][2]);
+			}
+
+			/// 行ベクトルの方向の変換
+			template<typename MatrixType>
+			Vector3 TransformVector(const Vector3& v, const MatrixType& m)
+			{
+				return Vector3(
+					v.x * m.mat[0][0] + v.y * m.mat[1][0] + v.z * m.mat[2][0],
+					v.x * m.mat[0][1] + v.y * m.mat[1][1] + v.z * m.mat[2][1],
+					v.x * m.mat[0][2] + v.y * m.mat[1][2] + v.z * m.mat[2][2]);
+			}
+
+			/// ハミルトン積 a * b
+			Quaternion Multiply(const Quaternion& a, const Quaternion& b)
+			{
+				return Quaternion(
+					a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+					a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+					a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+					a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z);
+			}
+
+			// 1頂点ずつ、ウェイト0の影響も含めて4つ全てを足す
+			void SkinLinear(const SkinningVertices& in, const JointVertex* joints, const JointXform* palette, SkinningVertices& out)
+			{
+				for (size_t v = 0; v < in.GetCount(); ++v)
+				{
+					float weights[SkinPacking::kMaxInfluences];
+					SkinPacking::DecodeWeights(joints[v], weights);
+					const Vector3 position(in.positionX[v], in.positionY[v], in.positionZ[v]);
+					const Vector3 normal(in.normalX[v], in.normalY[v], in.normalZ[v]);
+
+					Vector3 outPosition(0.0f, 0.0f, 0.0f), outNormal(0.0f, 0.0f, 0.0f);
+					for (uint32_t k = 0; k < SkinPacking::kMaxInfluences; ++k)
+					{
+						const JointXform& xform = palette[joints[v].jointIndices[k]];
+						outPosition += TransformPoint(position, xform.posXform) * weights[k];
+						outNormal += TransformVector(normal, xform.nrmXform) * weights[k];
+					}
+					outNormal.Normalize();
+
+					out.positionX[v] = outPosition.x; out.positionY[v] = outPosition.y; out.positionZ[v] = outPosition.z;
+					out.normalX[v] = outNormal.x; out.normalY[v] = outNormal.y; out.normalZ[v] = outNormal.z;
+				}
+			}
+
+			// 影響ごとにデュアルクォータニオンを作って足し、正規化した回転を行列に戻して変換する
+			void SkinDualQuaternion(const SkinningVertices& in, const JointVertex* joints, const JointXform* palette, SkinningVertices& out)
+			{
+				for (size_t v = 0; v < in.GetCount(); ++v)
+				{
+					float weights[SkinPacking::kMaxInfluences];
+					SkinPacking::DecodeWeights(joints[v], weights);
+
+					Quaternion pivot, real(0.0f, 0.0f, 0.0f, 0.0f), dual(0.0f, 0.0f, 0.0f, 0.0f);
+					for (uint32_t k = 0; k < SkinPacking::kMaxInfluences; ++k)
+					{
+						const Matrix4x4& m = palette[joints[v].jointIndices[k]].posXform;
+						Quaternion rotation{ Matrix3x3(m) };
+						rotation.Normalize();
+						const Quaternion translation(m.mat[3][0], m.mat[3][1], m.mat[3][2], 0.0f);
+
+						if (k == 0)
+							pivot = rotation;
+						const float weight = rotation.Dot(pivot) < 0.0f ? -weights[k] : weights[k];
+						real = real + rotation * weight;
+						dual = dual + Multiply(translation, rotation) * (0.5f * weight);
+					}
+
+					const float lengthSqr = real.Dot(real);
+					const Quaternion translation = Multiply(dual, real.Conjugate()) * (2.0f / lengthSqr);
+					const Matrix3x3 rotation(real / std::sqrt(lengthSqr));
+
+					const Vector3 position(in.positionX[v], in.positionY[v], in.positionZ[v]);
+					const Vector3 outPosition = TransformVector(position, rotation) + Vector3(translation.x, translation.y, translation.z);
+					Vector3 outNormal = TransformVector(Vector3(in.normalX[v], in.normalY[v], in.normalZ[v]), rotation);
+					outNormal.Normalize();
+
+					out.positionX[v] = outPosition.x; out.positionY[v] = outPosition.y; out.positionZ[v] = outPosition.z;
+					out.normalX[v] = outNormal.x; out.normalY[v] = outNormal.y; out.normalZ[v] = outNormal.z;
+				}
+			}
+		}
+
+		/// 平行移動・回転を同じ時刻に持つトラック
+		struct Track
+		{
+			std::vector<KeyframeVec3> values;
+			std::vector<KeyframeQuat> rotations;
+			float duration = 0.0f;
+		};
+
+		/// 時刻の動かし方
+		enum class SamplePattern
+		{
+			Forward,    ///< 1フレームずつ進めて末尾でループする
+			Scrub,      ///< 前後に少しずつ動かす
+			Seek,       ///< 範囲外を含む任意の時刻に飛ぶ
+			KeyTime,    ///< キーちょうどの時刻
+			NaN,
+			Count,
+		};
+
+		template<typename Func>
+		double MeasureMilliseconds(int iterations, Func&& func)
+		{
+			using namespace std::chrono;
+			const auto start = steady_clock::now();
+			for (int i = 0; i < iterations; ++i)
+				func();
+			return duration<double, std::milli>(steady_clock::now() - start).count();
+		}
+
+		template<typename T>
+		bool BitEqual(const T& a, const T& b)
+		{
+			return std::memcmp(&a, &b, sizeof(T)) == 0;
+		}
+
+		bool Report(const char* name, double scalarMs, double optimizedMs, size_t mismatches)
+		{
+			const bool passed = mismatches == 0;
+			Log("[AnimationBenchmark]:%-18s scalar %8.3f ms  cursor %8.3f ms  x%5.2f  mismatches %zu%s\n",
+				name, scalarMs, optimizedMs, scalarMs / std::max(optimizedMs, 1e-6), mismatches, passed ? "" : "  (NG)");
+			return passed;
+		}
+
+		bool Report(const char* name, double scalarMs, double simdMs, float error, float tolerance)
+		{
+			const bool passed = error <= tolerance;
+			Log("[AnimationBenchmark]:%-18s scalar %8.3f ms  simd %8.3f ms  x%5.2f  max error %.3g%s\n",
+				name, scalarMs, simdMs, scalarMs / std::max(simdMs, 1e-6), error, passed ? "" : "  (NG)");
+			return passed;
+		}
+
+		/// 計測を伴わない確認の結果
+		bool Report(const char* name, float error, float tolerance)
+		{
+			const bool passed = error <= tolerance;
+			Log("[AnimationBenchmark]:%-18s max error %.3g%s\n", name, error, passed ? "" : "  (NG)");
+			return passed;
+		}
+
+		/**
+		 * @brief 間隔がばらばらで、同じ時刻のキーも含むトラックを作る
+		 */
+		Track MakeTrack(std::mt19937& engine, uint32_t keyCount)
+		{
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+			Track track;
+			float time = 0.1f * static_cast<float>(engine() % 5);
+			for (uint32_t k = 0; k < keyCount; ++k)
+			{
+				Quaternion rotation(unit(engine), unit(engine), unit(engine), unit(engine));
+				rotation.Normalize();
+				track.values.push_back({ time, Vector3(unit(engine), unit(engine), unit(engine)) });
+				track.rotations.push_back({ time, rotation });
+
+				// 7回に1回は次のキーを同じ時刻にする
+				if (engine() % 7 != 0)
+					time += kFrameTime * static_cast<float>(1 + engine() % 3);
+			}
+			track.duration = time + 0.2f;
+			return track;
+		}
+
+		/**
+		 * @brief 時刻を指定のパターンで動かす
+		 */
+		float NextTime(std::mt19937& engine, const Track& track, SamplePattern pattern, float time)
+		{
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			switch (pattern)
+			{
+			case SamplePattern::Forward:
+				time = std::isnan(time) ? 0.0f : time + kFrameTime;
+				return time >= track.duration ? std::fmod(time, track.duration) : time;
+			case SamplePattern::Scrub:
+				time = std::isnan(time) ? 0.0f : time + unit(engine) * kFrameTime * 4.0f;
+				return std::clamp(time, -0.1f, track.duration * 1.1f);
+			case SamplePattern::Seek:
+				return unit(engine) * track.duration * 1.5f;
+			case SamplePattern::KeyTime:
+				return track.values[engine() % track.values.size()].time;
+			default:
+				return std::nanf("");
+			}
+		}
+
+		/**
+		 * @brief ランダムな再生・スクラブ・シークでカーソル付きの結果を線形探索と比べる
+		 * @return 一致しなかったサンプル数
+		 */
+		size_t VerifySampler(std::mt19937& engine)
+		{
+			size_t mismatches = 0;
+			for (int trackIndex = 0; trackIndex < kTrackCount; ++trackIndex)
+			{
+				const Track track = MakeTrack(engine, 1 + engine() % kMaxKeyCount);
+				uint32_t cursors[4] = {};
+
+				// 同じパターンを数十サンプル続けてから切り替える
+				SamplePattern pattern = SamplePattern::Forward;
+				float time = -0.1f;
+				for (int sample = 0; sample < kSamplesPerTrack; ++sample)
+				{
+					if (engine() % 32 == 0)
+						pattern = static_cast<SamplePattern>(engine() % static_cast<uint32_t>(SamplePattern::Count));
+					time = NextTime(engine, track, pattern, time);
+
+					mismatches += !BitEqual(AnimationSampler::SampleValue(track.values, time, cursors[0]),
+						CalculateValue(track.values, time));
+					mismatches += !BitEqual(AnimationSampler::SampleRotation(track.rotations, time, cursors[1]),
+						CaculateRotation(track.rotations, time));
+					mismatches += !BitEqual(AnimationSampler::SampleValueLoop(track.values, time, track.duration, cursors[2]),
+						CalculateValueLoop(track.values, time, track.duration));
+					mismatches += !BitEqual(AnimationSampler::SampleRotationLoop(track.rotations, time, track.duration, cursors[3]),
+						CalculateRotationLoop(track.rotations, time, track.duration));
+				}
+			}
+			return mismatches;
+		}
+
+		/**
+		 * @brief 計測用のクリップ（全カーブが同じ長さ）を作る
+		 */
+		AnimationClip MakeClip(std::mt19937& engine)
+		{
+			AnimationClip clip;
+			clip.duration = 0.0f;
+			for (uint32_t i = 0; i < kCurveCount; ++i)
+			{
+				const Track track = MakeTrack(engine, kMaxKeyCount);
+				AnimationCurve curve;
+				curve.translation = track.values;
+				curve.rotation = track.rotations;
+				curve.scale = track.values;
+				curve.targetJoint = i;
+				clip.curves.push_back(std::move(curve));
+				clip.duration = std::max(clip.duration, track.duration);
+			}
+			return clip;
+		}
+
+		/// 全ジョイントの差の最大値（回転は成分の差、回転の符号は区別しない）
+		float PoseError(const JointPose* actual, const JointPose* expected, uint32_t jointCount)
+		{
+			float error = 0.0f;
+			for (uint32_t j = 0; j < jointCount; ++j)
+			{
+				const Quaternion rotation = actual[j].rotation.Dot(expected[j].rotation) < 0.0f ? -actual[j].rotation : actual[j].rotation;
+				const float values[] = {
+					(rotation - expected[j].rotation).Length(),
+					(actual[j].translation - expected[j].translation).Length(),
+					(actual[j].scale - expected[j].scale).Length(),
+				};
+				for (float value : values)
+					error = std::isnan(value) ? 1.0f : std::max(error, value);
+			}
+			return error;
+		}
+
+		/// 位置と法線の差の最大値（各成分）
+		float SkinningError(const SkinningVertices& actual, const SkinningVertices& expected)
+		{
+			const std::vector<float>* actualArrays[] = { &actual.positionX, &actual.positionY, &actual.positionZ, &actual.normalX, &actual.normalY, &actual.normalZ };
+			const std::vector<float>* expectedArrays[] = { &expected.positionX, &expected.positionY, &expected.positionZ, &expected.normalX, &expected.normalY, &expected.normalZ };
+			float error = 0.0f;
+			for (size_t a = 0; a < std::size(actualArrays); ++a)
+			{
+				for (size_t v = 0; v < actual.GetCount(); ++v)
+				{
+					const float difference = std::abs((*actualArrays[a])[v] - (*expectedArrays[a])[v]);
+					error = std::isnan(difference) ? 1.0f : std::max(error, difference);
+				}
+			}
+			return error;
+		}
+
+		/**
+		 * @brief 指定ジョイントを一定の姿勢に保つクリップ（キー1つ）を作る
+		 * @param joints 動かすジョイントとその姿勢
+		 */
+		AnimationClip MakeConstantClip(std::initializer_list<std::pair<uint32_t, JointPose>> joints)
+		{
+			AnimationClip clip;
+			clip.duration = 1.0f;
+			for (const auto& [joint, pose] : joints)
+			{
+				AnimationCurve curve;
+				curve.translation = { { 0.0f, pose.translation } };
+				curve.rotation = { { 0.0f, pose.rotation } };
+				curve.scale = { { 0.0f, pose.scale } };
+				curve.targetJoint = joint;
+				clip.curves.push_back(std::move(curve));
+			}
+			return clip;
+		}
+
+		/**
+		 * @brief Animatorの再生・クロスフェード・レイヤーの結果を手計算の値と比べる
+		 * @return 期待値との差の最大値（再生状態が違う場合は1）
+		 */
+		float VerifyAnimator()
+		{
+			const Quaternion turn(Radian(Math::HalfPI), Vector3::UP);
+			const Quaternion halfTurn(Radian(Math::PIDiv4), Vector3::UP);
+			auto pose = [](float x, const Quaternion& rotation = Quaternion::IDENTITY)
+				{
+					return JointPose{ rotation, Vector3(x, 0.0f, 0.0f), Vector3(1.0f, 1.0f, 1.0f) };
+				};
+
+			// 0: ジョイント0,1を+1、1: ジョイント1,2を+3（ジョイント1は回転も）、2: ジョイント0を+2
+			const AnimationClip clips[] = {
+				MakeConstantClip({ { 0, pose(1.0f) }, { 1, pose(1.0f) } }),
+				MakeConstantClip({ { 1, pose(3.0f, turn) }, { 2, pose(3.0f) } }),
+				MakeConstantClip({ { 0, pose(2.0f) } }),
+			};
+			const JointPose bindPose[kAnimatorJointCount] = { pose(0.0f), pose(0.0f), pose(0.0f), pose(0.0f) };
+			JointPose result[kAnimatorJointCount];
+
+			float error = 0.0f;
+			auto expect = [&](Animator& animator, float deltaTime, std::initializer_list<JointPose> expected)
+				{
+					if (!animator.Update(deltaTime, clips, {}, bindPose, result, kAnimatorJointCount))
+					{
+						error = 1.0f;
+						return;
+					}
+					error = std::max(error, PoseError(result, expected.begin(), kAnimatorJointCount));
+				};
+			auto expectState = [&](bool condition) { error = condition ? error : 1.0f; };
+
+			{
+				// 何も再生していなければフェード時間を指定してもバインドポーズからフェードしない
+				Animator animator;
+				animator.CrossFade(0, 0, 0.2f, true);
+				expect(animator, 0.05f, { pose(1.0f), pose(1.0f), pose(0.0f), pose(0.0f) });
+
+				// 0.2秒のクロスフェードの中間は半分ずつ（回転は最短経路のnlerp）
+				animator.CrossFade(0, 1, 0.2f, true);
+				expect(animator, 0.1f, { pose(0.5f), pose(2.0f, halfTurn), pose(1.5f), pose(0.0f) });
+				expectState(animator.IsPlaying(0) && animator.IsPlaying(1));
+
+				// 終わると切り替え前のクリップは取り除かれる
+				expect(animator, 0.1f, { pose(0.0f), pose(3.0f, turn), pose(3.0f), pose(0.0f) });
+				expectState(!animator.IsPlaying(0) && animator.IsPlaying(1));
+
+				// 加算レイヤー（ジョイント0だけ、重み0.5）はバインドポーズとの差を足す
+				const uint32_t additive = animator.AddLayer(Animator::BlendMode::kAdditive, 0.5f);
+				animator.SetLayerMask(additive, { 1.0f, 0.0f, 0.0f, 0.0f });
+				animator.Play(additive, 2, 0.0f, true);
+				expect(animator, 0.05f, { pose(1.0f), pose(3.0f, turn), pose(3.0f), pose(0.0f) });
+			}
+
+			{
+				// 全クリップの同時ループは、後のクリップがカーブを持つジョイントだけを上書きする
+				Animator animator;
+				animator.LoopAll(clips, kAnimatorJointCount);
+				expect(animator, 0.05f, { pose(2.0f), pose(3.0f, turn), pose(3.0f), pose(0.0f) });
+				expectState(animator.IsPlaying(0) && animator.IsPlaying(1) && animator.IsPlaying(2));
+
+				// 1つだけ再生し直すと他のクリップのレイヤーは止まる
+				animator.StopLoopAll();
+				animator.CrossFade(0, 0, 0.2f, true);
+				expect(animator, 0.05f, { pose(1.0f), pose(1.0f), pose(0.0f), pose(0.0f) });
+				expectState(animator.IsPlaying(0) && !animator.IsPlaying(1) && !animator.IsPlaying(2));
+
+				// 2回目はレイヤーを使い回す
+				const uint32_t layerCount = animator.GetLayerCount();
+				animator.LoopAll(clips, kAnimatorJointCount);
+				expect(animator, 0.05f, { pose(2.0f), pose(3.0f, turn), pose(3.0f), pose(0.0f) });
+				expectState(animator.GetLayerCount() == layerCount);
+			}
+			return error;
+		}
+	}
+
+	bool AnimationBenchmark::Run(int iterations)
+	{
+		std::mt19937 engine(12345);
+		Log("[AnimationBenchmark]:%d tracks x %d samples, clip %u curves x %u keys x %d frames\n",
+			kTrackCount, kSamplesPerTrack, kCurveCount, kMaxKeyCount, kPlaybackFrames);
+
+		bool passed = true;
+
+		{
+			const size_t samplerMismatches = VerifySampler(engine);
+
+			// ループ再生で全カーブを毎フレーム評価する（MeshComponentの使い方）
+			const AnimationClip clip = MakeClip(engine);
+
+			std::vector<JointPose> expected(kCurveCount), actual(kCurveCount);
+			AnimationCursor cursor;
+			size_t mismatches = samplerMismatches;
+
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					float time = 0.0f;
+					for (int frame = 0; frame < kPlaybackFrames; ++frame)
+					{
+						time = std::fmod(time + kFrameTime, clip.duration);
+						for (const AnimationCurve& curve : clip.curves)
+						{
+							JointPose& joint = expected[curve.targetJoint];
+							joint.translation = CalculateValue(curve.translation, time);
+							joint.rotation = CaculateRotation(curve.rotation, time);
+							joint.scale = CalculateValue(curve.scale, time);
+						}
+					}
+				});
+			const double cursorMs = MeasureMilliseconds(iterations, [&]()
+				{
+					float time = 0.0f;
+					for (int frame = 0; frame < kPlaybackFrames; ++frame)
+					{
+						time = std::fmod(time + kFrameTime, clip.duration);
+						AnimationSampler::SampleClip(clip, time, cursor, actual.data(), kCurveCount);
+					}
+				});
+
+			for (uint32_t i = 0; i < kCurveCount; ++i)
+			{
+				mismatches += !BitEqual(expected[i].translation, actual[i].translation);
+				mismatches += !BitEqual(expected[i].rotation, actual[i].rotation);
+				mismatches += !BitEqual(expected[i].scale, actual[i].scale);
+			}
+			passed &= Report("Sample Keyframes", scalarMs, cursorMs, mismatches);
+		}
+
+		{
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			std::vector<JointPose> poses(kBlendPoseCount * kBlendJointCount);
+			for (JointPose& pose : poses)
+			{
+				pose.rotation = Quaternion(unit(engine), unit(engine), unit(engine), unit(engine));
+				pose.rotation.Normalize();
+				pose.translation = Vector3(unit(engine), unit(engine), unit(engine));
+				pose.scale = Vector3(1.0f, 1.0f, 1.0f) + Vector3(unit(engine), unit(engine), unit(engine)) * 0.5f;
+			}
+			const JointPose* inputs[kBlendPoseCount];
+			float weights[kBlendPoseCount];
+			for (uint32_t p = 0; p < kBlendPoseCount; ++p)
+			{
+				inputs[p] = poses.data() + p * kBlendJointCount;
+				weights[p] = static_cast<float>(p + 1);
+			}
+
+			std::vector<JointPose> expected(kBlendJointCount), actual(kBlendJointCount);
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					Reference::Blend(inputs, weights, kBlendPoseCount, expected.data(), kBlendJointCount);
+				});
+			const double simdMs = MeasureMilliseconds(iterations, [&]()
+				{
+					AnimationBlend::Blend(inputs, weights, kBlendPoseCount, actual.data(), kBlendJointCount);
+				});
+			passed &= Report("Blend Poses", scalarMs, simdMs, PoseError(actual.data(), expected.data(), kBlendJointCount), 1e-5f);
+		}
+
+		passed &= Report("Animator", VerifyAnimator(), 1e-5f);
+
+		{
+			// 剛体変換のパレット（デュアルクォータニオンはスケールを扱わないので、両方の方法で同じ結果の基準になる）
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			std::vector<JointXform> palette(kSkinningJointCount);
+			for (JointXform& xform : palette)
+			{
+				Quaternion rotation(unit(engine), unit(engine), unit(engine), unit(engine));
+				rotation.Normalize();
+				xform.posXform = Transform(Vector3(unit(engine), unit(engine), unit(engine)), rotation, Vector3::UNIT_SCALE).GetMatrix();
+				xform.nrmXform = Math::InverseTranspose(xform.posXform);
+			}
+
+			// 影響の数はまとまりごとに1つ、2つ、1～4つ、1～6つ（5つ目以降は捨てられる）。順不同で渡してSkinPackingで並べる
+			std::uniform_int_distribution<uint32_t> jointDistribution(0, kSkinningJointCount - 1);
+			std::uniform_real_distribution<float> weightDistribution(0.05f, 1.0f);
+			std::vector<SkinInfluence> influences;
+			for (uint32_t v = 0; v < kSkinningVertexCount; ++v)
+			{
+				uint32_t influenceCount = 0;
+				switch ((v / kSkinningBlockSize) % 4)
+				{
+				case 0: influenceCount = 1; break;
+				case 1: influenceCount = 2; break;
+				case 2: influenceCount = 1 + jointDistribution(engine) % 4; break;
+				default: influenceCount = 1 + jointDistribution(engine) % 6; break;
+				}
+				for (uint32_t i = 0; i < influenceCount; ++i)
+					influences.push_back({ v, jointDistribution(engine), weightDistribution(engine) });
+			}
+			std::shuffle(influences.begin(), influences.end(), engine);
+			std::vector<JointVertex> joints;
+			SkinPacking::Pack(influences.data(), influences.size(), kSkinningVertexCount, kSkinningJointCount, 0, joints);
+
+			// 影響のループはウェイトが大きい順に並んでいることを前提に、4頂点とも0になった所で抜ける
+			bool sortedWeights = true;
+			for (const JointVertex& vertex : joints)
+			{
+				for (uint32_t k = 1; k < SkinPacking::kMaxInfluences; ++k)
+					sortedWeights &= vertex.weights[k] <= vertex.weights[k - 1];
+			}
+
+			SkinningVertices bindPose;
+			bindPose.Resize(kSkinningVertexCount);
+			for (uint32_t v = 0; v < kSkinningVertexCount; ++v)
+			{
+				Vector3 normal(unit(engine), unit(engine), unit(engine) + 2.0f);
+				normal.Normalize();
+				bindPose.positionX[v] = unit(engine); bindPose.positionY[v] = unit(engine); bindPose.positionZ[v] = unit(engine);
+				bindPose.normalX[v] = normal.x; bindPose.normalY[v] = normal.y; bindPose.normalZ[v] = normal.z;
+			}
+
+			SkinningVertices expected, actual;
+			expected.Resize(kSkinningVertexCount);
+			actual.Resize(kSkinningVertexCount);
+
+			SkinningJob job;
+			job.positions = bindPose.GetPositions();
+			job.normals = bindPose.GetNormals();
+			job.joints = joints.data();
+			job.palette = palette.data();
+			job.paletteCount = kSkinningJointCount;
+			job.vertexCount = kSkinningVertexCount;
+			job.outPositions = actual.GetPositions();
+			job.outNormals = actual.GetNormals();
+
+			const struct
+			{
+				const char* name;
+				SkinningMethod method;
+				void (*reference)(const SkinningVertices&, const JointVertex*, const JointXform*, SkinningVertices&);
+			} methods[] = {
+				{ "Skin Linear", SkinningMethod::kLinear, Reference::SkinLinear },
+				{ "Skin Dual Quat", SkinningMethod::kDualQuaternion, Reference::SkinDualQuaternion },
+			};
+			for (const auto& method : methods)
+			{
+				job.method = method.method;
+				const double scalarMs = MeasureMilliseconds(iterations, [&]()
+					{
+						method.reference(bindPose, joints.data(), palette.data(), expected);
+					});
+				const double simdMs = MeasureMilliseconds(iterations, [&]()
+					{
+						CpuSkinning::Skin(job);
+					});
+
+				// ウェイトの並びが崩れていれば、早く抜けた分の影響が落ちるので失敗にする
+				const float error = sortedWeights ? SkinningError(actual, expected) : 1.0f;
+				passed &= Report(method.name, scalarMs, simdMs, error, 1e-4f);
+			}
+		}
+
+		return passed;
+	}
+}
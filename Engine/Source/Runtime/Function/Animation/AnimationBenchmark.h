@@ -0,0 +1,27 @@
+/**
+ * @file AnimationBenchmark.h
+ * @brief アニメーション処理の高速化前後の比較と検証
+ *
+ * エディタを --math-benchmark 引数付きで起動するとMathBenchmarkに続けて実行され、結果をログに出力する。
+ * 従来の実装（キーの線形探索など）をscalarの欄に出す。入力は固定のシードで生成するので毎回同じになる。
+ */
+
+#pragma once
+
+namespace AtomEngine
+{
+	/**
+	 * @class AnimationBenchmark
+	 * @brief アニメーションのサンプリングなどの速度と結果の一致の確認
+	 */
+	class AnimationBenchmark
+	{
+	public:
+		/**
+		 * @brief 全ての計測と検証を行い、処理時間と結果をログに出力する
+		 * @param iterations 各計測の繰り返し回数
+		 * @return 全ての結果が従来の実装と一致すればtrue
+		 */
+		static bool Run(int iterations = 10);
+	};
+}
@@ -0,0 +1,179 @@
+#include "AnimationBlend.h"
+#include "Runtime/Core/Math/SIMD.h"
+#include "Runtime/Resource/Skeleton.h"
+#include "Runtime/Resource/Animation.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		using namespace SIMD;
+
+		/// 長さ0の場合は単位四元数を返す正規化
+		inline Float4 NormalizeQuaternion(Float4 q)
+		{
+			const Float4 lengthSqr = Dot4(q, q);
+			const Float4 normalized = Div(q, Sqrt(lengthSqr));
+			return Select(normalized, Set(0.0f, 0.0f, 0.0f, 1.0f), CmpLE(lengthSqr, Splat(1e-12f)));
+		}
+
+		/// referenceと同じ半球に揃える（qと-qは同じ回転）
+		inline Float4 AlignHemisphere(Float4 q, Float4 reference)
+		{
+			return Select(q, Neg(q), CmpLT(Dot4(q, reference), Zero()));
+		}
+
+		/// 最短経路のnlerp
+		inline Float4 Nlerp(Float4 a, Float4 b, Float4 t)
+		{
+			b = AlignHemisphere(b, a);
+			return NormalizeQuaternion(MulAdd(Sub(b, a), t, a));
+		}
+
+		inline float GetJointWeight(float weight, const float* jointWeights, uint32_t joint)
+		{
+			return jointWeights ? weight * jointWeights[joint] : weight;
+		}
+	}
+
+	void AnimationBlend::Blend(const JointPose* const* poses, const float* weights, uint32_t poseCount, JointPose* out, uint32_t jointCount)
+	{
+		assert(poseCount > 0);
+
+		float totalWeight = 0.0f;
+		for (uint32_t p = 0; p < poseCount; ++p)
+			totalWeight += weights[p];
+
+		if (!(totalWeight > 0.0f))
+		{
+			if (out != poses[0])
+				std::copy(poses[0], poses[0] + jointCount, out);
+			return;
+		}
+
+		const float invTotal = 1.0f / totalWeight;
+		for (uint32_t j = 0; j < jointCount; ++j)
+		{
+			const Float4 reference = Load(poses[0][j].rotation.ptr());
+			Float4 rotation = Zero();
+			Float4 translation = Zero();
+			Float4 scale = Zero();
+
+			for (uint32_t p = 0; p < poseCount; ++p)
+			{
+				const JointPose& pose = poses[p][j];
+				const Float4 w = Splat(weights[p] * invTotal);
+				rotation = MulAdd(AlignHemisphere(Load(pose.rotation.ptr()), reference), w, rotation);
+				translation = MulAdd(Load3(pose.translation.ptr()), w, translation);
+				scale = MulAdd(Load3(pose.scale.ptr()), w, scale);
+			}
+
+			Store(out[j].rotation.ptr(), NormalizeQuaternion(rotation));
+			Store3(out[j].translation.ptr(), translation);
+			Store3(out[j].scale.ptr(), scale);
+		}
+	}
+
+	void AnimationBlend::Lerp(const JointPose* from, const JointPose* to, float t, const float* jointWeights, JointPose* out, uint32_t jointCount)
+	{
+		for (uint32_t j = 0; j < jointCount; ++j)
+		{
+			const float weight = GetJointWeight(t, jointWeights, j);
+			if (weight <= 0.0f)
+			{
+				if (out != from)
+					out[j] = from[j];
+				continue;
+			}
+
+			const Float4 w = Splat(weight);
+			const Float4 fromTranslation = Load3(from[j].translation.ptr());
+			const Float4 fromScale = Load3(from[j].scale.ptr());
+
+			Store(out[j].rotation.ptr(), Nlerp(Load(from[j].rotation.ptr()), Load(to[j].rotation.ptr()), w));
+			Store3(out[j].translation.ptr(), MulAdd(Sub(Load3(to[j].translation.ptr()), fromTranslation), w, fromTranslation));
+			Store3(out[j].scale.ptr(), MulAdd(Sub(Load3(to[j].scale.ptr()), fromScale), w, fromScale));
+		}
+	}
+
+	void AnimationBlend::MakeAdditive(const JointPose* pose, const JointPose* reference, JointPose* out, uint32_t jointCount)
+	{
+		const Float4 conjugateSign = Set(-1.0f, -1.0f, -1.0f, 1.0f);
+		for (uint32_t j = 0; j < jointCount; ++j)
+		{
+			const Float4 inverseReference = Mul(Load(reference[j].rotation.ptr()), conjugateSign);
+			const Float4 rotation = QuaternionMultiply(inverseReference, Load(pose[j].rotation.ptr()));
+			const Float4 translation = Sub(Load3(pose[j].translation.ptr()), Load3(reference[j].translation.ptr()));
+			const Float4 scale = Div(Load3(pose[j].scale.ptr()), Set(reference[j].scale.x, reference[j].scale.y, reference[j].scale.z, 1.0f));
+
+			Store(out[j].rotation.ptr(), NormalizeQuaternion(rotation));
+			Store3(out[j].translation.ptr(), translation);
+			Store3(out[j].scale.ptr(), scale);
+		}
+	}
+
+	void AnimationBlend::ApplyAdditive(const JointPose* base, const JointPose* additive, float weight, const float* jointWeights, JointPose* out, uint32_t jointCount)
+	{
+		const Float4 identity = Set(0.0f, 0.0f, 0.0f, 1.0f);
+		const Float4 one = Splat(1.0f);
+		for (uint32_t j = 0; j < jointCount; ++j)
+		{
+			const float jointWeight = GetJointWeight(weight, jointWeights, j);
+			if (jointWeight <= 0.0f)
+			{
+				if (out != base)
+					out[j] = base[j];
+				continue;
+			}
+
+			const Float4 w = Splat(jointWeight);
+			const Float4 delta = Nlerp(identity, Load(additive[j].rotation.ptr()), w);
+			const Float4 rotation = QuaternionMultiply(Load(base[j].rotation.ptr()), delta);
+			const Float4 translation = MulAdd(Load3(additive[j].translation.ptr()), w, Load3(base[j].translation.ptr()));
+			const Float4 scale = Mul(Load3(base[j].scale.ptr()), MulAdd(Sub(Load3(additive[j].scale.ptr()), one), w, one));
+
+			Store(out[j].rotation.ptr(), NormalizeQuaternion(rotation));
+			Store3(out[j].translation.ptr(), translation);
+			Store3(out[j].scale.ptr(), scale);
+		}
+	}
+
+	std::vector<float> AnimationBlend::MakeJointMask(const Skeleton& skeleton, uint32_t rootJoint, float weight)
+	{
+		const uint32_t jointCount = static_cast<uint32_t>(skeleton.joints.size());
+		std::vector<float> mask(jointCount, 0.0f);
+		if (rootJoint >= jointCount)
+			return mask;
+
+		// 親は子より前にあるので、1回の走査で親の所属を子に伝えられる
+		std::vector<uint8_t> inside(jointCount, 0);
+		inside[rootJoint] = 1;
+		for (uint32_t j = rootJoint + 1; j < jointCount; ++j)
+		{
+			const Joint& joint = skeleton.joints[j];
+			if (joint.parent && inside[*joint.parent])
+				inside[j] = 1;
+		}
+
+		for (uint32_t j = 0; j < jointCount; ++j)
+		{
+			if (inside[j])
+				mask[j] = weight;
+		}
+		return mask;
+	}
+
+	std::vector<float> AnimationBlend::MakeClipMask(const AnimationClip& clip, uint32_t jointCount)
+	{
+		std::vector<float> mask(jointCount, 0.0f);
+		for (const AnimationCurve& curve : clip.curves)
+		{
+			if (curve.targetJoint < jointCount)
+				mask[curve.targetJoint] = 1.0f;
+		}
+		return mask;
+	}
+}
@@ -0,0 +1,91 @@
+/**
+ * @file AnimationBlend.h
+ * @brief ローカルポーズのブレンド処理
+ *
+ * ポーズ配列をジョイント単位でまとめて処理する。描画やリソースに依存しないので単体で確認できる。
+ * 回転は最短経路の正規化線形補間（nlerp）で補間する。
+ * 出力先は入力のどれかと同じ配列でもよい（ジョイントごとに読んでから書く）。
+ */
+
+#pragma once
+#include "AnimationPose.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace AtomEngine
+{
+	struct Skeleton;
+	struct AnimationClip;
+
+	/**
+	 * @class AnimationBlend
+	 * @brief ポーズのブレンド関数群
+	 */
+	class AnimationBlend
+	{
+	public:
+		/**
+		 * @brief 複数ポーズの重み付きブレンド
+		 *
+		 * 重みは合計で正規化する。合計が0以下ならposes[0]をそのまま出力する。
+		 * @param poses 入力ポーズの配列（それぞれjointCount個）
+		 * @param weights ポーズごとの重み
+		 * @param poseCount ポーズ数（1以上）
+		 * @param out 出力ポーズ
+		 * @param jointCount ジョイント数
+		 */
+		static void Blend(const JointPose* const* poses, const float* weights, uint32_t poseCount, JointPose* out, uint32_t jointCount);
+
+		/**
+		 * @brief 2つのポーズを補間する
+		 * @param from 補間元（t = 0）
+		 * @param to 補間先（t = 1）
+		 * @param t 補間係数
+		 * @param jointWeights ジョイントごとの重み（tに掛ける。nullptrなら全て1）
+		 * @param out 出力ポーズ
+		 * @param jointCount ジョイント数
+		 */
+		static void Lerp(const JointPose* from, const JointPose* to, float t, const float* jointWeights, JointPose* out, uint32_t jointCount);
+
+		/**
+		 * @brief 基準ポーズとの差分を加算用ポーズにする
+		 *
+		 * 回転はconj(reference) * pose、平行移動は差、スケールは比になる。
+		 * ApplyAdditiveで基準ポーズに重み1で加算すると元のポーズに戻る。
+		 * @param pose 元のポーズ
+		 * @param reference 基準ポーズ（スケールは0でないこと）
+		 * @param out 出力ポーズ
+		 * @param jointCount ジョイント数
+		 */
+		static void MakeAdditive(const JointPose* pose, const JointPose* reference, JointPose* out, uint32_t jointCount);
+
+		/**
+		 * @brief 加算用ポーズを重み付きで加算する
+		 * @param base 加算先のポーズ
+		 * @param additive MakeAdditiveで作ったポーズ
+		 * @param weight 重み
+		 * @param jointWeights ジョイントごとの重み（weightに掛ける。nullptrなら全て1）
+		 * @param out 出力ポーズ
+		 * @param jointCount ジョイント数
+		 */
+		static void ApplyAdditive(const JointPose* base, const JointPose* additive, float weight, const float* jointWeights, JointPose* out, uint32_t jointCount);
+
+		/**
+		 * @brief 指定ジョイント以下の階層だけに効くジョイントマスクを作る
+		 *
+		 * ジョイントは親が子より前に並んでいることを前提とする。
+		 * @param skeleton スケルトン
+		 * @param rootJoint マスクの根になるジョイント
+		 * @param weight 階層内のジョイントの重み（それ以外は0）
+		 */
+		static std::vector<float> MakeJointMask(const Skeleton& skeleton, uint32_t rootJoint, float weight = 1.0f);
+
+		/**
+		 * @brief クリップがカーブを持つジョイントだけに効くジョイントマスクを作る
+		 * @param clip クリップ
+		 * @param jointCount ジョイント数
+		 */
+		static std::vector<float> MakeClipMask(const AnimationClip& clip, uint32_t jointCount);
+	};
+}
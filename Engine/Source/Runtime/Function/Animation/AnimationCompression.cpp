@@ -0,0 +1,431 @@
+#include "AnimationCompression.h"
+#include "Runtime/Core/Utility/BinaryStream.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		constexpr float kQuantizeMax = 65535.0f;
+		constexpr float kSmallestThreeMax = 32767.0f;
+		constexpr float kInvSqrt2 = 0.70710678118f;
+
+		/**
+		 * @brief 2つの回転の角度差（ラジアン）
+		 *
+		 * acos(dot)は差が小さいとfloatの精度で潰れるので、4次元の弦の長さから求める。
+		 */
+		float RotationError(const Quaternion& a, const Quaternion& b)
+		{
+			const Quaternion qa = a.NormalizeCopy();
+			Quaternion qb = b.NormalizeCopy();
+			if (qa.Dot(qb) < 0.0f)
+				qb = -qb;
+			const float chord = std::min(2.0f, (qa - qb).Length());
+			return 4.0f * std::asin(chord * 0.5f);
+		}
+
+		float VectorError(const Vector3& a, const Vector3& b)
+		{
+			return (a - b).Length();
+		}
+
+		float MaxComponentError(const Vector3& a, const Vector3& b)
+		{
+			return std::max(std::max(std::fabs(a.x - b.x), std::fabs(a.y - b.y)), std::fabs(a.z - b.z));
+		}
+
+		/**
+		 * @brief 最大の成分を除いた3成分を15ビットずつ詰める（上位2ビットは除いた成分の番号）
+		 */
+		void EncodeRotation(const Quaternion& rotation, uint16_t* out)
+		{
+			Quaternion q = rotation.NormalizeCopy();
+			float c[4] = { q.x, q.y, q.z, q.w };
+
+			uint32_t largest = 0;
+			for (uint32_t i = 1; i < 4; ++i)
+			{
+				if (std::fabs(c[i]) > std::fabs(c[largest]))
+					largest = i;
+			}
+			// 残りの成分から最大の成分を復元できるよう、最大の成分が正になる側を使う
+			const float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+
+			uint64_t bits = largest;
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				if (i == largest)
+					continue;
+				const float normalized = std::clamp(c[i] * sign * kInvSqrt2 + 0.5f, 0.0f, 1.0f);
+				bits = (bits << 15) | static_cast<uint64_t>(std::lround(normalized * kSmallestThreeMax));
+			}
+
+			out[0] = static_cast<uint16_t>(bits >> 32);
+			out[1] = static_cast<uint16_t>(bits >> 16);
+			out[2] = static_cast<uint16_t>(bits);
+		}
+
+		Quaternion DecodeRotation(const uint16_t* in)
+		{
+			const uint64_t bits = (static_cast<uint64_t>(in[0]) << 32) | (static_cast<uint64_t>(in[1]) << 16) | in[2];
+			const uint32_t largest = static_cast<uint32_t>(bits >> 45) & 3;
+
+			float c[4];
+			float sumSqr = 0.0f;
+			uint32_t shift = 30;
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				if (i == largest)
+					continue;
+				const float normalized = static_cast<float>((bits >> shift) & 0x7FFF) / kSmallestThreeMax;
+				c[i] = (normalized - 0.5f) * 2.0f * kInvSqrt2;
+				sumSqr += c[i] * c[i];
+				shift -= 15;
+			}
+			c[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSqr));
+			return Quaternion(c[0], c[1], c[2], c[3]);
+		}
+
+		Vector3 DecodeVector(const uint16_t* in, const Vector3& min, const Vector3& step)
+		{
+			return Vector3(
+				min.x + static_cast<float>(in[0]) * step.x,
+				min.y + static_cast<float>(in[1]) * step.y,
+				min.z + static_cast<float>(in[2]) * step.z);
+		}
+
+		/// 最短経路の正規化線形補間
+		Quaternion Nlerp(const Quaternion& a, const Quaternion& b, float t)
+		{
+			const float sign = a.Dot(b) < 0.0f ? -1.0f : 1.0f;
+			Quaternion q(
+				a.x + (b.x * sign - a.x) * t,
+				a.y + (b.y * sign - a.y) * t,
+				a.z + (b.z * sign - a.z) * t,
+				a.w + (b.w * sign - a.w) * t);
+			q.Normalize();
+			return q;
+		}
+
+		/// 全フレームが許容値の半分以内なら一定とみなす（残りは量子化と補間の誤差に回す）
+		template<typename T, typename ErrorFunc>
+		bool IsConstant(const std::vector<T>& frames, float tolerance, ErrorFunc&& error)
+		{
+			for (const T& value : frames)
+			{
+				if (error(value, frames[0]) > tolerance * 0.5f)
+					return false;
+			}
+			return true;
+		}
+
+		void ComputeQuantization(const std::vector<Vector3>& frames, Vector3& outMin, Vector3& outStep)
+		{
+			Vector3 min = frames[0], max = frames[0];
+			for (const Vector3& v : frames)
+			{
+				min = Vector3(std::min(min.x, v.x), std::min(min.y, v.y), std::min(min.z, v.z));
+				max = Vector3(std::max(max.x, v.x), std::max(max.y, v.y), std::max(max.z, v.z));
+			}
+			outMin = min;
+			outStep = (max - min) * (1.0f / kQuantizeMax);
+		}
+
+		void EncodeVector(const Vector3& v, const Vector3& min, const Vector3& step, uint16_t* out)
+		{
+			auto quantize = [](float value, float base, float s) -> uint16_t
+				{
+					if (s <= 0.0f)
+						return 0;
+					return static_cast<uint16_t>(std::clamp(std::lround((value - base) / s), 0L, 65535L));
+				};
+			out[0] = quantize(v.x, min.x, step.x);
+			out[1] = quantize(v.y, min.y, step.y);
+			out[2] = quantize(v.z, min.z, step.z);
+		}
+	}
+
+	bool CompressedAnimationClip::Compress(const AnimationClip& source, const AnimationCompressionSettings& settings)
+	{
+		float rate = settings.sampleRate > 0.0f ? settings.sampleRate : EstimateSampleRate(source, settings.maxSampleRate);
+		for (rate = std::min(rate, settings.maxSampleRate); rate <= settings.maxSampleRate; rate *= 2.0f)
+		{
+			if (!CompressAtRate(source, rate, settings))
+				continue;
+
+			const AnimationCompressionError error = MeasureError(source);
+			if (error.translation <= settings.translationTolerance &&
+				error.rotation <= settings.rotationTolerance &&
+				error.scale <= settings.scaleTolerance)
+			{
+				return true;
+			}
+		}
+
+		*this = CompressedAnimationClip();
+		return false;
+	}
+
+	size_t CompressedAnimationClip::GetSourceMemorySize(const AnimationClip& source)
+	{
+		size_t size = source.curves.size() * sizeof(AnimationCurve);
+		for (const AnimationCurve& curve : source.curves)
+		{
+			size += (curve.translation.size() + curve.scale.size()) * sizeof(KeyframeVec3);
+			size += curve.rotation.size() * sizeof(KeyframeQuat);
+		}
+		return size;
+	}
+
+	float CompressedAnimationClip::EstimateSampleRate(const AnimationClip& source, float maxSampleRate)
+	{
+		// 重複したキー（間隔がほぼ0）は数えない
+		const float minInterval = 1.0f / (maxSampleRate * 4.0f);
+		std::vector<float> intervals;
+		auto addIntervals = [&](const auto& keys)
+			{
+				for (size_t k = 1; k < keys.size(); ++k)
+				{
+					const float interval = keys[k].time - keys[k - 1].time;
+					if (interval > minInterval)
+						intervals.push_back(interval);
+				}
+			};
+		for (const AnimationCurve& curve : source.curves)
+		{
+			addIntervals(curve.translation);
+			addIntervals(curve.rotation);
+			addIntervals(curve.scale);
+		}
+		if (intervals.empty())
+			return kDefaultSampleRate;
+
+		std::nth_element(intervals.begin(), intervals.begin() + intervals.size() / 2, intervals.end());
+		float rate = 1.0f / intervals[intervals.size() / 2];
+		// 秒に直したキーの時刻は誤差を含むので、24.0003fpsのような値は整数にする
+		const float rounded = std::round(rate);
+		if (rounded >= 1.0f && std::fabs(rate - rounded) <= rate * 1e-3f)
+			rate = rounded;
+		return std::min(rate, maxSampleRate);
+	}
+
+	bool CompressedAnimationClip::CompressAtRate(const AnimationClip& source, float sampleRate, const AnimationCompressionSettings& settings)
+	{
+		mCurves.clear();
+		mFrames.clear();
+		mSampleRate = sampleRate;
+		mFrameCount = static_cast<uint32_t>(std::ceil(std::max(source.duration, 0.0f) * sampleRate)) + 1;
+		mFrameStride = 0;
+
+		// 元のクリップをフレームごとにサンプリング
+		const size_t curveCount = source.curves.size();
+		std::vector<std::vector<Vector3>> translations(curveCount), scales(curveCount);
+		std::vector<std::vector<Quaternion>> rotations(curveCount);
+		for (size_t c = 0; c < curveCount; ++c)
+		{
+			const AnimationCurve& curve = source.curves[c];
+			if (curve.translation.empty() || curve.rotation.empty() || curve.scale.empty())
+				return false;
+
+			translations[c].resize(mFrameCount);
+			rotations[c].resize(mFrameCount);
+			scales[c].resize(mFrameCount);
+			for (uint32_t f = 0; f < mFrameCount; ++f)
+			{
+				const float time = static_cast<float>(f) / sampleRate;
+				translations[c][f] = CalculateValue(curve.translation, time);
+				rotations[c][f] = CaculateRotation(curve.rotation, time);
+				scales[c][f] = CalculateValue(curve.scale, time);
+			}
+		}
+
+		// 一定でないチャンネルだけフレームデータに割り当てる
+		mCurves.resize(curveCount);
+		for (size_t c = 0; c < curveCount; ++c)
+		{
+			Curve& curve = mCurves[c];
+			curve.targetJoint = source.curves[c].targetJoint;
+
+			if (IsConstant(translations[c], settings.translationTolerance, VectorError))
+			{
+				curve.translationMin = translations[c][0];
+			}
+			else
+			{
+				curve.translationOffset = mFrameStride;
+				mFrameStride += 3;
+				ComputeQuantization(translations[c], curve.translationMin, curve.translationStep);
+			}
+
+			if (IsConstant(rotations[c], settings.rotationTolerance, RotationError))
+			{
+				curve.constantRotation = rotations[c][0].NormalizeCopy();
+			}
+			else
+			{
+				curve.rotationOffset = mFrameStride;
+				mFrameStride += 3;
+			}
+
+			if (IsConstant(scales[c], settings.scaleTolerance, MaxComponentError))
+			{
+				curve.scaleMin = scales[c][0];
+			}
+			else
+			{
+				curve.scaleOffset = mFrameStride;
+				mFrameStride += 3;
+				ComputeQuantization(scales[c], curve.scaleMin, curve.scaleStep);
+			}
+		}
+
+		mFrames.resize(static_cast<size_t>(mFrameCount) * mFrameStride);
+		for (uint32_t f = 0; f < mFrameCount; ++f)
+		{
+			uint16_t* frame = mFrames.data() + static_cast<size_t>(f) * mFrameStride;
+			for (size_t c = 0; c < curveCount; ++c)
+			{
+				const Curve& curve = mCurves[c];
+				if (curve.translationOffset != kConstantChannel)
+					EncodeVector(translations[c][f], curve.translationMin, curve.translationStep, frame + curve.translationOffset);
+				if (curve.rotationOffset != kConstantChannel)
+					EncodeRotation(rotations[c][f], frame + curve.rotationOffset);
+				if (curve.scaleOffset != kConstantChannel)
+					EncodeVector(scales[c][f], curve.scaleMin, curve.scaleStep, frame + curve.scaleOffset);
+			}
+		}
+		return true;
+	}
+
+	AnimationCompressionError CompressedAnimationClip::MeasureError(const AnimationClip& source) const
+	{
+		AnimationCompressionError error;
+		if (!IsValid())
+			return error;
+
+		std::vector<float> times;
+		for (uint32_t f = 0; f < mFrameCount; ++f)
+		{
+			times.push_back(static_cast<float>(f) / mSampleRate);
+			times.push_back((static_cast<float>(f) + 0.5f) / mSampleRate);
+		}
+		for (const AnimationCurve& curve : source.curves)
+		{
+			for (const KeyframeVec3& key : curve.translation) times.push_back(key.time);
+			for (const KeyframeQuat& key : curve.rotation) times.push_back(key.time);
+			for (const KeyframeVec3& key : curve.scale) times.push_back(key.time);
+		}
+		std::sort(times.begin(), times.end());
+		times.erase(std::unique(times.begin(), times.end()), times.end());
+
+		uint32_t jointCount = 0;
+		for (const Curve& curve : mCurves)
+			jointCount = std::max(jointCount, curve.targetJoint + 1);
+		std::vector<JointPose> pose(jointCount);
+
+		for (float time : times)
+		{
+			if (time < 0.0f || time > source.duration)
+				continue;
+
+			Sample(time, pose.data(), jointCount);
+			for (const AnimationCurve& curve : source.curves)
+			{
+				const JointPose& joint = pose[curve.targetJoint];
+				error.translation = std::max(error.translation, VectorError(joint.translation, CalculateValue(curve.translation, time)));
+				error.rotation = std::max(error.rotation, RotationError(joint.rotation, CaculateRotation(curve.rotation, time)));
+				error.scale = std::max(error.scale, MaxComponentError(joint.scale, CalculateValue(curve.scale, time)));
+			}
+		}
+		return error;
+	}
+
+	void CompressedAnimationClip::Sample(float time, JointPose* pose, uint32_t jointCount) const
+	{
+		assert(IsValid());
+
+		// キー番号は時間から直接求まる
+		const float frame = time * mSampleRate;
+		const uint32_t lastFrame = mFrameCount - 1;
+		uint32_t frame0 = 0;
+		float alpha = 0.0f;
+		if (frame >= static_cast<float>(lastFrame))
+		{
+			frame0 = lastFrame;
+		}
+		else if (frame > 0.0f)
+		{
+			frame0 = static_cast<uint32_t>(frame);
+			alpha = frame - static_cast<float>(frame0);
+		}
+		const uint32_t frame1 = std::min(frame0 + 1, lastFrame);
+
+		const uint16_t* data0 = mFrames.data() + static_cast<size_t>(frame0) * mFrameStride;
+		const uint16_t* data1 = mFrames.data() + static_cast<size_t>(frame1) * mFrameStride;
+
+		for (const Curve& curve : mCurves)
+		{
+			if (curve.targetJoint >= jointCount)
+				continue;
+
+			JointPose& joint = pose[curve.targetJoint];
+
+			if (curve.translationOffset == kConstantChannel)
+				joint.translation = curve.translationMin;
+			else
+				joint.translation = Vector3::Lerp(
+					DecodeVector(data0 + curve.translationOffset, curve.translationMin, curve.translationStep),
+					DecodeVector(data1 + curve.translationOffset, curve.translationMin, curve.translationStep), alpha);
+
+			if (curve.rotationOffset == kConstantChannel)
+				joint.rotation = curve.constantRotation;
+			else
+				joint.rotation = Nlerp(DecodeRotation(data0 + curve.rotationOffset), DecodeRotation(data1 + curve.rotationOffset), alpha);
+
+			if (curve.scaleOffset == kConstantChannel)
+				joint.scale = curve.scaleMin;
+			else
+				joint.scale = Vector3::Lerp(
+					DecodeVector(data0 + curve.scaleOffset, curve.scaleMin, curve.scaleStep),
+					DecodeVector(data1 + curve.scaleOffset, curve.scaleMin, curve.scaleStep), alpha);
+		}
+	}
+
+	void CompressedAnimationClip::Write(BinaryWriter& writer) const
+	{
+		writer.Write(mFrameCount);
+		writer.Write(mFrameStride);
+		writer.Write(mSampleRate);
+		writer.WriteArray(mCurves);
+		writer.WriteArray(mFrames);
+	}
+
+	bool CompressedAnimationClip::Read(BinaryReader& reader)
+	{
+		reader.Read(mFrameCount);
+		reader.Read(mFrameStride);
+		reader.Read(mSampleRate);
+		reader.ReadArray(mCurves);
+		reader.ReadArray(mFrames);
+
+		// フレームデータの大きさとオフセットが合わなければ使わない
+		bool valid = !reader.IsFailed() && mFrames.size() == static_cast<size_t>(mFrameCount) * mFrameStride;
+		for (const Curve& curve : mCurves)
+		{
+			// どのチャンネルも1フレームあたりuint16を3つ使う
+			for (uint32_t offset : { curve.translationOffset, curve.rotationOffset, curve.scaleOffset })
+				valid = valid && (offset == kConstantChannel || static_cast<uint64_t>(offset) + 3 <= mFrameStride);
+		}
+
+		if (!valid)
+		{
+			*this = CompressedAnimationClip();
+			return false;
+		}
+		return true;
+	}
+}
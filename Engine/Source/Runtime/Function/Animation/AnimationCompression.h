@@ -0,0 +1,139 @@
+/**
+ * @file AnimationCompression.h
+ * @brief 一定フレームレートにリサンプリングして量子化したアニメーションクリップ
+ *
+ * インポート時にAnimationClipから作る。キー番号はfloor(時間 * フレームレート)で求まるので探索が不要で、
+ * 1回のサンプリングで読むのは隣り合う2フレーム分の連続したデータだけになる。
+ * - 一定のチャンネルはフレームデータから除いて定数として持つ
+ * - 回転はsmallest-three形式の48ビット（成分あたり15ビット）
+ * - 平行移動とスケールはトラックごとの範囲に対する16ビット
+ * フレームレートは元のキーの間隔から決める（24fpsで打たれたキーは24fpsのまま）。
+ * 圧縮後に元のクリップと比較して、誤差が許容値を超えればフレームレートを上げてやり直す。
+ * 元のキーより小さくならない場合は圧縮しない（呼び出し側でGetSourceMemorySizeと比べる）。
+ */
+
+#pragma once
+#include "AnimationPose.h"
+#include "Runtime/Resource/Animation.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace AtomEngine
+{
+	class BinaryWriter;
+	class BinaryReader;
+
+	/**
+	 * @struct AnimationCompressionSettings
+	 * @brief 圧縮の設定
+	 */
+	struct AnimationCompressionSettings
+	{
+		float sampleRate = 0.0f;                ///< リサンプリングのフレームレート（0なら元のキーの間隔から決める）
+		float maxSampleRate = 120.0f;           ///< 誤差が収まらない場合に上げるフレームレートの上限
+		float translationTolerance = 1e-3f;     ///< 平行移動の許容誤差（距離）
+		float rotationTolerance = 1e-3f;        ///< 回転の許容誤差（ラジアン）
+		float scaleTolerance = 1e-3f;           ///< スケールの許容誤差（各成分）
+	};
+
+	/**
+	 * @struct AnimationCompressionError
+	 * @brief 元のクリップに対する最大誤差
+	 */
+	struct AnimationCompressionError
+	{
+		float translation = 0.0f;
+		float rotation = 0.0f;
+		float scale = 0.0f;
+	};
+
+	/**
+	 * @class CompressedAnimationClip
+	 * @brief 量子化済みのアニメーションクリップ
+	 */
+	class CompressedAnimationClip
+	{
+	public:
+		/**
+		 * @brief クリップを圧縮する
+		 * @param source 元のクリップ（キーは時間順、各チャンネル1キー以上）
+		 * @param settings 圧縮の設定
+		 * @return 許容誤差内に収まればtrue（falseの場合は空のまま）
+		 */
+		bool Compress(const AnimationClip& source, const AnimationCompressionSettings& settings = {});
+
+		/**
+		 * @brief 元のクリップとの最大誤差を求める
+		 *
+		 * 元の全キーの時刻と、各フレームとその中間の時刻で比較する。
+		 * @param source 元のクリップ
+		 */
+		AnimationCompressionError MeasureError(const AnimationClip& source) const;
+
+		/**
+		 * @brief 全チャンネルをサンプリングしてポーズに書き込む
+		 * @param time 時間（0～duration、範囲外は端のフレーム）
+		 * @param pose 書き込み先のローカルポーズ
+		 * @param jointCount ポーズのジョイント数（範囲外のジョイントは無視）
+		 */
+		void Sample(float time, JointPose* pose, uint32_t jointCount) const;
+
+		bool IsValid() const { return mFrameCount > 0; }
+		float GetSampleRate() const { return mSampleRate; }
+		uint32_t GetFrameCount() const { return mFrameCount; }
+
+		/// キャッシュファイルに書き出す（無効なクリップも書ける）
+		void Write(BinaryWriter& writer) const;
+
+		/**
+		 * @brief Writeで書いたデータを読む
+		 * @return データが壊れていればfalse（空のまま）
+		 */
+		bool Read(BinaryReader& reader);
+
+		/// 保持しているデータのバイト数
+		size_t GetMemorySize() const { return mCurves.size() * sizeof(Curve) + mFrames.size() * sizeof(uint16_t); }
+
+		/// 元のクリップのキーフレームのバイト数（GetMemorySizeと比べる）
+		static size_t GetSourceMemorySize(const AnimationClip& source);
+
+		/**
+		 * @brief 元のキーの間隔からリサンプリングのフレームレートを決める
+		 *
+		 * 全チャンネルのキーの間隔の中央値の逆数（整数に近ければ丸める）。キーが1つずつならkDefaultSampleRate。
+		 * @param source 元のクリップ
+		 * @param maxSampleRate 上限
+		 */
+		static float EstimateSampleRate(const AnimationClip& source, float maxSampleRate);
+
+		/// キーの間隔が分からない場合のフレームレート
+		static constexpr float kDefaultSampleRate = 30.0f;
+
+	private:
+		/// フレームデータに含まれないチャンネル
+		static constexpr uint32_t kConstantChannel = 0xFFFFFFFF;
+
+		struct Curve
+		{
+			uint32_t targetJoint = 0;
+			uint32_t translationOffset = kConstantChannel;   ///< フレーム内のオフセット（uint16単位）
+			uint32_t rotationOffset = kConstantChannel;
+			uint32_t scaleOffset = kConstantChannel;
+
+			Quaternion constantRotation;
+			Vector3 translationMin;     ///< 一定なら値そのもの
+			Vector3 translationStep;    ///< 量子化の1段分
+			Vector3 scaleMin;
+			Vector3 scaleStep;
+		};
+
+		bool CompressAtRate(const AnimationClip& source, float sampleRate, const AnimationCompressionSettings& settings);
+
+		std::vector<Curve> mCurves;
+		std::vector<uint16_t> mFrames;  ///< フレームごとに全トラックを並べたデータ
+		uint32_t mFrameStride = 0;      ///< 1フレームのuint16数
+		uint32_t mFrameCount = 0;
+		float mSampleRate = 0.0f;
+	};
+}
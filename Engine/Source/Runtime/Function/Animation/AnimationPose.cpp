@@ -0,0 +1,202 @@
+#include "AnimationPose.h"
+#include "Runtime/Resource/Skeleton.h"
+
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		constexpr uint32_t kMinPooledJoints = 16;
+		constexpr uint32_t kSizeClassCount = 7;              ///< 16, 32, ..., 1024
+		constexpr uint32_t kDirectSizeClass = 0xFFFFFFFF;    ///< プールを通さず確保したブロック
+		constexpr size_t kBlockAlignment = 64;
+
+		static_assert((kMinPooledJoints << (kSizeClassCount - 1)) == PosePool::kMaxPooledJoints, "size class table mismatch");
+
+		std::mutex sPoolMutex;
+		std::vector<void*> sFreeBlocks[kSizeClassCount];
+		std::atomic<uint32_t> sLiveCount{ 0 };
+
+		uint32_t GetSizeClass(uint32_t jointCount)
+		{
+			if (jointCount > PosePool::kMaxPooledJoints)
+				return kDirectSizeClass;
+
+			uint32_t sizeClass = 0;
+			while ((kMinPooledJoints << sizeClass) < jointCount)
+				++sizeClass;
+			return sizeClass;
+		}
+
+		uint32_t GetCapacity(uint32_t sizeClass, uint32_t jointCount)
+		{
+			return sizeClass == kDirectSizeClass ? jointCount : kMinPooledJoints << sizeClass;
+		}
+
+		/// モデル空間行列を先頭に置き、その後ろにローカルポーズを置く
+		size_t GetBlockSize(uint32_t capacity)
+		{
+			return capacity * (sizeof(Matrix4x4) + sizeof(JointPose));
+		}
+
+		void* AllocateBlock(uint32_t capacity)
+		{
+			return ::operator new(GetBlockSize(capacity), std::align_val_t(kBlockAlignment));
+		}
+
+		void FreeBlock(void* block)
+		{
+			::operator delete(block, std::align_val_t(kBlockAlignment));
+		}
+	}
+
+	PoseBuffer::~PoseBuffer()
+	{
+		Release();
+	}
+
+	PoseBuffer::PoseBuffer(PoseBuffer&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	PoseBuffer& PoseBuffer::operator=(PoseBuffer&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Release();
+			mBlock = other.mBlock;
+			mLocalPose = other.mLocalPose;
+			mModelSpace = other.mModelSpace;
+			mJointCount = other.mJointCount;
+			mSizeClass = other.mSizeClass;
+
+			other.mBlock = nullptr;
+			other.mLocalPose = nullptr;
+			other.mModelSpace = nullptr;
+			other.mJointCount = 0;
+		}
+		return *this;
+	}
+
+	void PoseBuffer::Release()
+	{
+		if (!mBlock)
+			return;
+
+		PosePool::Free(mBlock, mSizeClass);
+		mBlock = nullptr;
+		mLocalPose = nullptr;
+		mModelSpace = nullptr;
+		mJointCount = 0;
+	}
+
+	void PoseBuffer::ResetToBindPose(const Skeleton& skeleton)
+	{
+		assert(skeleton.joints.size() == mJointCount);
+
+		for (uint32_t i = 0; i < mJointCount; ++i)
+		{
+			const Transform& bind = skeleton.joints[i].transform;
+			mLocalPose[i].rotation = bind.rotation;
+			mLocalPose[i].translation = bind.transition;
+			mLocalPose[i].scale = bind.scale;
+		}
+	}
+
+	void PoseBuffer::ComputeModelSpace(const Skeleton& skeleton)
+	{
+		assert(skeleton.joints.size() == mJointCount);
+
+		for (uint32_t i = 0; i < mJointCount; ++i)
+		{
+			const Joint& joint = skeleton.joints[i];
+			const Matrix4x4 local = mLocalPose[i].GetMatrix();
+			if (joint.parent)
+			{
+				assert(static_cast<uint32_t>(*joint.parent) < i);
+				mModelSpace[i] = local * mModelSpace[*joint.parent];
+			}
+			else
+			{
+				mModelSpace[i] = local;
+			}
+		}
+	}
+
+	PoseBuffer PosePool::Allocate(uint32_t jointCount)
+	{
+		PoseBuffer buffer;
+		if (jointCount == 0)
+			return buffer;
+
+		const uint32_t sizeClass = GetSizeClass(jointCount);
+		const uint32_t capacity = GetCapacity(sizeClass, jointCount);
+
+		void* block = nullptr;
+		if (sizeClass != kDirectSizeClass)
+		{
+			std::lock_guard<std::mutex> lock(sPoolMutex);
+			std::vector<void*>& freeBlocks = sFreeBlocks[sizeClass];
+			if (!freeBlocks.empty())
+			{
+				block = freeBlocks.back();
+				freeBlocks.pop_back();
+			}
+		}
+		if (!block)
+			block = AllocateBlock(capacity);
+
+		buffer.mBlock = block;
+		buffer.mModelSpace = static_cast<Matrix4x4*>(block);
+		buffer.mLocalPose = reinterpret_cast<JointPose*>(static_cast<uint8_t*>(block) + capacity * sizeof(Matrix4x4));
+		buffer.mJointCount = jointCount;
+		buffer.mSizeClass = sizeClass;
+
+		// 単位行列・単位ポーズで初期化しておく
+		for (uint32_t i = 0; i < jointCount; ++i)
+		{
+			new (&buffer.mModelSpace[i]) Matrix4x4(Matrix4x4::IDENTITY);
+			new (&buffer.mLocalPose[i]) JointPose();
+		}
+
+		sLiveCount.fetch_add(1, std::memory_order_relaxed);
+		return buffer;
+	}
+
+	void PosePool::Free(void* block, uint32_t sizeClass)
+	{
+		sLiveCount.fetch_sub(1, std::memory_order_relaxed);
+
+		if (sizeClass == kDirectSizeClass)
+		{
+			FreeBlock(block);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(sPoolMutex);
+		sFreeBlocks[sizeClass].push_back(block);
+	}
+
+	void PosePool::Trim()
+	{
+		std::lock_guard<std::mutex> lock(sPoolMutex);
+		for (std::vector<void*>& freeBlocks : sFreeBlocks)
+		{
+			for (void* block : freeBlocks)
+				FreeBlock(block);
+			freeBlocks.clear();
+			freeBlocks.shrink_to_fit();
+		}
+	}
+
+	uint32_t PosePool::GetLiveCount()
+	{
+		return sLiveCount.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,132 @@
+/**
+ * @file AnimationPose.h
+ * @brief インスタンスごとのアニメーションポーズ
+ *
+ * スケルトンとクリップはModelが不変のまま持ち、エンティティごとに
+ * ローカルポーズ（ジョイントごとのSRT）とモデル空間行列を持つ。
+ * ポーズのメモリはジョイント数ごとのサイズクラスでプールから確保する。
+ */
+
+#pragma once
+#include "Runtime/Core/Math/MathInclude.h"
+#include <cstdint>
+
+namespace AtomEngine
+{
+	struct Skeleton;
+
+	/**
+	 * @struct JointPose
+	 * @brief 1ジョイントのローカル変換
+	 */
+	struct JointPose
+	{
+		Quaternion rotation;
+		Vector3 translation;
+		Vector3 scale = Vector3(1.0f, 1.0f, 1.0f);
+
+		/// ローカル行列（Transform::GetMatrixと同じ計算）
+		Matrix4x4 GetMatrix() const
+		{
+			Matrix4x4 result;
+			result.MakeAffine(scale, rotation, translation);
+			return result;
+		}
+	};
+
+	/**
+	 * @class PoseBuffer
+	 * @brief 1インスタンス分のローカルポーズとモデル空間行列（ムーブのみ可能）
+	 *
+	 * 使用例:
+	 * @code
+	 * PoseBuffer pose = PosePool::Allocate(jointCount);
+	 * pose.ResetToBindPose(model.mSkeleton);
+	 * pose.GetLocalPose()[joint].rotation = ...;
+	 * pose.ComputeModelSpace(model.mSkeleton);
+	 * @endcode
+	 */
+	class PoseBuffer
+	{
+	public:
+		PoseBuffer() = default;
+		~PoseBuffer();
+
+		PoseBuffer(PoseBuffer&& other) noexcept;
+		PoseBuffer& operator=(PoseBuffer&& other) noexcept;
+		PoseBuffer(const PoseBuffer&) = delete;
+		PoseBuffer& operator=(const PoseBuffer&) = delete;
+
+		explicit operator bool() const { return mBlock != nullptr; }
+
+		uint32_t GetJointCount() const { return mJointCount; }
+
+		/// ジョイントごとのローカル変換
+		JointPose* GetLocalPose() { return mLocalPose; }
+		const JointPose* GetLocalPose() const { return mLocalPose; }
+
+		/// ジョイントごとのモデル空間行列（ComputeModelSpaceで更新）
+		Matrix4x4* GetModelSpace() { return mModelSpace; }
+		const Matrix4x4* GetModelSpace() const { return mModelSpace; }
+
+		/**
+		 * @brief ローカルポーズをスケルトンのバインドポーズに戻す
+		 * @param skeleton 対応するスケルトン
+		 */
+		void ResetToBindPose(const Skeleton& skeleton);
+
+		/**
+		 * @brief ローカルポーズからモデル空間行列を計算する
+		 *
+		 * ジョイントは親が子より前に並んでいる（ModelLoaderが深さ優先で作る）ことを前提とする。
+		 * @param skeleton 対応するスケルトン
+		 */
+		void ComputeModelSpace(const Skeleton& skeleton);
+
+	private:
+		friend class PosePool;
+
+		void Release();
+
+		void* mBlock = nullptr;
+		JointPose* mLocalPose = nullptr;
+		Matrix4x4* mModelSpace = nullptr;
+		uint32_t mJointCount = 0;
+		uint32_t mSizeClass = 0;
+	};
+
+	/**
+	 * @class PosePool
+	 * @brief ポーズバッファのプール
+	 *
+	 * ジョイント数を2の累乗に切り上げたサイズクラスごとに解放済みブロックを保持し、
+	 * 同じキャラクターを大量に出し入れしてもヒープ確保が発生しないようにする。
+	 */
+	class PosePool
+	{
+	public:
+		/// プールで扱う最大ジョイント数（これを超えると直接確保する）
+		static constexpr uint32_t kMaxPooledJoints = 1024;
+
+		/**
+		 * @brief ポーズバッファを確保する（スレッドセーフ）
+		 * @param jointCount ジョイント数
+		 * @return ポーズバッファ（jointCountが0なら空）
+		 */
+		static PoseBuffer Allocate(uint32_t jointCount);
+
+		/**
+		 * @brief 保持している解放済みブロックを全てヒープに返す
+		 */
+		static void Trim();
+
+		/**
+		 * @brief 使用中のブロック数を取得
+		 */
+		static uint32_t GetLiveCount();
+
+	private:
+		friend class PoseBuffer;
+		static void Free(void* block, uint32_t sizeClass);
+	};
+}
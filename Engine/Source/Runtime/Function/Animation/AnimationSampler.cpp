@@ -0,0 +1,144 @@
+#include "AnimationSampler.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		/// カーソルから順方向に調べる区間数（これを超えたら二分探索）
+		constexpr uint32_t kMaxForwardSteps = 4;
+
+		/**
+		 * @brief timeを含むキー区間の先頭番号を求める
+		 *
+		 * 既存の線形探索と同じく、keys[i].time <= time <= keys[i + 1].timeを満たす最小のiを返す。
+		 * 時間順のキーでは「keys[i + 1].time >= timeとなる最小のi」と同じになる。
+		 * 前提: keys.size() >= 2、keys.front().time <= time <= keys.back().time
+		 */
+		template<typename Key>
+		uint32_t FindKey(const std::vector<Key>& keys, float time, uint32_t& cursor)
+		{
+			const uint32_t lastInterval = static_cast<uint32_t>(keys.size()) - 2;
+			uint32_t i = std::min(cursor, lastInterval);
+
+			// 前回の区間以降なら順方向に数個だけ調べる
+			if (i == 0 || keys[i].time < time)
+			{
+				for (uint32_t step = 0; step <= kMaxForwardSteps && i <= lastInterval; ++step, ++i)
+				{
+					if (keys[i + 1].time >= time)
+					{
+						cursor = i;
+						return i;
+					}
+				}
+			}
+
+			// 時間が戻った（シーク・ループ）か大きく進んだので二分探索
+			auto it = std::lower_bound(keys.begin() + 1, keys.end(), time,
+				[](const Key& key, float t) { return key.time < t; });
+			i = static_cast<uint32_t>(it - keys.begin()) - 1;
+			cursor = i;
+			return i;
+		}
+
+		template<typename Key>
+		float GetInterpolationFactor(const std::vector<Key>& keys, uint32_t i, float time)
+		{
+			return (time - keys[i].time) / (keys[i + 1].time - keys[i].time);
+		}
+	}
+
+	Vector3 AnimationSampler::SampleValue(const std::vector<KeyframeVec3>& keyframes, float time, uint32_t& cursor)
+	{
+		assert(!keyframes.empty());
+		if (keyframes.size() == 1 || time <= keyframes[0].time)
+			return keyframes[0].value;
+
+		// 最後のキー以降（NaNを含む）は最後の値
+		if (!(time <= keyframes.back().time))
+			return keyframes.back().value;
+
+		const uint32_t i = FindKey(keyframes, time, cursor);
+		return Math::Lerp(keyframes[i].value, keyframes[i + 1].value, GetInterpolationFactor(keyframes, i, time));
+	}
+
+	Quaternion AnimationSampler::SampleRotation(const std::vector<KeyframeQuat>& keyframes, float time, uint32_t& cursor)
+	{
+		assert(!keyframes.empty());
+		if (keyframes.size() == 1 || time <= keyframes[0].time)
+			return keyframes[0].value;
+
+		if (!(time <= keyframes.back().time))
+			return keyframes.back().value;
+
+		const uint32_t i = FindKey(keyframes, time, cursor);
+		return Slerp(keyframes[i].value, keyframes[i + 1].value, GetInterpolationFactor(keyframes, i, time), true);
+	}
+
+	Vector3 AnimationSampler::SampleValueLoop(const std::vector<KeyframeVec3>& keyframes, float time, float duration, uint32_t& cursor)
+	{
+		assert(!keyframes.empty());
+		if (keyframes.size() == 1)
+			return keyframes[0].value;
+
+		const KeyframeVec3& first = keyframes.front();
+		const KeyframeVec3& last = keyframes.back();
+
+		if (time <= last.time)
+		{
+			// 最初のキーより前はどの区間にも含まれず、既存の実装では最後の値になる
+			if (time < first.time)
+				return last.value;
+
+			const uint32_t i = FindKey(keyframes, time, cursor);
+			return Math::Lerp(keyframes[i].value, keyframes[i + 1].value, GetInterpolationFactor(keyframes, i, time));
+		}
+
+		float t = (time - last.time) / (duration - last.time + first.time);
+		return Math::Lerp(last.value, first.value, t);
+	}
+
+	Quaternion AnimationSampler::SampleRotationLoop(const std::vector<KeyframeQuat>& keyframes, float time, float duration, uint32_t& cursor)
+	{
+		assert(!keyframes.empty());
+		if (keyframes.size() == 1)
+			return keyframes[0].value;
+
+		const KeyframeQuat& first = keyframes.front();
+		const KeyframeQuat& last = keyframes.back();
+
+		if (time <= last.time)
+		{
+			if (time < first.time)
+				return last.value;
+
+			const uint32_t i = FindKey(keyframes, time, cursor);
+			return Slerp(keyframes[i].value, keyframes[i + 1].value, GetInterpolationFactor(keyframes, i, time), true);
+		}
+
+		float t = (time - last.time) / (duration - last.time + first.time);
+		return Slerp(last.value, first.value, t, true);
+	}
+
+	void AnimationSampler::SampleClip(const AnimationClip& clip, float time, AnimationCursor& cursor, JointPose* pose, uint32_t jointCount)
+	{
+		if (cursor.keys.size() != clip.curves.size() * 3)
+			cursor.keys.assign(clip.curves.size() * 3, 0);
+
+		uint32_t* keys = cursor.keys.data();
+		for (const AnimationCurve& curve : clip.curves)
+		{
+			if (curve.targetJoint < jointCount)
+			{
+				JointPose& joint = pose[curve.targetJoint];
+				joint.translation = SampleValue(curve.translation, time, keys[0]);
+				joint.rotation = SampleRotation(curve.rotation, time, keys[1]);
+				joint.scale = SampleValue(curve.scale, time, keys[2]);
+			}
+			keys += 3;
+		}
+	}
+}
@@ -0,0 +1,77 @@
+/**
+ * @file AnimationSampler.h
+ * @brief トラックごとのカーソルを使ったキーフレームのサンプリング
+ *
+ * 前回サンプリングしたキー区間を覚えておき、順再生では次の区間を数個調べるだけで済ませる。
+ * シークやループで時間が戻った場合や大きく進んだ場合は二分探索に切り替える。
+ * 結果はAnimation.hのCalculateValue / CaculateRotation / CalculateValueLoop /
+ * CalculateRotationLoopとビット単位で一致する（キーは時間順に並んでいること）。
+ */
+
+#pragma once
+#include "AnimationPose.h"
+#include "Runtime/Resource/Animation.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace AtomEngine
+{
+	/**
+	 * @struct AnimationCursor
+	 * @brief 1クリップ分のトラックごとのカーソル（インスタンスごとに持つ）
+	 */
+	struct AnimationCursor
+	{
+		/// カーブごとに平行移動・回転・スケールの順で、前回使ったキー区間の先頭番号
+		std::vector<uint32_t> keys;
+
+		/// 全てのカーソルを先頭に戻す
+		void Reset() { keys.assign(keys.size(), 0); }
+	};
+
+	/**
+	 * @class AnimationSampler
+	 * @brief カーソル付きのキーフレーム補間
+	 */
+	class AnimationSampler
+	{
+	public:
+		/**
+		 * @brief CalculateValueと同じ結果を返す
+		 * @param keyframes キーフレーム（空でないこと）
+		 * @param time 時間
+		 * @param cursor 前回のキー区間（更新される）
+		 */
+		static Vector3 SampleValue(const std::vector<KeyframeVec3>& keyframes, float time, uint32_t& cursor);
+
+		/**
+		 * @brief CaculateRotationと同じ結果を返す
+		 */
+		static Quaternion SampleRotation(const std::vector<KeyframeQuat>& keyframes, float time, uint32_t& cursor);
+
+		/**
+		 * @brief CalculateValueLoopと同じ結果を返す
+		 * @param duration クリップの長さ
+		 */
+		static Vector3 SampleValueLoop(const std::vector<KeyframeVec3>& keyframes, float time, float duration, uint32_t& cursor);
+
+		/**
+		 * @brief CalculateRotationLoopと同じ結果を返す
+		 * @param duration クリップの長さ
+		 */
+		static Quaternion SampleRotationLoop(const std::vector<KeyframeQuat>& keyframes, float time, float duration, uint32_t& cursor);
+
+		/**
+		 * @brief クリップの全チャンネルを1回でサンプリングしてポーズに書き込む
+		 *
+		 * 対象ジョイントがポーズの範囲外のカーブは無視する。
+		 * @param clip クリップ
+		 * @param time 時間
+		 * @param cursor このインスタンスのカーソル（カーブ数に合わせて初期化される）
+		 * @param pose 書き込み先のローカルポーズ
+		 * @param jointCount ポーズのジョイント数
+		 */
+		static void SampleClip(const AnimationClip& clip, float time, AnimationCursor& cursor, JointPose* pose, uint32_t jointCount);
+	};
+}
@@ -0,0 +1,120 @@
+#include "AnimationSystem.h"
+#include "Runtime/Core/Job/JobSystem.h"
+#include "Runtime/Core/Math/FrustumCulling.h"
+#include "Runtime/Function/Camera/CameraBase.h"
+#include "Runtime/Function/Framework/Component/MeshComponent.h"
+#include "Runtime/Function/Framework/ECS/World.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		/// この数未満なら並列化せずにメインスレッドで評価する
+		constexpr uint32_t kParallelThreshold = 8;
+
+		/// 1回の範囲関数で評価する最小インスタンス数
+		constexpr uint32_t kMinBatchSize = 4;
+	}
+
+	AnimationLodSettings AnimationSystem::sSettings;
+	AnimationUpdateStats AnimationSystem::sStats;
+	AnimationSystem::Batch AnimationSystem::sBatch;
+
+	void AnimationSystem::Batch::Clear()
+	{
+		meshes.clear();
+		centerX.clear();
+		centerY.clear();
+		centerZ.clear();
+		radius.clear();
+		intervals.clear();
+	}
+
+	uint32_t AnimationSystem::GetUpdateInterval(float screenSize, const AnimationLodSettings& settings)
+	{
+		if (!settings.enabled || settings.maxInterval <= 1)
+			return 1;
+
+		uint32_t interval = 1;
+		float threshold = settings.fullRateScreenSize;
+		while (screenSize < threshold && interval * 2 <= settings.maxInterval)
+		{
+			interval *= 2;
+			threshold *= 0.5f;
+		}
+		return interval;
+	}
+
+	void AnimationSystem::Update(World& world, const Camera& camera, float deltaTime)
+	{
+		Batch& batch = sBatch;
+		batch.Clear();
+
+		// アニメーションを持つインスタンスとワールド空間のバウンディングスフィアを集める
+		auto view = world.View<MeshComponent, TransformComponent>();
+		for (auto entity : view)
+		{
+			auto& mesh = view.get<MeshComponent>(entity);
+			if (!mesh.IsRender() || !mesh.IsAnimated())
+				continue;
+
+			const BoundingSphere sphere = mesh.GetWorldBoundingSphere(view.get<TransformComponent>(entity));
+			const Vector3 center = sphere.GetCenter();
+			batch.meshes.push_back(&mesh);
+			batch.centerX.push_back(center.x);
+			batch.centerY.push_back(center.y);
+			batch.centerZ.push_back(center.z);
+			batch.radius.push_back(sphere.GetRadius());
+		}
+
+		const uint32_t count = static_cast<uint32_t>(batch.meshes.size());
+		sStats = {};
+		sStats.instanceCount = count;
+		if (count == 0)
+			return;
+
+		// 画面外判定（見えるものはビットが1）
+		batch.visibility.assign(CullingPlanes::GetMaskWordCount(count), ~0u);
+		if (sSettings.cullOffscreen)
+		{
+			const CullingPlanes planes(camera.GetViewProjMatrix());
+			SphereArrays spheres;
+			spheres.centerX = batch.centerX.data();
+			spheres.centerY = batch.centerY.data();
+			spheres.centerZ = batch.centerZ.data();
+			spheres.radius = batch.radius.data();
+			const uint32_t visibleCount = planes.CullSpheres(spheres, count, batch.visibility.data());
+			sStats.culledCount = count - visibleCount;
+		}
+
+		// 画面上の大きさから評価間隔を決める
+		const Vector3 cameraPosition = camera.GetPosition();
+		batch.intervals.resize(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const Vector3 toCamera(batch.centerX[i] - cameraPosition.x, batch.centerY[i] - cameraPosition.y, batch.centerZ[i] - cameraPosition.z);
+			const float distance = std::max(toCamera.Length(), 1e-3f);
+			batch.intervals[i] = GetUpdateInterval(batch.radius[i] / distance, sSettings);
+			if (batch.intervals[i] > 1 && CullingPlanes::IsVisible(batch.visibility.data(), i))
+				++sStats.reducedCount;
+		}
+
+		// 各インスタンスは自身のポーズとスキニング行列だけを書き換えるので並列に評価できる
+		auto evaluate = [&batch, deltaTime](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					batch.meshes[i]->EvaluateAnimation(deltaTime, batch.intervals[i],
+						CullingPlanes::IsVisible(batch.visibility.data(), i));
+				}
+			};
+
+		if (count >= kParallelThreshold && JobSystem::GetWorkerCount() > 1)
+			JobSystem::ParallelFor(count, evaluate, kMinBatchSize);
+		else
+			evaluate(0, count);
+	}
+}
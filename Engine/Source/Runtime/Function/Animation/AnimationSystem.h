@@ -0,0 +1,91 @@
+/**
+ * @file AnimationSystem.h
+ * @brief アニメーションの並列更新と更新頻度のLOD
+ *
+ * 描画の更新より前に、アニメーションを持つ全インスタンスを集めてまとめて評価する。
+ * - 画面上の大きさ（半径 / カメラからの距離）に応じて評価を数フレームおきに間引き、
+ *   間のフレームは前回の評価結果から補間する
+ * - 視錐台の外にあるインスタンスは時間だけ進めて評価しない
+ * - 評価（クリップのサンプリング・ブレンド・スキニング行列）はJobSystemで並列に行う
+ * 画面外のインスタンスの影は、再び見えるまで最後のポーズのまま描かれる。
+ */
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace AtomEngine
+{
+	class World;
+	class Camera;
+	class MeshComponent;
+
+	/**
+	 * @struct AnimationLodSettings
+	 * @brief 更新頻度のLOD設定
+	 */
+	struct AnimationLodSettings
+	{
+		bool enabled = true;                ///< falseなら全インスタンスを毎フレーム評価する
+		bool cullOffscreen = true;          ///< 視錐台の外のインスタンスを評価しない
+		float fullRateScreenSize = 0.1f;    ///< 毎フレーム評価する画面上の大きさ（半径 / 距離）
+		uint32_t maxInterval = 8;           ///< 最大の評価間隔（フレーム数、2の累乗）
+	};
+
+	/**
+	 * @struct AnimationUpdateStats
+	 * @brief 直近の更新の統計
+	 */
+	struct AnimationUpdateStats
+	{
+		uint32_t instanceCount = 0;     ///< アニメーションを持つインスタンス数
+		uint32_t culledCount = 0;       ///< 画面外で評価しなかった数
+		uint32_t reducedCount = 0;      ///< 評価を間引いた数（評価間隔が2以上）
+	};
+
+	/**
+	 * @class AnimationSystem
+	 * @brief アニメーションを持つMeshComponentの更新
+	 */
+	class AnimationSystem
+	{
+	public:
+		/**
+		 * @brief 全インスタンスのアニメーションを評価する
+		 * @param world ワールド
+		 * @param camera LODと画面外判定に使うカメラ
+		 * @param deltaTime フレーム時間
+		 */
+		static void Update(World& world, const Camera& camera, float deltaTime);
+
+		/**
+		 * @brief 画面上の大きさから評価間隔を求める
+		 *
+		 * fullRateScreenSize以上なら1、半分になるごとに間隔を2倍にしてmaxIntervalで止める。
+		 * @param screenSize 画面上の大きさ（半径 / 距離）
+		 * @param settings LOD設定
+		 * @return 評価間隔（フレーム数）
+		 */
+		static uint32_t GetUpdateInterval(float screenSize, const AnimationLodSettings& settings);
+
+		static void SetLodSettings(const AnimationLodSettings& settings) { sSettings = settings; }
+		static const AnimationLodSettings& GetLodSettings() { return sSettings; }
+		static const AnimationUpdateStats& GetStats() { return sStats; }
+
+	private:
+		/// 毎フレーム集め直す作業用の配列（容量は使い回す）
+		struct Batch
+		{
+			std::vector<MeshComponent*> meshes;
+			std::vector<float> centerX, centerY, centerZ, radius;
+			std::vector<uint32_t> intervals;
+			std::vector<uint32_t> visibility;
+
+			void Clear();
+		};
+
+		static AnimationLodSettings sSettings;
+		static AnimationUpdateStats sStats;
+		static Batch sBatch;
+	};
+}
@@ -0,0 +1,289 @@
+#include "Animator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace AtomEngine
+{
+	Animator::Animator()
+	{
+		mLayers.emplace_back();
+	}
+
+	uint32_t Animator::AddLayer(BlendMode mode, float weight)
+	{
+		Layer& layer = mLayers.emplace_back();
+		layer.mode = mode;
+		layer.weight = weight;
+		return static_cast<uint32_t>(mLayers.size()) - 1;
+	}
+
+	void Animator::SetLayerWeight(uint32_t layer, float weight)
+	{
+		if (layer < mLayers.size())
+			mLayers[layer].weight = weight;
+	}
+
+	void Animator::SetLayerMask(uint32_t layer, std::vector<float> jointWeights)
+	{
+		if (layer < mLayers.size())
+			mLayers[layer].jointWeights = std::move(jointWeights);
+	}
+
+	void Animator::CrossFade(uint32_t layer, uint32_t clip, float fadeTime, bool loop)
+	{
+		if (layer >= mLayers.size())
+			return;
+
+		std::vector<Playback>& playbacks = mLayers[layer].playbacks;
+		auto it = std::find_if(playbacks.begin(), playbacks.end(),
+			[clip](const Playback& playback) { return playback.clip == clip; });
+
+		// 既に切り替え先なら時間はそのまま
+		if (it != playbacks.end() && it + 1 == playbacks.end() && it->fadeRate >= 0.0f)
+		{
+			it->loop = loop;
+			it->paused = false;
+			return;
+		}
+
+		Playback target;
+		if (it != playbacks.end())
+		{
+			target = std::move(*it);
+			playbacks.erase(it);
+		}
+		else
+		{
+			target.clip = clip;
+		}
+		target.loop = loop;
+		target.paused = false;
+
+		if (fadeTime <= 0.0f || (layer == 0 && playbacks.empty()))
+		{
+			playbacks.clear();
+			target.weight = 1.0f;
+			target.fadeRate = 0.0f;
+		}
+		else
+		{
+			// 全てのクリップがfadeTime後に同時に切り替わるよう、現在の重みから速度を決める
+			for (Playback& playback : playbacks)
+				playback.fadeRate = -playback.weight / fadeTime;
+			target.fadeRate = (1.0f - target.weight) / fadeTime;
+		}
+		playbacks.push_back(std::move(target));
+	}
+
+	void Animator::StopLayer(uint32_t layer, float fadeTime)
+	{
+		if (layer >= mLayers.size())
+			return;
+
+		std::vector<Playback>& playbacks = mLayers[layer].playbacks;
+		if (fadeTime <= 0.0f)
+		{
+			playbacks.clear();
+			return;
+		}
+		for (Playback& playback : playbacks)
+			playback.fadeRate = -playback.weight / fadeTime;
+	}
+
+	void Animator::Stop(uint32_t clip)
+	{
+		for (Layer& layer : mLayers)
+		{
+			std::erase_if(layer.playbacks, [clip](const Playback& playback) { return playback.clip == clip; });
+		}
+	}
+
+	void Animator::LoopAll(std::span<const AnimationClip> clips, uint32_t jointCount)
+	{
+		const uint32_t clipCount = static_cast<uint32_t>(clips.size());
+		for (uint32_t clip = 0; clip < clipCount; ++clip)
+			Stop(clip);
+		if (clipCount == 0)
+			return;
+
+		Play(0, 0, 0.0f, true);
+		for (uint32_t clip = 1; clip < clipCount; ++clip)
+		{
+			if (mLoopAllLayers.size() < clip)
+				mLoopAllLayers.push_back(AddLayer(BlendMode::kOverride));
+
+			const uint32_t layer = mLoopAllLayers[clip - 1];
+			SetLayerWeight(layer, 1.0f);
+			SetLayerMask(layer, AnimationBlend::MakeClipMask(clips[clip], jointCount));
+			Play(layer, clip, 0.0f, true);
+		}
+	}
+
+	void Animator::StopLoopAll(float fadeTime)
+	{
+		for (uint32_t layer : mLoopAllLayers)
+			StopLayer(layer, fadeTime);
+	}
+
+	void Animator::SetPaused(uint32_t clip, bool paused)
+	{
+		for (Layer& layer : mLayers)
+		{
+			for (Playback& playback : layer.playbacks)
+			{
+				if (playback.clip == clip)
+					playback.paused = paused;
+			}
+		}
+	}
+
+	void Animator::SetTime(uint32_t clip, float time)
+	{
+		for (Layer& layer : mLayers)
+		{
+			for (Playback& playback : layer.playbacks)
+			{
+				if (playback.clip == clip)
+					playback.time = time;
+			}
+		}
+	}
+
+	bool Animator::IsPlaying(uint32_t clip) const
+	{
+		for (const Layer& layer : mLayers)
+		{
+			for (const Playback& playback : layer.playbacks)
+			{
+				if (playback.clip == clip && !playback.paused)
+					return true;
+			}
+		}
+		return false;
+	}
+
+	bool Animator::IsActive() const
+	{
+		for (const Layer& layer : mLayers)
+		{
+			if (!layer.playbacks.empty())
+				return true;
+		}
+		return false;
+	}
+
+	bool Animator::IsLayerActive(uint32_t layer) const
+	{
+		return layer < mLayers.size() && !mLayers[layer].playbacks.empty();
+	}
+
+	void Animator::AdvancePlaybacks(Layer& layer, float deltaTime, std::span<const AnimationClip> clips)
+	{
+		for (Playback& playback : layer.playbacks)
+		{
+			const float duration = playback.clip < clips.size() ? clips[playback.clip].duration : 0.0f;
+
+			if (!playback.paused)
+				playback.time += deltaTime;
+
+			if (playback.loop && duration > 0.0f)
+			{
+				playback.time = std::fmod(playback.time, duration);
+				if (playback.time < 0.0f)
+					playback.time += duration;
+			}
+			else
+			{
+				// ループしないクリップは最後のフレームで止まる
+				playback.time = std::clamp(playback.time, 0.0f, std::max(duration, 0.0f));
+			}
+
+			playback.weight += playback.fadeRate * deltaTime;
+			if (playback.fadeRate > 0.0f && playback.weight >= 1.0f)
+			{
+				playback.weight = 1.0f;
+				playback.fadeRate = 0.0f;
+			}
+		}
+
+		std::erase_if(layer.playbacks, [](const Playback& playback)
+			{
+				return playback.fadeRate < 0.0f && playback.weight <= 0.0f;
+			});
+	}
+
+	bool Animator::Update(float deltaTime,
+		std::span<const AnimationClip> clips,
+		std::span<const CompressedAnimationClip> compressed,
+		const JointPose* bindPose,
+		JointPose* pose,
+		uint32_t jointCount)
+	{
+		size_t maxPlaybacks = 0;
+		for (Layer& layer : mLayers)
+		{
+			AdvancePlaybacks(layer, deltaTime, clips);
+			maxPlaybacks = std::max(maxPlaybacks, layer.playbacks.size());
+		}
+		if (maxPlaybacks == 0 || jointCount == 0)
+			return false;
+
+		mScratch.resize((maxPlaybacks + 1) * jointCount);
+		std::copy(bindPose, bindPose + jointCount, pose);
+
+		for (Layer& layer : mLayers)
+		{
+			if (layer.playbacks.empty() || layer.weight <= 0.0f)
+				continue;
+
+			// 再生中のクリップをそれぞれサンプリング
+			const uint32_t playbackCount = static_cast<uint32_t>(layer.playbacks.size());
+			mBlendInputs.resize(playbackCount);
+			mBlendWeights.resize(playbackCount);
+			float coverage = 0.0f;
+			for (uint32_t p = 0; p < playbackCount; ++p)
+			{
+				Playback& playback = layer.playbacks[p];
+				JointPose* sampled = mScratch.data() + static_cast<size_t>(p) * jointCount;
+				std::copy(bindPose, bindPose + jointCount, sampled);
+
+				if (playback.clip < compressed.size() && compressed[playback.clip].IsValid())
+					compressed[playback.clip].Sample(playback.time, sampled, jointCount);
+				else if (playback.clip < clips.size())
+					AnimationSampler::SampleClip(clips[playback.clip], playback.time, playback.cursor, sampled, jointCount);
+
+				mBlendInputs[p] = sampled;
+				mBlendWeights[p] = playback.weight;
+				coverage += playback.weight;
+			}
+
+			// クロスフェード中のクリップを1つのポーズにまとめる
+			JointPose* layerPose = mScratch.data();
+			if (playbackCount > 1)
+			{
+				layerPose = mScratch.data() + static_cast<size_t>(playbackCount) * jointCount;
+				AnimationBlend::Blend(mBlendInputs.data(), mBlendWeights.data(), playbackCount, layerPose, jointCount);
+			}
+
+			const float weight = layer.weight * std::min(coverage, 1.0f);
+			const float* jointWeights = layer.jointWeights.size() >= jointCount ? layer.jointWeights.data() : nullptr;
+
+			if (layer.mode == BlendMode::kAdditive)
+			{
+				AnimationBlend::MakeAdditive(layerPose, bindPose, layerPose, jointCount);
+				AnimationBlend::ApplyAdditive(pose, layerPose, weight, jointWeights, pose, jointCount);
+			}
+			else if (weight >= 1.0f && !jointWeights)
+			{
+				std::copy(layerPose, layerPose + jointCount, pose);
+			}
+			else
+			{
+				AnimationBlend::Lerp(pose, layerPose, weight, jointWeights, pose, jointCount);
+			}
+		}
+		return true;
+	}
+}
@@ -0,0 +1,182 @@
+/**
+ * @file Animator.h
+ * @brief レイヤーとクロスフェードによるアニメーション再生状態
+ *
+ * エンティティごとに持つ小さな再生状態。レイヤーごとに再生中のクリップと重みを持ち、
+ * Updateで時間を進めてからレイヤーを順に合成してローカルポーズを作る。
+ * - 上書きレイヤー: 下のレイヤーの結果に重みとジョイントマスクで補間する
+ * - 加算レイヤー: バインドポーズとの差分を重みとジョイントマスクで加算する
+ * コストは「ジョイント数 × 再生中のクリップ数」に比例する。
+ *
+ * 使用例:
+ * @code
+ * Animator animator;
+ * animator.CrossFade(0, runClip, 0.2f, true);
+ * uint32_t upper = animator.AddLayer(Animator::BlendMode::kOverride);
+ * animator.SetLayerMask(upper, AnimationBlend::MakeJointMask(skeleton, spineJoint));
+ * animator.Play(upper, waveClip, 0.0f, false);
+ * animator.Update(deltaTime, clips, compressedClips, bindPose, pose, jointCount);
+ * @endcode
+ */
+
+#pragma once
+#include "AnimationBlend.h"
+#include "AnimationCompression.h"
+#include "AnimationSampler.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace AtomEngine
+{
+	/**
+	 * @class Animator
+	 * @brief アニメーションのレイヤー・クロスフェード管理
+	 */
+	class Animator
+	{
+	public:
+		/// レイヤーの合成方法
+		enum class BlendMode
+		{
+			kOverride,  ///< 下のレイヤーの結果に補間する
+			kAdditive,  ///< バインドポーズとの差分を加算する
+		};
+
+		Animator();
+
+		/**
+		 * @brief レイヤーを追加する（レイヤー0は常に存在する上書きレイヤー）
+		 * @param mode 合成方法
+		 * @param weight レイヤーの重み
+		 * @return 追加したレイヤーの番号
+		 */
+		uint32_t AddLayer(BlendMode mode, float weight = 1.0f);
+
+		uint32_t GetLayerCount() const { return static_cast<uint32_t>(mLayers.size()); }
+
+		void SetLayerWeight(uint32_t layer, float weight);
+
+		/**
+		 * @brief レイヤーのジョイントマスクを設定する
+		 * @param layer レイヤー番号
+		 * @param jointWeights ジョイントごとの重み（空なら全ジョイントに1）
+		 */
+		void SetLayerMask(uint32_t layer, std::vector<float> jointWeights);
+
+		/**
+		 * @brief クリップを再生する（fadeTimeが0なら即座に切り替える）
+		 *
+		 * 引数の順はCrossFadeと同じ（boolとfloatは暗黙に変換されるので順を揃えている）。
+		 * @param layer レイヤー番号
+		 * @param clip クリップ番号
+		 * @param fadeTime クロスフェードの時間（秒）
+		 * @param loop ループ再生するか
+		 */
+		void Play(uint32_t layer, uint32_t clip, float fadeTime, bool loop) { CrossFade(layer, clip, fadeTime, loop); }
+
+		/**
+		 * @brief 現在のクリップからクロスフェードする
+		 *
+		 * 既に同じクリップへ切り替え中・再生中なら時間は戻さない。
+		 * フェードアウト中のクリップを再び選んだ場合はその時間から続ける。
+		 * レイヤー0で何も再生していない場合は、バインドポーズからフェードしないよう即座に切り替える。
+		 * @param layer レイヤー番号
+		 * @param clip クリップ番号
+		 * @param fadeTime クロスフェードの時間（秒）
+		 * @param loop ループ再生するか
+		 */
+		void CrossFade(uint32_t layer, uint32_t clip, float fadeTime, bool loop);
+
+		/**
+		 * @brief レイヤーの全クリップをフェードアウトする
+		 * @param layer レイヤー番号
+		 * @param fadeTime フェードアウトの時間（秒、0なら即座に止める）
+		 */
+		void StopLayer(uint32_t layer, float fadeTime = 0.0f);
+
+		/// 全レイヤーから指定クリップを取り除く
+		void Stop(uint32_t clip);
+
+		/**
+		 * @brief 全クリップを先頭から同時にループ再生する
+		 *
+		 * クリップ0をレイヤー0で、それ以降はクリップごとの上書きレイヤーで再生する。
+		 * 各レイヤーはそのクリップがカーブを持つジョイントだけに効くので、
+		 * 後のクリップが同じジョイントを上書きする（1クリップずつ順に評価していた従来の再生と同じ結果）。
+		 * レイヤーは初回に追加し、2回目以降は使い回す。
+		 * @param clips クリップ
+		 * @param jointCount ジョイント数
+		 */
+		void LoopAll(std::span<const AnimationClip> clips, uint32_t jointCount);
+
+		/**
+		 * @brief LoopAllで追加したレイヤーを止める（レイヤー0はそのまま）
+		 * @param fadeTime フェードアウトの時間（秒、0なら即座に止める）
+		 */
+		void StopLoopAll(float fadeTime = 0.0f);
+
+		/// 指定クリップの時間を止める・再開する
+		void SetPaused(uint32_t clip, bool paused);
+
+		/// 指定クリップの再生時間を設定する
+		void SetTime(uint32_t clip, float time);
+
+		/// 指定クリップがいずれかのレイヤーで再生中か
+		bool IsPlaying(uint32_t clip) const;
+
+		/// 再生中のクリップがあるか
+		bool IsActive() const;
+
+		/// 指定レイヤーで再生中（フェードアウト中を含む）のクリップがあるか
+		bool IsLayerActive(uint32_t layer) const;
+
+		/**
+		 * @brief 時間を進めてローカルポーズを作る
+		 *
+		 * 再生中のクリップが無い場合はposeを書き換えずにfalseを返す。
+		 * @param deltaTime 経過時間
+		 * @param clips クリップ（クリップ番号で参照する）
+		 * @param compressed 圧縮済みクリップ（clipsと同じ並び、有効なものを優先して使う）
+		 * @param bindPose バインドポーズ（カーブの無いジョイントと加算レイヤーの基準）
+		 * @param pose 出力ポーズ
+		 * @param jointCount ジョイント数
+		 * @return poseを更新したらtrue
+		 */
+		bool Update(float deltaTime,
+			std::span<const AnimationClip> clips,
+			std::span<const CompressedAnimationClip> compressed,
+			const JointPose* bindPose,
+			JointPose* pose,
+			uint32_t jointCount);
+
+	private:
+		struct Playback
+		{
+			uint32_t clip = 0;
+			float time = 0.0f;
+			float weight = 0.0f;
+			float fadeRate = 0.0f;   ///< 1秒あたりの重みの変化（負ならフェードアウト）
+			bool loop = false;
+			bool paused = false;
+			AnimationCursor cursor;
+		};
+
+		struct Layer
+		{
+			BlendMode mode = BlendMode::kOverride;
+			float weight = 1.0f;
+			std::vector<float> jointWeights;
+			std::vector<Playback> playbacks;    ///< 末尾が切り替え先のクリップ
+		};
+
+		void AdvancePlaybacks(Layer& layer, float deltaTime, std::span<const AnimationClip> clips);
+
+		std::vector<Layer> mLayers;
+		std::vector<uint32_t> mLoopAllLayers;   ///< LoopAllでクリップ1以降を再生するレイヤー
+		std::vector<JointPose> mScratch;    ///< サンプリング結果とレイヤーの合成結果
+		std::vector<const JointPose*> mBlendInputs;
+		std::vector<float> mBlendWeights;
+	};
+}
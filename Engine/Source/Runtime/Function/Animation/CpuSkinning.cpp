@@ -0,0 +1,410 @@
+#include "CpuSkinning.h"
+#include "Runtime/Core/Job/JobSystem.h"
+#include "Runtime/Core/Math/SIMD.h"
+#include "Runtime/Resource/SkinPacking.h"
+#include "Runtime/Resource/VertexCompression.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		using namespace SIMD;
+
+		/// 合計の頂点数がこれ未満なら並列化しない
+		constexpr uint32_t kParallelThreshold = CpuSkinning::kBatchVertexCount * 2;
+
+		/// 1レーン分の空のスキン（ウェイト0。端数のレーンに使う）
+		constexpr JointVertex kEmptyJointVertex = {};
+
+		/// 剛体変換のデュアルクォータニオン（実部が回転、双対部が0.5 * 平行移動 * 回転）
+		struct DualQuaternion
+		{
+			float real[4];
+			float dual[4];
+		};
+
+		/// パレットの行列を変換する（行の長さで割ってスケールを取り除く）
+		DualQuaternion ToDualQuaternion(const Matrix4x4& m)
+		{
+			Vector3 rows[3];
+			for (int r = 0; r < 3; ++r)
+			{
+				rows[r] = Vector3(m.mat[r][0], m.mat[r][1], m.mat[r][2]);
+				const float length = rows[r].Length();
+				if (length > 1e-12f)
+					rows[r] = rows[r] / length;
+			}
+			Quaternion q(Matrix3x3(rows[0], rows[1], rows[2]));
+			q.Normalize();
+
+			// (t, 0) * q の半分
+			const float tx = m.mat[3][0], ty = m.mat[3][1], tz = m.mat[3][2];
+			DualQuaternion dq;
+			dq.real[0] = q.x; dq.real[1] = q.y; dq.real[2] = q.z; dq.real[3] = q.w;
+			dq.dual[0] = 0.5f * (q.w * tx + ty * q.z - tz * q.y);
+			dq.dual[1] = 0.5f * (q.w * ty + tz * q.x - tx * q.z);
+			dq.dual[2] = 0.5f * (q.w * tz + tx * q.y - ty * q.x);
+			dq.dual[3] = -0.5f * (tx * q.x + ty * q.y + tz * q.z);
+			return dq;
+		}
+
+		/// 4要素を読む（count未満のレーンは0）
+		inline Float4 LoadLanes(const float* p, uint32_t count)
+		{
+			if (count == 4)
+				return Load(p);
+			float lanes[4] = {};
+			std::copy(p, p + count, lanes);
+			return Load(lanes);
+		}
+
+		/// count個のレーンだけを書く
+		inline void StoreLanes(float* p, Float4 v, uint32_t count)
+		{
+			if (count == 4)
+			{
+				Store(p, v);
+				return;
+			}
+			float lanes[4];
+			Store(lanes, v);
+			std::copy(lanes, lanes + count, p);
+		}
+
+		/// 4レーンの4要素の行を読み、要素ごとにレーンを並べた形にする（c0 = 各レーンのrow[0]、...）
+		inline void Gather(const float* const rows[4], Float4& c0, Float4& c1, Float4& c2, Float4& c3)
+		{
+			c0 = Load(rows[0]);
+			c1 = Load(rows[1]);
+			c2 = Load(rows[2]);
+			c3 = Load(rows[3]);
+			Transpose(c0, c1, c2, c3);
+		}
+
+		/// 長さ0の場合はそのまま返す正規化
+		inline void Normalize3(Float4& x, Float4& y, Float4& z)
+		{
+			const Float4 lengthSqr = Add(Add(Mul(x, x), Mul(y, y)), Mul(z, z));
+			const Float4 invLength = Div(Splat(1.0f), Sqrt(Max(lengthSqr, Splat(1e-24f))));
+			x = Mul(x, invLength);
+			y = Mul(y, invLength);
+			z = Mul(z, invLength);
+		}
+
+		/// 回転 q * v * conj(q)。qは単位でなくてもよく、結果は|q|^2倍になる
+		inline void Rotate(Float4 qx, Float4 qy, Float4 qz, Float4 qw, Float4& x, Float4& y, Float4& z)
+		{
+			const Float4 s = Sub(Mul(qw, qw), Add(Add(Mul(qx, qx), Mul(qy, qy)), Mul(qz, qz)));
+			const Float4 d = Add(Add(Mul(qx, x), Mul(qy, y)), Mul(qz, z));
+			const Float4 d2 = Add(d, d);
+			const Float4 w2 = Add(qw, qw);
+			const Float4 cx = Sub(Mul(qy, z), Mul(qz, y));
+			const Float4 cy = Sub(Mul(qz, x), Mul(qx, z));
+			const Float4 cz = Sub(Mul(qx, y), Mul(qy, x));
+			const Float4 rx = Add(Add(Mul(s, x), Mul(d2, qx)), Mul(w2, cx));
+			const Float4 ry = Add(Add(Mul(s, y), Mul(d2, qy)), Mul(w2, cy));
+			const Float4 rz = Add(Add(Mul(s, z), Mul(d2, qz)), Mul(w2, cz));
+			x = rx;
+			y = ry;
+			z = rz;
+		}
+
+		/**
+		 * @brief ジョブの[begin, end)の頂点を処理する
+		 * @param dualQuaternions デュアルクォータニオンのパレット（線形ブレンドならnullptr）
+		 * @param bounds 出力した位置を加える箱（不要ならnullptr）
+		 */
+		void SkinRange(const SkinningJob& job, const DualQuaternion* dualQuaternions,
+			uint32_t begin, uint32_t end, AxisAlignedBox* bounds)
+		{
+			const bool hasNormals = job.normals.x != nullptr;
+			const Float4 weightScale = Splat(1.0f / SkinPacking::kWeightScale);
+			Float4 boundsMin[3] = { Splat(FLT_MAX), Splat(FLT_MAX), Splat(FLT_MAX) };
+			Float4 boundsMax[3] = { Splat(-FLT_MAX), Splat(-FLT_MAX), Splat(-FLT_MAX) };
+
+			for (uint32_t v = begin; v < end; v += 4)
+			{
+				const uint32_t count = std::min(end - v, 4u);
+				const JointVertex* lanes[4];
+				for (uint32_t i = 0; i < 4; ++i)
+					lanes[i] = i < count ? &job.joints[v + i] : &kEmptyJointVertex;
+
+				const Float4 px = LoadLanes(job.positions.x + v, count);
+				const Float4 py = LoadLanes(job.positions.y + v, count);
+				const Float4 pz = LoadLanes(job.positions.z + v, count);
+				Float4 nx = Zero(), ny = Zero(), nz = Zero();
+				if (hasNormals)
+				{
+					nx = LoadLanes(job.normals.x + v, count);
+					ny = LoadLanes(job.normals.y + v, count);
+					nz = LoadLanes(job.normals.z + v, count);
+				}
+
+				Float4 ox, oy, oz, onx, ony, onz;
+				if (!dualQuaternions)
+				{
+					// シェーダーと同じく、各ジョイントで変換してからウェイトを掛けて足す
+					ox = oy = oz = onx = ony = onz = Zero();
+					for (uint32_t k = 0; k < SkinPacking::kMaxInfluences; ++k)
+					{
+						// ウェイトは大きい順なので、4頂点とも0になったら残りも0
+						if (k > 0 && (lanes[0]->weights[k] | lanes[1]->weights[k] | lanes[2]->weights[k] | lanes[3]->weights[k]) == 0)
+							break;
+
+						const Float4 w = Mul(Set(lanes[0]->weights[k], lanes[1]->weights[k], lanes[2]->weights[k], lanes[3]->weights[k]), weightScale);
+						const JointXform* xforms[4];
+						for (uint32_t i = 0; i < 4; ++i)
+							xforms[i] = &job.palette[lanes[i]->jointIndices[k]];
+
+						Float4 m[4][4];     // m[行][列]の各レーン
+						for (int r = 0; r < 4; ++r)
+						{
+							const float* rows[4] = { xforms[0]->posXform.mat[r], xforms[1]->posXform.mat[r], xforms[2]->posXform.mat[r], xforms[3]->posXform.mat[r] };
+							Gather(rows, m[r][0], m[r][1], m[r][2], m[r][3]);
+						}
+						ox = Add(ox, Mul(Add(Add(Add(Mul(px, m[0][0]), Mul(py, m[1][0])), Mul(pz, m[2][0])), m[3][0]), w));
+						oy = Add(oy, Mul(Add(Add(Add(Mul(px, m[0][1]), Mul(py, m[1][1])), Mul(pz, m[2][1])), m[3][1]), w));
+						oz = Add(oz, Mul(Add(Add(Add(Mul(px, m[0][2]), Mul(py, m[1][2])), Mul(pz, m[2][2])), m[3][2]), w));
+
+						if (hasNormals)
+						{
+							for (int r = 0; r < 3; ++r)
+							{
+								const float* rows[4] = { xforms[0]->nrmXform.mat[r], xforms[1]->nrmXform.mat[r], xforms[2]->nrmXform.mat[r], xforms[3]->nrmXform.mat[r] };
+								Gather(rows, m[r][0], m[r][1], m[r][2], m[r][3]);
+							}
+							onx = Add(onx, Mul(Add(Add(Mul(nx, m[0][0]), Mul(ny, m[1][0])), Mul(nz, m[2][0])), w));
+							ony = Add(ony, Mul(Add(Add(Mul(nx, m[0][1]), Mul(ny, m[1][1])), Mul(nz, m[2][1])), w));
+							onz = Add(onz, Mul(Add(Add(Mul(nx, m[0][2]), Mul(ny, m[1][2])), Mul(nz, m[2][2])), w));
+						}
+					}
+				}
+				else
+				{
+					// 最初のジョイントと同じ半球に揃えて足し、長さで割る
+					Float4 bx = Zero(), by = Zero(), bz = Zero(), bw = Zero();
+					Float4 ex = Zero(), ey = Zero(), ez = Zero(), ew = Zero();
+					Float4 pivotX = Zero(), pivotY = Zero(), pivotZ = Zero(), pivotW = Zero();
+					for (uint32_t k = 0; k < SkinPacking::kMaxInfluences; ++k)
+					{
+						if (k > 0 && (lanes[0]->weights[k] | lanes[1]->weights[k] | lanes[2]->weights[k] | lanes[3]->weights[k]) == 0)
+							break;
+
+						Float4 w = Mul(Set(lanes[0]->weights[k], lanes[1]->weights[k], lanes[2]->weights[k], lanes[3]->weights[k]), weightScale);
+						const DualQuaternion* dq[4];
+						for (uint32_t i = 0; i < 4; ++i)
+							dq[i] = &dualQuaternions[lanes[i]->jointIndices[k]];
+
+						Float4 qx, qy, qz, qw, dx, dy, dz, dw;
+						const float* reals[4] = { dq[0]->real, dq[1]->real, dq[2]->real, dq[3]->real };
+						const float* duals[4] = { dq[0]->dual, dq[1]->dual, dq[2]->dual, dq[3]->dual };
+						Gather(reals, qx, qy, qz, qw);
+						Gather(duals, dx, dy, dz, dw);
+
+						if (k == 0)
+						{
+							pivotX = qx; pivotY = qy; pivotZ = qz; pivotW = qw;
+						}
+						else
+						{
+							const Float4 dot = Add(Add(Add(Mul(qx, pivotX), Mul(qy, pivotY)), Mul(qz, pivotZ)), Mul(qw, pivotW));
+							w = Select(w, Neg(w), CmpLT(dot, Zero()));
+						}
+						bx = Add(bx, Mul(qx, w)); by = Add(by, Mul(qy, w)); bz = Add(bz, Mul(qz, w)); bw = Add(bw, Mul(qw, w));
+						ex = Add(ex, Mul(dx, w)); ey = Add(ey, Mul(dy, w)); ez = Add(ez, Mul(dz, w)); ew = Add(ew, Mul(dw, w));
+					}
+
+					const Float4 lengthSqr = Max(Add(Add(Add(Mul(bx, bx), Mul(by, by)), Mul(bz, bz)), Mul(bw, bw)), Splat(1e-24f));
+					const Float4 invLengthSqr = Div(Splat(1.0f), lengthSqr);
+
+					// 平行移動 = 2 * (双対部 * conj(実部)) のベクトル部（|実部|^2倍）
+					const Float4 tx = Add(Sub(Mul(bw, ex), Mul(ew, bx)), Sub(Mul(by, ez), Mul(bz, ey)));
+					const Float4 ty = Add(Sub(Mul(bw, ey), Mul(ew, by)), Sub(Mul(bz, ex), Mul(bx, ez)));
+					const Float4 tz = Add(Sub(Mul(bw, ez), Mul(ew, bz)), Sub(Mul(bx, ey), Mul(by, ex)));
+
+					ox = px; oy = py; oz = pz;
+					Rotate(bx, by, bz, bw, ox, oy, oz);
+					ox = Mul(Add(ox, Add(tx, tx)), invLengthSqr);
+					oy = Mul(Add(oy, Add(ty, ty)), invLengthSqr);
+					oz = Mul(Add(oz, Add(tz, tz)), invLengthSqr);
+
+					onx = nx; ony = ny; onz = nz;
+					if (hasNormals)
+						Rotate(bx, by, bz, bw, onx, ony, onz);
+				}
+
+				StoreLanes(job.outPositions.x + v, ox, count);
+				StoreLanes(job.outPositions.y + v, oy, count);
+				StoreLanes(job.outPositions.z + v, oz, count);
+				if (hasNormals)
+				{
+					Normalize3(onx, ony, onz);
+					StoreLanes(job.outNormals.x + v, onx, count);
+					StoreLanes(job.outNormals.y + v, ony, count);
+					StoreLanes(job.outNormals.z + v, onz, count);
+				}
+
+				if (bounds)
+				{
+					// 使わないレーンは最初のレーンで埋める
+					const Float4 first[3] = { SplatLane<0>(ox), SplatLane<0>(oy), SplatLane<0>(oz) };
+					const Float4 valid = CmpLT(Set(0.0f, 1.0f, 2.0f, 3.0f), Splat(static_cast<float>(count)));
+					const Float4 values[3] = { Select(first[0], ox, valid), Select(first[1], oy, valid), Select(first[2], oz, valid) };
+					for (int c = 0; c < 3; ++c)
+					{
+						boundsMin[c] = Min(boundsMin[c], values[c]);
+						boundsMax[c] = Max(boundsMax[c], values[c]);
+					}
+				}
+			}
+
+			if (bounds && begin < end)
+			{
+				float minLanes[3][4], maxLanes[3][4];
+				for (int c = 0; c < 3; ++c)
+				{
+					Store(minLanes[c], boundsMin[c]);
+					Store(maxLanes[c], boundsMax[c]);
+				}
+				for (int i = 0; i < 4; ++i)
+				{
+					bounds->AddPoint(Vector3(minLanes[0][i], minLanes[1][i], minLanes[2][i]));
+					bounds->AddPoint(Vector3(maxLanes[0][i], maxLanes[1][i], maxLanes[2][i]));
+				}
+			}
+		}
+
+		/// デュアルクォータニオンを使うジョブのパレットを変換する（ジョブごとの先頭をoffsetsに入れる）
+		void BuildDualQuaternions(const SkinningJob* jobs, size_t count,
+			std::vector<DualQuaternion>& dualQuaternions, std::vector<size_t>& offsets)
+		{
+			offsets.assign(count, 0);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const SkinningJob& job = jobs[i];
+				if (job.method != SkinningMethod::kDualQuaternion || job.vertexCount == 0)
+					continue;
+				offsets[i] = dualQuaternions.size();
+				for (uint32_t j = 0; j < job.paletteCount; ++j)
+					dualQuaternions.push_back(ToDualQuaternion(job.palette[j].posXform));
+			}
+		}
+
+		const DualQuaternion* GetDualQuaternions(const SkinningJob& job,
+			const std::vector<DualQuaternion>& dualQuaternions, size_t offset)
+		{
+			return job.method == SkinningMethod::kDualQuaternion ? dualQuaternions.data() + offset : nullptr;
+		}
+	}
+
+	void CpuSkinning::Skin(const SkinningJob& job)
+	{
+		std::vector<DualQuaternion> dualQuaternions;
+		std::vector<size_t> offsets;
+		BuildDualQuaternions(&job, 1, dualQuaternions, offsets);
+
+		if (job.outBounds)
+			*job.outBounds = AxisAlignedBox();
+		SkinRange(job, GetDualQuaternions(job, dualQuaternions, offsets[0]),
+			job.vertexOffset, job.vertexOffset + job.vertexCount, job.outBounds);
+	}
+
+	void CpuSkinning::Skin(const SkinningJob* jobs, size_t count)
+	{
+		if (count == 0)
+			return;
+
+		std::vector<DualQuaternion> dualQuaternions;
+		std::vector<size_t> offsets;
+		BuildDualQuaternions(jobs, count, dualQuaternions, offsets);
+
+		// ジョブをkBatchVertexCountずつに区切り、通し番号で並列に処理する
+		std::vector<uint32_t> batchStarts(count + 1, 0);
+		size_t vertexCount = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			batchStarts[i + 1] = batchStarts[i] + (jobs[i].vertexCount + kBatchVertexCount - 1) / kBatchVertexCount;
+			vertexCount += jobs[i].vertexCount;
+		}
+		const uint32_t batchCount = batchStarts[count];
+		std::vector<AxisAlignedBox> batchBounds(batchCount);
+
+		auto skin = [&](uint32_t first, uint32_t last)
+			{
+				size_t jobIndex = std::upper_bound(batchStarts.begin(), batchStarts.end(), first) - batchStarts.begin() - 1;
+				for (uint32_t batch = first; batch < last; ++batch)
+				{
+					while (batch >= batchStarts[jobIndex + 1])
+						++jobIndex;
+					const SkinningJob& job = jobs[jobIndex];
+					const uint32_t begin = job.vertexOffset + (batch - batchStarts[jobIndex]) * kBatchVertexCount;
+					const uint32_t end = std::min(begin + kBatchVertexCount, job.vertexOffset + job.vertexCount);
+					SkinRange(job, GetDualQuaternions(job, dualQuaternions, offsets[jobIndex]),
+						begin, end, job.outBounds ? &batchBounds[batch] : nullptr);
+				}
+			};
+
+		if (vertexCount >= kParallelThreshold && batchCount > 1 && JobSystem::GetWorkerCount() > 1)
+			JobSystem::ParallelFor(batchCount, skin);
+		else
+			skin(0, batchCount);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!jobs[i].outBounds)
+				continue;
+			AxisAlignedBox bounds;
+			for (uint32_t batch = batchStarts[i]; batch < batchStarts[i + 1]; ++batch)
+				bounds = bounds.Union(batchBounds[batch]);
+			*jobs[i].outBounds = bounds;
+		}
+	}
+
+	uint32_t CpuSkinning::DecodeVertices(const PositionVertex* positions, const AttributeVertex* attributes,
+		const JointVertex* skin, uint32_t vertexCount, const std::vector<Mesh>& meshes,
+		SkinningVertices& outVertices, std::vector<JointVertex>& outJoints)
+	{
+		outVertices.Resize(vertexCount);
+		outJoints.assign(skin, skin + vertexCount);
+
+		uint32_t remapped = 0;
+		for (const Mesh& mesh : meshes)
+		{
+			for (const SubMesh& sub : mesh.subMeshes)
+			{
+				const uint32_t end = std::min(sub.vertexOffset + sub.vertexCount, vertexCount);
+				for (uint32_t v = sub.vertexOffset; v < end; ++v)
+				{
+					const Vector3 position = VertexCompression::DecodePosition(positions[v], sub.positionDequantization);
+					Vector2 texcoord;
+					Vector3 normal, tangent, bitangent;
+					VertexCompression::DecodeAttributes(attributes[v], texcoord, normal, tangent, bitangent);
+
+					outVertices.positionX[v] = position.x;
+					outVertices.positionY[v] = position.y;
+					outVertices.positionZ[v] = position.z;
+					outVertices.normalX[v] = normal.x;
+					outVertices.normalY[v] = normal.y;
+					outVertices.normalZ[v] = normal.z;
+
+					if (!(mesh.psoFlags & kHasSkin))
+						continue;
+					// パレットの外を読まないよう、範囲外のジョイントは0番にする
+					for (uint32_t k = 0; k < SkinPacking::kMaxInfluences; ++k)
+					{
+						uint16_t& joint = outJoints[v].jointIndices[k];
+						if (joint >= mesh.numJoints)
+						{
+							joint = 0;
+							++remapped;
+						}
+					}
+				}
+			}
+		}
+		return remapped;
+	}
+}
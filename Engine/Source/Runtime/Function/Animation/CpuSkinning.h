@@ -0,0 +1,127 @@
+/**
+ * @file CpuSkinning.h
+ * @brief スキンメッシュの頂点をCPUで変形する
+ *
+ * GPUと同じスキンストリーム（JointVertex）とスキニング行列のパレットから、ポーズを付けた位置と法線を求める。
+ * 描画には使わず、アニメーション中のキャラクターの境界の更新・ピッキング・衝突判定や、
+ * GPUのないところでのスキニング結果の確認に使う。
+ * - 頂点はSoAで持ち、4頂点ずつSIMDで処理する（端数も同じ処理で、使わないレーンを捨てる）
+ * - 線形ブレンド（シェーダーと同じ計算順）とデュアルクォータニオンのどちらかを選べる
+ * - 複数のジョブ（メッシュ・インスタンス）をまとめて渡すと、頂点を区切ってJobSystemで並列に処理する
+ * 出力はパレットと同じ空間（スケルトンの空間）で、法線は正規化する。
+ */
+
+#pragma once
+#include "Runtime/Core/Math/BatchTransform.h"
+#include "Runtime/Resource/Mesh.h"
+#include "Runtime/Resource/Skeleton.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AtomEngine
+{
+	/// スキニングの方法
+	enum class SkinningMethod : uint8_t
+	{
+		kLinear,            ///< 行列の線形ブレンド（GPUと同じ）
+		kDualQuaternion,    ///< デュアルクォータニオンのブレンド（関節のつぶれがない。パレットのスケールは無視する）
+	};
+
+	/**
+	 * @struct SkinningVertices
+	 * @brief 位置と法線のSoA配列
+	 */
+	struct SkinningVertices
+	{
+		std::vector<float> positionX, positionY, positionZ;
+		std::vector<float> normalX, normalY, normalZ;
+
+		void Resize(size_t count)
+		{
+			positionX.resize(count); positionY.resize(count); positionZ.resize(count);
+			normalX.resize(count); normalY.resize(count); normalZ.resize(count);
+		}
+
+		size_t GetCount() const { return positionX.size(); }
+
+		ConstVector3Arrays GetPositions() const { return { positionX.data(), positionY.data(), positionZ.data() }; }
+		ConstVector3Arrays GetNormals() const { return { normalX.data(), normalY.data(), normalZ.data() }; }
+		Vector3Arrays GetPositions() { return { positionX.data(), positionY.data(), positionZ.data() }; }
+		Vector3Arrays GetNormals() { return { normalX.data(), normalY.data(), normalZ.data() }; }
+	};
+
+	/**
+	 * @struct SkinningJob
+	 * @brief 1つの頂点範囲のスキニング
+	 *
+	 * 入出力の配列は同じ番号で引く（vertexOffsetから）。入力と出力に同じ配列を渡してもよい。
+	 */
+	struct SkinningJob
+	{
+		ConstVector3Arrays positions;       ///< バインドポーズの位置
+		ConstVector3Arrays normals;         ///< バインドポーズの法線（xがnullptrなら法線は出力しない）
+		const JointVertex* joints = nullptr;
+		const JointXform* palette = nullptr;    ///< ジョイント番号で引くパレット（Mesh::startJointを足した位置）
+		uint32_t paletteCount = 0;          ///< ジョイント番号はこれ未満であること（DecodeVerticesで確認する）
+		uint32_t vertexOffset = 0;
+		uint32_t vertexCount = 0;
+		SkinningMethod method = SkinningMethod::kLinear;
+
+		Vector3Arrays outPositions;
+		Vector3Arrays outNormals;           ///< normalsがある場合だけ使う
+		AxisAlignedBox* outBounds = nullptr;    ///< 出力した位置を囲む箱（不要ならnullptr）
+	};
+
+	/**
+	 * @class CpuSkinning
+	 * @brief CPUスキニングの関数群
+	 *
+	 * 使用例:
+	 * @code
+	 * std::vector<SkinningJob> jobs;
+	 * for (MeshComponent* mesh : characters)
+	 *     mesh->CreateSkinningJobs(outputs[i], SkinningMethod::kLinear, jobs);
+	 * CpuSkinning::Skin(jobs.data(), jobs.size());
+	 * @endcode
+	 */
+	class CpuSkinning
+	{
+	public:
+		/// 1回の範囲関数で処理する頂点数（4の倍数）
+		static constexpr uint32_t kBatchVertexCount = 2048;
+
+		/**
+		 * @brief 1つのジョブを呼び出したスレッドで処理する
+		 */
+		static void Skin(const SkinningJob& job);
+
+		/**
+		 * @brief 複数のジョブをまとめて処理する
+		 *
+		 * 合計の頂点数が多ければ、ジョブをkBatchVertexCountずつに区切ってJobSystemで並列に処理する。
+		 * @param jobs ジョブの配列
+		 * @param count ジョブの数
+		 */
+		static void Skin(const SkinningJob* jobs, size_t count);
+
+		/**
+		 * @brief 圧縮した頂点ストリームをCPUスキニング用に復元する
+		 *
+		 * 位置はサブメッシュごとの復元用の値で戻す（シェーダーと同じ計算）。
+		 * スキンありのメッシュの頂点で、ジョイント番号がMesh::numJoints以上のものはウェイトごと0番に付け替える。
+		 * @param positions 位置ストリーム
+		 * @param attributes 属性ストリーム
+		 * @param skin スキンストリーム
+		 * @param vertexCount 頂点の数
+		 * @param meshes メッシュ（サブメッシュの頂点範囲と復元用の値）
+		 * @param outVertices バインドポーズの位置と法線
+		 * @param outJoints スキンストリームの複製
+		 * @return 付け替えたジョイント番号の数
+		 */
+		static uint32_t DecodeVertices(const PositionVertex* positions, const AttributeVertex* attributes,
+			const JointVertex* skin, uint32_t vertexCount, const std::vector<Mesh>& meshes,
+			SkinningVertices& outVertices, std::vector<JointVertex>& outJoints);
+	};
+}
@@ -10,11 +10,18 @@
 #include "Runtime/Function/Render/RenderSystem.h"
 #include "imgui.h"
 #include "Runtime/Platform/DirectX12/Core/DirectX12Core.h"
+#include "Runtime/Core/Math/BatchTransform.h"
+
+#include <algorithm>
+#include <atomic>
 
 namespace AtomEngine
 {
 	MeshComponent::MeshComponent(std::shared_ptr<Model>model)
 	{
+		static std::atomic<uint32_t> sInstanceCounter{ 0 };
+		mLodPhase = sInstanceCounter.fetch_add(1, std::memory_order_relaxed);
+
 		if (!model)
 		{
 			mMeshConstantsCPU.Destroy();
@@ -36,18 +43,22 @@ namespace AtomEngine
 
 			mBoundingSphereTransforms.resize(numSceneNode);
 			mSkeletonTransforms = std::make_unique<JointXform[]>(mModel->mNumJoints);
+			mPose = PosePool::Allocate(mModel->mNumJoints);
+			if (mPose)
+			{
+				mPose.ResetToBindPose(mModel->mSkeleton);
+				UpdateSkinningPalette();
+			}
 
 			if (!model->mAnimationData.empty())
 			{
 				mAnimGraph = std::make_unique<GraphNode[]>(numSceneNode);
 				std::memcpy(mAnimGraph.get(), model->mSceneGraph.data(), model->mSceneGraph.size() * sizeof(GraphNode));
-				mAnimState.resize(model->mAnimationData.size());
 				LoopAllAnimations();
 			}
 			else
 			{
 				mAnimGraph.reset();
-				mAnimState.clear();
 			}
 		}
 	}
@@ -63,7 +74,7 @@ namespace AtomEngine
 		mMaterialConstantsGPU.Destroy();
 	}
 
-	void MeshComponent::Update(GraphicsContext& gfxContext, const TransformComponent& transform, const MaterialComponent& material, float deltaTime)
+	void MeshComponent::Update(GraphicsContext& gfxContext, const TransformComponent& transform, const MaterialComponent& material)
 	{
 		if (!mModel) return;
 
@@ -74,7 +85,7 @@ namespace AtomEngine
 
 		size_t stackIdx = 0;
 		Matrix4x4 matrixStack[kMaxStackDepth];
-		Matrix4x4 ParentMatrix = transform.GetMatrix() * mModelTransform.GetMatrix();
+		Matrix4x4 ParentMatrix = transform.GetWorldMatrix() * mModelTransform.GetMatrix();
 
 		MeshConstants* cb = (MeshConstants*)mMeshConstantsCPU.Map();
 		if (!cb) return;
@@ -103,7 +114,6 @@ namespace AtomEngine
 
 		if (mAnimGraph)
 		{
-			UpdateAnimation(deltaTime);
 			for (uint32_t i = 0; i < mModel->mSceneGraph.size(); ++i)
 			{
 				GraphNode& node = mAnimGraph[i];
@@ -153,24 +163,6 @@ namespace AtomEngine
 			}
 		}
 
-		for (uint32_t i = 0; i < mModel->mNumJoints; ++i)
-		{
-			Joint& joint = mModel->mSkeleton.joints[i];
-			joint.localMatrix = joint.transform.GetMatrix();
-			if (joint.parent)
-			{
-				joint.skeletonSpaceMatrix = joint.localMatrix * mModel->mSkeleton.joints[*joint.parent].skeletonSpaceMatrix;
-			}
-			else
-			{
-				joint.skeletonSpaceMatrix = joint.localMatrix;
-			}
-
-			JointXform& jointTrans = mSkeletonTransforms[i];
-			jointTrans.posXform = mModel->mJointIBMs[i] * mModel->mSkeleton.joints[i].skeletonSpaceMatrix;
-			jointTrans.nrmXform = Math::InverseTranspose(jointTrans.posXform);
-		}
-
 		mMeshConstantsCPU.Unmap();
 
 		if (!mMeshConstantsGPU.GetResource() || !mMaterialConstantsGPU.GetResource())
@@ -193,76 +185,187 @@ namespace AtomEngine
 				mSkeletonTransforms.get());
 		}
 	}
-	void MeshComponent::UpdateAnimation(float deltaTime)
+	BoundingSphere MeshComponent::GetWorldBoundingSphere(const TransformComponent& transform) const
 	{
-		for (uint32_t i = 0; i < mAnimState.size(); ++i)
+		if (!mModel)
+			return BoundingSphere(0.0f, 0.0f, 0.0f, 0.0f);
+
+		const Matrix4x4 world = transform.GetWorldMatrix() * mModelTransform.GetMatrix();
+		BoundingSphere sphere;
+		BatchTransform::TransformSpheres(world, &mModel->mBoundingSphere, &sphere, 1);
+		return sphere;
+	}
+
+	bool MeshComponent::UpdateAnimation(float deltaTime)
+	{
+		if (!mPose || mModel->mBindPose.size() != mPose.GetJointCount())
+			return false;
+
+		return mAnimator.Update(deltaTime * mDeltaScale,
+			mModel->mAnimationData,
+			mModel->mCompressedAnimations,
+			mModel->mBindPose.data(),
+			mPose.GetLocalPose(),
+			mPose.GetJointCount());
+	}
+
+	void MeshComponent::EvaluateAnimation(float deltaTime, uint32_t updateInterval, bool isVisible)
+	{
+		if (!IsAnimated())
+			return;
+
+		// 画面外では時間だけ進め、見えた時点ですぐに評価する
+		mLodAccumulatedTime += deltaTime;
+		if (!isVisible)
 		{
-			AnimationState& animState = mAnimState[i];
-			if (animState.state == AnimationState::kStopped)
-				continue;
-			animState.time += deltaTime * mDeltaScale;
-			const AnimationClip& clip = mModel->mAnimationData[i];
-
-			if (animState.state == AnimationState::kLooping)
-				animState.time = std::fmodf(animState.time, clip.duration);
-			else if (animState.time > clip.duration)
-			{
-				animState.time = clip.duration;
-				animState.state = AnimationState::kStopped;
-			}
+			mLodFramesUntilUpdate = 0;
+			return;
+		}
+
+		const float elapsed = mLodAccumulatedTime;
+		mLodAccumulatedTime = 0.0f;
+
+		if (updateInterval <= 1)
+		{
+			mLodInterval = 1;
+			if (UpdateAnimation(elapsed))
+				UpdateSkinningPalette();
+			return;
+		}
+
+		const uint32_t jointCount = mPose.GetJointCount();
+		JointPose* localPose = mPose.GetLocalPose();
+		if (mLodInterval == 1)
+		{
+			// 間引きを始めるときは現在のポーズから始め、評価するフレームをインスタンスごとにずらす
+			mLodFrom.assign(localPose, localPose + jointCount);
+			mLodTo.assign(localPose, localPose + jointCount);
+			mLodFramesUntilUpdate = mLodPhase % updateInterval;
+		}
+		else if (mLodInterval != updateInterval)
+		{
+			mLodFramesUntilUpdate = std::min(mLodFramesUntilUpdate, updateInterval);
+		}
+		mLodInterval = updateInterval;
 
-			auto& time = animState.time;
-			for (auto& curve : clip.curves)
+		if (mLodFramesUntilUpdate == 0)
+		{
+			// 表示中のポーズから新しく評価したポーズへ、次の評価までの間に補間する
+			std::copy(localPose, localPose + jointCount, mLodFrom.begin());
+			if (!UpdateAnimation(elapsed))
 			{
-				auto& joint = mModel->mSkeleton.joints[curve.targetJoint];
-				joint.transform.scale = CalculateValue(curve.scale, time);
-				joint.transform.rotation = CaculateRotation(curve.rotation, time);
-				joint.transform.transition = CalculateValue(curve.translation, time);
+				mLodFramesUntilUpdate = mLodInterval;
+				return;
 			}
+			std::copy(localPose, localPose + jointCount, mLodTo.begin());
+			mLodFramesUntilUpdate = mLodInterval;
 		}
+		else
+		{
+			// 間引いたフレームの時間は次の評価で進める
+			mLodAccumulatedTime = elapsed;
+		}
+
+		--mLodFramesUntilUpdate;
+		const float alpha = static_cast<float>(mLodInterval - mLodFramesUntilUpdate) / static_cast<float>(mLodInterval);
+		AnimationBlend::Lerp(mLodFrom.data(), mLodTo.data(), alpha, nullptr, localPose, jointCount);
+		UpdateSkinningPalette();
 	}
-	void MeshComponent::PlayAnimation(uint32_t animIdx, bool loop)
+
+	void MeshComponent::UpdateSkinningPalette()
 	{
-		if (animIdx >= mAnimState.size())return;
+		mPose.ComputeModelSpace(mModel->mSkeleton);
 
-		for(uint32_t i = 0; i < mAnimState.size() ; i++)
+		const Matrix4x4* skeletonSpace = mPose.GetModelSpace();
+		for (uint32_t i = 0; i < mModel->mNumJoints; ++i)
 		{
-			if (i == animIdx)continue;
-			auto& animState = mAnimState[i];
-			animState.state = AnimationState::kStopped;
-			animState.time = 0.0f;
+			JointXform& jointTrans = mSkeletonTransforms[i];
+			jointTrans.posXform = mModel->mJointIBMs[i] * skeletonSpace[i];
+			jointTrans.nrmXform = Math::InverseTranspose(jointTrans.posXform);
 		}
-	
-		mAnimState[animIdx].state = loop ? AnimationState::kLooping : AnimationState::kPlaying;
+	}
+
+	bool MeshComponent::CreateSkinningJobs(SkinningVertices& out, SkinningMethod method, std::vector<SkinningJob>& jobs) const
+	{
+		if (!mModel || !mSkeletonTransforms || mModel->mSkinningJoints.empty())
+			return false;
+
+		const SkinningVertices& rest = mModel->mSkinningVertices;
+		out.Resize(rest.GetCount());
+		for (const Mesh& mesh : mModel->mMeshData)
+		{
+			const bool skinned = (mesh.psoFlags & kHasSkin) && mesh.numJoints > 0;
+			for (const SubMesh& sub : mesh.subMeshes)
+			{
+				if (!skinned)
+				{
+					const size_t first = sub.vertexOffset;
+					const size_t last = first + sub.vertexCount;
+					std::copy(rest.positionX.begin() + first, rest.positionX.begin() + last, out.positionX.begin() + first);
+					std::copy(rest.positionY.begin() + first, rest.positionY.begin() + last, out.positionY.begin() + first);
+					std::copy(rest.positionZ.begin() + first, rest.positionZ.begin() + last, out.positionZ.begin() + first);
+					std::copy(rest.normalX.begin() + first, rest.normalX.begin() + last, out.normalX.begin() + first);
+					std::copy(rest.normalY.begin() + first, rest.normalY.begin() + last, out.normalY.begin() + first);
+					std::copy(rest.normalZ.begin() + first, rest.normalZ.begin() + last, out.normalZ.begin() + first);
+					continue;
+				}
+
+				SkinningJob job;
+				job.positions = rest.GetPositions();
+				job.normals = rest.GetNormals();
+				job.joints = mModel->mSkinningJoints.data();
+				job.palette = mSkeletonTransforms.get() + mesh.startJoint;
+				job.paletteCount = mesh.numJoints;
+				job.vertexOffset = sub.vertexOffset;
+				job.vertexCount = sub.vertexCount;
+				job.method = method;
+				job.outPositions = out.GetPositions();
+				job.outNormals = out.GetNormals();
+				jobs.push_back(job);
+			}
+		}
+		return true;
+	}
+
+	bool MeshComponent::SkinVertices(SkinningVertices& out, SkinningMethod method) const
+	{
+		std::vector<SkinningJob> jobs;
+		if (!CreateSkinningJobs(out, method, jobs))
+			return false;
+		CpuSkinning::Skin(jobs.data(), jobs.size());
+		return true;
+	}
+
+	void MeshComponent::PlayAnimation(uint32_t animIdx, float fadeTime, bool loop)
+	{
+		if (animIdx >= GetNumAnimations())return;
+
+		// 従来どおり他のクリップは止める（LoopAllAnimationsのレイヤーも同じ時間でフェードアウト）
+		mAnimator.StopLoopAll(fadeTime);
+		mAnimator.CrossFade(0, animIdx, fadeTime, loop);
 	}
 
 	void MeshComponent::PauseAnimation(uint32_t animIdx)
 	{
-		if (animIdx < mAnimState.size())
-		 mAnimState[animIdx].state = AnimationState::kStopped;
+		if (animIdx < GetNumAnimations())
+			mAnimator.SetPaused(animIdx, true);
 	}
 
 	void MeshComponent::ResetAnimation(uint32_t animIdx)
 	{
-		if (animIdx < mAnimState.size())
-		 mAnimState[animIdx].time = 0.0f;
+		if (animIdx < GetNumAnimations())
+			mAnimator.SetTime(animIdx, 0.0f);
 	}
 
 	void MeshComponent::StopAnimation(uint32_t animIdx)
 	{
-		if (animIdx < mAnimState.size())
-		{
-			mAnimState[animIdx].state = AnimationState::kStopped;
-			mAnimState[animIdx].time = 0.0f;
-		}
+		if (animIdx < GetNumAnimations())
+			mAnimator.Stop(animIdx);
 	}
 
 	void MeshComponent::LoopAllAnimations()
 	{
-		for (auto& anim : mAnimState)
-		{
-			anim.state = AnimationState::kLooping;
-			anim.time = 0.0f;
-		}
+		if (mModel)
+			mAnimator.LoopAll(mModel->mAnimationData, mModel->mNumJoints);
 	}
 }
@@ -13,6 +13,7 @@
 #include "Runtime/Platform/DirectX12/Buffer/UploadBuffer.h"
 #include "Runtime/Platform/DirectX12/Context/GraphicsContext.h"
 #include "Runtime/Platform/DirectX12/Pipeline/PipelineState.h"
+#include "Runtime/Function/Animation/Animator.h"
 #include<memory>
 
 namespace AtomEngine
@@ -45,9 +46,9 @@ namespace AtomEngine
 		 * @param gfxContext グラフィックスコンテキスト
 		 * @param transform トランスフォームコンポーネント
 		 * @param material マテリアルコンポーネント
-		 * @param deltaTime フレーム時間
+		 * @note アニメーションはAnimationSystemが先に評価するので、ここではフレーム時間を使わない
 		 */
-		void Update(GraphicsContext& gfxContext, const TransformComponent& transform, const MaterialComponent& material, float deltaTime);
+		void Update(GraphicsContext& gfxContext, const TransformComponent& transform, const MaterialComponent& material);
 		
 		/**
 		 * @brief メッシュをレンダーキューに追加
@@ -62,17 +63,74 @@ namespace AtomEngine
 		Transform& GetTransform() { return mModelTransform; }
 
 		/**
-		 * @brief アニメーションを更新
+		 * @brief アニメーションを更新（ローカルポーズのみ）
+		 * @param deltaTime フレーム時間
+		 * @return ポーズを更新したらtrue
+		 */
+		bool UpdateAnimation(float deltaTime);
+
+		/**
+		 * @brief 更新間隔を指定してアニメーションを評価し、スキニング行列を更新する
+		 *
+		 * AnimationSystemから並列に呼ばれる。インスタンス自身のデータとModelの読み取りだけを行う。
+		 * 間隔が2以上なら間隔ごとにクリップを評価し、その間のフレームは前回の結果から補間する。
+		 * 見えない間は時間だけ進め、再び見えたフレームで評価する。
 		 * @param deltaTime フレーム時間
+		 * @param updateInterval 評価の間隔（フレーム数）
+		 * @param isVisible 画面内にあるか
+		 */
+		void EvaluateAnimation(float deltaTime, uint32_t updateInterval, bool isVisible);
+
+		/**
+		 * @brief スケルタルアニメーションを持つか
+		 */
+		bool IsAnimated() const { return mPose && mAnimGraph && mModel->mBindPose.size() == mPose.GetJointCount(); }
+
+		/**
+		 * @brief ワールド空間のバウンディングスフィアを取得
+		 * @param transform トランスフォームコンポーネント
+		 */
+		BoundingSphere GetWorldBoundingSphere(const TransformComponent& transform) const;
+
+		/**
+		 * @brief 現在のポーズでCPUスキニングするジョブを作る
+		 *
+		 * スキンありのメッシュごとにジョブを追加する。CpuSkinning::Skinに複数のインスタンスのジョブを
+		 * まとめて渡すと並列に処理される。出力はモデルの空間（ワールド行列は掛けない）。
+		 * @param out 出力先（モデルの全頂点分にする。スキンなしのメッシュの頂点にはバインドポーズを書く）
+		 * @param method スキニングの方法
+		 * @param jobs ジョブの追加先
+		 * @return スキンありのモデルならtrue
 		 */
-		void UpdateAnimation(float deltaTime);
+		bool CreateSkinningJobs(SkinningVertices& out, SkinningMethod method, std::vector<SkinningJob>& jobs) const;
 
 		/**
-		 * @brief アニメーションを再生
+		 * @brief 現在のポーズの頂点をCPUで求める（CreateSkinningJobsとCpuSkinning::Skinをまとめたもの）
+		 * @param out 出力先
+		 * @param method スキニングの方法
+		 * @return スキンありのモデルならtrue
+		 */
+		bool SkinVertices(SkinningVertices& out, SkinningMethod method = SkinningMethod::kLinear) const;
+
+		/// クロスフェードするPlayAnimationに渡す時間の目安（秒）
+		static constexpr float kDefaultCrossFadeTime = 0.2f;
+
+		/**
+		 * @brief アニメーションを再生（他のクリップを止めて即座に切り替える）
+		 * @param animIdx アニメーションインデックス
+		 * @param loop ループ再生するか
+		 */
+		void PlayAnimation(uint32_t animIdx, bool loop) { PlayAnimation(animIdx, 0.0f, loop); }
+
+		/**
+		 * @brief アニメーションを再生（引数の順はAnimator::CrossFadeと同じ）
+		 *
+		 * 再生中のクリップからクロスフェードする。何も再生していなければ即座に切り替える。
 		 * @param animIdx アニメーションインデックス
+		 * @param fadeTime クロスフェードの時間（秒、0なら即座に切り替える）
 		 * @param loop ループ再生するか
 		 */
-		void PlayAnimation(uint32_t animIdx, bool loop);
+		void PlayAnimation(uint32_t animIdx, float fadeTime, bool loop);
 
 		/**
 		 * @brief アニメーションを一時停止
@@ -93,7 +151,9 @@ namespace AtomEngine
 		void StopAnimation(uint32_t animIdx);
 
 		/**
-		 * @brief 全アニメーションをループ再生
+		 * @brief 全アニメーションを先頭から同時にループ再生（Animator::LoopAll）
+		 *
+		 * 同じジョイントを動かすクリップは後のものが優先される。
 		 */
 		void LoopAllAnimations();
 		
@@ -101,7 +161,13 @@ namespace AtomEngine
 		 * @brief アニメーション数を取得
 		 * @return アニメーション数
 		 */
-		uint32_t GetNumAnimations() const { return static_cast<uint32_t>(mAnimState.size()); }
+		uint32_t GetNumAnimations() const { return mModel ? static_cast<uint32_t>(mModel->mAnimationData.size()) : 0; }
+
+		/**
+		 * @brief アニメーションの再生状態を取得（レイヤーの追加やブレンドの指定に使う）
+		 * @return アニメーター参照
+		 */
+		Animator& GetAnimator() { return mAnimator; }
 		
 		/**
 		 * @brief レンダリング有効状態を取得
@@ -122,6 +188,9 @@ namespace AtomEngine
 		void SetDeltaScale(float deltaScale) { mDeltaScale = deltaScale; }
 		
 	private:
+		/// ポーズからスキニング行列を計算する
+		void UpdateSkinningPalette();
+
 		bool mIsRender = true;  ///< レンダリング有効フラグ
 		std::shared_ptr<Model> mModel = nullptr;  ///< 3Dモデル
 		UploadBuffer mMeshConstantsCPU;    ///< メッシュ定数バッファ（CPU側）
@@ -132,11 +201,19 @@ namespace AtomEngine
 
 		Transform mModelTransform;  ///< モデルのトランスフォーム
 		std::unique_ptr <GraphNode[]> mAnimGraph;  ///< アニメーショングラフ
-		std::vector<AnimationState> mAnimState;  ///< アニメーション状態
+		Animator mAnimator;  ///< レイヤー・クロスフェードの再生状態
 
+		PoseBuffer mPose;  ///< このインスタンスのポーズ（モデルのスケルトンは書き換えない）
 		std::unique_ptr<JointXform[]> mSkeletonTransforms;  ///< スケルトントランスフォーム配列
 		std::vector<Matrix4x4> mBoundingSphereTransforms;  ///< バウンディングスフィアのトランスフォーム
 		float mDeltaScale = 1.0f;  ///< アニメーション速度スケール
+
+		uint32_t mLodInterval = 1;  ///< 現在の評価間隔
+		uint32_t mLodFramesUntilUpdate = 0;  ///< 次の評価までのフレーム数
+		uint32_t mLodPhase = 0;  ///< 評価するフレームをインスタンスごとにずらすための値
+		float mLodAccumulatedTime = 0.0f;  ///< まだアニメーターに渡していない時間
+		std::vector<JointPose> mLodFrom;  ///< 補間元のローカルポーズ
+		std::vector<JointPose> mLodTo;  ///< 補間先のローカルポーズ
 	};
 }
 
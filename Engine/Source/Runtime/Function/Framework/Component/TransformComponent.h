@@ -17,6 +17,10 @@ namespace AtomEngine
 	 * 
 	 * エンティティの3D空間での位置、回転、スケールを保持する。
 	 * Transform基底クラスのすべての機能を継承する。
+	 *
+	 * ワールド行列はWorld::UpdateTransformsで親から順に更新されたものをキャッシュしており、
+	 * GetWorldMatrixなどはその読み出しになる。Transform::GetMatrixはローカル行列のまま。
+	 * 親子関係はWorld::SetParentで設定する。
 	 */
 	struct TransformComponent : public Transform
 	{
@@ -30,6 +34,7 @@ namespace AtomEngine
 			const Quaternion& rotation_ = Quaternion::IDENTITY,
 			const Vector3& scale_ = Vector3::UNIT_SCALE)
 			: Transform(position_, rotation_, scale_)
+			, mWorldMatrix(Transform::GetMatrix())
 		{
 		}
 		
@@ -38,5 +43,30 @@ namespace AtomEngine
 		 */
 		TransformComponent() = default;
 		~TransformComponent() = default;
+
+		/**
+		 * @brief キャッシュ済みのワールド行列を取得
+		 * @return 直近のWorld::UpdateTransforms時点のワールド行列
+		 */
+		const Matrix4x4& GetWorldMatrix() const { return mWorldMatrix; }
+
+		/**
+		 * @brief キャッシュ済みのワールド行列の回転・スケール部分を取得
+		 */
+		const Matrix3x3 GetWorldMatrix3x3() const { return Matrix3x3(mWorldMatrix); }
+
+		/**
+		 * @brief キャッシュ済みのワールド座標を取得
+		 */
+		Vector3 GetWorldTranslation() const { return mWorldMatrix.GetTrans(); }
+
+		/**
+		 * @brief ワールド行列を設定（TransformHierarchyから呼ばれる）
+		 * @param worldMatrix ワールド行列
+		 */
+		void SetWorldMatrix(const Matrix4x4& worldMatrix) { mWorldMatrix = worldMatrix; }
+
+	private:
+		Matrix4x4 mWorldMatrix;   ///< キャッシュ済みのワールド行列
 	};
 }
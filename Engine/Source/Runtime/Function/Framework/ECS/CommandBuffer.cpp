@@ -0,0 +1,74 @@
+#include "CommandBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace AtomEngine
+{
+	CommandBuffer::~CommandBuffer()
+	{
+		Reset();
+	}
+
+	DeferredEntity CommandBuffer::CreateGameObject(const std::string& name)
+	{
+		auto lock = Lock();
+		char* payload = nullptr;
+		if (!name.empty())
+		{
+			payload = static_cast<char*>(Allocate(name.size() + 1, alignof(char)));
+			std::memcpy(payload, name.c_str(), name.size() + 1);
+		}
+
+		mCommands.push_back({ CommandType::CreateGameObject, false, mCreateCount, nullptr, payload });
+		return DeferredEntity{ mCreateCount++ };
+	}
+
+	void CommandBuffer::DestroyGameObject(Entity entity)
+	{
+		auto lock = Lock();
+		mCommands.push_back({ CommandType::DestroyGameObject, false,
+			static_cast<uint32_t>(entt::to_integral(entity)), nullptr, nullptr });
+	}
+
+	void* CommandBuffer::Allocate(size_t size, size_t alignment)
+	{
+		while (mBlockIndex < mBlocks.size())
+		{
+			Block& block = mBlocks[mBlockIndex];
+			const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+			const uintptr_t aligned = (base + mBlockOffset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+			const size_t end = static_cast<size_t>(aligned - base) + size;
+			if (end <= block.size)
+			{
+				mBlockOffset = end;
+				return reinterpret_cast<void*>(aligned);
+			}
+			++mBlockIndex;
+			mBlockOffset = 0;
+		}
+
+		// ブロックに収まらない大きさのコンポーネントは専用のブロックを確保する
+		Block block;
+		block.size = std::max(kBlockSize, size + alignment);
+		block.data = std::make_unique<std::byte[]>(block.size);
+		mBlocks.push_back(std::move(block));
+		mBlockIndex = mBlocks.size() - 1;
+		mBlockOffset = 0;
+		return Allocate(size, alignment);
+	}
+
+	void CommandBuffer::Reset()
+	{
+		for (const Command& command : mCommands)
+		{
+			if (command.type == CommandType::AddComponent && command.payload)
+				command.ops->destroy(command.payload);
+		}
+
+		mCommands.clear();
+		mCreated.clear();
+		mCreateCount = 0;
+		mBlockIndex = 0;
+		mBlockOffset = 0;
+	}
+}
@@ -0,0 +1,227 @@
+/**
+ * @file CommandBuffer.h
+ * @brief 構造変更（エンティティ・コンポーネントの生成・破棄）を遅延実行するコマンドバッファ
+ *
+ * 並行実行中のシステムやビューの走査中はレジストリを直接変更できないため、
+ * 操作をスレッドごとのバッファに記録し、World::PlaybackCommandsで一括して反映する。
+ * ワーカー以外のスレッドは、記録ごとにロックする共有バッファを使う。
+ * 共有バッファで生成予約したエンティティは、World::LockSharedCommandBufferを保持している間だけ使える。
+ * コンポーネントの引数はバッファ内の線形アロケーターに確保され、反映後にまとめて解放される。
+ */
+
+#pragma once
+#include "ECSCommon.h"
+#include "Runtime/Core/LogSystem/EventLog.h"
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace AtomEngine
+{
+	class World;
+
+	/**
+	 * @struct DeferredEntity
+	 * @brief コマンドバッファ上で生成を予約したエンティティ
+	 *
+	 * 実体のエンティティは反映時に確定する。同じバッファへのコマンドでのみ参照できる。
+	 */
+	struct DeferredEntity
+	{
+		uint32_t index = 0;   ///< バッファ内の生成コマンド番号
+	};
+
+	/**
+	 * @class CommandBuffer
+	 * @brief 構造変更コマンドの記録バッファ（共有指定がなければ1スレッド専用）
+	 *
+	 * 使用例:
+	 * @code
+	 * auto& commands = world.GetCommandBuffer();
+	 * DeferredEntity bullet = commands.CreateGameObject("Bullet");
+	 * commands.AddComponent<TransformComponent>(bullet, position);
+	 * commands.DestroyGameObject(target);
+	 * @endcode
+	 */
+	class CommandBuffer
+	{
+	public:
+		/// 線形アロケーターの1ブロックのサイズ
+		static constexpr size_t kBlockSize = 64 * 1024;
+
+		CommandBuffer() = default;
+
+		/**
+		 * @brief コンストラクタ
+		 * @param shared 複数スレッドから記録するか（記録ごとにロックする）
+		 */
+		explicit CommandBuffer(bool shared) : mShared(shared) {}
+
+		~CommandBuffer();
+
+		CommandBuffer(const CommandBuffer&) = delete;
+		CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+		/**
+		 * @brief ゲームオブジェクトの生成を記録
+		 * @param name オブジェクト名（オプション）
+		 * @return 生成予約したエンティティ
+		 */
+		DeferredEntity CreateGameObject(const std::string& name = "");
+
+		/**
+		 * @brief ゲームオブジェクトの破棄を記録
+		 * @param entity 破棄するエンティティ
+		 */
+		void DestroyGameObject(Entity entity);
+
+		/**
+		 * @brief コンポーネントの追加を記録（既に持っている場合は置き換える）
+		 * @tparam T コンポーネントの型
+		 * @param e エンティティ
+		 * @param args コンストラクタ引数
+		 */
+		template<typename T, typename... Args>
+		void AddComponent(Entity e, Args&&... args)
+		{
+			PushAdd<T>(static_cast<uint32_t>(entt::to_integral(e)), false, std::forward<Args>(args)...);
+		}
+
+		/**
+		 * @brief 生成予約したエンティティへのコンポーネントの追加を記録
+		 * @tparam T コンポーネントの型
+		 * @param e 生成予約したエンティティ
+		 * @param args コンストラクタ引数
+		 */
+		template<typename T, typename... Args>
+		void AddComponent(DeferredEntity e, Args&&... args)
+		{
+			PushAdd<T>(e.index, true, std::forward<Args>(args)...);
+		}
+
+		/**
+		 * @brief コンポーネントの削除を記録
+		 * @tparam T コンポーネントの型
+		 * @param e エンティティ
+		 */
+		template<typename T>
+		void RemoveComponent(Entity e)
+		{
+			auto lock = Lock();
+			mCommands.push_back({ CommandType::RemoveComponent, false,
+				static_cast<uint32_t>(entt::to_integral(e)), &GetOps<T>(), nullptr });
+		}
+
+		/**
+		 * @brief 記録済みのコマンドがないか判定
+		 */
+		bool IsEmpty() const { return mCommands.empty(); }
+
+	private:
+		friend class World;
+
+		enum class CommandType : uint8_t
+		{
+			CreateGameObject,
+			DestroyGameObject,
+			AddComponent,
+			RemoveComponent,
+		};
+
+		/// コンポーネント型ごとの型消去された操作
+		struct ComponentOps
+		{
+			void (*emplace)(entt::registry&, Entity, void*);
+			void (*remove)(entt::registry&, Entity);
+			bool (*has)(const entt::registry&, Entity);
+			void (*destroy)(void*);
+			std::type_index type;
+		};
+
+		struct Command
+		{
+			CommandType type;
+			bool deferred;              ///< targetが生成コマンド番号か
+			uint32_t target;            ///< エンティティ値、または生成コマンド番号
+			const ComponentOps* ops;    ///< コンポーネント操作（コンポーネント以外はnullptr）
+			void* payload;              ///< コンストラクタ済みのコンポーネント、または名前
+		};
+
+		struct Block
+		{
+			std::unique_ptr<std::byte[]> data;
+			size_t size = 0;
+		};
+
+		template<typename T>
+		static const ComponentOps& GetOps()
+		{
+			static const ComponentOps ops{
+				[](entt::registry& registry, Entity e, void* payload)
+				{
+					registry.emplace_or_replace<T>(e, std::move(*static_cast<T*>(payload)));
+					EVENT_LOG_COMPONENT(EventLogType::ComponentAdded, T, e);
+				},
+				[](entt::registry& registry, Entity e)
+				{
+					registry.remove<T>(e);
+					EVENT_LOG_COMPONENT(EventLogType::ComponentRemoved, T, e);
+				},
+				[](const entt::registry& registry, Entity e)
+				{
+					return registry.all_of<T>(e);
+				},
+				[](void* payload)
+				{
+					static_cast<T*>(payload)->~T();
+				},
+				std::type_index(typeid(T)),
+			};
+			return ops;
+		}
+
+		template<typename T, typename... Args>
+		void PushAdd(uint32_t target, bool deferred, Args&&... args)
+		{
+			auto lock = Lock();
+			assert(!deferred || target < mCreateCount);
+			void* payload = Allocate(sizeof(T), alignof(T));
+			if constexpr (std::is_aggregate_v<T>)
+				new (payload) T{ std::forward<Args>(args)... };
+			else
+				new (payload) T(std::forward<Args>(args)...);
+
+			mCommands.push_back({ CommandType::AddComponent, deferred, target, &GetOps<T>(), payload });
+		}
+
+		/**
+		 * @brief 共有バッファならロックする
+		 * @return ロック（共有でなければ何も保持しない）
+		 */
+		std::unique_lock<std::recursive_mutex> Lock()
+		{
+			return mShared ? std::unique_lock<std::recursive_mutex>(mMutex) : std::unique_lock<std::recursive_mutex>();
+		}
+
+		/**
+		 * @brief 線形アロケーターから確保（Resetまで解放されない）
+		 */
+		void* Allocate(size_t size, size_t alignment);
+
+		/**
+		 * @brief 未反映のコンポーネントを破棄し、記録とアロケーターを空にする
+		 */
+		void Reset();
+
+		std::vector<Command> mCommands;
+		std::vector<Entity> mCreated;    ///< 生成コマンド番号→反映時に確定したエンティティ
+		uint32_t mCreateCount = 0;
+
+		std::vector<Block> mBlocks;      ///< ブロックはReset後も再利用する
+		size_t mBlockIndex = 0;
+		size_t mBlockOffset = 0;
+
+		bool mShared = false;            ///< 複数スレッドから記録するか
+		std::recursive_mutex mMutex;     ///< 共有バッファの記録・反映の排他
+	};
+}
@@ -2,6 +2,7 @@
 #include <entt.hpp>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <memory>
 #include <functional>
 #include <typeindex>
@@ -35,6 +35,7 @@ namespace AtomEngine
 		 * @param handle エンティティハンドル
 		 * @param world ワールドへのポインタ
 		 */
+		GameObject() = default;
 		GameObject(Entity handle, World* world);
 		~GameObject()= default;
 		
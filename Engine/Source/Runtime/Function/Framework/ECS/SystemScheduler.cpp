@@ -0,0 +1,204 @@
+#include "SystemScheduler.h"
+#include "World.h"
+#include "Runtime/Core/LogSystem/LogSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <set>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		bool Contains(const std::vector<ComponentTypeId>& types, ComponentTypeId type)
+		{
+			return std::find(types.begin(), types.end(), type) != types.end();
+		}
+
+		bool Intersects(const std::vector<ComponentTypeId>& a, const std::vector<ComponentTypeId>& b)
+		{
+			for (ComponentTypeId type : a)
+			{
+				if (Contains(b, type)) return true;
+			}
+			return false;
+		}
+
+#if ENABLE_SYSTEM_ACCESS_CHECK
+		struct RunningSystem
+		{
+			const std::string* name = nullptr;
+			const SystemAccess* access = nullptr;
+		};
+
+		thread_local RunningSystem tRunningSystem;
+
+		std::mutex sReportMutex;
+		std::set<std::pair<std::string, std::string>> sReported;
+
+		// 同じ違反を毎フレーム出力しないよう、システムと対象の組ごとに1回だけ報告する
+		void ReportViolation(const std::string& systemName, std::string_view what, const char* reason)
+		{
+			{
+				std::lock_guard<std::mutex> lock(sReportMutex);
+				if (sReported.emplace(systemName, std::string(what)).second)
+				{
+					Log("[System Access]:%s %s %.*s\n",
+						systemName.c_str(), reason, static_cast<int>(what.size()), what.data());
+				}
+			}
+			// 宣言と違うアクセスは並行実行でデータ競合になるので止める
+			assert(false && "system accessed a component outside its declaration");
+		}
+#endif
+	}
+
+	bool SystemAccess::Declares(ComponentTypeId type) const
+	{
+		return Contains(reads, type) || Contains(writes, type);
+	}
+
+	bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+	{
+		if (exclusive || other.exclusive) return true;
+
+		return Intersects(writes, other.writes)
+			|| Intersects(writes, other.reads)
+			|| Intersects(other.writes, reads);
+	}
+
+	void SystemScheduler::AddSystem(const std::string& name, SystemAccess access, SystemFunction function)
+	{
+		assert(mSystems.size() < kMaxSystems);
+
+		SystemEntry entry{ name, std::move(access), std::move(function) };
+
+		// 後ろから衝突するシステムを探し、既に経路で順序付けられているものは辺を張らない
+		uint64_t ordered = 0;
+		for (int32_t i = static_cast<int32_t>(mSystems.size()) - 1; i >= 0; --i)
+		{
+			const uint64_t bit = 1ull << i;
+			if (ordered & bit) continue;
+
+			if (mSystems[i].access.ConflictsWith(entry.access))
+			{
+				entry.dependencies.push_back(static_cast<uint32_t>(i));
+				ordered |= mSystems[i].ancestors | bit;
+			}
+		}
+		entry.ancestors = ordered;
+
+		mSystems.push_back(std::move(entry));
+		mTimings.push_back({ name });
+	}
+
+	void SystemScheduler::Run(World& world, float deltaTime)
+	{
+		using namespace std::chrono;
+		const steady_clock::time_point frameStart = steady_clock::now();
+
+		assert(JobSystem::GetWorkerIndex() <= 0 && "SystemScheduler::Run must be called from the main thread");
+
+		JobHandle root = JobSystem::CreateJob(nullptr);
+		JobHandle jobs[kMaxSystems];
+
+		for (uint32_t i = 0; i < mSystems.size(); ++i)
+		{
+			// メインスレッド指定のシステムは処理を持たない目印のジョブにし、下で実行してから投入する
+			if (mSystems[i].access.mainThread)
+			{
+				jobs[i] = JobSystem::CreateChildJob(root, nullptr);
+				continue;
+			}
+
+			jobs[i] = JobSystem::CreateChildJob(root, [this, i, &world, deltaTime]
+				{
+					ExecuteSystem(i, world, deltaTime);
+				});
+
+			for (uint32_t dependency : mSystems[i].dependencies)
+				JobSystem::AddDependency(jobs[i], jobs[dependency]);
+		}
+
+		for (uint32_t i = 0; i < mSystems.size(); ++i)
+		{
+			if (!mSystems[i].access.mainThread)
+				JobSystem::Run(jobs[i]);
+		}
+
+		// 依存先は登録順で前にあるので、登録順に処理すれば先に実行すべきものは揃っている
+		for (uint32_t i = 0; i < mSystems.size(); ++i)
+		{
+			if (!mSystems[i].access.mainThread)
+				continue;
+
+			for (uint32_t dependency : mSystems[i].dependencies)
+				JobSystem::Wait(jobs[dependency]);
+			ExecuteSystem(i, world, deltaTime);
+			JobSystem::Run(jobs[i]);
+		}
+
+		JobSystem::Run(root);
+		JobSystem::Wait(root);
+
+		mTotalMilliseconds = duration<float, std::milli>(steady_clock::now() - frameStart).count();
+	}
+
+	void SystemScheduler::Clear()
+	{
+		mSystems.clear();
+		mTimings.clear();
+		mTotalMilliseconds = 0.0f;
+	}
+
+	void SystemScheduler::ExecuteSystem(uint32_t index, World& world, float deltaTime)
+	{
+		using namespace std::chrono;
+		SystemEntry& system = mSystems[index];
+
+#if ENABLE_SYSTEM_ACCESS_CHECK
+		// Wait中に別システムを実行する場合があるので、前の状態を退避する
+		const RunningSystem previous = tRunningSystem;
+		tRunningSystem = { &system.name, &system.access };
+#endif
+
+		const steady_clock::time_point start = steady_clock::now();
+		system.function(world, deltaTime);
+
+		SystemTiming& timing = mTimings[index];
+		timing.milliseconds = duration<float, std::milli>(steady_clock::now() - start).count();
+		timing.workerIndex = JobSystem::GetWorkerIndex();
+
+#if ENABLE_SYSTEM_ACCESS_CHECK
+		tRunningSystem = previous;
+#endif
+	}
+
+#if ENABLE_SYSTEM_ACCESS_CHECK
+	void SystemScheduler::ValidateAccess(ComponentTypeId type, std::string_view typeName, bool write)
+	{
+		const RunningSystem& running = tRunningSystem;
+		if (!running.access || running.access->exclusive) return;
+
+		if (write)
+		{
+			if (!Contains(running.access->writes, type))
+				ReportViolation(*running.name, typeName, running.access->Declares(type) ?
+					"wrote read-only component" : "wrote undeclared component");
+		}
+		else if (!running.access->Declares(type))
+		{
+			ReportViolation(*running.name, typeName, "read undeclared component");
+		}
+	}
+
+	void SystemScheduler::ValidateExclusive(const char* what)
+	{
+		const RunningSystem& running = tRunningSystem;
+		if (!running.access || running.access->exclusive) return;
+
+		ReportViolation(*running.name, what, "requires exclusive access for");
+	}
+#endif
+}
@@ -0,0 +1,191 @@
+/**
+ * @file SystemScheduler.h
+ * @brief コンポーネントの読み書き宣言に基づくシステムスケジューラー
+ *
+ * 各システムは読み取り・書き込みするコンポーネント型を登録時に宣言する。
+ * 登録順を保ったまま衝突するシステム間にのみ依存関係を張り、
+ * 衝突しないシステムはジョブシステム上で並行に実行する。
+ * 読み取りはconst付きの型で取得する（World::View<const T>、GetComponent<const T>など）。
+ * constなしの取得は書き込みとして検証する。
+ */
+
+#pragma once
+#include "ECSCommon.h"
+#include "Runtime/Core/Job/JobSystem.h"
+
+// 宣言外のコンポーネントアクセス検出（既定ではデバッグビルドのみ）
+#ifndef ENABLE_SYSTEM_ACCESS_CHECK
+#ifdef _DEBUG
+#define ENABLE_SYSTEM_ACCESS_CHECK 1
+#else
+#define ENABLE_SYSTEM_ACCESS_CHECK 0
+#endif
+#endif
+
+namespace AtomEngine
+{
+	class World;
+
+	using ComponentTypeId = entt::id_type;
+
+	/**
+	 * @struct SystemAccess
+	 * @brief システムがアクセスするコンポーネントの宣言
+	 *
+	 * 使用例:
+	 * @code
+	 * SystemAccess().Read<VelocityComponent>().Write<TransformComponent>()
+	 * SystemAccess().Read<PlayerTag>().Write<MeshComponent>().MainThread()   // Input・Audioを使う
+	 * @endcode
+	 */
+	struct SystemAccess
+	{
+		std::vector<ComponentTypeId> reads;    ///< 読み取りのみのコンポーネント
+		std::vector<ComponentTypeId> writes;   ///< 書き込むコンポーネント
+		bool exclusive = false;                ///< 他のシステムと並行実行しない（構造変更を伴う場合など、アクセス検証も行わない）
+		bool mainThread = false;               ///< メインスレッドで実行する（Input・Audioなどスレッドセーフでないシングルトンを使う場合）
+
+		template<typename... Components>
+		SystemAccess& Read()
+		{
+			(reads.push_back(entt::type_hash<Components>::value()), ...);
+			return *this;
+		}
+
+		template<typename... Components>
+		SystemAccess& Write()
+		{
+			(writes.push_back(entt::type_hash<Components>::value()), ...);
+			return *this;
+		}
+
+		SystemAccess& Exclusive()
+		{
+			exclusive = true;
+			return *this;
+		}
+
+		SystemAccess& MainThread()
+		{
+			mainThread = true;
+			return *this;
+		}
+
+		/**
+		 * @brief 読み取りまたは書き込みを宣言済みか判定
+		 * @param type コンポーネント型
+		 */
+		bool Declares(ComponentTypeId type) const;
+
+		/**
+		 * @brief 2つのシステムが並行実行できないか判定
+		 * @param other 比較対象
+		 * @return 書き込みが衝突する、またはどちらかが排他ならtrue
+		 */
+		bool ConflictsWith(const SystemAccess& other) const;
+	};
+
+	/**
+	 * @struct SystemTiming
+	 * @brief システムの実行時間
+	 */
+	struct SystemTiming
+	{
+		std::string name;             ///< システム名
+		float milliseconds = 0.0f;    ///< 直近フレームの実行時間
+		int32_t workerIndex = -1;     ///< 実行したワーカー番号
+	};
+
+	/**
+	 * @class SystemScheduler
+	 * @brief システムの依存グラフを構築し、フレームごとに実行する
+	 */
+	class SystemScheduler
+	{
+	public:
+		using SystemFunction = std::function<void(World&, float)>;
+
+		/// 登録できるシステム数の上限
+		static constexpr uint32_t kMaxSystems = 64;
+
+		/**
+		 * @brief システムを登録（登録順が衝突時の実行順になる）
+		 *
+		 * メインスレッド指定のシステムは、Runを呼んだスレッド（メインスレッド）が登録順に実行する。
+		 * @param name システム名
+		 * @param access アクセスするコンポーネントの宣言
+		 * @param function 更新関数
+		 */
+		void AddSystem(const std::string& name, SystemAccess access, SystemFunction function);
+
+		/**
+		 * @brief 全てのシステムを実行し、完了まで待つ（メインスレッドから呼ぶ）
+		 * @param world 対象ワールド
+		 * @param deltaTime 経過時間
+		 */
+		void Run(World& world, float deltaTime);
+
+		/**
+		 * @brief 登録済みのシステムを全て削除
+		 */
+		void Clear();
+
+		/**
+		 * @brief 直近フレームのシステムごとの実行時間を取得
+		 */
+		const std::vector<SystemTiming>& GetTimings() const { return mTimings; }
+
+		/**
+		 * @brief 直近フレームの全システムの実行時間を取得
+		 */
+		float GetTotalMilliseconds() const { return mTotalMilliseconds; }
+
+#if ENABLE_SYSTEM_ACCESS_CHECK
+		/**
+		 * @brief 実行中のシステムが宣言外のコンポーネントに触れていないか検証（違反はログに出してassertする）
+		 * @param type コンポーネント型
+		 * @param typeName 型名（報告用）
+		 * @param write 書き込みとして取得したか（読み取りだけの宣言では違反）
+		 */
+		static void ValidateAccess(ComponentTypeId type, std::string_view typeName, bool write);
+
+		/**
+		 * @brief 実行中のシステムが構造変更（エンティティやコンポーネントの追加・削除）をしてよいか検証
+		 * @param what 操作名（報告用）
+		 */
+		static void ValidateExclusive(const char* what);
+#endif
+
+	private:
+		struct SystemEntry
+		{
+			std::string name;
+			SystemAccess access;
+			SystemFunction function;
+			std::vector<uint32_t> dependencies;   ///< 先に完了している必要があるシステム
+			uint64_t ancestors = 0;               ///< 経路上で先行する全システムのビット集合
+		};
+
+		void ExecuteSystem(uint32_t index, World& world, float deltaTime);
+
+		std::vector<SystemEntry> mSystems;
+		std::vector<SystemTiming> mTimings;
+		float mTotalMilliseconds = 0.0f;
+	};
+}
+
+// SYSTEM_ACCESS_CHECKはconstなしの型を書き込み、SYSTEM_READ_CHECKは常に読み取りとして検証する
+#if ENABLE_SYSTEM_ACCESS_CHECK
+#define SYSTEM_ACCESS_CHECK(T) \
+	::AtomEngine::SystemScheduler::ValidateAccess(entt::type_hash<std::remove_const_t<T>>::value(), \
+		entt::type_name<std::remove_const_t<T>>::value(), !std::is_const_v<T>)
+#define SYSTEM_READ_CHECK(T) \
+	::AtomEngine::SystemScheduler::ValidateAccess(entt::type_hash<std::remove_const_t<T>>::value(), \
+		entt::type_name<std::remove_const_t<T>>::value(), false)
+#define SYSTEM_EXCLUSIVE_CHECK(what) ::AtomEngine::SystemScheduler::ValidateExclusive(what)
+#else
+// 型を参照しておかないとパック展開（(SYSTEM_ACCESS_CHECK(Components), ...)）がコンパイルできない
+#define SYSTEM_ACCESS_CHECK(T) ((void)sizeof(T))
+#define SYSTEM_READ_CHECK(T) ((void)sizeof(T))
+#define SYSTEM_EXCLUSIVE_CHECK(what) ((void)0)
+#endif
@@ -0,0 +1,179 @@
+#include "TransformHierarchy.h"
+#include "Runtime/Core/Job/JobSystem.h"
+
+#include <atomic>
+#include <cstring>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		bool SamePose(const Transform& transform, const Vector3& transition, const Vector3& scale, const Quaternion& rotation)
+		{
+			// 値の比較ではなくビット比較（-0.0やNaNも変更として扱う）
+			return std::memcmp(&transform.transition, &transition, sizeof(Vector3)) == 0
+				&& std::memcmp(&transform.scale, &scale, sizeof(Vector3)) == 0
+				&& std::memcmp(&transform.rotation, &rotation, sizeof(Quaternion)) == 0;
+		}
+	}
+
+	void TransformHierarchy::Connect(entt::registry& registry)
+	{
+		registry.on_construct<TransformComponent>().connect<&TransformHierarchy::OnStructureChanged>(this);
+		registry.on_destroy<TransformComponent>().connect<&TransformHierarchy::OnStructureChanged>(this);
+		mStructureDirty = true;
+	}
+
+	bool TransformHierarchy::SetParent(Entity child, Entity parent)
+	{
+		if (parent == entt::null)
+		{
+			mStructureDirty |= mParents.erase(child) > 0;
+			return true;
+		}
+
+		// 親をたどって子自身が現れたら循環
+		for (Entity e = parent; e != entt::null; e = GetParent(e))
+		{
+			if (e == child) return false;
+		}
+
+		mParents[child] = parent;
+		mStructureDirty = true;
+		return true;
+	}
+
+	Entity TransformHierarchy::GetParent(Entity child) const
+	{
+		auto it = mParents.find(child);
+		return it != mParents.end() ? it->second : entt::null;
+	}
+
+	void TransformHierarchy::Rebuild(entt::registry& registry)
+	{
+		auto view = registry.view<TransformComponent>();
+
+		// 親がいなくなった関係を外す
+		for (auto it = mParents.begin(); it != mParents.end();)
+		{
+			if (!view.contains(it->first) || !view.contains(it->second))
+				it = mParents.erase(it);
+			else
+				++it;
+		}
+
+		// 深さを求めて深さごとに数える
+		std::unordered_map<Entity, uint32_t> depths;
+		depths.reserve(view.size());
+		std::vector<uint32_t> depthCounts;
+
+		for (Entity entity : view)
+		{
+			uint32_t depth = 0;
+			for (Entity p = GetParent(entity); p != entt::null; p = GetParent(p))
+				++depth;
+
+			depths.emplace(entity, depth);
+			if (depth >= depthCounts.size())
+				depthCounts.resize(depth + 1, 0);
+			++depthCounts[depth];
+		}
+
+		mDepthOffsets.assign(depthCounts.size() + 1, 0);
+		for (size_t d = 0; d < depthCounts.size(); ++d)
+			mDepthOffsets[d + 1] = mDepthOffsets[d] + depthCounts[d];
+
+		const size_t count = view.size();
+		std::vector<Entity> entities(count);
+		std::vector<uint32_t> cursor(mDepthOffsets.begin(), mDepthOffsets.end() - 1);
+		for (Entity entity : view)
+			entities[cursor[depths[entity]]++] = entity;
+
+		std::unordered_map<Entity, int32_t> indices;
+		indices.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+			indices.emplace(entities[i], static_cast<int32_t>(i));
+
+		mComponents.resize(count);
+		mParentIndices.resize(count);
+		mLocalPoses.resize(count);
+		mLocalMatrices.resize(count);
+		mWorldMatrices.resize(count);
+		mChanged.assign(count, 0);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			TransformComponent& transform = view.get<TransformComponent>(entities[i]);
+			mComponents[i] = &transform;
+
+			const Entity parent = GetParent(entities[i]);
+			mParentIndices[i] = parent != entt::null ? indices[parent] : -1;
+		}
+
+		// 配列の並びが変わったので次の更新では全て再計算する
+		mStructureDirty = false;
+		mForceUpdate = true;
+	}
+
+	uint32_t TransformHierarchy::UpdateRange(uint32_t begin, uint32_t end)
+	{
+		uint32_t updated = 0;
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			TransformComponent& transform = *mComponents[i];
+			LocalPose& pose = mLocalPoses[i];
+
+			const bool localChanged = mForceUpdate || !SamePose(transform, pose.transition, pose.scale, pose.rotation);
+			if (localChanged)
+			{
+				pose.transition = transform.transition;
+				pose.scale = transform.scale;
+				pose.rotation = transform.rotation;
+				mLocalMatrices[i].MakeAffine(pose.scale, pose.rotation, pose.transition);
+			}
+
+			const int32_t parent = mParentIndices[i];
+			const bool changed = localChanged || (parent >= 0 && mChanged[parent]);
+			mChanged[i] = changed;
+			if (!changed) continue;
+
+			if (parent >= 0)
+				mWorldMatrices[i] = mLocalMatrices[i] * mWorldMatrices[parent];
+			else
+				mWorldMatrices[i] = mLocalMatrices[i];
+
+			transform.SetWorldMatrix(mWorldMatrices[i]);
+			++updated;
+		}
+		return updated;
+	}
+
+	void TransformHierarchy::Update(entt::registry& registry)
+	{
+		if (mStructureDirty)
+			Rebuild(registry);
+
+		mUpdatedCount = 0;
+		for (size_t d = 0; d + 1 < mDepthOffsets.size(); ++d)
+		{
+			const uint32_t begin = mDepthOffsets[d];
+			const uint32_t end = mDepthOffsets[d + 1];
+
+			// 同じ深さの要素は互いに依存しない
+			if (end - begin >= kParallelThreshold && JobSystem::GetWorkerCount() > 1)
+			{
+				std::atomic<uint32_t> updated{ 0 };
+				JobSystem::ParallelFor(end - begin, [&](uint32_t first, uint32_t last)
+					{
+						updated.fetch_add(UpdateRange(begin + first, begin + last), std::memory_order_relaxed);
+					}, 256);
+				mUpdatedCount += updated.load(std::memory_order_relaxed);
+			}
+			else
+			{
+				mUpdatedCount += UpdateRange(begin, end);
+			}
+		}
+		mForceUpdate = false;
+	}
+}
@@ -0,0 +1,94 @@
+/**
+ * @file TransformHierarchy.h
+ * @brief TransformComponentの親子関係とワールド行列のキャッシュ
+ *
+ * TransformComponentを持つエンティティを深さ順に並べた配列で管理し、
+ * 1フレームに1回、親から子へ変更のあったワールド行列だけを更新する。
+ * 更新結果は各TransformComponentにキャッシュされ、GetWorldMatrixはその読み出しになる。
+ */
+
+#pragma once
+#include "ECSCommon.h"
+#include "Runtime/Function/Framework/Component/TransformComponent.h"
+
+namespace AtomEngine
+{
+	/**
+	 * @class TransformHierarchy
+	 * @brief トランスフォーム階層の管理と行列の伝播
+	 */
+	class TransformHierarchy
+	{
+	public:
+		/// 1つの深さの要素数がこれ以上なら並列に更新する
+		static constexpr uint32_t kParallelThreshold = 1024;
+
+		/**
+		 * @brief レジストリのTransformComponentの追加・削除を監視する
+		 * @param registry 対象レジストリ
+		 */
+		void Connect(entt::registry& registry);
+
+		/**
+		 * @brief 親を設定
+		 * @param child 子エンティティ
+		 * @param parent 親エンティティ（entt::nullで解除）
+		 * @return 循環する場合は設定せずfalse
+		 */
+		bool SetParent(Entity child, Entity parent);
+
+		/**
+		 * @brief 親を取得
+		 * @param child 子エンティティ
+		 * @return 親エンティティ（なければentt::null）
+		 */
+		Entity GetParent(Entity child) const;
+
+		/**
+		 * @brief 変更のあったトランスフォームのワールド行列を親から順に更新する
+		 * @param registry 対象レジストリ
+		 */
+		void Update(entt::registry& registry);
+
+		/**
+		 * @brief 直近の更新でワールド行列を再計算した数を取得
+		 */
+		uint32_t GetUpdatedCount() const { return mUpdatedCount; }
+
+	private:
+		/// 変更検出用のローカル姿勢
+		struct LocalPose
+		{
+			Vector3 transition;
+			Vector3 scale;
+			Quaternion rotation;
+		};
+
+		void OnStructureChanged(entt::registry&, Entity) { mStructureDirty = true; }
+
+		/**
+		 * @brief 深さ順の配列を作り直す
+		 */
+		void Rebuild(entt::registry& registry);
+
+		/**
+		 * @brief 配列の範囲を更新する（同じ深さの範囲のみ渡す）
+		 */
+		uint32_t UpdateRange(uint32_t begin, uint32_t end);
+
+		std::unordered_map<Entity, Entity> mParents;   ///< 子→親
+
+		// 深さ順（親は必ず子より前）に並べた配列
+		std::vector<TransformComponent*> mComponents;
+		std::vector<int32_t> mParentIndices;           ///< 親の配列番号（ルートは-1）
+		std::vector<LocalPose> mLocalPoses;            ///< 前回更新時のローカル姿勢
+		std::vector<Matrix4x4> mLocalMatrices;
+		std::vector<Matrix4x4> mWorldMatrices;
+		std::vector<uint8_t> mChanged;                 ///< 今回ワールド行列が変わったか
+		std::vector<uint32_t> mDepthOffsets;           ///< 深さごとの開始位置（末尾は要素数）
+
+		bool mStructureDirty = true;
+		bool mForceUpdate = false;
+		uint32_t mUpdatedCount = 0;
+	};
+}
@@ -1,66 +1,97 @@
 #include "World.h"
 #include "GameObject.h"
 
-#include "Runtime/Core/LogSystem/LogSystem.h"
+#include <algorithm>
 
 namespace AtomEngine
 {
 	World::World()
+		: mSharedCommandBuffer(std::make_unique<CommandBuffer>(true))
 	{
-		mDispatcher.sink<ComponentAddedEvent>().connect<&World::OnComponentAdded>(this);
-		mDispatcher.sink<ComponentRemovedEvent>().connect<&World::OnComponentRemoved>(this);
+		EnsureCommandBuffers();
+		mTransformHierarchy.Connect(mRegistry);
 	}
 
 	World::~World()
 	{
+		// 未反映のコンポーネントをレジストリより先に破棄する
+		mPlaybackBuffers.clear();
+		mCommandBuffers.clear();
+		mSharedCommandBuffer.reset();
+
 		mRegistry.clear();
 		mDispatcher.clear();
 
 		mNameLookup.clear();
+		mObjectPages.clear();
+	}
+
+	GameObject* World::CreateGameObject(const std::string& name)
+	{
+		SYSTEM_EXCLUSIVE_CHECK("CreateGameObject");
+		return SetupGameObject(mRegistry.create(), name.c_str());
 	}
 
-	std::unique_ptr<GameObject> World::CreateGameObject(const std::string& name)
+	GameObject* World::SetupGameObject(Entity e, const char* name)
 	{
-		Entity e = mRegistry.create();
-		auto obj = std::make_unique<GameObject>(e, this);
-		if (!name.empty())
+		GameObject* obj = GetObjectSlot(e, true);
+		*obj = GameObject(e, this);
+		if (name && *name)
 		{
 			obj->AddComponent<DeathFlag>();
 			obj->AddComponent<NameComponent>(name);
 			mNameLookup[name] = e;
 		}
-		mEntityToObject[e] = obj.get();
-		Log("[Object Added]:%s -> Entity(%d)\n", name.c_str(), (uint32_t)e);
+		EVENT_LOG_OBJECT(EventLogType::ObjectCreated, e);
 
-		return std::move(obj);
+		return obj;
 	}
 
 	GameObject* World::GetGameObject(Entity entity)
 	{
-		if (mEntityToObject.find(entity) != mEntityToObject.end())
-		{
-			return mEntityToObject[entity];
-		}
+		GameObject* obj = GetObjectSlot(entity, false);
+		// スロットは再利用されるため、バージョンを含めたハンドルで照合する
+		if (obj && obj->GetHandle() == entity)
+			return obj;
 		return nullptr;
 	}
 
 	void World::DestroyGameObject(Entity entity)
 	{
-		auto it = mEntityToObject.find(entity);
-		if (it != mEntityToObject.end())
+		SYSTEM_EXCLUSIVE_CHECK("DestroyGameObject");
+		if (GameObject* obj = GetGameObject(entity))
 		{
-			auto* obj = it->second;
 			if (obj->HasComponent<NameComponent>())
 			{
-				Log("[Object Destroyed]:%s -> Entity(%d)\n",
-					obj->GetComponent<NameComponent>().value.c_str(), (uint32_t)entity);
 				mNameLookup.erase(obj->GetComponent<NameComponent>().value);
 			}
-			mEntityToObject.erase(it);
+			*obj = GameObject();
 		}
+		EVENT_LOG_OBJECT(EventLogType::ObjectDestroyed, entity);
 		mRegistry.destroy(entity);
 	}
 
+	GameObject* World::GetObjectSlot(Entity entity, bool allocate)
+	{
+		if (entity == entt::null) return nullptr;
+
+		const uint32_t index = static_cast<uint32_t>(entt::to_entity(entity));
+		const size_t page = index / kObjectPageSize;
+		if (page >= mObjectPages.size())
+		{
+			if (!allocate) return nullptr;
+			mObjectPages.resize(page + 1);
+		}
+
+		auto& objects = mObjectPages[page];
+		if (!objects)
+		{
+			if (!allocate) return nullptr;
+			objects = std::make_unique<GameObject[]>(kObjectPageSize);
+		}
+		return &objects[index % kObjectPageSize];
+	}
+
 	Entity World::FindByName(const std::string& name)
 	{
 		auto it = mNameLookup.find(name);
@@ -71,6 +102,7 @@ namespace AtomEngine
 
 	void World::SetName(Entity entity, const std::string& name)
 	{
+		SYSTEM_EXCLUSIVE_CHECK("SetName");
 		if (!mRegistry.valid(entity)) return;
 
 		if (mRegistry.any_of<NameComponent>(entity))
@@ -87,15 +119,140 @@ namespace AtomEngine
 		mNameLookup[name] = entity;
 	}
 
-	void World::OnComponentAdded(const ComponentAddedEvent& e)
+	void World::UpdateSystems(float deltaTime)
+	{
+		EnsureCommandBuffers();
+		UpdateTransforms();
+		mScheduler.Run(*this, deltaTime);
+		PlaybackCommands();
+	}
+
+	CommandBuffer& World::GetCommandBuffer()
+	{
+		const int32_t worker = JobSystem::GetWorkerIndex();
+		if (worker < 0)
+			return *mSharedCommandBuffer;
+
+		assert(static_cast<size_t>(worker) < mCommandBuffers.size());
+		return *mCommandBuffers[worker];
+	}
+
+	void World::EnsureCommandBuffers()
 	{
-		std::string typeName = e.type.name();
-		Log("[Component Added]:%s -> Entity(%d)\n", typeName.c_str(), (uint32_t)e.entity);
+		const size_t count = std::max<size_t>(JobSystem::GetWorkerCount(), 1);
+		if (mCommandBuffers.size() >= count) return;
+
+		while (mCommandBuffers.size() < count)
+			mCommandBuffers.push_back(std::make_unique<CommandBuffer>());
+
+		mPlaybackBuffers.clear();
+		for (auto& buffer : mCommandBuffers)
+			mPlaybackBuffers.push_back(buffer.get());
+		mPlaybackBuffers.push_back(mSharedCommandBuffer.get());
 	}
 
-	void World::OnComponentRemoved(const ComponentRemovedEvent& e)
+	void World::PlaybackCommands()
 	{
-		std::string typeName = e.type.name();
-		Log("[Component Removed]:%s -> Entity(%d)\n", typeName.c_str(), (uint32_t)e.entity);
+		SYSTEM_EXCLUSIVE_CHECK("PlaybackCommands");
+		using CommandType = CommandBuffer::CommandType;
+
+		// 反映中は他のスレッドに共有バッファへ記録させない
+		std::lock_guard<std::recursive_mutex> lock(mSharedCommandBuffer->mMutex);
+
+		// 生成は全バッファ分をまとめて行う
+		size_t createCount = 0;
+		for (CommandBuffer* buffer : mPlaybackBuffers)
+			createCount += buffer->mCreateCount;
+
+		if (createCount > 0)
+		{
+			std::vector<Entity> created(createCount);
+			mRegistry.create(created.begin(), created.end());
+
+			auto next = created.begin();
+			for (CommandBuffer* buffer : mPlaybackBuffers)
+			{
+				buffer->mCreated.assign(next, next + buffer->mCreateCount);
+				next += buffer->mCreateCount;
+
+				for (const auto& command : buffer->mCommands)
+				{
+					if (command.type == CommandType::CreateGameObject)
+						SetupGameObject(buffer->mCreated[command.target], static_cast<const char*>(command.payload));
+				}
+			}
+		}
+
+		for (auto& batch : mAddedBatches)
+			batch.second.clear();
+
+		for (CommandBuffer* buffer : mPlaybackBuffers)
+		{
+			for (auto& command : buffer->mCommands)
+			{
+				const Entity e = command.deferred
+					? buffer->mCreated[command.target]
+					: static_cast<Entity>(command.target);
+
+				switch (command.type)
+				{
+				case CommandType::CreateGameObject:
+					break;
+
+				case CommandType::DestroyGameObject:
+					// 同じフレームで複数回破棄が記録されることがある
+					if (mRegistry.valid(e))
+						DestroyGameObject(e);
+					break;
+
+				case CommandType::AddComponent:
+				{
+					if (mRegistry.valid(e))
+					{
+						// 置き換えは追加として通知しない
+						const bool added = !command.ops->has(mRegistry, e);
+						command.ops->emplace(mRegistry, e, command.payload);
+
+						if (added)
+						{
+							auto it = std::find_if(mAddedBatches.begin(), mAddedBatches.end(),
+								[&](const auto& batch) { return batch.first == command.ops; });
+							if (it == mAddedBatches.end())
+							{
+								mAddedBatches.emplace_back(command.ops, std::vector<Entity>());
+								it = mAddedBatches.end() - 1;
+							}
+							it->second.push_back(e);
+						}
+					}
+					command.ops->destroy(command.payload);
+					command.payload = nullptr;
+					break;
+				}
+
+				case CommandType::RemoveComponent:
+					if (mRegistry.valid(e) && command.ops->has(mRegistry, e))
+					{
+						command.ops->remove(mRegistry, e);
+						mDispatcher.trigger(ComponentRemovedEvent{ e, command.ops->type });
+					}
+					break;
+				}
+			}
+			buffer->Reset();
+		}
+
+		// 追加後に破棄・削除されたものを除いて型ごとに通知する
+		for (auto& [ops, entities] : mAddedBatches)
+		{
+			if (entities.empty()) continue;
+
+			entities.erase(std::remove_if(entities.begin(), entities.end(),
+				[&](Entity e) { return !mRegistry.valid(e) || !ops->has(mRegistry, e); }),
+				entities.end());
+
+			if (!entities.empty())
+				mDispatcher.trigger(ComponentBatchAddedEvent{ ops->type, &entities });
+		}
 	}
-}
\ No newline at end of file
+}
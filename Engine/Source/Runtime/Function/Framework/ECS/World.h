@@ -8,6 +8,10 @@
 
 #pragma once
 #include "ECSCommon.h"
+#include "SystemScheduler.h"
+#include "CommandBuffer.h"
+#include "TransformHierarchy.h"
+#include "Runtime/Core/LogSystem/EventLog.h"
 
 namespace AtomEngine
 {
@@ -35,6 +39,18 @@ namespace AtomEngine
 		std::type_index type;       ///< コンポーネントの型情報
 	};
 
+	/**
+	 * @struct ComponentBatchAddedEvent
+	 * @brief コマンドバッファの反映で追加されたコンポーネントの型ごとの一括イベント
+	 *
+	 * 反映時の追加はComponentAddedEventではなく、型ごとにまとめてこのイベントで通知する。
+	 */
+	struct ComponentBatchAddedEvent
+	{
+		std::type_index type;                   ///< コンポーネントの型情報
+		const std::vector<Entity>* entities;    ///< 追加されたエンティティ（反映後も有効なもの、通知中のみ有効）
+	};
+
 	/**
 	 * @class World
 	 * @brief ECSワールドの中核クラス
@@ -57,9 +73,9 @@ namespace AtomEngine
 		/**
 		 * @brief ゲームオブジェクトを生成
 		 * @param name オブジェクト名（オプション）
-		 * @return 生成されたゲームオブジェクト
+		 * @return 生成されたゲームオブジェクト（ワールドが所有し、破棄まで有効）
 		 */
-		std::unique_ptr<GameObject> CreateGameObject(const std::string& name = "");
+		GameObject* CreateGameObject(const std::string& name = "");
 
 		/**
 		 * @brief エンティティからゲームオブジェクトを取得
@@ -91,7 +107,9 @@ namespace AtomEngine
 		template<typename T, typename... Args>
 		void AddComponent(Entity e, Args&&... args)
 		{
+			SYSTEM_EXCLUSIVE_CHECK("AddComponent");
 			mRegistry.emplace<T>(e, std::forward<Args>(args)...);
+			EVENT_LOG_COMPONENT(EventLogType::ComponentAdded, T, e);
 			mDispatcher.trigger(ComponentAddedEvent{ e, std::type_index(typeid(T)) });
 		}
 
@@ -102,16 +120,24 @@ namespace AtomEngine
 		 * @return コンポーネントが存在すればtrue
 		 */
 		template<typename T>
-		bool HasComponent(Entity e) const { return mRegistry.any_of<T>(e); }
+		bool HasComponent(Entity e) const
+		{
+			SYSTEM_READ_CHECK(T);
+			return mRegistry.any_of<T>(e);
+		}
 
 		/**
 		 * @brief コンポーネントを取得
-		 * @tparam T コンポーネントの型
+		 * @tparam T コンポーネントの型（読み取りだけならconst付き）
 		 * @param e エンティティ
 		 * @return コンポーネントへの参照
 		 */
 		template<typename T>
-		T& GetComponent(Entity e) { return mRegistry.get<T>(e); }
+		T& GetComponent(Entity e)
+		{
+			SYSTEM_ACCESS_CHECK(T);
+			return mRegistry.get<T>(e);
+		}
 
 		/**
 		 * @brief コンポーネントを削除
@@ -121,30 +147,34 @@ namespace AtomEngine
 		template<typename T>
 		void RemoveComponent(Entity e)
 		{
+			SYSTEM_EXCLUSIVE_CHECK("RemoveComponent");
 			mRegistry.remove<T>(e);
+			EVENT_LOG_COMPONENT(EventLogType::ComponentRemoved, T, e);
 			mDispatcher.trigger(ComponentRemovedEvent{ e, std::type_index(typeid(T)) });
 		}
 
 		/**
 		 * @brief 指定コンポーネントを持つエンティティのビューを取得
-		 * @tparam Components ビュー対象のコンポーネント型
+		 * @tparam Components ビュー対象のコンポーネント型（読み取りだけの型はconst付き）
 		 * @return エンティティビュー
 		 */
 		template<typename... Components>
 		decltype(auto) View()
 		{
+			(SYSTEM_ACCESS_CHECK(Components), ...);
 			return mRegistry.view<Components...>();
 		}
 
 		/**
 		 * @brief コンポーネントを安全に取得（nullableポインタ）
-		 * @tparam Components コンポーネント型
+		 * @tparam Components コンポーネント型（読み取りだけならconst付き）
 		 * @param e エンティティ
 		 * @return コンポーネントへのポインタ（なければnullptr）
 		 */
 		template<typename... Components>
 		decltype(auto) TryGet(Entity e)
 		{
+			(SYSTEM_ACCESS_CHECK(Components), ...);
 			return mRegistry.try_get<Components...>(e);
 		}
 
@@ -168,9 +198,96 @@ namespace AtomEngine
 
 		/**
 		 * @brief レジストリを取得
+		 *
+		 * 宣言を経由しない直接アクセスとなるため、スケジューラー上では排他システムのみ使用可。
 		 * @return レジストリへの参照
 		 */
-		entt::registry& GetRegistry() { return mRegistry; }
+		entt::registry& GetRegistry()
+		{
+			SYSTEM_EXCLUSIVE_CHECK("GetRegistry");
+			return mRegistry;
+		}
+
+		/**
+		 * @brief 現在のスレッド用のコマンドバッファを取得
+		 *
+		 * ワーカースレッド（メインスレッドを含む）にはそれぞれ専用のバッファを返す。
+		 * それ以外のスレッド（読み込みスレッドなど）には記録ごとにロックする共有バッファを返す。
+		 * 記録した操作は次の同期ポイント（UpdateSystemsの終了時、またはPlaybackCommands）で反映される。
+		 * @return コマンドバッファへの参照
+		 */
+		CommandBuffer& GetCommandBuffer();
+
+		/**
+		 * @brief 共有コマンドバッファへの一連の記録の間、反映させないようにする
+		 *
+		 * ワーカー以外のスレッドで生成予約したエンティティにコンポーネントを追加する場合は、
+		 * 使い終わるまでロックを保持する（間に反映が入ると生成コマンド番号が無効になる）。
+		 * @code
+		 * auto lock = world.LockSharedCommandBuffer();
+		 * auto& commands = world.GetCommandBuffer();
+		 * DeferredEntity e = commands.CreateGameObject("Loaded");
+		 * commands.AddComponent<MeshComponent>(e, model);
+		 * @endcode
+		 * @return ロック
+		 */
+		std::unique_lock<std::recursive_mutex> LockSharedCommandBuffer() { return mSharedCommandBuffer->Lock(); }
+
+		/**
+		 * @brief 全スレッドのコマンドバッファを記録順に反映する（同期ポイント）
+		 *
+		 * 生成をまとめて行った後に破棄・追加・削除を反映し、
+		 * 追加イベントは最後に型ごとにComponentBatchAddedEventとして発行する。
+		 * システムの実行中には呼ばないこと。
+		 */
+		void PlaybackCommands();
+
+		/**
+		 * @brief システムスケジューラーを取得
+		 * @return スケジューラーへの参照
+		 */
+		SystemScheduler& GetScheduler() { return mScheduler; }
+
+		/**
+		 * @brief 登録済みのシステムを依存関係に従って実行し、コマンドバッファを反映する
+		 *
+		 * 実行前にトランスフォームのワールド行列を更新するので、システムは前のフレームの変更を反映した値を読める。
+		 * @param deltaTime 経過時間
+		 */
+		void UpdateSystems(float deltaTime);
+
+		/**
+		 * @brief トランスフォームの親を設定
+		 * @param child 子エンティティ
+		 * @param parent 親エンティティ（entt::nullで解除）
+		 * @return 循環する場合は設定せずfalse
+		 */
+		bool SetParent(Entity child, Entity parent) { return mTransformHierarchy.SetParent(child, parent); }
+
+		/**
+		 * @brief トランスフォームの親を取得
+		 * @param child 子エンティティ
+		 * @return 親エンティティ（なければentt::null）
+		 */
+		Entity GetParent(Entity child) const { return mTransformHierarchy.GetParent(child); }
+
+		/**
+		 * @brief 変更のあったトランスフォームのワールド行列を親から順に更新する
+		 *
+		 * UpdateSystemsの実行前に呼ばれる。システムが動かした後に読む処理（描画など）の前にも呼ぶ。
+		 * 排他指定のシステムからも呼べる。
+		 */
+		void UpdateTransforms()
+		{
+			SYSTEM_EXCLUSIVE_CHECK("UpdateTransforms");
+			mTransformHierarchy.Update(mRegistry);
+		}
+
+		/**
+		 * @brief トランスフォーム階層を取得
+		 * @return 階層への参照
+		 */
+		const TransformHierarchy& GetTransformHierarchy() const { return mTransformHierarchy; }
 
 		/**
 		 * @brief エンティティに名前を設定
@@ -182,8 +299,26 @@ namespace AtomEngine
 	private:
 		entt::registry mRegistry;         ///< enttレジストリ
 		entt::dispatcher mDispatcher;     ///< イベントディスパッチャー
+		SystemScheduler mScheduler;       ///< システムスケジューラー
+		TransformHierarchy mTransformHierarchy;   ///< トランスフォーム階層
+
+		/// ワーカー番号→コマンドバッファ
+		std::vector<std::unique_ptr<CommandBuffer>> mCommandBuffers;
+
+		/// ワーカー以外のスレッドが共有するコマンドバッファ
+		std::unique_ptr<CommandBuffer> mSharedCommandBuffer;
+
+		/// 反映する順のコマンドバッファ（ワーカー順、最後に共有バッファ）
+		std::vector<CommandBuffer*> mPlaybackBuffers;
+
+		/// 反映中に追加されたコンポーネント（型ごと、フレーム間で再利用）
+		std::vector<std::pair<const CommandBuffer::ComponentOps*, std::vector<Entity>>> mAddedBatches;
 
-		std::unordered_map<Entity, GameObject*> mEntityToObject;  ///< エンティティ→オブジェクトマップ
+		/// 1ページあたりのオブジェクト数
+		static constexpr uint32_t kObjectPageSize = 1024;
+
+		/// エンティティインデックス→オブジェクト（ページ単位で確保し、アドレスは破棄まで不変）
+		std::vector<std::unique_ptr<GameObject[]>> mObjectPages;
 
 		std::unordered_map<std::string, Entity> mNameLookup;      ///< 名前→エンティティマップ
 
@@ -192,16 +327,25 @@ namespace AtomEngine
 
 	private:
 		/**
-		 * @brief コンポーネント追加イベントハンドラ
-		 * @param e イベントデータ
+		 * @brief エンティティに対応するオブジェクトスロットを取得
+		 * @param entity エンティティ
+		 * @param allocate ページが未確保の場合に確保するか
+		 * @return スロットへのポインタ（範囲外ならnullptr）
+		 */
+		GameObject* GetObjectSlot(Entity entity, bool allocate);
+
+		/**
+		 * @brief 生成済みエンティティにオブジェクトと名前を設定
+		 * @param e エンティティ
+		 * @param name オブジェクト名（nullptrまたは空なら名前なし）
+		 * @return ゲームオブジェクト
 		 */
-		void OnComponentAdded(const ComponentAddedEvent& e);
+		GameObject* SetupGameObject(Entity e, const char* name);
 
 		/**
-		 * @brief コンポーネント削除イベントハンドラ
-		 * @param e イベントデータ
+		 * @brief ワーカー数に合わせてコマンドバッファを確保する
 		 */
-		void OnComponentRemoved(const ComponentRemovedEvent& e);
+		void EnsureCommandBuffers();
 
 	};
 }
@@ -0,0 +1,151 @@
+#include "WorldBenchmark.h"
+#include "World.h"
+#include "GameObject.h"
+#include "Runtime/Core/LogSystem/LogSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		/// 検索を繰り返す回数（1回の計測で kObjectCount × kLookupPasses 回引く）
+		constexpr int kLookupPasses = 10;
+
+		/// 比較用の従来の管理（オブジェクトを1つずつ確保し、ハッシュマップで引く）
+		struct ReferenceWorld
+		{
+			entt::registry registry;
+			std::unordered_map<Entity, std::unique_ptr<GameObject>> objects;
+
+			GameObject* Create()
+			{
+				const Entity e = registry.create();
+				auto obj = std::make_unique<GameObject>(e, nullptr);
+				GameObject* result = obj.get();
+				objects[e] = std::move(obj);
+				return result;
+			}
+
+			GameObject* Get(Entity e)
+			{
+				if (objects.find(e) != objects.end())
+					return objects[e].get();
+				return nullptr;
+			}
+
+			void Destroy(Entity e)
+			{
+				objects.erase(e);
+				registry.destroy(e);
+			}
+		};
+
+		struct Timings
+		{
+			double create = 0.0;
+			double lookup = 0.0;
+			double destroy = 0.0;
+		};
+
+		template<typename Func>
+		double MeasureMilliseconds(Func&& func)
+		{
+			using namespace std::chrono;
+			const auto start = steady_clock::now();
+			func();
+			return duration<double, std::milli>(steady_clock::now() - start).count();
+		}
+
+		/**
+		 * @brief 生成・取得・破棄を計測し、取得結果を確認する
+		 * @return 生成した全てを取得でき、破棄後は全て取得できなければtrue
+		 */
+		template<typename WorldType, typename CreateFunc, typename GetFunc, typename DestroyFunc>
+		bool Measure(WorldType& world, CreateFunc&& create, GetFunc&& get, DestroyFunc&& destroy,
+			std::vector<Entity>& handles, Timings& timings)
+		{
+			handles.clear();
+			timings.create += MeasureMilliseconds([&]()
+				{
+					for (unsigned i = 0; i < WorldBenchmark::kObjectCount; ++i)
+						handles.push_back(create(world)->GetHandle());
+				});
+
+			size_t found = 0;
+			timings.lookup += MeasureMilliseconds([&]()
+				{
+					for (int pass = 0; pass < kLookupPasses; ++pass)
+					{
+						for (Entity e : handles)
+						{
+							const GameObject* obj = get(world, e);
+							found += (obj && obj->GetHandle() == e) ? 1 : 0;
+						}
+					}
+				});
+
+			timings.destroy += MeasureMilliseconds([&]()
+				{
+					for (Entity e : handles)
+						destroy(world, e);
+				});
+
+			size_t stale = 0;
+			for (Entity e : handles)
+				stale += get(world, e) ? 1 : 0;
+
+			return found == static_cast<size_t>(WorldBenchmark::kObjectCount) * kLookupPasses && stale == 0;
+		}
+
+		bool Report(const char* name, double scalarMs, double worldMs, bool passed)
+		{
+			Log("[WorldBenchmark]:%-18s scalar %8.3f ms  world %8.3f ms  x%5.2f%s\n",
+				name, scalarMs, worldMs, scalarMs / std::max(worldMs, 1e-6), passed ? "" : "  (NG)");
+			return passed;
+		}
+	}
+
+	bool WorldBenchmark::Run(int iterations)
+	{
+		Log("[WorldBenchmark]:%u objects x %d iterations\n", kObjectCount, iterations);
+
+		std::vector<Entity> handles;
+		handles.reserve(kObjectCount);
+
+		Timings reference, paged;
+		bool referencePassed = true, pagedPassed = true;
+		for (int i = 0; i < iterations; ++i)
+		{
+			ReferenceWorld referenceWorld;
+			referencePassed &= Measure(referenceWorld,
+				[](ReferenceWorld& w) { return w.Create(); },
+				[](ReferenceWorld& w, Entity e) { return w.Get(e); },
+				[](ReferenceWorld& w, Entity e) { w.Destroy(e); },
+				handles, reference);
+
+			World world;
+			pagedPassed &= Measure(world,
+				[](World& w) { return w.CreateGameObject(); },
+				[](World& w, Entity e) { return w.GetGameObject(e); },
+				[](World& w, Entity e) { w.DestroyGameObject(e); },
+				handles, paged);
+
+			// 破棄したスロットは再利用されるが、古いハンドルでは取得できないこと
+			const Entity recycled = world.CreateGameObject()->GetHandle();
+			pagedPassed &= entt::to_entity(recycled) == entt::to_entity(handles.back()) &&
+				world.GetGameObject(handles.back()) == nullptr &&
+				world.GetGameObject(recycled) != nullptr;
+		}
+
+		bool passed = referencePassed;
+		passed &= Report("Create", reference.create, paged.create, pagedPassed);
+		passed &= Report("Lookup", reference.lookup, paged.lookup, pagedPassed);
+		passed &= Report("Destroy", reference.destroy, paged.destroy, pagedPassed);
+		return passed;
+	}
+}
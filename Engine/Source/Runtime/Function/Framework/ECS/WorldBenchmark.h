@@ -0,0 +1,30 @@
+/**
+ * @file WorldBenchmark.h
+ * @brief World のゲームオブジェクト管理と従来のハッシュマップによる管理の比較ベンチマーク
+ *
+ * エディタを --math-benchmark 引数付きで起動するとMathBenchmarkに続けて実行され、結果をログに出力する。
+ * 従来の方法（unique_ptrで1つずつ確保し、unordered_mapで引く）をscalarの欄に出す。
+ */
+
+#pragma once
+
+namespace AtomEngine
+{
+	/**
+	 * @class WorldBenchmark
+	 * @brief ゲームオブジェクトの生成・取得・破棄の速度と正しさの計測
+	 */
+	class WorldBenchmark
+	{
+	public:
+		/// 計測するオブジェクトの数
+		static constexpr unsigned kObjectCount = 100000;
+
+		/**
+		 * @brief 全ての計測を行い、処理時間と結果の確認をログに出力する
+		 * @param iterations 各計測の繰り返し回数
+		 * @return 取得・破棄の結果が全て正しければtrue
+		 */
+		static bool Run(int iterations = 10);
+	};
+}
@@ -1,5 +1,7 @@
 #include "GlobalContext.h"
 #include "Runtime/Core/LogSystem/LogSystem.h"
+#include "Runtime/Core/LogSystem/EventLog.h"
+#include "Runtime/Core/Job/JobSystem.h"
 #include "Runtime/Function/Render/WindowManager.h"
 #include "Runtime/Function/Input/Input.h"
 #include "Runtime/Function/Audio/Audio.h"
@@ -14,6 +16,8 @@ namespace AtomEngine
 	{
 		StartLog();
 
+		JobSystem::Initialize();
+
 		windowManager = WindowManager::GetInstance();
 		WindowCreateInfo windowCreateInfo;
 		windowCreateInfo.title = L"P and Advance";
@@ -35,7 +39,9 @@ namespace AtomEngine
 	{
 		imgui->Shutdown();
 		input->Shutdown();
+		JobSystem::Shutdown();
 
+		EventLog::Dump();
 		CloseLog();
 	}
 }
@@ -7,13 +7,17 @@
 #include "Runtime/Platform/DirectX12/Buffer/BufferManager.h"
 #include "Runtime/Platform/DirectX12/Shader/ConstantBufferStructures.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace AtomEngine
 {
 	void RenderQueue::AddMesh(
 		const Mesh& mesh,
 		const JointXform* skeleton,
-		D3D12_VERTEX_BUFFER_VIEW vbv,
+		const D3D12_VERTEX_BUFFER_VIEW (&vbv)[kNumVertexStreams],
 		D3D12_INDEX_BUFFER_VIEW ibv,
+		uint32_t indexCount,
 		D3D12_GPU_VIRTUAL_ADDRESS meshCBV,
 		D3D12_GPU_VIRTUAL_ADDRESS materialCBV,
 		float distance,
@@ -76,8 +80,9 @@ namespace AtomEngine
 		RenderObject obj{};
 		obj.mesh = &mesh;
 		obj.skeleton = skeleton;
-		obj.vbv = vbv;
+		std::copy(std::begin(vbv), std::end(vbv), obj.vbv);
 		obj.ibv = ibv;
+		obj.indexCount = indexCount;
 		obj.meshCBV = meshCBV;
 		obj.materialCBV = materialCBV;
 		obj.subMeshIndex = subMeshIndex;
@@ -207,9 +212,12 @@ namespace AtomEngine
 				}
 				context.SetPipelineState(Renderer::GetPSO(key.psoIdx));
 
-				context.SetVertexBuffer(0, object.vbv);
+				// 位置は16bitに量子化してあるので、サブメッシュごとの復元用の値をルート定数で渡す
+				context.SetConstantArray(kPositionDequantization, sizeof(PositionDequantization) / sizeof(uint32_t), &subMesh.positionDequantization);
+				context.SetVertexBuffers(0, mesh->numJoints > 0 ? kNumVertexStreams : kSkinStream, object.vbv);
 				context.SetIndexBuffer(object.ibv);
-				context.DrawIndexedInstanced(subMesh.indexCount, 1, subMesh.indexOffset, subMesh.vertexOffset, 0);
+				// ibvは描画する範囲のインデックスの先頭を指している
+				context.DrawIndexedInstanced(object.indexCount, 1, 0, subMesh.vertexOffset, 0);
 				
 				++mCurrentDraw;
 			}
@@ -5,7 +5,9 @@
 #include "Runtime/Platform/DirectX12/Context/GraphicsContext.h"
 #include "Runtime/Function/Camera/CameraBase.h"
 #include "Runtime/Core/Math/Frustum.h"
+#include "Runtime/Core/Math/FrustumCulling.h"
 #include "Runtime/Core/Math/Matrix4x4.h"
+#include "Runtime/Resource/Mesh.h"
 
 struct GlobalConstants;
 
@@ -13,7 +15,6 @@ namespace AtomEngine
 {
 
 	class CameraBase;
-	struct Mesh;
 	struct JointXform;
 
 	struct RenderObject
@@ -21,8 +22,9 @@ namespace AtomEngine
 		const Mesh* mesh = nullptr;
 		const JointXform* skeleton = nullptr;
 
-		D3D12_VERTEX_BUFFER_VIEW vbv;
-		D3D12_INDEX_BUFFER_VIEW ibv;
+		D3D12_VERTEX_BUFFER_VIEW vbv[kNumVertexStreams];   ///< VertexStreamの順（スキンなしならkSkinStreamは空）
+		D3D12_INDEX_BUFFER_VIEW ibv;        ///< 描画する範囲の先頭を指す
+		uint32_t indexCount = 0;            ///< 描画するインデックスの数（メッシュレットのカリングでサブメッシュの一部になる）
 
 		D3D12_GPU_VIRTUAL_ADDRESS meshCBV;
 		D3D12_GPU_VIRTUAL_ADDRESS materialCBV;
@@ -51,6 +53,11 @@ namespace AtomEngine
 		void SetCamera(const CameraBase& camera)
 		{
 			mCamera = &camera;
+
+			// シャドウはライトと近平面の間にあるキャスターも影を落とすので近平面で外さない
+			mCullingPlaneBits = mBatchType == kShadows ?
+				CullingPlanes::kAllPlaneBits & ~CullingPlanes::kNearPlaneBit : CullingPlanes::kAllPlaneBits;
+			mCullingPlanes = CullingPlanes(camera.GetViewProjMatrix(), mCullingPlaneBits);
 		}
 
 		void SetViewportAndScissor(const D3D12_VIEWPORT& viewport, const D3D12_RECT& scissor)
@@ -68,12 +75,42 @@ namespace AtomEngine
 		const Frustum& GetWorldFrustum() const { return  mCamera->GetWorldSpaceFrustum(); }
 		const Frustum& GetViewFrustum() const { return  mCamera->GetViewSpaceFrustum(); }
 		const Matrix4x4& GetViewMatrix() const { return  mCamera->GetViewMatrix(); }
+		const CullingPlanes& GetCullingPlanes() const { return mCullingPlanes; }
+		const Vector3& GetViewPosition() const { return mCamera->GetPosition(); }
+
+		/// ローカル空間で判定するための平面（localToWorldはローカルからワールドへの行列）
+		CullingPlanes GetLocalCullingPlanes(const Matrix4x4& localToWorld) const
+		{
+			return CullingPlanes(localToWorld * mCamera->GetViewProjMatrix(), mCullingPlaneBits);
+		}
+
+		/**
+		 * @brief 視点から裏を向いた面を描画しないか
+		 *
+		 * メインビューは時計回りを表として裏面を捨てる。シャドウは反対側の面を捨てるうえ平行投影なので、
+		 * 視点の位置による裏向きの判定（メッシュレットの法線の円錐など）は使えない。
+		 */
+		bool IsBackfaceCullingEnabled() const { return mBatchType == kDefault; }
+
+		/**
+		 * @brief 視点から距離distanceにある長さ1が、画面上で何ピクセルになるか（LODの選択用）
+		 *
+		 * 透視投影では距離に反比例し、平行投影（シャドウ）では距離によらない。
+		 */
+		float GetPixelsPerUnit(float distance) const
+		{
+			const Matrix4x4& proj = mCamera->GetProjMatrix();
+			const float w = Math::Max(distance * proj.mat[2][3] + proj.mat[3][3], kMinProjectedW);
+			const float height = mViewport.Height > 0.0f ? mViewport.Height : static_cast<float>(mDSV ? mDSV->GetHeight() : 0);
+			return proj.mat[1][1] * 0.5f * height / w;
+		}
 
 		void AddMesh(
 			const Mesh& mesh,
 			const JointXform* skeleton,
-			D3D12_VERTEX_BUFFER_VIEW vbv,
+			const D3D12_VERTEX_BUFFER_VIEW (&vbv)[kNumVertexStreams],
 			D3D12_INDEX_BUFFER_VIEW ibv,
+			uint32_t indexCount,
 			D3D12_GPU_VIRTUAL_ADDRESS meshCBV,
 			D3D12_GPU_VIRTUAL_ADDRESS materialCBV,
 			float distance,
@@ -85,6 +122,9 @@ namespace AtomEngine
 		void RenderMeshes(DrawType type, GraphicsContext& context, GlobalConstants& globals);
 	private:
 
+		/// 視点に重なる物体のLODの選択で、距離0による割り算を避ける
+		static constexpr float kMinProjectedW = 1e-4f;
+
 		struct SortKey
 		{
 			union
@@ -108,6 +148,8 @@ namespace AtomEngine
 		uint32_t mCurrentDraw;
 
 		const CameraBase* mCamera = nullptr;
+		CullingPlanes mCullingPlanes;
+		uint32_t mCullingPlaneBits = CullingPlanes::kAllPlaneBits;
 		D3D12_VIEWPORT mViewport{};
 		D3D12_RECT mScissor{};
 
@@ -15,6 +15,7 @@
 #include "Runtime/Resource/Model.h"
 #include "Runtime/Core/Utility/Utility.h"
 #include "Runtime/Function/Framework/Component/MeshComponent.h"
+#include "Runtime/Function/Animation/AnimationSystem.h"
 #include "Runtime/Function/Render/RenderPasses/RenderPassManager.h"
 #include "Runtime/Function/Render/RenderPasses/RenderPassesInclude.h"
 #include "Runtime/Function/Render/MeshRenderer.h"
@@ -55,41 +56,41 @@ namespace AtomEngine
 		mRootSig[kCommonCBV].InitAsConstantBuffer(1);
         mRootSig[kLightConstants].InitAsConstantBuffer(2, D3D12_SHADER_VISIBILITY_PIXEL);
 		mRootSig[kSkinMatrices].InitAsBufferSRV(20, D3D12_SHADER_VISIBILITY_VERTEX);
+		mRootSig[kPositionDequantization].InitAsConstants(3, sizeof(PositionDequantization) / sizeof(uint32_t), D3D12_SHADER_VISIBILITY_VERTEX);
 		mRootSig.Finalize(L"RootSig", D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
 		DXGI_FORMAT ColorFormat = gSceneColorBuffer.GetFormat();
 		DXGI_FORMAT DepthFormat = gSceneDepthBuffer.GetFormat();
 
-		//D3D12_INPUT_ELEMENT_DESC posOnlyInput[] =
-		//{
-		//	{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-		//};
+		// 頂点はストリームごとのスロットに分かれている（VertexStream）。深度・シャドウは位置とスキンだけを読む
+		D3D12_INPUT_ELEMENT_DESC posOnlyInput[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, kPositionStream, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		};
 
-		//D3D12_INPUT_ELEMENT_DESC posOnlySkinInput[] =
-		//{
-		//	{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-		//	{ "WEIGHT",   0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
-		//	{ "INDEX",   0, DXGI_FORMAT_R32G32B32A32_UINT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
-		//};
+		D3D12_INPUT_ELEMENT_DESC posOnlySkinInput[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, kPositionStream, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+			{ "WEIGHT",   0, DXGI_FORMAT_R16G16B16A16_UNORM, kSkinStream, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+			{ "INDEX",    0, DXGI_FORMAT_R16G16B16A16_UINT,  kSkinStream, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		};
 
 		D3D12_INPUT_ELEMENT_DESC defaultInput[] =
 		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-			{ "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-			{ "TANGENT",  0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-			{ "BITTANGENT",  0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+			{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, kPositionStream,  D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT,       kAttributeStream, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+			{ "NORMAL",   0, DXGI_FORMAT_R16G16_SNORM,       kAttributeStream, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+			{ "TANGENT",  0, DXGI_FORMAT_R10G10B10A2_UNORM,  kAttributeStream, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		};
 
 		D3D12_INPUT_ELEMENT_DESC skinInput[] =
 		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,	 0},
-			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,	 0},
-			{ "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,	 0},
-			{ "TANGENT",  0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,	 0},
-			{ "BITTANGENT",  0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,	 0},
-			{ "WEIGHT",   0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
-			{ "INDEX",   0, DXGI_FORMAT_R32G32B32A32_UINT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
+			{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, kPositionStream,  D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT,       kAttributeStream, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+			{ "NORMAL",   0, DXGI_FORMAT_R16G16_SNORM,       kAttributeStream, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+			{ "TANGENT",  0, DXGI_FORMAT_R10G10B10A2_UNORM,  kAttributeStream, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+			{ "WEIGHT",   0, DXGI_FORMAT_R16G16B16A16_UNORM, kSkinStream,      D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+			{ "INDEX",    0, DXGI_FORMAT_R16G16B16A16_UINT,  kSkinStream,      D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		};
 
 		//default PSO
@@ -172,7 +173,7 @@ namespace AtomEngine
 		depthOnlyPSO.SetRasterizerState(RasterizerDefaultCw);
 		depthOnlyPSO.SetBlendState(BlendDisable);
 		depthOnlyPSO.SetDepthStencilState(DepthStateReadWrite);
-		depthOnlyPSO.SetInputLayout(_countof(defaultInput), defaultInput);
+		depthOnlyPSO.SetInputLayout(_countof(posOnlyInput), posOnlyInput);
 		depthOnlyPSO.SetPrimitiveTopologyType(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
 		depthOnlyPSO.SetRenderTargetFormats(0, nullptr, DepthFormat);
 		depthOnlyPSO.SetVertexShader(depthOnlyVS.Get());
@@ -183,7 +184,7 @@ namespace AtomEngine
 		auto shadowSkinVS = ShaderCompiler::CompileBlob(L"DepthOnlySkinVS.hlsl", L"vs_6_2");
 		GraphicsPSO SkinDepthOnlyPSO(L"depthOnly Skin PSO");
 		SkinDepthOnlyPSO = depthOnlyPSO;
-		SkinDepthOnlyPSO.SetInputLayout(_countof(skinInput), skinInput);
+		SkinDepthOnlyPSO.SetInputLayout(_countof(posOnlySkinInput), posOnlySkinInput);
 		SkinDepthOnlyPSO.SetVertexShader(shadowSkinVS.Get());
 		SkinDepthOnlyPSO.Finalize();
 		gPSOs.push_back(SkinDepthOnlyPSO);
@@ -249,8 +250,14 @@ namespace AtomEngine
 		mRenderPassManager->SetUpRenderPass();
 	}
 
-	void Renderer::Update(World& world,float deltaTime)
+	void Renderer::Update(World& world, const Camera& camera, float deltaTime)
 	{
+		//システムが動かしたトランスフォームのワールド行列を更新
+		world.UpdateTransforms();
+
+		//アニメーションをまとめて評価（スキニング行列まで）
+		AnimationSystem::Update(world, camera, deltaTime);
+
 		GraphicsContext& gfxContext = GraphicsContext::Begin(L"Scene Update");
 		//ワールドからメッシュコンポーネントとトランスフォームコンポーネントを取得
 		auto view = world.View<MeshComponent,TransformComponent,MaterialComponent>();
@@ -263,7 +270,7 @@ namespace AtomEngine
 
 			auto& material = view.get<MaterialComponent>(entity);
 			auto& transform = view.get<TransformComponent>(entity);
-            mesh.Update(gfxContext,transform, material,deltaTime);
+            mesh.Update(gfxContext,transform, material);
 		}
 		//描画パスを更新
 		mRenderPassManager->Update(gfxContext,deltaTime);
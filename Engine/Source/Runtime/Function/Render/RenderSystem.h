@@ -15,6 +15,7 @@ namespace AtomEngine
 		kCommonCBV,				// グローバル定数バッファ
         kLightConstants,		// ライト定数バッファ
 		kSkinMatrices,			// スキニング行列バッファ
+		kPositionDequantization,	// 量子化した位置の復元用の値（ルート定数）
 
 		kNumRootBindings
 	};
@@ -43,7 +44,7 @@ namespace AtomEngine
 
 		static void Initialize();
 		static void InitializeRenderPasses();
-		static void Update(World& world,float deltaTime);
+		static void Update(World& world, const Camera& camera, float deltaTime);
 		static void UpdateBuffers();
 		static void Render(World& world,Camera& camera ,float deltaTime);
 
@@ -30,6 +30,7 @@ namespace AtomEngine
 
     DescriptorHandle DescriptorHeap::Alloc(uint32_t Count)
     {
+        std::lock_guard<std::mutex> LockGuard(mAllocationMutex);
         ASSERT(HasAvailableSpace(Count), "Descriptor Heap out of space.  Increase heap size.");
         DescriptorHandle ret = mNextFreeHandle;
         mNextFreeHandle += Count * mDescriptorSize;
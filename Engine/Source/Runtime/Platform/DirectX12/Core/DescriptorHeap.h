@@ -1,5 +1,6 @@
 #pragma once
 #include "../D3dUtility/d3dInclude.h"
+#include <mutex>
 
 namespace AtomEngine
 {
@@ -80,5 +81,6 @@ namespace AtomEngine
         uint32_t mNumFreeDescriptors = 0;
         DescriptorHandle mFirstHandle;
         DescriptorHandle mNextFreeHandle;
+        std::mutex mAllocationMutex;    // モデルの読み込みスレッドからも確保される
     };
 }
@@ -1,18 +1,23 @@
 #include "AssetManager.h"
+#include "CookedModel.h"
 #include "ModelLoader.h"
 #include "DirectXTex.h"
 #include "Runtime/Function/Render/RenderSystem.h"
 #include "Runtime/Platform/DirectX12/Core/DirectX12Core.h"
 #include "Runtime/Platform/DirectX12/Shader/ConstantBufferStructures.h"
+#include "Runtime/Core/Job/JobSystem.h"
 
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <unordered_set>
 
 namespace
 {
 	std::wstring sRootPath = L"";
 	std::map<std::wstring, std::unique_ptr<AtomEngine::ManagedTexture>>sTextureCache;
 	std::map<std::wstring, std::shared_ptr<AtomEngine::Model>> sModelDataCache;
+	std::map<std::wstring, AtomEngine::ModelFuture> sPendingModels;     // 読み込み中のモデル
 	std::unordered_map<uint32_t, uint32_t> gSamplerPermutations;
 
 	std::mutex sTextureMutex;
@@ -28,6 +33,16 @@ namespace AtomEngine
 
 	void AssetManager::Shutdown()
 	{
+		// 読み込み中のモデルが終わるのを待ってから破棄する
+		std::vector<ModelFuture> pending;
+		{
+			std::lock_guard<std::mutex> guard(sModelMutex);
+			for (const auto& [name, future] : sPendingModels)
+				pending.push_back(future);
+		}
+		for (const ModelFuture& future : pending)
+			future.wait();
+
 		sTextureCache.clear();
 		sModelDataCache.clear();
 	}
@@ -43,7 +58,7 @@ namespace AtomEngine
 
 	void AssetManager::DestroyModel(const std::wstring& key)
 	{
-		std::lock_guard<std::mutex> Guard(sTextureMutex);
+		std::lock_guard<std::mutex> Guard(sModelMutex);
 		auto iter = sModelDataCache.find(key);
 		if (iter != sModelDataCache.end())
 			sModelDataCache.erase(iter);
@@ -155,45 +170,69 @@ namespace AtomEngine
 		}
 	}
 
-	void LoadMaterialTexture(
-		Model& model,
-		const ModelData& modelData,
-		const std::map<uint32_t, std::vector<MaterialTexture>>& textures,
-		const std::wstring& basePath)
+	/// モデルが使うテクスチャの変換要求（同じファイルは最初の1つだけ）
+	std::vector<TextureConversionRequest> GetModelTextureRequests(const Model& model, const std::wstring& basePath)
 	{
-		static_assert((_alignof(MaterialConstants) & 255) == 0, "CBVs need 256 byte alignment");
-
+		std::vector<TextureConversionRequest> requests;
+		std::unordered_set<std::wstring> files;
+		for (const Material& material : model.mMaterials)
+		{
+			for (const MaterialTexture& texture : material.textures)
+			{
+				std::wstring file = basePath + texture.name;
+				if (!files.insert(file).second)
+					continue;
 
-		const uint32_t numMaterials = (uint32_t)modelData.materials.size();
-		std::vector<uint32_t> tableOffsets(numMaterials);
-		std::vector<bool> hasMRTextures(numMaterials);
+				bool optionalSRGB =
+					(texture.slot & (TextureSlot::kBaseColor | TextureSlot::kEmissive)) ? true : false;
+				requests.push_back({ std::move(file), TextureOptions(optionalSRGB) });
+			}
+		}
+		return requests;
+	}
 
-		for (uint32_t matIdx = 0; matIdx < numMaterials; ++matIdx)
+	/// 読み込み済み（キャッシュにある）テクスチャをマテリアルごとにモデルへ設定する
+	void BindModelTextures(Model& model, const std::wstring& basePath)
+	{
+		for (uint32_t matIdx = 0; matIdx < model.mMaterials.size(); ++matIdx)
 		{
-			auto it = textures.find(matIdx);
-			if (it == textures.end())continue;
-			auto& mataTextures = it->second;
-			const uint32_t numTextures = (uint32_t)mataTextures.size();
+			const auto& textures = model.mMaterials[matIdx].textures;
+			if (textures.empty())
+				continue;
 
 			auto& modelTextures = model.mTextures[matIdx];
-			modelTextures.resize(numTextures);
-
-			for (uint32_t ti = 0; ti < numTextures; ++ti)
+			modelTextures.resize(textures.size());
+			for (size_t texIdx = 0; texIdx < textures.size(); ++texIdx)
 			{
-				std::wstring originalFile = basePath + mataTextures[ti].name;
-				bool optionalSRGB =
-					(mataTextures[ti].slot & (TextureSlot::kBaseColor | TextureSlot::kEmissive)) ? true : false;
-				CompileTextureOnDemand(originalFile, TextureOptions(optionalSRGB));
-
-				std::wstring ddsFile = RemoveExtension(originalFile) + L".dds";
-				modelTextures[ti] = AssetManager::LoadTextureFile(ddsFile);
+				std::wstring ddsFile = RemoveExtension(basePath + textures[texIdx].name) + L".dds";
+				modelTextures[texIdx] = AssetManager::LoadTextureFile(ddsFile);
 			}
 		}
+	}
+
+	/**
+	 * @brief モデルの全テクスチャをDDSに変換（必要なものだけ並列に）してから読み込む
+	 *
+	 * 複数のマテリアルが同じ画像を使っていても変換は1度だけ行う。
+	 */
+	void LoadModelTextures(Model& model, const std::wstring& basePath)
+	{
+		CompileTexturesOnDemand(GetModelTextureRequests(model, basePath));
+		BindModelTextures(model, basePath);
+	}
+
+	void CreateMaterialTables(Model& model)
+	{
+		static_assert((_alignof(MaterialConstants) & 255) == 0, "CBVs need 256 byte alignment");
+
+		const uint32_t numMaterials = (uint32_t)model.mMaterials.size();
+		std::vector<uint32_t> tableOffsets(numMaterials);
+		std::vector<bool> hasMRTextures(numMaterials);
 
 		for (uint32_t matIdx = 0; matIdx < numMaterials; ++matIdx)
 		{
 
-			const auto& material = modelData.materials[matIdx];
+			const auto& material = model.mMaterials[matIdx];
 			uint32_t mask = material.textureMask;
 			hasMRTextures[matIdx] = (mask & kMetallicRoughness) == kMetallicRoughness;
 
@@ -309,169 +348,249 @@ namespace AtomEngine
 		return  LoadModel(WStringToUTF8(filePath));
 	}
 
-	std::shared_ptr<Model> AssetManager::LoadModel(const std::string& filePath)
+	namespace
 	{
-		std::lock_guard<std::mutex> guard(sModelMutex);
-
-		std::wstring filePathW = UTF8ToWString(filePath);
-		std::wstring basePath = GetBasePath(filePathW);
-		std::wstring modelName = RemoveBasePath(filePathW);
-		auto it = sModelDataCache.find(modelName);
-		if (it != sModelDataCache.end())
-			return it->second;
+		template<typename T>
+		void UploadVertexStream(ByteAddressBuffer& buffer, const std::wstring& name, const T* data, uint32_t count)
+		{
+			const size_t bufferSize = static_cast<size_t>(count) * sizeof(T);
 
-		auto model = std::make_shared<Model>();
+			UploadBuffer upload;
+			upload.Create(name + L"Upload", bufferSize);
+			memcpy(upload.Map(), data, bufferSize);
+			upload.Unmap();
 
-		ModelData modelData;
+			buffer.Create(name, count, sizeof(T), upload);
+		}
 
-		if (!ModelLoader::LoadModel(modelData, filePath))
+		/**
+		 * 1つのモデルの読み込み要求
+		 * 解析 → 頂点・インデックスのアップロード → テクスチャ（変換は並列）→ マテリアルとキャッシュ登録 の順に進める。
+		 * 各段階はロックを取らず、最後のキャッシュ登録だけsModelMutexを取る。
+		 * 非同期の読み込みでは、解析・アップロードを1つずつ、テクスチャを1枚につき1つのタスクで行い、
+		 * 最後に終わったテクスチャのタスクがマテリアルを作って登録する。
+		 */
+		struct ModelLoadRequest
 		{
-			Log("Failed to load model: %s", filePath.c_str());
-			return nullptr;
-		}
+			std::string filePath;
+			std::wstring filePathW;
+			std::wstring basePath;
+			std::wstring modelName;
 
-		model->mBoundingBox = modelData.boundingBox;
-		model->mBoundingSphere = modelData.boundingSphere;
+			std::promise<std::shared_ptr<Model>> promise;
+			std::shared_ptr<Model> model = std::make_shared<Model>();
+			CookedModel cooked;
 
-		model->mMeshData = std::move(modelData.meshes);
-		model->mSceneGraph = std::move(modelData.graphNodes);
-		//頂点データをアップロード
-		if (!modelData.vertices.empty())
-		{
-			if (modelData.skinClusterData.empty())
-			{
-				size_t vertexBufferSize = modelData.vertices.size() * sizeof(Vertex);
-
-				UploadBuffer vertexUpload;
-				vertexUpload.Create(L"VertexUpload", vertexBufferSize);
-				memcpy(vertexUpload.Map(), modelData.vertices.data(), vertexBufferSize);
-				vertexUpload.Unmap();
-
-				model->mVertexBuffer.Create(
-					RemoveExtension(modelName) + L"VertexBuffer",
-					static_cast<uint32_t>(modelData.vertices.size()),
-					sizeof(Vertex),
-					vertexUpload
-				);
-			}
-			else
-			{
-				std::vector<JointVertex> sortedJointData(modelData.vertices.size());
+			std::vector<TextureConversionRequest> textures;     ///< 非同期で読み込むテクスチャ
+			std::atomic<size_t> remainingTextures{ 0 };         ///< 読み込みが終わっていないテクスチャ数
 
-				for (const auto& [jointName, skinInfo] : modelData.skinClusterData)
+			/// キャッシュを開く（古ければassimpでインポートして作り直す）
+			bool Parse()
+			{
+				// 前回の結果が残っていてソースが変わっていなければ、インポートせずにそれを使う
+				const std::wstring cookedPath = CookedModel::GetCookedPath(filePathW);
+				if (!cooked.Open(cookedPath, filePathW))
 				{
-					auto it = modelData.skeleton.jointMap.find(jointName);
-					if (it == modelData.skeleton.jointMap.end()) continue;
+					ModelData modelData;
+					if (!ModelLoader::LoadModel(modelData, filePath) || !cooked.Cook(modelData, filePathW, cookedPath))
+					{
+						Log("Failed to load model: %s", filePath.c_str());
+						return false;
+					}
+				}
 
-					int32_t jointIndex = it->second;
+				if (!cooked.ReadModel(*model))
+				{
+					Log("Failed to read cooked model: %s", filePath.c_str());
+					return false;
+				}
+				return true;
+			}
 
-					for (const auto& weightInfo : skinInfo.vertexWeights)
+			/// 頂点・インデックスをアップロードする
+			void Process()
+			{
+				//頂点データをストリームごとにアップロード
+				if (cooked.GetVertexCount() > 0)
+				{
+					const std::wstring name = RemoveExtension(modelName);
+					UploadVertexStream(model->mPositionBuffer, name + L"PositionBuffer", cooked.GetPositionData(), cooked.GetVertexCount());
+					UploadVertexStream(model->mAttributeBuffer, name + L"AttributeBuffer", cooked.GetAttributeData(), cooked.GetVertexCount());
+					if (cooked.GetSkinData())
 					{
-						uint32_t vertexIdx = weightInfo.vertexIndex;
-						float weightVal = weightInfo.weight;
+						UploadVertexStream(model->mSkinBuffer, name + L"SkinBuffer", cooked.GetSkinData(), cooked.GetVertexCount());
 
-						if (vertexIdx < sortedJointData.size())
-						{
-							// 既存のjointIndices/weights配列の空きスロットを探して代入
-							for (int k = 0; k < 4; ++k)
-							{
-								if (sortedJointData[vertexIdx].weights[k] == 0.0f)
-								{
-									sortedJointData[vertexIdx].jointIndices[k] = jointIndex;
-									sortedJointData[vertexIdx].weights[k] = weightVal;
-									break;
-								}
-							}
-						}
+						// ピッキングや衝突判定でポーズを付けた頂点を求められるよう、CPUにも残す
+						const uint32_t remapped = CpuSkinning::DecodeVertices(cooked.GetPositionData(), cooked.GetAttributeData(),
+							cooked.GetSkinData(), cooked.GetVertexCount(), model->mMeshData, model->mSkinningVertices, model->mSkinningJoints);
+						if (remapped > 0)
+							Log("Skin of %s references %u joints outside its palette", filePath.c_str(), remapped);
 					}
 				}
+				//インデックスデータをアップロード（16bitと32bitのサブメッシュが混ざるのでバイト列のまま送る）
+				if (cooked.GetIndexDataSize() > 0)
+				{
+					size_t indexBufferSize = cooked.GetIndexDataSize();
+
+					UploadBuffer indexUpload;
+					indexUpload.Create(L"IndexUpload", indexBufferSize);
+					memcpy(indexUpload.Map(), cooked.GetIndexData(), indexBufferSize);
+					indexUpload.Unmap();
+
+					model->mIndexBuffer.Create(
+						RemoveExtension(modelName) + L"IndexBuffer",
+						cooked.GetIndexDataSize() / sizeof(uint32_t),
+						sizeof(uint32_t),
+						indexUpload
+					);
+				}
+				cooked.Close();
 
-				size_t vertexSize = sizeof(Vertex);
-				size_t skinSize = sizeof(JointVertex);
-				size_t totalSize = modelData.vertices.size() * (vertexSize + skinSize);
+				model->mBindPose.resize(model->mNumJoints);
+				for (uint32_t i = 0; i < model->mNumJoints; ++i)
+				{
+					const Transform& bind = model->mSkeleton.joints[i].transform;
+					model->mBindPose[i].rotation = bind.rotation;
+					model->mBindPose[i].translation = bind.transition;
+					model->mBindPose[i].scale = bind.scale;
+				}
+			}
 
-				UploadBuffer vertexUpload;
-				vertexUpload.Create(L"VertexUpload", totalSize);
+			void LoadTextures()
+			{
+				LoadModelTextures(*model, basePath);
+			}
 
-				uint8_t* dst = reinterpret_cast<uint8_t*>(vertexUpload.Map());
-				for (size_t i = 0; i < modelData.vertices.size(); ++i)
-				{
-					memcpy(dst, &modelData.vertices[i], vertexSize);
-					dst += vertexSize;
+			/**
+			 * @brief texturesのindex番目を変換して読み込む
+			 * @return 最後の1枚ならtrue（呼び出し側がマテリアルを作って登録する）
+			 */
+			bool LoadTexture(size_t index)
+			{
+				const TextureConversionRequest& texture = textures[index];
+				CompileTextureOnDemand(texture.sourceFile, texture.flags);
+				AssetManager::LoadTextureFile(RemoveExtension(texture.sourceFile) + L".dds");
+				return remainingTextures.fetch_sub(1) == 1;
+			}
 
-					memcpy(dst, &sortedJointData[i], skinSize);
-					dst += skinSize;
+			/// マテリアルを作ってキャッシュに登録し、待っている全員に結果を渡す
+			void Finish(bool succeeded)
+			{
+				if (succeeded)
+				{
+					// 非同期の読み込みではテクスチャはキャッシュに入っているので、モデルへの設定だけ行う
+					if (!textures.empty())
+						BindModelTextures(*model, basePath);
+					CreateMaterialTables(*model);
 				}
 
-				vertexUpload.Unmap();
-
-				model->mVertexBuffer.Create(
-					RemoveExtension(modelName) + L"VertexBuffer",
-					static_cast<uint32_t>(modelData.vertices.size()),
-					static_cast<uint32_t>(vertexSize + skinSize),
-					vertexUpload
-				);
+				{
+					std::lock_guard<std::mutex> guard(sModelMutex);
+					if (succeeded)
+						sModelDataCache[modelName] = model;
+					sPendingModels.erase(modelName);
+				}
+				promise.set_value(succeeded ? model : nullptr);
 			}
-			
-		}
-		//インデックスデータをアップロード
-		if (!modelData.indices.empty())
-		{
-			size_t indexBufferSize = modelData.indices.size() * sizeof(uint32_t);
-
-			UploadBuffer indexUpload;
-			indexUpload.Create(L"IndexUpload", indexBufferSize);
-			memcpy(indexUpload.Map(), modelData.indices.data(), indexBufferSize);
-			indexUpload.Unmap();
-
-			model->mIndexBuffer.Create(
-				RemoveExtension(modelName) + L"IndexBuffer",
-				static_cast<uint32_t>(modelData.indices.size()),
-				sizeof(uint32_t),
-				indexUpload
-			);
-		}
+		};
 
-		std::map<uint32_t, std::vector<MaterialTexture>> textures;
-		for (uint32_t m = 0; m < modelData.materials.size(); ++m)
+		/**
+		 * @brief キャッシュ済み・読み込み中ならその結果を、なければ新しい要求を作って返す
+		 * @param request 新しい要求を作った場合だけ設定される（呼び出し側が読み込みを進める）
+		 */
+		ModelFuture FindOrCreateRequest(const std::string& filePath, std::shared_ptr<ModelLoadRequest>& request)
 		{
-			for (uint32_t t = 0; t < modelData.materials[m].textures.size(); ++t)
+			std::wstring filePathW = UTF8ToWString(filePath);
+			std::wstring modelName = RemoveBasePath(filePathW);
+
+			std::lock_guard<std::mutex> guard(sModelMutex);
+			auto it = sModelDataCache.find(modelName);
+			if (it != sModelDataCache.end())
 			{
-				textures[m].push_back(modelData.materials[m].textures[t]);
+				std::promise<std::shared_ptr<Model>> ready;
+				ready.set_value(it->second);
+				return ready.get_future().share();
 			}
-		}
 
-		LoadMaterialTexture(*model, modelData, textures, basePath);
+			auto pending = sPendingModels.find(modelName);
+			if (pending != sPendingModels.end())
+				return pending->second;
 
-		//マテリアル定数バッファアップロード
-		if (modelData.materials.size() > 0)
-		{
-			model->mMaterials = std::move(modelData.materials);
+			request = std::make_shared<ModelLoadRequest>();
+			request->filePath = filePath;
+			request->basePath = GetBasePath(filePathW);
+			request->filePathW = std::move(filePathW);
+			request->modelName = modelName;
+
+			ModelFuture future = request->promise.get_future().share();
+			sPendingModels.emplace(std::move(modelName), future);
+			return future;
 		}
+	}
 
-		if (!modelData.animations.empty())
+	std::shared_ptr<Model> AssetManager::LoadModel(const std::string& filePath)
+	{
+		std::shared_ptr<ModelLoadRequest> request;
+		ModelFuture future = FindOrCreateRequest(filePath, request);
+
+		// 新しい要求なら呼び出したスレッドでそのまま読み込む（他の要求の読み込みは止めない）
+		if (request)
 		{
-			model->mAnimationData = std::move(modelData.animations);
+			if (request->Parse())
+			{
+				request->Process();
+				request->LoadTextures();
+				request->Finish(true);
+			}
+			else
+			{
+				request->Finish(false);
+			}
 		}
+		return future.get();
+	}
 
-		if (!modelData.skeleton.joints.empty())
-		{
-			model->mSkeleton = std::move(modelData.skeleton);
-			model->mNumJoints = static_cast<uint32_t>(model->mSkeleton.joints.size());
-			model->mJointIBMs.resize(model->mNumJoints);
+	ModelFuture AssetManager::LoadModelAsync(const std::wstring& filePath)
+	{
+		return LoadModelAsync(WStringToUTF8(filePath));
+	}
 
-			for (const auto& jointWeight : modelData.skinClusterData)
+	ModelFuture AssetManager::LoadModelAsync(const std::string& filePath)
+	{
+		std::shared_ptr<ModelLoadRequest> request;
+		ModelFuture future = FindOrCreateRequest(filePath, request);
+		if (!request)
+			return future;
+
+		JobSystem::ScheduleBackground([request]
 			{
-				auto it = model->mSkeleton.jointMap.find(jointWeight.first);
-				if (it == model->mSkeleton.jointMap.end())
+				if (!request->Parse())
 				{
-					continue;
+					request->Finish(false);
+					return;
 				}
-				model->mJointIBMs[it->second] = jointWeight.second.inverseBindPoseMatrix;
-			}
-		}
+				JobSystem::ScheduleBackground([request]
+					{
+						request->Process();
 
-		sModelDataCache[modelName] = model;
-		return model;
+						request->textures = GetModelTextureRequests(*request->model, request->basePath);
+						if (request->textures.empty())
+						{
+							request->Finish(true);
+							return;
+						}
+
+						request->remainingTextures.store(request->textures.size());
+						for (size_t i = 0; i < request->textures.size(); ++i)
+						{
+							JobSystem::ScheduleBackground([request, i]
+								{
+									if (request->LoadTexture(i))
+										request->Finish(true);
+								});
+						}
+					});
+			});
+		return future;
 	}
 }
@@ -1,10 +1,14 @@
 #pragma once
 #include "TextureRef.h"
 #include "Model.h"
+#include <future>
 #include <string>
 
 namespace AtomEngine
 {
+	/// 読み込み中・読み込み済みのモデル（同じファイルへの要求は同じ結果を共有する。失敗時はnullptr）
+	using ModelFuture = std::shared_future<std::shared_ptr<Model>>;
+
 	class AssetManager
 	{
 	public:
@@ -23,6 +27,17 @@ namespace AtomEngine
 		static std::shared_ptr<Model> LoadModel(const std::wstring& filePath);
 		static std::shared_ptr<Model> LoadModel(const std::string& filePath);
 
+		/**
+		 * @brief モデルをバックグラウンドで読み込む（すぐに戻る）
+		 *
+		 * 解析・アップロード・テクスチャの各段階をワーカーで実行し、完了したらキャッシュに登録する。
+		 * 読み込み中に同じファイルをLoadModel / LoadModelAsyncすると、その完了を待つ / 共有する。
+		 * @param filePath モデルファイル
+		 * @return 結果（ready後のgetはブロックしない）
+		 */
+		static ModelFuture LoadModelAsync(const std::wstring& filePath);
+		static ModelFuture LoadModelAsync(const std::string& filePath);
+
 	};
 }
 
@@ -0,0 +1,662 @@
+#include "CookedModel.h"
+#include "ModelLoader.h"
+#include "VertexCompression.h"
+#include "Runtime/Core/LogSystem/LogSystem.h"
+#include "Runtime/Core/Utility/BinaryStream.h"
+#include "Runtime/Core/Utility/Hash.h"
+#include "Runtime/Core/Utility/Utility.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		enum Section : uint32_t
+		{
+			kPositions,
+			kAttributes,
+			kSkin,
+			kIndices,
+			kMeshes,
+			kSceneGraph,
+			kMaterials,
+			kSkeleton,
+			kJointIBMs,
+			kAnimations,
+			kCompressedAnimations,
+			kMeshlets,
+			kMeshletBounds,
+			kBounds,
+			kSectionCount
+		};
+
+		/// 頂点とインデックスをそのままGPUへコピーできるよう、各セクションの先頭を揃える
+		constexpr size_t kSectionAlignment = 16;
+
+		struct SectionEntry
+		{
+			uint64_t offset;
+			uint64_t size;
+		};
+
+		struct FileHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t layout;
+			uint32_t sectionCount;
+			uint64_t sourceSize;
+			int64_t sourceWriteTime;
+			uint64_t sourceHash;
+			uint32_t vertexCount;
+			uint32_t indexDataSize;
+			SectionEntry sections[kSectionCount];
+		};
+
+		/// そのまま書き出す構造体の大きさ。変わったら古いキャッシュは使わない
+		constexpr uint32_t kLayout = static_cast<uint32_t>(
+			(sizeof(PositionVertex) + sizeof(AttributeVertex)) ^ (sizeof(JointVertex) << 7) ^ (sizeof(GraphNode) << 14) ^
+			(sizeof(SubMesh) << 21) ^ (sizeof(wchar_t) << 28));
+
+		const FileHeader& GetHeader(const uint8_t* data)
+		{
+			return *reinterpret_cast<const FileHeader*>(data);
+		}
+
+		void WriteMesh(BinaryWriter& writer, const Mesh& mesh)
+		{
+			writer.Write(mesh.boundingBox);
+			writer.Write(mesh.vertexCount);
+			writer.Write(mesh.indexCount);
+			writer.Write(mesh.psoFlags);
+			writer.Write(mesh.numJoints);
+			writer.Write(mesh.startJoint);
+			writer.WriteArray(mesh.subMeshes);
+		}
+
+		void ReadMesh(BinaryReader& reader, Mesh& mesh)
+		{
+			reader.Read(mesh.boundingBox);
+			reader.Read(mesh.vertexCount);
+			reader.Read(mesh.indexCount);
+			reader.Read(mesh.psoFlags);
+			reader.Read(mesh.numJoints);
+			reader.Read(mesh.startJoint);
+			reader.ReadArray(mesh.subMeshes);
+		}
+
+		void WriteMaterial(BinaryWriter& writer, const Material& material)
+		{
+			writer.WriteString(material.name);
+			writer.Write(material.baseColorFactor);
+			writer.Write(material.emissiveFactor);
+			writer.Write(material.metallicFactor);
+			writer.Write(material.roughnessFactor);
+			writer.Write(material.normalScale);
+			writer.Write(material.ao);
+			writer.Write(material.textureMask);
+			writer.Write(material.hasAlphaBlend);
+
+			writer.Write(static_cast<uint32_t>(material.textures.size()));
+			for (const MaterialTexture& texture : material.textures)
+			{
+				writer.WriteString(texture.name);
+				writer.Write(texture.slot);
+			}
+		}
+
+		void ReadMaterial(BinaryReader& reader, Material& material)
+		{
+			reader.ReadString(material.name);
+			reader.Read(material.baseColorFactor);
+			reader.Read(material.emissiveFactor);
+			reader.Read(material.metallicFactor);
+			reader.Read(material.roughnessFactor);
+			reader.Read(material.normalScale);
+			reader.Read(material.ao);
+			reader.Read(material.textureMask);
+			reader.Read(material.hasAlphaBlend);
+
+			uint32_t textureCount = 0;
+			if (!reader.ReadCount(textureCount))
+				return;
+			for (uint32_t i = 0; i < textureCount && !reader.IsFailed(); ++i)
+			{
+				MaterialTexture& texture = material.textures.emplace_back();
+				reader.ReadString(texture.name);
+				reader.Read(texture.slot);
+			}
+		}
+
+		void WriteSkeleton(BinaryWriter& writer, const Skeleton& skeleton)
+		{
+			writer.Write(skeleton.rootJoint);
+			writer.Write(static_cast<uint32_t>(skeleton.joints.size()));
+			for (const Joint& joint : skeleton.joints)
+			{
+				writer.Write(joint.transform.transition);
+				writer.Write(joint.transform.scale);
+				writer.Write(joint.transform.rotation);
+				writer.Write(joint.localMatrix);
+				writer.Write(joint.skeletonSpaceMatrix);
+				writer.WriteString(joint.name);
+				writer.WriteArray(joint.children);
+				writer.Write(joint.index);
+				writer.Write(joint.parent.value_or(-1));
+			}
+		}
+
+		void ReadSkeleton(BinaryReader& reader, Skeleton& skeleton)
+		{
+			uint32_t jointCount = 0;
+			reader.Read(skeleton.rootJoint);
+			if (!reader.ReadCount(jointCount))
+				return;
+
+			skeleton.joints.reserve(jointCount);
+			for (uint32_t i = 0; i < jointCount && !reader.IsFailed(); ++i)
+			{
+				Joint& joint = skeleton.joints.emplace_back();
+				int32_t parent = -1;
+				reader.Read(joint.transform.transition);
+				reader.Read(joint.transform.scale);
+				reader.Read(joint.transform.rotation);
+				reader.Read(joint.localMatrix);
+				reader.Read(joint.skeletonSpaceMatrix);
+				reader.ReadString(joint.name);
+				reader.ReadArray(joint.children);
+				reader.Read(joint.index);
+				reader.Read(parent);
+				if (parent >= 0)
+					joint.parent = parent;
+
+				skeleton.jointMap[joint.name] = static_cast<int32_t>(i);
+			}
+		}
+
+		void WriteClip(BinaryWriter& writer, const AnimationClip& clip)
+		{
+			writer.WriteString(clip.name);
+			writer.Write(clip.duration);
+			writer.Write(static_cast<uint32_t>(clip.curves.size()));
+			for (const AnimationCurve& curve : clip.curves)
+			{
+				writer.Write(curve.targetJoint);
+				writer.WriteArray(curve.translation);
+				writer.WriteArray(curve.rotation);
+				writer.WriteArray(curve.scale);
+			}
+		}
+
+		void ReadClip(BinaryReader& reader, AnimationClip& clip)
+		{
+			uint32_t curveCount = 0;
+			reader.ReadString(clip.name);
+			reader.Read(clip.duration);
+			if (!reader.ReadCount(curveCount))
+				return;
+
+			for (uint32_t i = 0; i < curveCount && !reader.IsFailed(); ++i)
+			{
+				AnimationCurve& curve = clip.curves.emplace_back();
+				reader.Read(curve.targetJoint);
+				reader.ReadArray(curve.translation);
+				reader.ReadArray(curve.rotation);
+				reader.ReadArray(curve.scale);
+			}
+		}
+
+		/// 要素数の記録がない配列（セクション全体が1つの配列）を読む
+		template<typename T>
+		bool ReadRawArray(const uint8_t* data, const SectionEntry& section, std::vector<T>& values)
+		{
+			static_assert(kIsBinaryCopyable<T>, "T must be binary copyable");
+			if (section.size % sizeof(T) != 0)
+				return false;
+			values.resize(static_cast<size_t>(section.size / sizeof(T)));
+			if (!values.empty())
+				std::memcpy(values.data(), data + section.offset, static_cast<size_t>(section.size));
+			return true;
+		}
+	}
+
+	bool CookedSourceInfo::Query(const std::wstring& filePath, CookedSourceInfo& info)
+	{
+		std::error_code error;
+		const uint64_t size = std::filesystem::file_size(filePath, error);
+		if (error)
+			return false;
+		const auto writeTime = std::filesystem::last_write_time(filePath, error);
+		if (error)
+			return false;
+
+		info.size = size;
+		info.writeTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+		return true;
+	}
+
+	bool CookedSourceInfo::ComputeHash(const std::wstring& filePath, uint64_t& hash)
+	{
+		MappedFile file;
+		if (!file.Open(filePath))
+			return false;
+		hash = HashBytes64(file.GetData(), file.GetSize());
+		return true;
+	}
+
+	std::wstring CookedModel::GetCookedPath(const std::wstring& sourcePath)
+	{
+		return RemoveExtension(sourcePath) + L".amdl";
+	}
+
+	bool CookedModel::Open(const std::wstring& cookedPath, const std::wstring& sourcePath)
+	{
+		Close();
+		if (!mFile.Open(cookedPath) || !Attach(mFile.GetData(), mFile.GetSize()))
+		{
+			Close();
+			return false;
+		}
+
+		CookedSourceInfo source;
+		if (!CookedSourceInfo::Query(sourcePath, source))
+			return true;
+
+		const FileHeader& header = GetHeader(mData);
+		if (source.size == header.sourceSize && source.writeTime == header.sourceWriteTime)
+			return true;
+
+		// 更新時刻だけが変わった場合（チェックアウトやコピーなど）は内容で比べる
+		if (source.size != header.sourceSize ||
+			!CookedSourceInfo::ComputeHash(sourcePath, source.hash) ||
+			source.hash != header.sourceHash)
+		{
+			Close();
+			return false;
+		}
+
+		// 内容は同じなので記録した更新時刻を書き換え、次回はハッシュを求めずに済ませる
+		Close();
+		{
+			std::fstream file(std::filesystem::path(cookedPath), std::ios::in | std::ios::out | std::ios::binary);
+			file.seekp(offsetof(FileHeader, sourceWriteTime));
+			file.write(reinterpret_cast<const char*>(&source.writeTime), sizeof(source.writeTime));
+		}
+		if (!mFile.Open(cookedPath) || !Attach(mFile.GetData(), mFile.GetSize()))
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	bool CookedModel::Cook(const ModelData& data, const std::wstring& sourcePath, const std::wstring& cookedPath)
+	{
+		Close();
+
+		CookedSourceInfo source;
+		if (CookedSourceInfo::Query(sourcePath, source))
+			CookedSourceInfo::ComputeHash(sourcePath, source.hash);
+
+		FileHeader header = {};
+		header.magic = kMagic;
+		header.version = kVersion;
+		header.layout = kLayout;
+		header.sectionCount = kSectionCount;
+		header.sourceSize = source.size;
+		header.sourceWriteTime = source.writeTime;
+		header.sourceHash = source.hash;
+		header.vertexCount = static_cast<uint32_t>(data.vertices.size());
+
+		std::vector<uint8_t> buffer;
+		BinaryWriter writer(buffer);
+		writer.Write(header);
+
+		auto beginSection = [&](Section section) { header.sections[section].offset = writer.Align(kSectionAlignment); };
+		auto endSection = [&](Section section) { header.sections[section].size = writer.GetOffset() - header.sections[section].offset; };
+
+		// 頂点は位置・属性・スキンのストリームに分けて書く（位置の復元用の値はサブメッシュに入る）
+		// 描画は圧縮したストリームしか扱えないので、許容誤差を超えたら作らない（見た目が崩れたまま残さない）
+		std::vector<Mesh> meshes = data.meshes;
+		CompressedVertices vertices;
+		if (!VertexCompression::Compress(data.vertices, meshes, vertices))
+		{
+			Log(L"Vertex compression exceeded tolerance: %ls (position %f, normal %f, tangent %f, texcoord %f)",
+				sourcePath.c_str(), vertices.error.position, vertices.error.normal, vertices.error.tangent, vertices.error.texcoord);
+			return false;
+		}
+
+		beginSection(kPositions);
+		writer.WriteBytes(vertices.positions.data(), vertices.positions.size() * sizeof(PositionVertex));
+		endSection(kPositions);
+
+		beginSection(kAttributes);
+		writer.WriteBytes(vertices.attributes.data(), vertices.attributes.size() * sizeof(AttributeVertex));
+		endSection(kAttributes);
+
+		// スキンはModelLoaderがSkinPackingで頂点と同じ並びに詰めてある
+		beginSection(kSkin);
+		if (data.jointVertices.size() == data.vertices.size())
+			writer.WriteBytes(data.jointVertices.data(), data.jointVertices.size() * sizeof(JointVertex));
+		endSection(kSkin);
+
+		// インデックスはサブメッシュの頂点範囲の先頭からの番号なので、範囲が収まれば16bitで足りる。
+		// LODは頂点を共有するので、LOD0と同じサイズで続けて置く
+		beginSection(kIndices);
+		std::vector<uint16_t> narrowIndices;
+		for (Mesh& mesh : meshes)
+		{
+			for (SubMesh& subMesh : mesh.subMeshes)
+			{
+				subMesh.indexSize = subMesh.vertexCount <= 0x10000 ? sizeof(uint16_t) : sizeof(uint32_t);
+				for (uint32_t lod = 0; lod < subMesh.lodCount; ++lod)
+				{
+					const MeshLod range = subMesh.GetLod(lod);
+					const uint32_t* indices = data.indices.data() + range.indexOffset;
+					const uint32_t indexByteOffset = static_cast<uint32_t>(writer.Align(sizeof(uint32_t)) - header.sections[kIndices].offset);
+					if (lod == 0)
+						subMesh.indexByteOffset = indexByteOffset;
+					else
+						subMesh.lods[lod - 1].indexByteOffset = indexByteOffset;
+
+					if (subMesh.indexSize == sizeof(uint16_t))
+					{
+						narrowIndices.resize(range.indexCount);
+						std::transform(indices, indices + range.indexCount, narrowIndices.begin(),
+							[](uint32_t index) { return static_cast<uint16_t>(index); });
+						writer.WriteBytes(narrowIndices.data(), narrowIndices.size() * sizeof(uint16_t));
+					}
+					else
+					{
+						writer.WriteBytes(indices, range.indexCount * sizeof(uint32_t));
+					}
+				}
+			}
+		}
+		writer.Align(sizeof(uint32_t));
+		endSection(kIndices);
+		header.indexDataSize = static_cast<uint32_t>(header.sections[kIndices].size);
+
+		beginSection(kMeshes);
+		writer.Write(static_cast<uint32_t>(meshes.size()));
+		for (const Mesh& mesh : meshes)
+			WriteMesh(writer, mesh);
+		endSection(kMeshes);
+
+		beginSection(kSceneGraph);
+		writer.WriteBytes(data.graphNodes.data(), data.graphNodes.size() * sizeof(GraphNode));
+		endSection(kSceneGraph);
+
+		beginSection(kMaterials);
+		writer.Write(static_cast<uint32_t>(data.materials.size()));
+		for (const Material& material : data.materials)
+			WriteMaterial(writer, material);
+		endSection(kMaterials);
+
+		beginSection(kSkeleton);
+		WriteSkeleton(writer, data.skeleton);
+		endSection(kSkeleton);
+
+		// 逆バインド行列はジョイント番号順
+		beginSection(kJointIBMs);
+		if (data.jointIBMs.size() == data.skeleton.joints.size())
+			writer.WriteBytes(data.jointIBMs.data(), data.jointIBMs.size() * sizeof(Matrix4x4));
+		endSection(kJointIBMs);
+
+		beginSection(kAnimations);
+		writer.Write(static_cast<uint32_t>(data.animations.size()));
+		for (const AnimationClip& clip : data.animations)
+			WriteClip(writer, clip);
+		endSection(kAnimations);
+
+		beginSection(kCompressedAnimations);
+		writer.Write(static_cast<uint32_t>(data.compressedAnimations.size()));
+		for (const CompressedAnimationClip& clip : data.compressedAnimations)
+			clip.Write(writer);
+		endSection(kCompressedAnimations);
+
+		beginSection(kMeshlets);
+		writer.WriteBytes(data.meshlets.data(), data.meshlets.size() * sizeof(Meshlet));
+		endSection(kMeshlets);
+
+		beginSection(kMeshletBounds);
+		writer.WriteBytes(data.meshletBounds.data(), data.meshletBounds.size() * sizeof(MeshletBounds));
+		endSection(kMeshletBounds);
+
+		beginSection(kBounds);
+		writer.Write(data.boundingBox);
+		writer.Write(data.boundingSphere);
+		endSection(kBounds);
+
+		std::memcpy(buffer.data(), &header, sizeof(header));
+
+		// 一時ファイルに書いてから置き換え、書きかけのファイルを読まないようにする
+		const std::wstring tempPath = cookedPath + L".tmp";
+		bool saved = false;
+		{
+			std::ofstream file(std::filesystem::path(tempPath), std::ios::out | std::ios::binary | std::ios::trunc);
+			if (file)
+			{
+				file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+				saved = file.good();
+			}
+		}
+		std::error_code error;
+		if (saved)
+			std::filesystem::rename(tempPath, cookedPath, error);
+		if (!saved || error)
+		{
+			std::filesystem::remove(tempPath, error);
+			Log(L"Failed to save cooked model: %ls", cookedPath.c_str());
+		}
+
+		mMemory = std::move(buffer);
+		return Attach(mMemory.data(), mMemory.size());
+	}
+
+	void CookedModel::Close()
+	{
+		mFile.Close();
+		mMemory.clear();
+		mMemory.shrink_to_fit();
+		mData = nullptr;
+		mSize = 0;
+	}
+
+	bool CookedModel::Attach(const uint8_t* data, size_t size)
+	{
+		if (size < sizeof(FileHeader))
+			return false;
+
+		const FileHeader& header = GetHeader(data);
+		if (header.magic != kMagic || header.version != kVersion ||
+			header.layout != kLayout || header.sectionCount != kSectionCount)
+			return false;
+
+		for (const SectionEntry& section : header.sections)
+		{
+			if (section.offset > size || section.size > size - section.offset)
+				return false;
+		}
+
+		const uint64_t vertexCount = header.vertexCount;
+		const uint64_t skinSize = header.sections[kSkin].size;
+		if (header.sections[kPositions].size != vertexCount * sizeof(PositionVertex) ||
+			header.sections[kAttributes].size != vertexCount * sizeof(AttributeVertex) ||
+			(skinSize != 0 && skinSize != vertexCount * sizeof(JointVertex)) ||
+			header.sections[kIndices].size != header.indexDataSize ||
+			header.indexDataSize % sizeof(uint32_t) != 0)
+			return false;
+
+		mData = data;
+		mSize = size;
+		return true;
+	}
+
+	const PositionVertex* CookedModel::GetPositionData() const
+	{
+		return reinterpret_cast<const PositionVertex*>(mData + GetHeader(mData).sections[kPositions].offset);
+	}
+
+	const AttributeVertex* CookedModel::GetAttributeData() const
+	{
+		return reinterpret_cast<const AttributeVertex*>(mData + GetHeader(mData).sections[kAttributes].offset);
+	}
+
+	const JointVertex* CookedModel::GetSkinData() const
+	{
+		const SectionEntry& section = GetHeader(mData).sections[kSkin];
+		return section.size > 0 ? reinterpret_cast<const JointVertex*>(mData + section.offset) : nullptr;
+	}
+
+	uint32_t CookedModel::GetVertexCount() const
+	{
+		return GetHeader(mData).vertexCount;
+	}
+
+	const uint8_t* CookedModel::GetIndexData() const
+	{
+		return mData + GetHeader(mData).sections[kIndices].offset;
+	}
+
+	uint32_t CookedModel::GetIndexDataSize() const
+	{
+		return GetHeader(mData).indexDataSize;
+	}
+
+	bool CookedModel::ReadModel(Model& model) const
+	{
+		if (!mData)
+			return false;
+
+		const FileHeader& header = GetHeader(mData);
+		auto openSection = [&](Section section)
+			{
+				return BinaryReader(mData + header.sections[section].offset, static_cast<size_t>(header.sections[section].size));
+			};
+
+		bool succeeded = true;
+		uint32_t count = 0;
+
+		BinaryReader meshes = openSection(kMeshes);
+		if (meshes.ReadCount(count))
+		{
+			model.mMeshData.resize(count);
+			for (Mesh& mesh : model.mMeshData)
+				ReadMesh(meshes, mesh);
+		}
+		succeeded = succeeded && !meshes.IsFailed();
+
+		succeeded = succeeded && ReadRawArray(mData, header.sections[kMeshlets], model.mMeshlets);
+		succeeded = succeeded && ReadRawArray(mData, header.sections[kMeshletBounds], model.mMeshletBounds);
+		succeeded = succeeded && model.mMeshlets.size() == model.mMeshletBounds.size();
+
+		// 描画時にインデックスバッファの外を読まないよう、各サブメッシュ（全てのLOD）とメッシュレットの範囲を確かめる
+		for (const Mesh& mesh : model.mMeshData)
+		{
+			for (const SubMesh& subMesh : mesh.subMeshes)
+			{
+				if ((subMesh.indexSize != sizeof(uint16_t) && subMesh.indexSize != sizeof(uint32_t)) ||
+					subMesh.lodCount == 0 || subMesh.lodCount > kMaxMeshLods)
+				{
+					succeeded = false;
+					continue;
+				}
+				for (uint32_t lod = 0; lod < subMesh.lodCount; ++lod)
+				{
+					const MeshLod range = subMesh.GetLod(lod);
+					const uint64_t indexEnd = range.indexByteOffset + static_cast<uint64_t>(range.indexCount) * subMesh.indexSize;
+					if (range.indexByteOffset % sizeof(uint32_t) != 0 || indexEnd > header.indexDataSize)
+						succeeded = false;
+				}
+
+				if (static_cast<uint64_t>(subMesh.meshletOffset) + subMesh.meshletCount > model.mMeshlets.size())
+				{
+					succeeded = false;
+					continue;
+				}
+				for (uint32_t m = 0; m < subMesh.meshletCount; ++m)
+				{
+					const Meshlet& meshlet = model.mMeshlets[subMesh.meshletOffset + m];
+					if ((static_cast<uint64_t>(meshlet.triangleOffset) + meshlet.triangleCount) * 3 > subMesh.indexCount)
+						succeeded = false;
+				}
+			}
+		}
+
+		succeeded = succeeded && ReadRawArray(mData, header.sections[kSceneGraph], model.mSceneGraph);
+
+		// 定数バッファはノードごとに1つなので、各ノードの書き込み先がノード数に収まっているか確かめる
+		for (const GraphNode& node : model.mSceneGraph)
+		{
+			if (node.matrixIdx >= model.mSceneGraph.size())
+				succeeded = false;
+		}
+
+		BinaryReader materials = openSection(kMaterials);
+		if (materials.ReadCount(count))
+		{
+			model.mMaterials.resize(count);
+			for (Material& material : model.mMaterials)
+				ReadMaterial(materials, material);
+		}
+		succeeded = succeeded && !materials.IsFailed();
+
+		BinaryReader skeleton = openSection(kSkeleton);
+		ReadSkeleton(skeleton, model.mSkeleton);
+		succeeded = succeeded && !skeleton.IsFailed();
+		model.mNumJoints = static_cast<uint32_t>(model.mSkeleton.joints.size());
+
+		// ポーズの計算は親を先に処理する前提でジョイントを先頭から順に辿るので、親は自身より前にあること
+		for (uint32_t i = 0; i < model.mNumJoints; ++i)
+		{
+			const Joint& joint = model.mSkeleton.joints[i];
+			if (joint.parent && (*joint.parent < 0 || static_cast<uint32_t>(*joint.parent) >= i))
+				succeeded = false;
+			for (int32_t child : joint.children)
+			{
+				if (child <= static_cast<int32_t>(i) || static_cast<uint32_t>(child) >= model.mNumJoints)
+					succeeded = false;
+			}
+		}
+
+		succeeded = succeeded && ReadRawArray(mData, header.sections[kJointIBMs], model.mJointIBMs);
+		succeeded = succeeded && model.mJointIBMs.size() == model.mNumJoints;
+
+		// スキンのパレットはジョイント0からnumJoints個を送るので、スケルトンに収まっているか確かめる
+		for (const Mesh& mesh : model.mMeshData)
+		{
+			if (static_cast<uint64_t>(mesh.startJoint) + mesh.numJoints > model.mNumJoints)
+				succeeded = false;
+		}
+
+		BinaryReader animations = openSection(kAnimations);
+		if (animations.ReadCount(count))
+		{
+			model.mAnimationData.resize(count);
+			for (AnimationClip& clip : model.mAnimationData)
+				ReadClip(animations, clip);
+		}
+		succeeded = succeeded && !animations.IsFailed();
+
+		BinaryReader compressed = openSection(kCompressedAnimations);
+		if (compressed.ReadCount(count))
+		{
+			model.mCompressedAnimations.resize(count);
+			for (CompressedAnimationClip& clip : model.mCompressedAnimations)
+				succeeded = clip.Read(compressed) && succeeded;
+		}
+		succeeded = succeeded && !compressed.IsFailed();
+
+		BinaryReader bounds = openSection(kBounds);
+		bounds.Read(model.mBoundingBox);
+		bounds.Read(model.mBoundingSphere);
+		succeeded = succeeded && !bounds.IsFailed();
+
+		return succeeded;
+	}
+}
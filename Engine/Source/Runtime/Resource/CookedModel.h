@@ -0,0 +1,132 @@
+/**
+ * @file CookedModel.h
+ * @brief インポート済みモデルのバイナリキャッシュ
+ *
+ * assimpでのインポートと後処理（頂点とスキンの結合、スケルトン、アニメーションの圧縮）の結果を
+ * ソースファイルの隣に保存し、次回からはそれをメモリマップして読む。
+ * - 頂点（VertexCompressionで圧縮した位置・属性・スキンのストリーム）とインデックスは
+ *   GPUに送る形のまま格納し、解析せずにアップロードする。インデックスは頂点が65536個以下の
+ *   サブメッシュでは16bitにする（LODのインデックスも同じ幅で、LOD0の後ろに続ける）
+ * - メッシュ、シーングラフ、マテリアル、スケルトン、クリップなどの小さなデータだけを読み出す
+ * - ソースのサイズと更新時刻が記録と同じなら内容は読まない。違う場合はソースのハッシュを比べ、
+ *   内容が同じなら作り直さずに記録を更新する
+ * フォーマットやデータ構造を変えたらkVersionを上げること（古いキャッシュは作り直される）。
+ */
+
+#pragma once
+#include "Runtime/Core/Utility/MappedFile.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AtomEngine
+{
+	struct ModelData;
+	struct PositionVertex;
+	struct AttributeVertex;
+	struct JointVertex;
+	class Model;
+
+	/**
+	 * @struct CookedSourceInfo
+	 * @brief キャッシュの元になったソースファイルの情報
+	 */
+	struct CookedSourceInfo
+	{
+		uint64_t size = 0;
+		int64_t writeTime = 0;
+		uint64_t hash = 0;      ///< 内容のハッシュ（HashBytes64）
+
+		/**
+		 * @brief サイズと更新時刻を取得する（ハッシュは求めない）
+		 * @return ファイルが存在すればtrue
+		 */
+		static bool Query(const std::wstring& filePath, CookedSourceInfo& info);
+
+		/**
+		 * @brief ファイルの内容のハッシュを求める
+		 * @return 読めればtrue
+		 */
+		static bool ComputeHash(const std::wstring& filePath, uint64_t& hash);
+	};
+
+	/**
+	 * @class CookedModel
+	 * @brief キャッシュファイルの読み書き
+	 *
+	 * 使用例:
+	 * @code
+	 * CookedModel cooked;
+	 * if (!cooked.Open(cookedPath, sourcePath))
+	 * {
+	 *     ModelData data;
+	 *     ModelLoader::LoadModel(data, sourcePath);
+	 *     cooked.Cook(data, sourcePath, cookedPath);
+	 * }
+	 * Upload(cooked.GetPositionData(), cooked.GetVertexCount() * sizeof(PositionVertex));
+	 * cooked.ReadModel(model);
+	 * @endcode
+	 */
+	class CookedModel
+	{
+	public:
+		static constexpr uint32_t kMagic = 0x4C444D41;    ///< "AMDL"
+		static constexpr uint32_t kVersion = 8;
+
+		/// ソースファイルに対応するキャッシュファイルのパス（拡張子を.amdlにする）
+		static std::wstring GetCookedPath(const std::wstring& sourcePath);
+
+		/**
+		 * @brief キャッシュファイルを開く
+		 *
+		 * ソースが存在しない場合はキャッシュだけで開く（キャッシュのみを配布する場合）。
+		 * @param cookedPath キャッシュファイル
+		 * @param sourcePath ソースファイル
+		 * @return キャッシュが有効ならtrue（古い・壊れている場合はfalse）
+		 */
+		bool Open(const std::wstring& cookedPath, const std::wstring& sourcePath);
+
+		/**
+		 * @brief インポート結果からキャッシュを作って保存する
+		 *
+		 * 保存に失敗しても作ったデータで開いた状態になる（次回は再インポートになる）。
+		 * 頂点の圧縮誤差が許容値（VertexCompressionSettings）を超えた場合は作らずに失敗する。
+		 * @param data インポート結果
+		 * @param sourcePath ソースファイル
+		 * @param cookedPath 保存先
+		 * @return データを作れたらtrue
+		 */
+		bool Cook(const ModelData& data, const std::wstring& sourcePath, const std::wstring& cookedPath);
+
+		void Close();
+
+		bool IsOpen() const { return mData != nullptr; }
+
+		/// 位置ストリーム（復元用の値は各サブメッシュのpositionDequantization）
+		const PositionVertex* GetPositionData() const;
+		/// 属性ストリーム（UV・法線・接線）
+		const AttributeVertex* GetAttributeData() const;
+		/// スキンストリーム（スキンなしのモデルはnullptr）
+		const JointVertex* GetSkinData() const;
+		uint32_t GetVertexCount() const;
+
+		/// インデックス（サブメッシュのLODごとにindexByteOffsetから、indexSizeの幅で並ぶ）
+		const uint8_t* GetIndexData() const;
+		uint32_t GetIndexDataSize() const;
+
+		/**
+		 * @brief メッシュ、メッシュレット、シーングラフ、マテリアル、スケルトン、逆バインド行列、クリップ、境界を読み出す
+		 * @return データが壊れていればfalse
+		 */
+		bool ReadModel(Model& model) const;
+
+	private:
+		bool Attach(const uint8_t* data, size_t size);
+
+		MappedFile mFile;
+		std::vector<uint8_t> mMemory;   ///< 保存できなかった場合のデータ
+		const uint8_t* mData = nullptr;
+		size_t mSize = 0;
+	};
+}
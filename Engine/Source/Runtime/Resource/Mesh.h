@@ -1,9 +1,11 @@
 #pragma once
 #include "Runtime/Core/Math/MathInclude.h"
 #include "Runtime/Core/Math/BoundingBox.h"
+#include "Runtime/Core/Math/BoundingSphere.h"
 
 namespace AtomEngine
 {
+	/// インポート時の頂点（全て32bit浮動小数点）。GPUへはVertexCompressionで圧縮したストリームを送る
 	struct Vertex
 	{
 		Vector3 position;
@@ -13,6 +15,40 @@ namespace AtomEngine
 		Vector3 bitangent;
 	};
 
+	/// 頂点バッファのスロット。深度・シャドウパスは位置（とスキン）だけを読む
+	enum VertexStream : uint32_t
+	{
+		kPositionStream,
+		kAttributeStream,
+		kSkinStream,        ///< スキンありのモデルだけ
+		kNumVertexStreams
+	};
+
+	/// 位置ストリーム（R16G16B16A16_UNORM）。サブメッシュの範囲に対する16bit正規化で、wは常に1
+	struct PositionVertex
+	{
+		uint16_t position[4];
+	};
+
+	/// 属性ストリーム
+	struct AttributeVertex
+	{
+		uint16_t texcoord[2];   ///< R16G16_FLOAT
+		int16_t normal[2];      ///< R16G16_SNORM。八面体符号化
+		uint32_t tangent;       ///< R10G10B10A2_UNORM。xyが八面体符号化、aが利き手（3なら+1、0なら-1）
+	};
+
+	/**
+	 * @brief 位置ストリームの復元に使う値（position = 量子化値 * scale + offset）
+	 *
+	 * シェーダーのルート定数と同じ並び。w成分は常に1になるようにしてある。
+	 */
+	struct PositionDequantization
+	{
+		float scale[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+		float offset[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	};
+
 	enum PSOFlags : uint16_t
 	{
 		kHasSkin		= 1 << 0,
@@ -20,10 +56,26 @@ namespace AtomEngine
 		kAlphaBlend		= 1 << 2,
 	};
 
+	/// サブメッシュのLODの数の上限（LOD0を含む）
+	constexpr uint32_t kMaxMeshLods = 4;
+
+	/// 簡略化したLOD。頂点はLOD0と共有し、インデックスだけを持つ
+	struct MeshLod
+	{
+		uint32_t indexOffset = 0;       ///< ModelData::indicesでの位置
+		uint32_t indexCount = 0;
+		uint32_t indexByteOffset = 0;   ///< インデックスバッファでの位置（バイト）
+		float error = 0.0f;             ///< LOD0からの形の誤差（ローカル空間の距離）
+	};
+
 	struct SubMesh
 	{
-		uint32_t indexOffset = 0;
+		uint32_t indexOffset = 0;       ///< ModelData::indicesでの位置
 		uint32_t indexCount = 0;
+		uint32_t indexByteOffset = 0;   ///< インデックスバッファでの位置（バイト）
+		uint32_t indexSize = sizeof(uint32_t);  ///< 2ならR16_UINT、4ならR32_UINT
+		uint32_t meshletOffset = 0;     ///< モデルのメッシュレットの配列での位置
+		uint32_t meshletCount = 0;
 		uint32_t vertexOffset = 0;
 		uint32_t vertexCount = 0;
 
@@ -31,6 +83,30 @@ namespace AtomEngine
 		uint32_t materialIndex = 0;
 		uint32_t srvTableIndex = 0;
 		AxisAlignedBox bounds;
+		BoundingSphere sphere;          ///< ローカル空間の境界球（描画順の距離に使う）
+		PositionDequantization positionDequantization;
+
+		uint32_t lodCount = 1;          ///< LOD0を含む
+		MeshLod lods[kMaxMeshLods - 1]; ///< LOD1以降（インデックスのサイズはLOD0と同じ）
+
+		/// LODのインデックスの範囲（0ならLOD0）
+		MeshLod GetLod(uint32_t lod) const
+		{
+			return lod == 0 ? MeshLod{ indexOffset, indexCount, indexByteOffset, 0.0f } : lods[lod - 1];
+		}
+
+		/**
+		 * @brief 画面上の誤差がmaxPixelError以下の最も粗いLODを選ぶ
+		 * @param pixelsPerUnit ローカル空間の長さ1が画面上で何ピクセルになるか
+		 * @param maxPixelError 許容する誤差（ピクセル）
+		 */
+		uint32_t SelectLod(float pixelsPerUnit, float maxPixelError) const
+		{
+			uint32_t lod = 0;
+			while (lod + 1 < lodCount && lods[lod].error * pixelsPerUnit <= maxPixelError)
+				++lod;
+			return lod;
+		}
 	};
 
 	struct Mesh
@@ -0,0 +1,334 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		constexpr uint32_t kInvalidVertex = ~0u;
+
+		/**
+		 * @brief FIFOキャッシュのシミュレーション
+		 *
+		 * 頂点ごとに入った時刻を持ち、その後のミスがcacheSize回未満ならキャッシュにあるとみなす。
+		 * 時刻をcacheSize + 1進めるとキャッシュを空にしたのと同じになる。
+		 */
+		struct CacheSimulator
+		{
+			std::vector<uint32_t> timestamps;
+			uint32_t time;
+			uint32_t cacheSize;
+
+			CacheSimulator(uint32_t vertexCount, uint32_t size)
+				: timestamps(vertexCount, 0), time(size + 1), cacheSize(size) {}
+
+			bool IsCached(uint32_t vertex) const { return time - timestamps[vertex] <= cacheSize; }
+
+			/// @return ミスならtrue
+			bool Access(uint32_t vertex)
+			{
+				if (IsCached(vertex))
+					return false;
+				timestamps[vertex] = time++;
+				return true;
+			}
+
+			uint32_t AccessTriangle(const uint32_t* triangle)
+			{
+				return Access(triangle[0]) + Access(triangle[1]) + Access(triangle[2]);
+			}
+
+			void Flush() { time += cacheSize + 1; }
+		};
+
+		/**
+		 * @brief Tipsifyで次に扇を作る頂点が見つからないとき、まだ三角形が残っている頂点を探す
+		 *
+		 * 最近出力した頂点（キャッシュに残っている可能性が高い）から順に探し、無ければ番号順に探す。
+		 */
+		uint32_t FindDeadEndVertex(std::vector<uint32_t>& deadEnd, uint32_t& cursor, const std::vector<uint32_t>& liveTriangles)
+		{
+			while (!deadEnd.empty())
+			{
+				const uint32_t vertex = deadEnd.back();
+				deadEnd.pop_back();
+				if (liveTriangles[vertex] > 0)
+					return vertex;
+			}
+
+			const uint32_t vertexCount = static_cast<uint32_t>(liveTriangles.size());
+			for (; cursor < vertexCount; ++cursor)
+			{
+				if (liveTriangles[cursor] > 0)
+					return cursor;
+			}
+			return kInvalidVertex;
+		}
+
+		/**
+		 * @brief クラスタをACMRがあまり悪くならない範囲で細かく分ける
+		 *
+		 * 各クラスタの先頭からキャッシュを空にしてシミュレーションし、
+		 * そこまでのACMRがクラスタ全体のACMRのthreshold倍以下になったら区切る。
+		 */
+		std::vector<uint32_t> SplitClusters(const uint32_t* indices, size_t triangleCount, uint32_t vertexCount,
+			const std::vector<uint32_t>& clusters, float threshold, uint32_t cacheSize)
+		{
+			std::vector<uint32_t> result;
+			result.reserve(clusters.size());
+			CacheSimulator cache(vertexCount, cacheSize);
+
+			for (size_t c = 0; c < clusters.size(); ++c)
+			{
+				const uint32_t start = clusters[c];
+				const uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : static_cast<uint32_t>(triangleCount);
+				if (start >= end)
+					continue;
+
+				cache.Flush();
+				uint32_t clusterMisses = 0;
+				for (uint32_t t = start; t < end; ++t)
+					clusterMisses += cache.AccessTriangle(indices + t * 3);
+				const float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+				result.push_back(start);
+				cache.Flush();
+				uint32_t misses = 0;
+				uint32_t triangles = 0;
+				for (uint32_t t = start; t + 1 < end; ++t)
+				{
+					misses += cache.AccessTriangle(indices + t * 3);
+					++triangles;
+					if (static_cast<float>(misses) <= clusterThreshold * static_cast<float>(triangles))
+					{
+						result.push_back(t + 1);
+						cache.Flush();
+						misses = 0;
+						triangles = 0;
+					}
+				}
+			}
+			return result;
+		}
+	}
+
+	void MeshOptimizer::Optimize(uint32_t* indices, size_t indexCount, Vertex* vertices, uint32_t vertexCount,
+		std::vector<uint32_t>& remap, VertexCacheStatistics* before, VertexCacheStatistics* after)
+	{
+		if (before)
+			*before = AnalyzeVertexCache(indices, indexCount, vertexCount);
+
+		std::vector<uint32_t> clusters;
+		OptimizeVertexCache(indices, indexCount, vertexCount, &clusters);
+		OptimizeOverdraw(indices, indexCount, vertices, vertexCount, clusters);
+		OptimizeVertexFetch(indices, indexCount, vertices, vertexCount, remap);
+
+		if (after)
+			*after = AnalyzeVertexCache(indices, indexCount, vertexCount);
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(uint32_t* indices, size_t indexCount, uint32_t vertexCount,
+		std::vector<uint32_t>* clusters, uint32_t cacheSize)
+	{
+		if (clusters)
+			clusters->clear();
+
+		const size_t triangleCount = indexCount / 3;
+		if (triangleCount == 0)
+			return;
+
+		// 頂点ごとに、その頂点を使う三角形の一覧を作る
+		std::vector<uint32_t> liveTriangles(vertexCount, 0);
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+			++liveTriangles[indices[i]];
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		std::partial_sum(liveTriangles.begin(), liveTriangles.end(), adjacencyOffsets.begin() + 1);
+
+		std::vector<uint32_t> adjacency(triangleCount * 3);
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < triangleCount * 3; ++i)
+				adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		const std::vector<uint32_t> source(indices, indices + triangleCount * 3);
+		std::vector<uint8_t> emitted(triangleCount, 0);
+		std::vector<uint32_t> deadEnd;
+		std::vector<uint32_t> candidates;
+		deadEnd.reserve(triangleCount * 3);
+		CacheSimulator cache(vertexCount, cacheSize);
+
+		size_t written = 0;
+		uint32_t cursor = 0;
+		uint32_t current = FindDeadEndVertex(deadEnd, cursor, liveTriangles);
+		if (clusters)
+			clusters->push_back(0);
+
+		while (current != kInvalidVertex)
+		{
+			// 現在の頂点を囲む三角形（扇）を全て出力する
+			candidates.clear();
+			for (uint32_t a = adjacencyOffsets[current]; a < adjacencyOffsets[current + 1]; ++a)
+			{
+				const uint32_t triangle = adjacency[a];
+				if (emitted[triangle])
+					continue;
+				emitted[triangle] = 1;
+
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					const uint32_t vertex = source[triangle * 3 + k];
+					indices[written++] = vertex;
+					deadEnd.push_back(vertex);
+					candidates.push_back(vertex);
+					--liveTriangles[vertex];
+					cache.Access(vertex);
+				}
+			}
+
+			// 残りの三角形を全て出力してもキャッシュから追い出されない頂点のうち、最も古いものを選ぶ
+			uint32_t next = kInvalidVertex;
+			int64_t bestPriority = -1;
+			for (uint32_t vertex : candidates)
+			{
+				if (liveTriangles[vertex] == 0)
+					continue;
+
+				int64_t priority = 0;
+				const uint32_t age = cache.time - cache.timestamps[vertex];
+				if (static_cast<uint64_t>(age) + 2ull * liveTriangles[vertex] <= cacheSize)
+					priority = age;
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					next = vertex;
+				}
+			}
+
+			// 周りに続けられる頂点が無ければ別の場所へ移るので、そこでクラスタを区切る
+			if (next == kInvalidVertex)
+			{
+				next = FindDeadEndVertex(deadEnd, cursor, liveTriangles);
+				if (clusters && next != kInvalidVertex)
+					clusters->push_back(static_cast<uint32_t>(written / 3));
+			}
+			current = next;
+		}
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(uint32_t* indices, size_t indexCount, const Vertex* vertices, uint32_t vertexCount,
+		const std::vector<uint32_t>& clusters, float threshold, uint32_t cacheSize)
+	{
+		const size_t triangleCount = indexCount / 3;
+		if (triangleCount == 0 || clusters.empty())
+			return;
+
+		const std::vector<uint32_t> split = SplitClusters(indices, triangleCount, vertexCount, clusters, threshold, cacheSize);
+		if (split.size() <= 1)
+			return;
+
+		// メッシュの中心
+		Vector3 meshCenter(0.0f, 0.0f, 0.0f);
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+			meshCenter += vertices[indices[i]].position;
+		meshCenter = meshCenter * (1.0f / static_cast<float>(triangleCount * 3));
+
+		// クラスタの面積で重み付けした中心と法線から、中心から外を向いている度合いを求める
+		std::vector<float> outward(split.size());
+		for (size_t c = 0; c < split.size(); ++c)
+		{
+			const uint32_t start = split[c];
+			const uint32_t end = c + 1 < split.size() ? split[c + 1] : static_cast<uint32_t>(triangleCount);
+
+			Vector3 center(0.0f, 0.0f, 0.0f);
+			Vector3 normal(0.0f, 0.0f, 0.0f);
+			float area = 0.0f;
+			for (uint32_t t = start; t < end; ++t)
+			{
+				const Vertex& v0 = vertices[indices[t * 3 + 0]];
+				const Vertex& v1 = vertices[indices[t * 3 + 1]];
+				const Vertex& v2 = vertices[indices[t * 3 + 2]];
+
+				// 巻き方向の規約に依らないよう、向きは頂点法線から取る
+				const float triangleArea = Math::Cross(v1.position - v0.position, v2.position - v0.position).Length() * 0.5f;
+				center += (v0.position + v1.position + v2.position) * (triangleArea / 3.0f);
+				normal += (v0.normal + v1.normal + v2.normal) * triangleArea;
+				area += triangleArea;
+			}
+
+			const float normalLength = normal.Length();
+			if (area <= 0.0f || normalLength <= 0.0f)
+			{
+				outward[c] = 0.0f;
+				continue;
+			}
+			center = center * (1.0f / area);
+			outward[c] = Math::Dot(center - meshCenter, normal) / normalLength;
+		}
+
+		// 外を向いているクラスタほど手前の面を覆うので先に描く。同じ値なら元の順
+		std::vector<uint32_t> order(split.size());
+		std::iota(order.begin(), order.end(), 0u);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return outward[a] > outward[b]; });
+
+		const std::vector<uint32_t> source(indices, indices + triangleCount * 3);
+		size_t written = 0;
+		for (uint32_t c : order)
+		{
+			const uint32_t start = split[c];
+			const uint32_t end = c + 1 < split.size() ? split[c + 1] : static_cast<uint32_t>(triangleCount);
+			std::copy(source.begin() + start * 3, source.begin() + end * 3, indices + written);
+			written += (end - start) * 3;
+		}
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(uint32_t* indices, size_t indexCount, Vertex* vertices, uint32_t vertexCount,
+		std::vector<uint32_t>& remap)
+	{
+		remap.assign(vertexCount, kInvalidVertex);
+
+		uint32_t next = 0;
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			uint32_t& target = remap[indices[i]];
+			if (target == kInvalidVertex)
+				target = next++;
+			indices[i] = target;
+		}
+
+		// 使われない頂点は末尾に元の順で残す
+		for (uint32_t& target : remap)
+		{
+			if (target == kInvalidVertex)
+				target = next++;
+		}
+
+		const std::vector<Vertex> source(vertices, vertices + vertexCount);
+		for (uint32_t v = 0; v < vertexCount; ++v)
+			vertices[remap[v]] = source[v];
+	}
+
+	VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, uint32_t vertexCount,
+		uint32_t cacheSize)
+	{
+		VertexCacheStatistics statistics;
+		statistics.triangleCount = indexCount / 3;
+
+		CacheSimulator cache(vertexCount, cacheSize);
+		std::vector<uint8_t> referenced(vertexCount, 0);
+		for (size_t i = 0; i < statistics.triangleCount * 3; ++i)
+		{
+			const uint32_t vertex = indices[i];
+			statistics.transformCount += cache.Access(vertex);
+			if (!referenced[vertex])
+			{
+				referenced[vertex] = 1;
+				++statistics.vertexCount;
+			}
+		}
+		return statistics;
+	}
+}
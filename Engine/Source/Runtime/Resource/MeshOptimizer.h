@@ -0,0 +1,101 @@
+/**
+ * @file MeshOptimizer.h
+ * @brief インポート時の三角形と頂点の並べ替え
+ *
+ * サブメッシュごとに次の順で並べ替える。結果は入力だけで決まる（スレッド数や実行ごとに変わらない）。
+ * 1. 頂点キャッシュ: Tipsify（Sander et al. 2007）で、変換後の頂点を再利用しやすい三角形の順にする
+ * 2. オーバードロー: Tipsifyの区切りで分けたクラスタを、外側を向いたものが先に描かれるよう並べる
+ *    （クラスタの中の順は変えないので、頂点キャッシュの効率はほとんど落ちない）
+ * 3. 頂点フェッチ: 頂点をインデックスで最初に使われる順に並べ替える
+ * 効果はFIFOキャッシュのシミュレーションで求めたACMR・ATVRで確認する。
+ */
+
+#pragma once
+#include "Mesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AtomEngine
+{
+	/**
+	 * @struct VertexCacheStatistics
+	 * @brief 頂点キャッシュのシミュレーション結果
+	 *
+	 * 複数のサブメッシュの結果は足し合わせてモデル全体の値にできる。
+	 */
+	struct VertexCacheStatistics
+	{
+		uint64_t triangleCount = 0;
+		uint64_t vertexCount = 0;       ///< インデックスから参照される頂点の数
+		uint64_t transformCount = 0;    ///< キャッシュに無く、頂点シェーダーを実行した回数
+
+		/// 三角形あたりの頂点シェーダーの実行回数（0.5に近いほど良い、最悪は3）
+		float GetACMR() const { return triangleCount > 0 ? static_cast<float>(transformCount) / static_cast<float>(triangleCount) : 0.0f; }
+		/// 頂点あたりの頂点シェーダーの実行回数（1が最良）
+		float GetATVR() const { return vertexCount > 0 ? static_cast<float>(transformCount) / static_cast<float>(vertexCount) : 0.0f; }
+
+		VertexCacheStatistics& operator+=(const VertexCacheStatistics& other)
+		{
+			triangleCount += other.triangleCount;
+			vertexCount += other.vertexCount;
+			transformCount += other.transformCount;
+			return *this;
+		}
+	};
+
+	/**
+	 * @class MeshOptimizer
+	 * @brief 三角形リストの並べ替え
+	 *
+	 * インデックスはサブメッシュの頂点範囲の先頭からの番号で、全てvertexCount未満であること。
+	 */
+	class MeshOptimizer
+	{
+	public:
+		static constexpr uint32_t kCacheSize = 16;              ///< シミュレーションと最適化で想定するFIFOキャッシュの大きさ
+		static constexpr float kOverdrawThreshold = 1.05f;      ///< クラスタを細かくするときに許すACMRの悪化の割合
+
+		/**
+		 * @brief サブメッシュの三角形と頂点を並べ替える
+		 *
+		 * 頂点の数は変えない（使われない頂点は末尾に移す）。
+		 * @param indices インデックス（書き換える）
+		 * @param indexCount インデックスの数（3の倍数）
+		 * @param vertices サブメッシュの頂点（書き換える）
+		 * @param vertexCount 頂点の数
+		 * @param remap 元の頂点番号から新しい番号への対応（スキンのウェイトなど頂点を参照するデータの付け替えに使う）
+		 * @param before 並べ替える前のシミュレーション結果（不要ならnullptr）
+		 * @param after 並べ替えた後のシミュレーション結果（不要ならnullptr）
+		 */
+		static void Optimize(uint32_t* indices, size_t indexCount, Vertex* vertices, uint32_t vertexCount,
+			std::vector<uint32_t>& remap, VertexCacheStatistics* before = nullptr, VertexCacheStatistics* after = nullptr);
+
+		/**
+		 * @brief 頂点キャッシュの効率が良くなるよう三角形を並べ替える（Tipsify）
+		 * @param clusters 各クラスタの先頭の三角形の番号（キャッシュが途切れる位置。不要ならnullptr）
+		 */
+		static void OptimizeVertexCache(uint32_t* indices, size_t indexCount, uint32_t vertexCount,
+			std::vector<uint32_t>* clusters = nullptr, uint32_t cacheSize = kCacheSize);
+
+		/**
+		 * @brief OptimizeVertexCacheで並べた三角形を、外側を向いたクラスタから描かれるよう並べ替える
+		 * @param clusters OptimizeVertexCacheが返したクラスタ
+		 * @param threshold クラスタを細かく分けるときに許すACMRの悪化の割合
+		 */
+		static void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const Vertex* vertices, uint32_t vertexCount,
+			const std::vector<uint32_t>& clusters, float threshold = kOverdrawThreshold, uint32_t cacheSize = kCacheSize);
+
+		/**
+		 * @brief 頂点をインデックスで最初に使われる順に並べ替え、インデックスを付け替える
+		 * @param remap 元の頂点番号から新しい番号への対応
+		 */
+		static void OptimizeVertexFetch(uint32_t* indices, size_t indexCount, Vertex* vertices, uint32_t vertexCount,
+			std::vector<uint32_t>& remap);
+
+		/// FIFOキャッシュで頂点シェーダーの実行回数を数える
+		static VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, uint32_t vertexCount,
+			uint32_t cacheSize = kCacheSize);
+	};
+}
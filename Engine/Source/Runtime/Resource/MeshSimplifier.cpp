@@ -0,0 +1,627 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		constexpr uint32_t kInvalid = ~0u;
+
+		/// 属性の成分数（法線3 + UV2）
+		constexpr uint32_t kAttributeCount = 5;
+
+		/// 開いた境界を動かす場合に、境界に垂直な平面へ掛ける重み（辺の長さの二乗に対する倍率）
+		constexpr float kBorderWeight = 10.0f;
+
+		/// 縮約で三角形の法線がこれ以上傾く（余弦がこれ以下になる）場合は、裏返りとみなして行わない
+		constexpr float kMinFlipCos = 0.25f;
+
+		/**
+		 * @brief 位置が同じ頂点の組の種類
+		 *
+		 * kManifold: 属性の継ぎ目も境界もない。どの隣の頂点へも寄せられる
+		 * kBorder: 開いた境界上（頂点は1つ）。境界に沿ってだけ寄せられる
+		 * kSeam: 属性の継ぎ目上（頂点が2つで、継ぎ目の両側が対応している）。継ぎ目に沿って両方を一緒に寄せる
+		 * kLocked: それ以外（角、3つ以上の継ぎ目の交点など）。動かさない
+		 */
+		enum VertexKind : uint8_t
+		{
+			kManifold,
+			kBorder,
+			kSeam,
+			kLocked,
+		};
+
+		/// 平面からの距離の二乗の和（重みの和で割ると平均になる）
+		struct Quadric
+		{
+			double a00 = 0, a11 = 0, a22 = 0, a01 = 0, a02 = 0, a12 = 0;
+			double b0 = 0, b1 = 0, b2 = 0;
+			double c = 0;
+			double weight = 0;
+
+			void AddPlane(const Vector3& normal, float distance, float w)
+			{
+				const double nx = normal.x, ny = normal.y, nz = normal.z, d = distance;
+				a00 += w * nx * nx; a11 += w * ny * ny; a22 += w * nz * nz;
+				a01 += w * nx * ny; a02 += w * nx * nz; a12 += w * ny * nz;
+				b0 += w * nx * d; b1 += w * ny * d; b2 += w * nz * d;
+				c += w * d * d;
+				weight += w;
+			}
+
+			void operator+=(const Quadric& q)
+			{
+				a00 += q.a00; a11 += q.a11; a22 += q.a22; a01 += q.a01; a02 += q.a02; a12 += q.a12;
+				b0 += q.b0; b1 += q.b1; b2 += q.b2;
+				c += q.c;
+				weight += q.weight;
+			}
+
+			/// Σw(n・p + d)^2（重みの和で割らない）
+			double Evaluate(const Vector3& p) const
+			{
+				const double x = p.x, y = p.y, z = p.z;
+				return a00 * x * x + a11 * y * y + a22 * z * z
+					+ 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+					+ 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+			}
+
+			double Error(const Vector3& p) const
+			{
+				return weight > 0.0 ? std::max(Evaluate(p), 0.0) / weight : 0.0;
+			}
+		};
+
+		/**
+		 * @brief 属性の誤差（Hoppe 1999）
+		 *
+		 * 三角形の中で属性が線形に変わるとして、その一次関数 g・p + d と、寄せた先の頂点の属性aとの差の二乗を積む。
+		 * 属性がなめらかに変わる面（UVを貼った平面など）では、隣の頂点へ寄せても誤差にならない。
+		 */
+		struct AttributeQuadric
+		{
+			Quadric value[kAttributeCount];         ///< Σw(g・p + d)^2
+			double linear[kAttributeCount][4] = {}; ///< Σw(g, d)
+			double weight = 0;
+
+			void AddTriangle(const Vector3& p0, const Vector3& p1, const Vector3& p2,
+				const float* a0, const float* a1, const float* a2, float w)
+			{
+				// 三角形の平面内で g・e1 = a1 - a0, g・e2 = a2 - a0 となる勾配gを求める
+				const Vector3 e1 = p1 - p0;
+				const Vector3 e2 = p2 - p0;
+				const double d11 = Math::Dot(e1, e1), d12 = Math::Dot(e1, e2), d22 = Math::Dot(e2, e2);
+				const double denominator = d11 * d22 - d12 * d12;
+				if (denominator <= 0.0)
+					return;
+
+				for (uint32_t i = 0; i < kAttributeCount; ++i)
+				{
+					const double da1 = a1[i] - a0[i];
+					const double da2 = a2[i] - a0[i];
+					const float u = static_cast<float>((d22 * da1 - d12 * da2) / denominator);
+					const float v = static_cast<float>((d11 * da2 - d12 * da1) / denominator);
+					const Vector3 gradient = e1 * u + e2 * v;
+					const float d = a0[i] - Math::Dot(gradient, p0);
+
+					value[i].AddPlane(gradient, d, w);
+					linear[i][0] += w * gradient.x;
+					linear[i][1] += w * gradient.y;
+					linear[i][2] += w * gradient.z;
+					linear[i][3] += w * d;
+				}
+				weight += w;
+			}
+
+			void operator+=(const AttributeQuadric& q)
+			{
+				for (uint32_t i = 0; i < kAttributeCount; ++i)
+				{
+					value[i] += q.value[i];
+					for (uint32_t k = 0; k < 4; ++k)
+						linear[i][k] += q.linear[i][k];
+				}
+				weight += q.weight;
+			}
+
+			/// 位置p、属性aの頂点へ寄せたときの誤差（Σw(g・p + d - a)^2 / Σw）
+			double Error(const Vector3& p, const float* a) const
+			{
+				if (weight <= 0.0)
+					return 0.0;
+				double r = 0.0;
+				for (uint32_t i = 0; i < kAttributeCount; ++i)
+				{
+					const double fitted = linear[i][0] * p.x + linear[i][1] * p.y + linear[i][2] * p.z + linear[i][3];
+					r += value[i].Evaluate(p) - 2.0 * a[i] * fitted + weight * a[i] * a[i];
+				}
+				return std::max(r, 0.0) / weight;
+			}
+		};
+
+		/// 縮約の候補（fromをtoへ寄せる）
+		struct Collapse
+		{
+			uint32_t from;
+			uint32_t to;
+			double error;
+		};
+
+		/// 位置のビット列で同じ位置の頂点をまとめる
+		struct PositionKey
+		{
+			uint32_t bits[3];
+			bool operator==(const PositionKey& other) const { return std::memcmp(bits, other.bits, sizeof(bits)) == 0; }
+		};
+
+		struct PositionKeyHash
+		{
+			size_t operator()(const PositionKey& key) const
+			{
+				return (static_cast<size_t>(key.bits[0]) * 73856093u) ^ (static_cast<size_t>(key.bits[1]) * 19349663u) ^ (static_cast<size_t>(key.bits[2]) * 83492791u);
+			}
+		};
+
+		PositionKey MakePositionKey(const Vector3& position)
+		{
+			PositionKey key;
+			// -0と+0を同じ位置として扱う
+			const float values[3] = { position.x + 0.0f, position.y + 0.0f, position.z + 0.0f };
+			std::memcpy(key.bits, values, sizeof(key.bits));
+			return key;
+		}
+
+		uint64_t MakeEdgeKey(uint64_t a, uint64_t b)
+		{
+			return (a << 32) | b;
+		}
+
+		/**
+		 * @brief 開いた辺（逆向きの辺がない辺）をたどる
+		 *
+		 * 辺はインデックスの組で調べるので、属性の継ぎ目も開いた辺になる。
+		 * loop[v]はvから出る開いた辺の先、loopback[v]はvへ入る開いた辺の元（複数あればv自身、なければkInvalid）。
+		 */
+		void BuildEdgeLoops(const uint32_t* indices, size_t indexCount,
+			std::vector<uint32_t>& loop, std::vector<uint32_t>& loopback)
+		{
+			std::unordered_set<uint64_t> edges;
+			edges.reserve(indexCount);
+			for (size_t i = 0; i < indexCount; i += 3)
+			{
+				for (uint32_t k = 0; k < 3; ++k)
+					edges.insert(MakeEdgeKey(indices[i + k], indices[i + (k + 1) % 3]));
+			}
+
+			for (size_t i = 0; i < indexCount; i += 3)
+			{
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					const uint32_t v0 = indices[i + k];
+					const uint32_t v1 = indices[i + (k + 1) % 3];
+					if (edges.count(MakeEdgeKey(v1, v0)) != 0)
+						continue;
+
+					loop[v0] = loop[v0] == kInvalid ? v1 : v0;
+					loopback[v1] = loopback[v1] == kInvalid ? v0 : v1;
+				}
+			}
+		}
+
+		/// 開いた辺の先が縮約で消えた場合に、つなぎ直す
+		void RemapEdgeLoops(std::vector<uint32_t>& loop, const std::vector<uint32_t>& collapseRemap)
+		{
+			for (size_t i = 0; i < loop.size(); ++i)
+			{
+				const uint32_t l = loop[i];
+				if (l == kInvalid || l == i)
+					continue;
+				const uint32_t r = collapseRemap[l];
+				if (r == i)
+					loop[i] = loop[l] != kInvalid && loop[l] != l ? collapseRemap[loop[l]] : kInvalid;
+				else
+					loop[i] = r;
+			}
+		}
+
+		/// 三角形の法線（時計回りが表。正規化しない）
+		Vector3 TriangleNormal(const Vector3& p0, const Vector3& p1, const Vector3& p2)
+		{
+			return Math::Cross(p1 - p0, p2 - p0);
+		}
+	}
+
+	size_t MeshSimplifier::Simplify(const uint32_t* indices, size_t indexCount, const Vertex* vertices, uint32_t vertexCount,
+		uint32_t* destination, size_t targetIndexCount, float maxError,
+		const MeshSimplifierSettings& settings, float* resultError)
+	{
+		std::copy(indices, indices + indexCount, destination);
+		if (resultError)
+			*resultError = 0.0f;
+		if (indexCount == 0 || vertexCount == 0 || targetIndexCount >= indexCount)
+			return indexCount;
+
+		// 位置が同じ頂点をまとめる。remapは組の代表（最初の頂点）、wedgeは組の中の次の頂点（循環）
+		std::vector<uint32_t> remap(vertexCount);
+		std::vector<uint32_t> wedge(vertexCount);
+		{
+			std::unordered_map<PositionKey, uint32_t, PositionKeyHash> firstVertex;
+			firstVertex.reserve(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; ++v)
+			{
+				const uint32_t first = firstVertex.emplace(MakePositionKey(vertices[v].position), v).first->second;
+				remap[v] = first;
+				if (first == v)
+				{
+					wedge[v] = v;
+				}
+				else
+				{
+					wedge[v] = wedge[first];
+					wedge[first] = v;
+				}
+			}
+		}
+
+		std::vector<uint32_t> loop(vertexCount, kInvalid);
+		std::vector<uint32_t> loopback(vertexCount, kInvalid);
+		BuildEdgeLoops(indices, indexCount, loop, loopback);
+
+		// 位置の組で数えた辺。インデックスでは開いていても、位置では閉じている辺は継ぎ目
+		std::unordered_set<uint64_t> positionEdges;
+		positionEdges.reserve(indexCount);
+		for (size_t i = 0; i < indexCount; i += 3)
+		{
+			for (uint32_t k = 0; k < 3; ++k)
+				positionEdges.insert(MakeEdgeKey(remap[indices[i + k]], remap[indices[i + (k + 1) % 3]]));
+		}
+		auto isPositionBorder = [&](uint32_t v0, uint32_t v1) { return positionEdges.count(MakeEdgeKey(remap[v1], remap[v0])) == 0; };
+
+		// 組の種類を決める
+		auto hasSingleEdge = [](uint32_t next, uint32_t v) { return next != kInvalid && next != v; };
+		std::vector<uint8_t> kinds(vertexCount, kLocked);
+		for (uint32_t v = 0; v < vertexCount; ++v)
+		{
+			if (remap[v] != v)
+				continue;
+
+			VertexKind kind = kLocked;
+			const uint32_t w = wedge[v];
+			if (w == v)
+			{
+				if (loop[v] == kInvalid && loopback[v] == kInvalid)
+					kind = kManifold;
+				else if (hasSingleEdge(loop[v], v) && hasSingleEdge(loopback[v], v) &&
+					isPositionBorder(v, loop[v]) && isPositionBorder(loopback[v], v))
+					kind = settings.lockBorder ? kLocked : kBorder;
+			}
+			else if (wedge[w] == v)
+			{
+				// 継ぎ目の両側で、開いた辺が逆向きに同じ位置を結んでいる
+				if (hasSingleEdge(loop[v], v) && hasSingleEdge(loopback[v], v) && hasSingleEdge(loop[w], w) && hasSingleEdge(loopback[w], w) &&
+					remap[loop[v]] == remap[loopback[w]] && remap[loopback[v]] == remap[loop[w]] && remap[loop[v]] != remap[loopback[v]] &&
+					!isPositionBorder(v, loop[v]) && !isPositionBorder(loopback[v], v))
+					kind = kSeam;
+			}
+			kinds[v] = static_cast<uint8_t>(kind);
+		}
+
+		// 属性はメッシュの大きさを掛けて距離と同じ単位にする
+		AxisAlignedBox box;
+		for (uint32_t v = 0; v < vertexCount; ++v)
+			box.AddPoint(vertices[v].position);
+		const Vector3 size = box.GetDimensions();
+		const float extent = std::max(size.x, std::max(size.y, size.z));
+		const float normalScale = settings.normalWeight * extent;
+		const float texcoordScale = settings.texcoordWeight * extent;
+
+		std::vector<float> attributes(static_cast<size_t>(vertexCount) * kAttributeCount);
+		for (uint32_t v = 0; v < vertexCount; ++v)
+		{
+			float* a = &attributes[static_cast<size_t>(v) * kAttributeCount];
+			a[0] = vertices[v].normal.x * normalScale;
+			a[1] = vertices[v].normal.y * normalScale;
+			a[2] = vertices[v].normal.z * normalScale;
+			a[3] = vertices[v].texcoord.x * texcoordScale;
+			a[4] = vertices[v].texcoord.y * texcoordScale;
+		}
+
+		// 位置の誤差は組ごと、属性の誤差は頂点ごとに、周りの三角形の面積で重み付けして積む
+		std::vector<Quadric> quadrics(vertexCount);
+		std::vector<AttributeQuadric> attributeQuadrics(vertexCount);
+		for (size_t i = 0; i < indexCount; i += 3)
+		{
+			const uint32_t triangle[3] = { indices[i], indices[i + 1], indices[i + 2] };
+			const Vector3& p0 = vertices[triangle[0]].position;
+			const Vector3& p1 = vertices[triangle[1]].position;
+			const Vector3& p2 = vertices[triangle[2]].position;
+			const Vector3 normal = TriangleNormal(p0, p1, p2);
+			const float length = normal.Length();
+			if (length <= 0.0f)
+				continue;
+
+			const Vector3 unitNormal = normal * (1.0f / length);
+			const float area = length * 0.5f;
+			const float distance = -Math::Dot(unitNormal, p0);
+			const float* a0 = &attributes[static_cast<size_t>(triangle[0]) * kAttributeCount];
+			const float* a1 = &attributes[static_cast<size_t>(triangle[1]) * kAttributeCount];
+			const float* a2 = &attributes[static_cast<size_t>(triangle[2]) * kAttributeCount];
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				quadrics[remap[triangle[k]]].AddPlane(unitNormal, distance, area);
+				attributeQuadrics[triangle[k]].AddTriangle(p0, p1, p2, a0, a1, a2, area);
+			}
+
+			// 動かす境界は、境界に垂直な平面で境界の形を保つ
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				const uint32_t v0 = triangle[k];
+				const uint32_t v1 = triangle[(k + 1) % 3];
+				if (loop[v0] != v1 || !isPositionBorder(v0, v1))
+					continue;
+
+				const Vector3 edge = vertices[v1].position - vertices[v0].position;
+				const Vector3 edgeNormal = Math::Cross(edge, unitNormal);
+				const float edgeNormalLength = edgeNormal.Length();
+				if (edgeNormalLength <= 0.0f)
+					continue;
+
+				const Vector3 planeNormal = edgeNormal * (1.0f / edgeNormalLength);
+				const float planeDistance = -Math::Dot(planeNormal, vertices[v0].position);
+				const float weight = edge.LengthSqr() * kBorderWeight;
+				quadrics[remap[v0]].AddPlane(planeNormal, planeDistance, weight);
+				quadrics[remap[v1]].AddPlane(planeNormal, planeDistance, weight);
+			}
+		}
+
+		// 継ぎ目の頂点fromをtoへ寄せるときの、もう片側の組（寄せられなければkInvalid）
+		auto getSeamPartner = [&](uint32_t from, uint32_t to) -> uint32_t
+			{
+				const uint32_t otherFrom = wedge[from];
+				uint32_t otherTo = kInvalid;
+				if (loop[from] == to)
+					otherTo = loopback[otherFrom];
+				else if (loopback[from] == to)
+					otherTo = loop[otherFrom];
+				if (otherTo == kInvalid || otherTo == to || otherTo == otherFrom || remap[otherTo] != remap[to])
+					return kInvalid;
+				return otherTo;
+			};
+
+		auto canCollapse = [&](uint32_t from, uint32_t to)
+			{
+				const uint8_t fromKind = kinds[remap[from]];
+				const uint8_t toKind = kinds[remap[to]];
+				switch (fromKind)
+				{
+				case kManifold:
+					return true;
+				case kBorder:
+					return (toKind == kBorder || toKind == kLocked) && (loop[from] == to || loopback[from] == to);
+				case kSeam:
+					return toKind == kSeam && getSeamPartner(from, to) != kInvalid;
+				default:
+					return false;
+				}
+			};
+
+		auto getCollapseError = [&](uint32_t from, uint32_t to)
+			{
+				const Vector3& position = vertices[to].position;
+				double error = quadrics[remap[from]].Error(position);
+				error += attributeQuadrics[from].Error(position, &attributes[static_cast<size_t>(to) * kAttributeCount]);
+				if (kinds[remap[from]] == kSeam)
+				{
+					const uint32_t otherTo = getSeamPartner(from, to);
+					error += attributeQuadrics[wedge[from]].Error(position, &attributes[static_cast<size_t>(otherTo) * kAttributeCount]);
+				}
+				return error;
+			};
+
+		const double maxErrorSqr = static_cast<double>(maxError) * maxError;
+		double resultErrorSqr = 0.0;
+		size_t resultCount = indexCount;
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+		std::vector<uint32_t> adjacency;
+		std::vector<Collapse> collapses;
+		std::vector<uint32_t> collapseRemap(vertexCount);
+		std::vector<uint8_t> collapseLocked(vertexCount);
+
+		while (resultCount > targetIndexCount)
+		{
+			// 頂点から三角形への逆引き
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0u);
+			for (size_t i = 0; i < resultCount; ++i)
+				++adjacencyOffsets[destination[i] + 1];
+			for (uint32_t v = 0; v < vertexCount; ++v)
+				adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+			adjacency.resize(resultCount);
+			{
+				std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+				for (size_t i = 0; i < resultCount; ++i)
+					adjacency[fill[destination[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+
+			// 辺の両方向を候補にして、誤差の小さい順に並べる
+			collapses.clear();
+			for (size_t i = 0; i < resultCount; i += 3)
+			{
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					const uint32_t v0 = destination[i + k];
+					const uint32_t v1 = destination[i + (k + 1) % 3];
+					// 閉じた辺は両側の三角形に逆向きで現れるので、片方からだけ追加する
+					if (remap[v0] == remap[v1] || (v0 > v1 && loop[v0] == kInvalid))
+						continue;
+					if (canCollapse(v0, v1))
+						collapses.push_back({ v0, v1, getCollapseError(v0, v1) });
+					if (canCollapse(v1, v0))
+						collapses.push_back({ v1, v0, getCollapseError(v1, v0) });
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b)
+				{
+					if (a.error != b.error)
+						return a.error < b.error;
+					return a.from != b.from ? a.from < b.from : a.to < b.to;
+				});
+
+			for (uint32_t v = 0; v < vertexCount; ++v)
+				collapseRemap[v] = v;
+			std::fill(collapseLocked.begin(), collapseLocked.end(), uint8_t(0));
+
+			// 1回の縮約で消える三角形はおおよそ2つ。目標を超えて減らしすぎないように、このパスで消す数を決める
+			const size_t triangleGoal = (resultCount - targetIndexCount) / 3;
+			size_t removedTriangles = 0;
+			size_t collapseCount = 0;
+
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapse.error > maxErrorSqr || removedTriangles >= triangleGoal)
+					break;
+
+				const uint32_t from = collapse.from;
+				const uint32_t to = collapse.to;
+				if (collapseLocked[remap[from]] || collapseLocked[remap[to]])
+					continue;
+
+				const bool seam = kinds[remap[from]] == kSeam;
+				const uint32_t wedges[2] = { from, seam ? wedge[from] : kInvalid };
+				const uint32_t targets[2] = { to, seam ? getSeamPartner(from, to) : kInvalid };
+
+				// 周りの三角形が裏返らないか調べる。周りの頂点はこのパスではまだ動いていない
+				bool flipped = false;
+				size_t degenerate = 0;
+				for (uint32_t w = 0; w < 2 && !flipped; ++w)
+				{
+					if (wedges[w] == kInvalid)
+						continue;
+					const Vector3& target = vertices[targets[w]].position;
+					for (uint32_t a = adjacencyOffsets[wedges[w]]; a < adjacencyOffsets[wedges[w] + 1]; ++a)
+					{
+						const uint32_t* triangle = destination + adjacency[a] * 3;
+						if (remap[triangle[0]] == remap[to] || remap[triangle[1]] == remap[to] || remap[triangle[2]] == remap[to])
+						{
+							++degenerate;
+							continue;
+						}
+
+						Vector3 p[3] = { vertices[triangle[0]].position, vertices[triangle[1]].position, vertices[triangle[2]].position };
+						const Vector3 before = TriangleNormal(p[0], p[1], p[2]);
+						for (uint32_t k = 0; k < 3; ++k)
+						{
+							if (triangle[k] == wedges[w])
+								p[k] = target;
+						}
+						const Vector3 after = TriangleNormal(p[0], p[1], p[2]);
+						if (Math::Dot(before, after) <= kMinFlipCos * before.Length() * after.Length())
+						{
+							flipped = true;
+							break;
+						}
+					}
+				}
+				if (flipped)
+					continue;
+
+				for (uint32_t w = 0; w < 2; ++w)
+				{
+					if (wedges[w] == kInvalid)
+						continue;
+					collapseRemap[wedges[w]] = targets[w];
+					attributeQuadrics[targets[w]] += attributeQuadrics[wedges[w]];
+
+					// 周りの頂点をこのパスでは動かさない（裏返りの判定が正しく行えるように）
+					for (uint32_t a = adjacencyOffsets[wedges[w]]; a < adjacencyOffsets[wedges[w] + 1]; ++a)
+					{
+						const uint32_t* triangle = destination + adjacency[a] * 3;
+						for (uint32_t k = 0; k < 3; ++k)
+							collapseLocked[remap[triangle[k]]] = 1;
+					}
+				}
+				quadrics[remap[to]] += quadrics[remap[from]];
+				collapseLocked[remap[from]] = 1;
+				collapseLocked[remap[to]] = 1;
+
+				resultErrorSqr = std::max(resultErrorSqr, collapse.error);
+				removedTriangles += degenerate;
+				++collapseCount;
+			}
+
+			if (collapseCount == 0)
+				break;
+
+			RemapEdgeLoops(loop, collapseRemap);
+			RemapEdgeLoops(loopback, collapseRemap);
+
+			// インデックスを付け替え、潰れた三角形を除く
+			size_t writeCount = 0;
+			for (size_t i = 0; i < resultCount; i += 3)
+			{
+				const uint32_t v0 = collapseRemap[destination[i]];
+				const uint32_t v1 = collapseRemap[destination[i + 1]];
+				const uint32_t v2 = collapseRemap[destination[i + 2]];
+				if (remap[v0] == remap[v1] || remap[v1] == remap[v2] || remap[v2] == remap[v0])
+					continue;
+				destination[writeCount++] = v0;
+				destination[writeCount++] = v1;
+				destination[writeCount++] = v2;
+			}
+			resultCount = writeCount;
+		}
+
+		if (resultError)
+			*resultError = static_cast<float>(std::sqrt(resultErrorSqr));
+		return resultCount;
+	}
+
+	void MeshSimplifier::GenerateLods(std::vector<uint32_t>& indices, SubMesh& subMesh, const Vertex* vertices,
+		const MeshLodSettings& settings)
+	{
+		subMesh.lodCount = 1;
+		if (subMesh.indexCount == 0)
+			return;
+
+		// 末尾への追加でindicesが再確保されるので、LOD0を写しておく
+		const std::vector<uint32_t> source(indices.begin() + subMesh.indexOffset, indices.begin() + subMesh.indexOffset + subMesh.indexCount);
+
+		AxisAlignedBox box;
+		for (uint32_t index : source)
+			box.AddPoint(vertices[index].position);
+		const Vector3 size = box.GetDimensions();
+		const float maxError = settings.maxError * std::max(size.x, std::max(size.y, size.z));
+
+		std::vector<uint32_t> lodIndices(source.size());
+		size_t previousCount = source.size();
+		float previousError = 0.0f;
+		for (uint32_t lod = 1; lod < kMaxMeshLods; ++lod)
+		{
+			const size_t targetCount = static_cast<size_t>(previousCount * settings.reduction) / 3 * 3;
+			float error = 0.0f;
+			const size_t count = Simplify(source.data(), source.size(), vertices, subMesh.vertexCount,
+				lodIndices.data(), targetCount, maxError, settings.simplifier, &error);
+			if (count == 0 || count > previousCount * settings.minReduction)
+				break;
+
+			MeshOptimizer::OptimizeVertexCache(lodIndices.data(), count, subMesh.vertexCount);
+
+			MeshLod& meshLod = subMesh.lods[lod - 1];
+			meshLod.indexOffset = static_cast<uint32_t>(indices.size());
+			meshLod.indexCount = static_cast<uint32_t>(count);
+			meshLod.error = std::max(error, previousError);
+			indices.insert(indices.end(), lodIndices.begin(), lodIndices.begin() + count);
+
+			subMesh.lodCount = lod + 1;
+			previousCount = count;
+			previousError = meshLod.error;
+		}
+	}
+}
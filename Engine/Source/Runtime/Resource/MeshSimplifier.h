@@ -0,0 +1,84 @@
+/**
+ * @file MeshSimplifier.h
+ * @brief 二次誤差（QEM）による辺の縮約でLODを作る
+ *
+ * 頂点は元のメッシュと共有し、インデックスだけを作り直す（頂点を別の頂点の位置へ寄せる縮約のみ）。
+ * - 誤差: 位置は周りの三角形の平面からの距離の二乗（Garland-Heckbert）、属性（法線・UV）は
+ *   寄せる前の値との差の二乗を面積で重み付けした平均。属性はメッシュの大きさを掛けて距離と同じ単位にして足す
+ * - UVや法線の継ぎ目（位置が同じで属性が違う頂点の組）は継ぎ目に沿ってだけ縮約し、両側を一緒に寄せる
+ * - 開いた境界は既定で固定する（隣のメッシュとの間に隙間ができないように）
+ * - 三角形が裏返る縮約は行わない
+ * 結果は入力だけで決まる。
+ */
+
+#pragma once
+#include "Mesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AtomEngine
+{
+	/**
+	 * @struct MeshSimplifierSettings
+	 * @brief 簡略化の設定
+	 */
+	struct MeshSimplifierSettings
+	{
+		float normalWeight = 0.5f;      ///< 法線の差の重み（メッシュの大きさに対する割合）
+		float texcoordWeight = 0.5f;    ///< UVの差の重み（メッシュの大きさに対する割合）
+		bool lockBorder = true;         ///< 開いた境界の頂点を動かさない
+	};
+
+	/**
+	 * @struct MeshLodSettings
+	 * @brief LODの作り方
+	 */
+	struct MeshLodSettings
+	{
+		float reduction = 0.5f;         ///< 各LODの三角形の数の、前のLODに対する割合
+		float minReduction = 0.85f;     ///< 前のLODに対してこの割合までしか減らせなければそこで止める
+		float maxError = 0.02f;         ///< 許容する誤差（メッシュの大きさに対する割合）
+		MeshSimplifierSettings simplifier;
+	};
+
+	/**
+	 * @class MeshSimplifier
+	 * @brief 三角形リストの簡略化
+	 *
+	 * インデックスはサブメッシュの頂点範囲の先頭からの番号で、全てvertexCount未満であること。
+	 */
+	class MeshSimplifier
+	{
+	public:
+		/**
+		 * @brief 三角形の数を減らす
+		 * @param indices 元のインデックス
+		 * @param indexCount インデックスの数（3の倍数）
+		 * @param vertices 頂点
+		 * @param vertexCount 頂点の数
+		 * @param destination 出力先（indexCount要素）
+		 * @param targetIndexCount 目標のインデックスの数（誤差の上限に達したらそこで止まる）
+		 * @param maxError 許容する誤差（ローカル空間の距離）
+		 * @param resultError 結果の誤差（ローカル空間の距離。不要ならnullptr）
+		 * @return 出力したインデックスの数
+		 */
+		static size_t Simplify(const uint32_t* indices, size_t indexCount, const Vertex* vertices, uint32_t vertexCount,
+			uint32_t* destination, size_t targetIndexCount, float maxError,
+			const MeshSimplifierSettings& settings = {}, float* resultError = nullptr);
+
+		/**
+		 * @brief サブメッシュのLOD1以降を作る
+		 *
+		 * 各LODは元のメッシュから簡略化し（誤差が積み重ならない）、頂点キャッシュ向けに並べ替えてから
+		 * indicesの末尾に追加する。subMeshのlodsとlodCountを設定する。
+		 * @param indices モデル全体のインデックス（subMesh.indexOffsetからがLOD0）
+		 * @param subMesh サブメッシュ
+		 * @param vertices サブメッシュの頂点（subMesh.vertexCount個）
+		 * @param settings LODの作り方
+		 */
+		static void GenerateLods(std::vector<uint32_t>& indices, SubMesh& subMesh, const Vertex* vertices,
+			const MeshLodSettings& settings = {});
+	};
+}
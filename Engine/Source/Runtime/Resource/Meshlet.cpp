@@ -0,0 +1,166 @@
+#include "Meshlet.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		/// 円錐の開きがこれより広い（三角形の法線と軸の内積の最小値が小さい）場合は、裏向きの判定にほとんど掛からないので作らない
+		constexpr float kMinConeDot = 0.1f;
+
+		/// 表向きの法線（時計回りが表）。面積が0なら長さ0を返す
+		Vector3 TriangleNormal(const Vector3& p0, const Vector3& p1, const Vector3& p2)
+		{
+			const Vector3 normal = Math::Cross(p1 - p0, p2 - p0);
+			const float length = normal.Length();
+			return length > 0.0f ? normal * (1.0f / length) : Vector3::ZERO;
+		}
+	}
+
+	void MeshletBuilder::Build(const uint32_t* indices, size_t indexCount, const Vertex* vertices, uint32_t vertexCount,
+		std::vector<Meshlet>& meshlets, std::vector<MeshletBounds>& bounds)
+	{
+		const uint32_t triangleCount = static_cast<uint32_t>(indexCount / 3);
+		if (triangleCount == 0)
+			return;
+
+		// 現在のメッシュレットで使った頂点に、メッシュレットごとに変わる印を付ける
+		std::vector<uint32_t> stamps(vertexCount, 0);
+		uint32_t stamp = 1;
+		Meshlet current;
+
+		auto countNewVertices = [&](const uint32_t* triangle)
+			{
+				uint32_t count = 0;
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					const uint32_t vertex = triangle[k];
+					if (stamps[vertex] != stamp && (k == 0 || vertex != triangle[0]) && (k < 2 || vertex != triangle[1]))
+						++count;
+				}
+				return count;
+			};
+
+		auto flush = [&](uint32_t nextTriangle)
+			{
+				meshlets.push_back(current);
+				bounds.push_back(ComputeBounds(indices + current.triangleOffset * 3, current.triangleCount, vertices));
+				current = Meshlet();
+				current.triangleOffset = nextTriangle;
+				++stamp;
+			};
+
+		for (uint32_t t = 0; t < triangleCount; ++t)
+		{
+			const uint32_t* triangle = indices + t * 3;
+			uint32_t newVertices = countNewVertices(triangle);
+			if (current.vertexCount + newVertices > kMaxVertices || current.triangleCount + 1u > kMaxTriangles)
+			{
+				flush(t);
+				newVertices = countNewVertices(triangle);
+			}
+
+			for (uint32_t k = 0; k < 3; ++k)
+				stamps[triangle[k]] = stamp;
+			current.vertexCount = static_cast<uint16_t>(current.vertexCount + newVertices);
+			++current.triangleCount;
+		}
+		flush(triangleCount);
+	}
+
+	MeshletBounds MeshletBuilder::ComputeBounds(const uint32_t* indices, size_t triangleCount, const Vertex* vertices)
+	{
+		MeshletBounds bounds;
+		if (triangleCount == 0)
+			return bounds;
+
+		// 境界ボックスの中心から最も遠い頂点までを半径にする
+		AxisAlignedBox box;
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+			box.AddPoint(vertices[indices[i]].position);
+		bounds.center = box.GetCenter();
+		float radiusSqr = 0.0f;
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+			radiusSqr = std::max(radiusSqr, (vertices[indices[i]].position - bounds.center).LengthSqr());
+		bounds.radius = std::sqrt(radiusSqr);
+
+		// 法線の平均を円錐の軸にする（面積0の三角形は描画されないので除く）
+		Vector3 axis(0.0f, 0.0f, 0.0f);
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const uint32_t* triangle = indices + t * 3;
+			axis += TriangleNormal(vertices[triangle[0]].position, vertices[triangle[1]].position, vertices[triangle[2]].position);
+		}
+		const float axisLength = axis.Length();
+		if (axisLength <= 0.0f)
+			return bounds;
+		axis = axis * (1.0f / axisLength);
+		bounds.coneAxis = axis;
+
+		float minDot = 1.0f;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const uint32_t* triangle = indices + t * 3;
+			const Vector3 normal = TriangleNormal(vertices[triangle[0]].position, vertices[triangle[1]].position, vertices[triangle[2]].position);
+			if (!normal.IsZero())
+				minDot = std::min(minDot, Math::Dot(normal, axis));
+		}
+		if (minDot <= kMinConeDot)
+			return bounds;
+
+		// 頂点を軸に沿って、全ての三角形の平面の裏側（または平面上）に来るまで下げる
+		float maxDistance = 0.0f;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const uint32_t* triangle = indices + t * 3;
+			const Vector3& p0 = vertices[triangle[0]].position;
+			const Vector3 normal = TriangleNormal(p0, vertices[triangle[1]].position, vertices[triangle[2]].position);
+			if (normal.IsZero())
+				continue;
+			maxDistance = std::max(maxDistance, Math::Dot(bounds.center - p0, normal) / Math::Dot(axis, normal));
+		}
+
+		// 法線の円錐の開きをcos(a)とすると、視点が入ると裏向きになる円錐の開きは90° - aなので、その余弦はsin(a)
+		bounds.coneApex = bounds.center - axis * maxDistance;
+		bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+		return bounds;
+	}
+
+	uint32_t MeshletCulling::Cull(const MeshletBounds* bounds, uint32_t count, const CullingPlanes& planes,
+		const Vector3* viewPosition, uint32_t* visibility)
+	{
+		if (count == 0)
+			return 0;
+
+		// 視錐台の判定は球のSoAでまとめて行う
+		thread_local std::vector<float> sphereData;
+		sphereData.resize(count * 4);
+		float* centerX = sphereData.data();
+		float* centerY = centerX + count;
+		float* centerZ = centerY + count;
+		float* radius = centerZ + count;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			centerX[i] = bounds[i].center.x;
+			centerY[i] = bounds[i].center.y;
+			centerZ[i] = bounds[i].center.z;
+			radius[i] = bounds[i].radius;
+		}
+
+		uint32_t visibleCount = planes.CullSpheres({ centerX, centerY, centerZ, radius }, count, visibility);
+		if (!viewPosition)
+			return visibleCount;
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (CullingPlanes::IsVisible(visibility, i) && IsBackfacing(bounds[i], *viewPosition))
+			{
+				visibility[i >> 5] &= ~(1u << (i & 31));
+				--visibleCount;
+			}
+		}
+		return visibleCount;
+	}
+}
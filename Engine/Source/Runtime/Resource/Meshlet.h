@@ -0,0 +1,108 @@
+/**
+ * @file Meshlet.h
+ * @brief サブメッシュを小さな三角形のまとまり（メッシュレット）に分け、まとまりごとにカリングする
+ *
+ * メッシュレットはサブメッシュのインデックスの連続した範囲で、三角形の順はMeshOptimizerで並べたまま先頭から詰めて分ける。
+ * 範囲が連続しているので、CPUのカリングでは見えるメッシュレットの範囲だけを描画できる
+ * （GPUでカリングする場合も同じデータを使える）。
+ * 各メッシュレットは次の判定用のデータを持つ。
+ * - 境界球: 視錐台との判定
+ * - 法線の円錐: 全ての三角形が視点から裏を向いているかの判定
+ */
+
+#pragma once
+#include "Mesh.h"
+#include "Runtime/Core/Math/FrustumCulling.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AtomEngine
+{
+	/**
+	 * @struct Meshlet
+	 * @brief メッシュレット（サブメッシュのインデックスの範囲）
+	 */
+	struct Meshlet
+	{
+		uint32_t triangleOffset = 0;    ///< サブメッシュの先頭からの三角形の番号
+		uint16_t triangleCount = 0;
+		uint16_t vertexCount = 0;       ///< 参照する頂点の数
+	};
+
+	/**
+	 * @struct MeshletBounds
+	 * @brief メッシュレットのカリング用データ（サブメッシュのローカル空間）
+	 *
+	 * 視点が円錐の内側（dot(normalize(coneApex - 視点), coneAxis) > coneCutoff）なら全ての三角形が裏を向いている。
+	 * 三角形の向きがばらばらで円錐が作れない場合はconeCutoffが1より大きく、常に表向きと判定される。
+	 */
+	struct MeshletBounds
+	{
+		Vector3 center;
+		float radius = 0.0f;
+		Vector3 coneApex;
+		float coneCutoff = 2.0f;
+		Vector3 coneAxis;
+	};
+
+	/**
+	 * @class MeshletBuilder
+	 * @brief メッシュレットの作成
+	 */
+	class MeshletBuilder
+	{
+	public:
+		static constexpr uint32_t kMaxVertices = 64;
+		static constexpr uint32_t kMaxTriangles = 124;
+
+		/**
+		 * @brief サブメッシュをメッシュレットに分ける
+		 *
+		 * 三角形の順は変えず、頂点か三角形の数が上限を超える位置で区切る。
+		 * @param indices サブメッシュのインデックス（サブメッシュの頂点範囲の先頭からの番号）
+		 * @param indexCount インデックスの数（3の倍数）
+		 * @param vertices サブメッシュの頂点
+		 * @param vertexCount 頂点の数
+		 * @param meshlets 出力先（末尾に追加する）
+		 * @param bounds 出力先（meshletsと同じ並びで末尾に追加する）
+		 */
+		static void Build(const uint32_t* indices, size_t indexCount, const Vertex* vertices, uint32_t vertexCount,
+			std::vector<Meshlet>& meshlets, std::vector<MeshletBounds>& bounds);
+
+		/// 三角形の集まりの境界球と法線の円錐を求める（三角形は時計回りが表）
+		static MeshletBounds ComputeBounds(const uint32_t* indices, size_t triangleCount, const Vertex* vertices);
+	};
+
+	/**
+	 * @class MeshletCulling
+	 * @brief メッシュレットのカリング
+	 *
+	 * 判定はサブメッシュのローカル空間で行うので、平面と視点はローカル空間に変換して渡す
+	 * （RenderQueue::GetLocalCullingPlanesなど）。
+	 */
+	class MeshletCulling
+	{
+	public:
+		/// 視点から全ての三角形が裏を向いているか
+		static bool IsBackfacing(const MeshletBounds& bounds, const Vector3& viewPosition)
+		{
+			const Vector3 toApex = bounds.coneApex - viewPosition;
+			const float distance = toApex.Length();
+			return Math::Dot(toApex, bounds.coneAxis) > bounds.coneCutoff * distance;
+		}
+
+		/**
+		 * @brief メッシュレットを判定して可視ビットマスクを書き出す
+		 * @param bounds 判定するメッシュレット
+		 * @param count 要素数
+		 * @param planes ローカル空間の平面
+		 * @param viewPosition ローカル空間の視点（nullptrなら裏向きの判定をしない。ラスタライザが裏面を捨てない場合など）
+		 * @param visibility 出力（CullingPlanes::GetMaskWordCount(count)要素、i番目の可視でビットiが1）
+		 * @return 可視の数
+		 */
+		static uint32_t Cull(const MeshletBounds* bounds, uint32_t count, const CullingPlanes& planes,
+			const Vector3* viewPosition, uint32_t* visibility);
+	};
+}
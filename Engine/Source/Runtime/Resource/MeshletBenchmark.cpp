@@ -0,0 +1,375 @@
+#include "MeshletBenchmark.h"
+#include "Meshlet.h"
+#include "Runtime/Core/LogSystem/LogSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		/// グリッドの1辺の四角形の数（z = 0の平面、表は+z）
+		constexpr uint32_t kGridSize = 32;
+
+		/// 確認用の球（半径1）の経度・緯度の分割数
+		constexpr uint32_t kSphereSegments = 48;
+		constexpr uint32_t kSphereRings = 24;
+
+		/// 計測用の球の経度・緯度の分割数
+		constexpr uint32_t kLargeSphereSegments = 512;
+		constexpr uint32_t kLargeSphereRings = 256;
+
+		/// 1回の計測で判定する視点の数（球の周りを回る）
+		constexpr uint32_t kViewCount = 16;
+
+		/// 位置の比較の許容誤差
+		constexpr float kEpsilon = 1e-4f;
+
+		struct TestMesh
+		{
+			std::vector<Vertex> vertices;
+			std::vector<uint32_t> indices;
+			std::vector<Meshlet> meshlets;
+			std::vector<MeshletBounds> bounds;
+
+			void Build()
+			{
+				MeshletBuilder::Build(indices.data(), indices.size(), vertices.data(), static_cast<uint32_t>(vertices.size()), meshlets, bounds);
+			}
+
+			const Vector3& GetPosition(const uint32_t* triangle, uint32_t corner) const
+			{
+				return vertices[triangle[corner]].position;
+			}
+
+			const uint32_t* GetTriangles(const Meshlet& meshlet) const
+			{
+				return indices.data() + static_cast<size_t>(meshlet.triangleOffset) * 3;
+			}
+		};
+
+		/// 判定の結果（期待値はメッシュレットごとの平面・円錐の判定から求める）
+		struct CullResult
+		{
+			uint32_t visibleCount = 0;
+			uint32_t frustumCulledCount = 0;    ///< 視錐台の外
+			uint32_t backfacingCount = 0;       ///< 視錐台の内側で裏向き
+			size_t errors = 0;                  ///< 期待値との不一致と、見える三角形を含むのに捨てた数
+		};
+
+		template<typename Func>
+		double MeasureMilliseconds(int iterations, Func&& func)
+		{
+			using namespace std::chrono;
+			const auto start = steady_clock::now();
+			for (int i = 0; i < iterations; ++i)
+				func();
+			return duration<double, std::milli>(steady_clock::now() - start).count();
+		}
+
+		bool Report(const char* name, double scalarMs, double cullMs, size_t mismatches)
+		{
+			const bool passed = mismatches == 0;
+			Log("[MeshletBenchmark]:%-18s scalar %8.3f ms  cull %8.3f ms  x%5.2f  mismatches %zu%s\n",
+				name, scalarMs, cullMs, scalarMs / std::max(cullMs, 1e-6), mismatches, passed ? "" : "  (NG)");
+			return passed;
+		}
+
+		/// 計測を伴わない確認の結果
+		bool Report(const char* name, size_t errors)
+		{
+			const bool passed = errors == 0;
+			Log("[MeshletBenchmark]:%-18s errors %zu%s\n", name, errors, passed ? "" : "  (NG)");
+			return passed;
+		}
+
+		/// 表向きの法線（MeshletBuilderと同じく時計回りが表）。面積が0なら長さ0
+		Vector3 TriangleNormal(const TestMesh& mesh, const uint32_t* triangle)
+		{
+			const Vector3& p0 = mesh.GetPosition(triangle, 0);
+			const Vector3 normal = Math::Cross(mesh.GetPosition(triangle, 1) - p0, mesh.GetPosition(triangle, 2) - p0);
+			const float length = normal.Length();
+			return length > 0.0f ? normal * (1.0f / length) : Vector3::ZERO;
+		}
+
+		TestMesh MakeGrid()
+		{
+			TestMesh mesh;
+			for (uint32_t y = 0; y <= kGridSize; ++y)
+			{
+				for (uint32_t x = 0; x <= kGridSize; ++x)
+				{
+					Vertex& vertex = mesh.vertices.emplace_back();
+					vertex.position = Vector3(static_cast<float>(x), static_cast<float>(y), 0.0f);
+				}
+			}
+
+			const uint32_t stride = kGridSize + 1;
+			for (uint32_t y = 0; y < kGridSize; ++y)
+			{
+				for (uint32_t x = 0; x < kGridSize; ++x)
+				{
+					const uint32_t corner = y * stride + x;
+					mesh.indices.insert(mesh.indices.end(), { corner, corner + 1, corner + stride });
+					mesh.indices.insert(mesh.indices.end(), { corner + 1, corner + stride + 1, corner + stride });
+				}
+			}
+			mesh.Build();
+			return mesh;
+		}
+
+		/// 原点を中心とする半径1の球（表は外向き。極の三角形は面積0になる）
+		TestMesh MakeSphere(uint32_t segments, uint32_t rings)
+		{
+			TestMesh mesh;
+			for (uint32_t r = 0; r <= rings; ++r)
+			{
+				const float theta = Math::PI * static_cast<float>(r) / static_cast<float>(rings);
+				for (uint32_t s = 0; s <= segments; ++s)
+				{
+					const float phi = 2.0f * Math::PI * static_cast<float>(s) / static_cast<float>(segments);
+					Vertex& vertex = mesh.vertices.emplace_back();
+					vertex.position = Vector3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+				}
+			}
+
+			const uint32_t stride = segments + 1;
+			for (uint32_t r = 0; r < rings; ++r)
+			{
+				for (uint32_t s = 0; s < segments; ++s)
+				{
+					const uint32_t corner = r * stride + s;
+					const uint32_t quad[2][3] = {
+						{ corner, corner + 1, corner + stride },
+						{ corner + 1, corner + stride + 1, corner + stride },
+					};
+					for (const auto& triangle : quad)
+					{
+						// 法線が外を向くように並べる
+						const Vector3& p0 = mesh.vertices[triangle[0]].position;
+						const Vector3& p1 = mesh.vertices[triangle[1]].position;
+						const Vector3& p2 = mesh.vertices[triangle[2]].position;
+						const bool outward = Math::Dot(Math::Cross(p1 - p0, p2 - p0), p0 + p1 + p2) >= 0.0f;
+						mesh.indices.insert(mesh.indices.end(), { triangle[0], outward ? triangle[1] : triangle[2], outward ? triangle[2] : triangle[1] });
+					}
+				}
+			}
+			mesh.Build();
+			return mesh;
+		}
+
+		/**
+		 * @brief 分割と境界球・法線の円錐を確かめる
+		 * @return 不正な箇所の数
+		 */
+		size_t VerifyMeshlets(const TestMesh& mesh)
+		{
+			size_t errors = mesh.meshlets.size() == mesh.bounds.size() ? 0 : 1;
+			uint32_t nextTriangle = 0;
+			std::vector<uint32_t> stamps(mesh.vertices.size(), ~0u);
+			for (uint32_t i = 0; i < mesh.meshlets.size() && errors == 0; ++i)
+			{
+				const Meshlet& meshlet = mesh.meshlets[i];
+				const MeshletBounds& bounds = mesh.bounds[i];
+
+				// 三角形の範囲が隙間なく並び、上限に収まっていること
+				errors += meshlet.triangleOffset != nextTriangle || meshlet.triangleCount == 0 ||
+					meshlet.triangleCount > MeshletBuilder::kMaxTriangles;
+				nextTriangle = meshlet.triangleOffset + meshlet.triangleCount;
+
+				// 頂点数が実際に参照する頂点の数と一致し、境界球が全ての頂点を含むこと
+				const uint32_t* triangles = mesh.GetTriangles(meshlet);
+				uint32_t vertexCount = 0;
+				for (uint32_t k = 0; k < meshlet.triangleCount * 3u; ++k)
+				{
+					const uint32_t vertex = triangles[k];
+					if (stamps[vertex] != i)
+					{
+						stamps[vertex] = i;
+						++vertexCount;
+					}
+					errors += (mesh.vertices[vertex].position - bounds.center).Length() > bounds.radius + kEpsilon;
+				}
+				errors += vertexCount != meshlet.vertexCount || vertexCount > MeshletBuilder::kMaxVertices;
+
+				// 円錐を作った場合は、頂点が全ての三角形の平面の裏側（または平面上）にあること
+				if (bounds.coneCutoff <= 1.0f)
+				{
+					for (uint32_t t = 0; t < meshlet.triangleCount; ++t)
+					{
+						const uint32_t* triangle = triangles + t * 3;
+						const Vector3 normal = TriangleNormal(mesh, triangle);
+						errors += !normal.IsZero() && Math::Dot(bounds.coneApex - mesh.GetPosition(triangle, 0), normal) > kEpsilon;
+					}
+				}
+			}
+			errors += nextTriangle != mesh.indices.size() / 3;
+			return errors;
+		}
+
+		CullingPlanes MakePlanes(const std::vector<Vector4>& planes)
+		{
+			CullingPlanes result;
+			for (const Vector4& plane : planes)
+				result.AddPlane(plane);
+			return result;
+		}
+
+		/// 球が平面の外側にあるか（平面の法線は正規化済み）
+		bool IsOutside(const Vector4& plane, const Vector3& center, float radius)
+		{
+			return plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius;
+		}
+
+		/// 比較用の実装（メッシュレットごとに平面と円錐を判定する）
+		bool IsVisibleReference(const MeshletBounds& bounds, const std::vector<Vector4>& planes, const Vector3& viewPosition)
+		{
+			for (const Vector4& plane : planes)
+			{
+				if (IsOutside(plane, bounds.center, bounds.radius))
+					return false;
+			}
+			return !MeshletCulling::IsBackfacing(bounds, viewPosition);
+		}
+
+		/// 全ての頂点が1つの平面の外にあるか、全ての三角形が視点から裏を向いているか（捨ててよいか）
+		bool IsHidden(const TestMesh& mesh, const Meshlet& meshlet, const std::vector<Vector4>& planes, const Vector3& viewPosition)
+		{
+			const uint32_t* triangles = mesh.GetTriangles(meshlet);
+			for (const Vector4& plane : planes)
+			{
+				bool outside = true;
+				for (uint32_t k = 0; k < meshlet.triangleCount * 3u && outside; ++k)
+					outside = IsOutside(plane, mesh.vertices[triangles[k]].position, 0.0f);
+				if (outside)
+					return true;
+			}
+
+			for (uint32_t t = 0; t < meshlet.triangleCount; ++t)
+			{
+				const uint32_t* triangle = triangles + t * 3;
+				const Vector3 normal = TriangleNormal(mesh, triangle);
+				if (!normal.IsZero() && Math::Dot(viewPosition - mesh.GetPosition(triangle, 0), normal) > kEpsilon)
+					return false;
+			}
+			return true;
+		}
+
+		CullResult Cull(const TestMesh& mesh, const std::vector<Vector4>& planes, const Vector3& viewPosition)
+		{
+			const uint32_t count = static_cast<uint32_t>(mesh.meshlets.size());
+			std::vector<uint32_t> visibility(CullingPlanes::GetMaskWordCount(count));
+
+			CullResult result;
+			result.visibleCount = MeshletCulling::Cull(mesh.bounds.data(), count, MakePlanes(planes), &viewPosition, visibility.data());
+
+			uint32_t visibleCount = 0;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				const MeshletBounds& bounds = mesh.bounds[i];
+				const bool visible = CullingPlanes::IsVisible(visibility.data(), i);
+				const bool expected = IsVisibleReference(bounds, planes, viewPosition);
+				visibleCount += visible ? 1 : 0;
+				result.errors += visible != expected;
+				result.errors += !visible && !IsHidden(mesh, mesh.meshlets[i], planes, viewPosition);
+
+				const bool insideFrustum = std::none_of(planes.begin(), planes.end(),
+					[&bounds](const Vector4& plane) { return IsOutside(plane, bounds.center, bounds.radius); });
+				result.frustumCulledCount += insideFrustum ? 0 : 1;
+				result.backfacingCount += insideFrustum && !expected ? 1 : 0;
+			}
+			result.errors += visibleCount != result.visibleCount;
+			return result;
+		}
+	}
+
+	bool MeshletBenchmark::Run(int iterations)
+	{
+		const TestMesh grid = MakeGrid();
+		const TestMesh sphere = MakeSphere(kSphereSegments, kSphereRings);
+		const TestMesh largeSphere = MakeSphere(kLargeSphereSegments, kLargeSphereRings);
+		Log("[MeshletBenchmark]:grid %zu meshlets, sphere %zu meshlets, timing sphere %zu meshlets x %u views\n",
+			grid.meshlets.size(), sphere.meshlets.size(), largeSphere.meshlets.size(), kViewCount);
+
+		bool passed = true;
+		passed &= Report("Build Meshlets", VerifyMeshlets(grid) + VerifyMeshlets(sphere) + VerifyMeshlets(largeSphere));
+
+		{
+			size_t errors = 0;
+			const float half = static_cast<float>(kGridSize) * 0.5f;
+			const std::vector<Vector4> lowerRows = { Vector4(0.0f, -1.0f, 0.0f, 4.0f) };
+
+			// グリッドを表から見ると裏向きで捨てるものはなく、y > 4の行（の一部）だけが視錐台の外になる
+			const CullResult front = Cull(grid, lowerRows, Vector3(half, half, 10.0f));
+			errors += front.errors;
+			errors += front.backfacingCount != 0 || front.frustumCulledCount == 0 || front.visibleCount == 0;
+
+			// 裏から見ると全て捨てる
+			const CullResult back = Cull(grid, lowerRows, Vector3(half, half, -10.0f));
+			errors += back.errors;
+			errors += back.visibleCount != 0 || back.backfacingCount == 0;
+
+			// 球の外から見ると、視錐台の内側でも奥側のメッシュレットは裏向きで捨てる
+			// （メッシュレットは緯度の帯になるので、y <= 0の平面で北極側の帯が外になる）
+			const CullResult outside = Cull(sphere, { Vector4(0.0f, -1.0f, 0.0f, 0.0f) }, Vector3(0.0f, 0.0f, 4.0f));
+			errors += outside.errors;
+			errors += outside.backfacingCount == 0 || outside.frustumCulledCount == 0 || outside.visibleCount == 0;
+
+			passed &= Report("Cull Meshlets", errors);
+		}
+
+		{
+			const uint32_t count = static_cast<uint32_t>(largeSphere.meshlets.size());
+			const uint32_t wordCount = CullingPlanes::GetMaskWordCount(count);
+			const std::vector<Vector4> planes = {
+				Vector4(1.0f, 0.0f, 0.0f, 0.6f),
+				Vector4(-1.0f, 0.0f, 0.0f, 0.6f),
+				Vector4(0.0f, 1.0f, 0.0f, 0.6f),
+				Vector4(0.0f, -1.0f, 0.0f, 0.6f),
+			};
+			const CullingPlanes cullingPlanes = MakePlanes(planes);
+
+			std::vector<Vector3> views;
+			for (uint32_t v = 0; v < kViewCount; ++v)
+			{
+				const float angle = 2.0f * Math::PI * static_cast<float>(v) / static_cast<float>(kViewCount);
+				views.push_back(Vector3(std::sin(angle) * 4.0f, 0.5f, std::cos(angle) * 4.0f));
+			}
+
+			std::vector<uint32_t> expected(wordCount * kViewCount), actual(wordCount * kViewCount);
+			const double scalarMs = MeasureMilliseconds(iterations, [&]()
+				{
+					std::fill(expected.begin(), expected.end(), 0u);
+					for (uint32_t v = 0; v < kViewCount; ++v)
+					{
+						uint32_t* visibility = expected.data() + v * wordCount;
+						for (uint32_t i = 0; i < count; ++i)
+						{
+							if (IsVisibleReference(largeSphere.bounds[i], planes, views[v]))
+								visibility[i >> 5] |= 1u << (i & 31);
+						}
+					}
+				});
+			const double cullMs = MeasureMilliseconds(iterations, [&]()
+				{
+					for (uint32_t v = 0; v < kViewCount; ++v)
+						MeshletCulling::Cull(largeSphere.bounds.data(), count, cullingPlanes, &views[v], actual.data() + v * wordCount);
+				});
+
+			size_t mismatches = 0;
+			for (uint32_t v = 0; v < kViewCount; ++v)
+			{
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					mismatches += CullingPlanes::IsVisible(expected.data() + v * wordCount, i) !=
+						CullingPlanes::IsVisible(actual.data() + v * wordCount, i);
+				}
+			}
+			passed &= Report("Cull Timing", scalarMs, cullMs, mismatches);
+		}
+		return passed;
+	}
+}
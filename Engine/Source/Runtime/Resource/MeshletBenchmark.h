@@ -0,0 +1,28 @@
+/**
+ * @file MeshletBenchmark.h
+ * @brief メッシュレットの作成とカリングの検証
+ *
+ * エディタを --math-benchmark 引数付きで起動するとMathBenchmarkに続けて実行され、結果をログに出力する。
+ * 形の分かっているメッシュ（平面のグリッドと球）からメッシュレットを作り、分割・境界球・法線の円錐と、
+ * 視錐台・裏向きの判定結果を確かめる。メッシュレットごとに平面と円錐を判定する実装をscalarの欄に出す。
+ */
+
+#pragma once
+
+namespace AtomEngine
+{
+	/**
+	 * @class MeshletBenchmark
+	 * @brief メッシュレットの作成結果とカリングの速度・結果の確認
+	 */
+	class MeshletBenchmark
+	{
+	public:
+		/**
+		 * @brief 全ての計測と検証を行い、処理時間と結果をログに出力する
+		 * @param iterations 各計測の繰り返し回数
+		 * @return 全ての結果が期待どおりならtrue
+		 */
+		static bool Run(int iterations = 10);
+	};
+}
@@ -5,11 +5,24 @@
 #include "Runtime/Platform/DirectX12/Shader/ConstantBufferStructures.h"
 
 #include "../Core/Math/Frustum.h"
+#include "../Core/Math/BatchTransform.h"
+
+#include <algorithm>
+#include <utility>
 
 namespace AtomEngine
 {
+	namespace
+	{
+		/// メッシュレットのカリングで1つのサブメッシュから出す描画の最大数
+		constexpr size_t kMaxMeshletDrawsPerSubMesh = 8;
+
+		/// LODの選択で許す画面上の誤差（ピクセル）
+		constexpr float kMaxLodPixelError = 1.0f;
+	}
+
 	void Model::Render(RenderQueue& sorter, const GpuBuffer& meshConstants,
-		const std::vector<Matrix4x4> sphereTransforms, const JointXform* skeleton) const
+		const std::vector<Matrix4x4>& sphereTransforms, const JointXform* skeleton) const
 	{
 		Render(sorter, meshConstants, mMaterialConstants, sphereTransforms, skeleton);
 	}
@@ -18,18 +31,88 @@ namespace AtomEngine
 		RenderQueue& sorter,
 		const GpuBuffer& meshConstants,
 		const GpuBuffer& materialConstants,
-		const std::vector<Matrix4x4> sphereTransforms,
+		const std::vector<Matrix4x4>& sphereTransforms,
 		const JointXform* skeleton)const
 	{
-		const Frustum& frustum = sorter.GetViewFrustum();
 		const Matrix4x4& viewMat = sorter.GetViewMatrix();
 
+		// サブメッシュのワールド空間AABBをSoAに集めて、視錐台カリングをまとめて行う
+		// スキンメッシュはバインドポーズの境界ボックスが実際の姿勢を覆わないので判定しない
+		thread_local std::vector<AxisAlignedBox> localBoxes;
+		thread_local std::vector<uint32_t> matrixIndices;
+		thread_local std::vector<float> boxData;
+		thread_local std::vector<uint32_t> testMask;
+		thread_local std::vector<uint32_t> visibility;
+		thread_local std::vector<uint32_t> meshletVisibility;
+		thread_local std::vector<std::pair<uint32_t, uint32_t>> meshletRanges;     ///< (先頭のインデックス, インデックスの数)
+		thread_local std::vector<uint32_t> meshletGaps;
+
+		uint32_t subMeshCount = 0;
+		for (const Mesh& mesh : mMeshData)
+			subMeshCount += static_cast<uint32_t>(mesh.subMeshes.size());
+		if (subMeshCount == 0)
+			return;
+
+		const uint32_t maskWordCount = CullingPlanes::GetMaskWordCount(subMeshCount);
+		localBoxes.resize(subMeshCount);
+		matrixIndices.resize(subMeshCount);
+		boxData.resize(subMeshCount * 6);
+		testMask.assign(maskWordCount, 0);
+		visibility.resize(maskWordCount);
+
+		uint32_t flatIdx = 0;
+		for (const Mesh& mesh : mMeshData)
+		{
+			const bool skinned = mesh.numJoints > 0;
+			for (const SubMesh& sub : mesh.subMeshes)
+			{
+				const uint32_t i = flatIdx++;
+				matrixIndices[i] = sub.meshCbvIndex;
+
+				const Vector3 boundsMin = sub.bounds.GetMin();
+				const Vector3 boundsMax = sub.bounds.GetMax();
+				if (skinned || boundsMin.x > boundsMax.x)
+				{
+					localBoxes[i] = AxisAlignedBox(Vector3::ZERO, Vector3::ZERO);
+					continue;
+				}
+				localBoxes[i] = sub.bounds;
+				testMask[i >> 5] |= 1u << (i & 31);
+			}
+		}
+
+		float* centerX = boxData.data();
+		float* centerY = centerX + subMeshCount;
+		float* centerZ = centerY + subMeshCount;
+		float* extentX = centerZ + subMeshCount;
+		float* extentY = extentX + subMeshCount;
+		float* extentZ = extentY + subMeshCount;
+		BatchTransform::TransformAABBs(sphereTransforms.data(), matrixIndices.data(), localBoxes.data(),
+			{ centerX, centerY, centerZ }, { extentX, extentY, extentZ }, subMeshCount);
+
+		const BoxArrays boxes{ centerX, centerY, centerZ, extentX, extentY, extentZ };
+		sorter.GetCullingPlanes().CullBoxes(boxes, subMeshCount, visibility.data(), testMask.data());
+
+		// 判定しなかったものは常に可視
+		for (uint32_t w = 0; w < maskWordCount; ++w)
+			visibility[w] |= ~testMask[w];
+
+		D3D12_VERTEX_BUFFER_VIEW vertexStreams[kNumVertexStreams] = {};
+		vertexStreams[kPositionStream] = mPositionBuffer.VertexBufferView();
+		vertexStreams[kAttributeStream] = mAttributeBuffer.VertexBufferView();
+		if (mSkinBuffer.GetGpuVirtualAddress() != D3D12_GPU_VIRTUAL_ADDRESS_NULL)
+			vertexStreams[kSkinStream] = mSkinBuffer.VertexBufferView();
+
+		flatIdx = 0;
 		for (size_t meshIdx = 0; meshIdx < mMeshData.size(); ++meshIdx)
 		{
 			const Mesh& mesh = mMeshData[meshIdx];
 			for (uint32_t subIdx = 0; subIdx < mesh.subMeshes.size(); ++subIdx)
 			{
 				const SubMesh& sub = mesh.subMeshes[subIdx];
+				const uint32_t boxIdx = flatIdx++;
+				if (!CullingPlanes::IsVisible(visibility.data(), boxIdx))
+					continue;
 
 				const Matrix4x4& sphereXform = sphereTransforms[sub.meshCbvIndex];
 				float scaleXSqr = sphereXform.GetX().LengthSqr();
@@ -38,7 +121,7 @@ namespace AtomEngine
 				float sphereScale = Math::Sqrt(Math::Max(Math::Max(scaleXSqr, scaleYSqr), scaleZSqr));
 				auto translate = sphereXform.GetTrans();
 
-				BoundingSphere sphereLS = mBoundingSphere;
+				const BoundingSphere& sphereLS = sub.sphere;
 				BoundingSphere sphereWS = BoundingSphere(
 					sphereLS.GetCenter() * sphereXform,
 					sphereScale * sphereLS.GetRadius()
@@ -48,10 +131,6 @@ namespace AtomEngine
 					sphereWS.GetRadius() + 1.0f
 				);
 
-				// TODO: ReverseZ 対応
-				//if (!frustum.IntersectSphere(sphereVS))
-				//	continue;
-				
 				// 距離計算。Reverse Z の場合は注意が必要かもしれないが、
 				// z はView空間のz座標なので、通常は負値のはず。GetCenter().z はカメラ前方の距離。
 				// 単純なソート用距離としては、Z値をそのまま使うか、カメラからの距離を使う。
@@ -64,17 +143,97 @@ namespace AtomEngine
 				D3D12_GPU_VIRTUAL_ADDRESS materialCBV =
 					materialConstants.GetGpuVirtualAddress() + sub.materialIndex * sizeof(MaterialConstants);
 
-				sorter.AddMesh(mesh, skeleton,
-					mVertexBuffer.VertexBufferView(),
-					mIndexBuffer.IndexBufferView(),
-					meshCBV, materialCBV, distance, subIdx);
+				// 画面上の誤差が許容値以下の最も粗いLODを選ぶ。距離はワールドの境界ボックスの最も近いところまでで測る
+				uint32_t lod = 0;
+				if (sub.lodCount > 1)
+				{
+					const Vector3 boxCenter(centerX[boxIdx], centerY[boxIdx], centerZ[boxIdx]);
+					const float boxRadius = Vector3(extentX[boxIdx], extentY[boxIdx], extentZ[boxIdx]).Length();
+					const float nearest = Math::Max((boxCenter - sorter.GetViewPosition()).Length() - boxRadius, 0.0f);
+					lod = sub.SelectLod(sphereScale * sorter.GetPixelsPerUnit(nearest), kMaxLodPixelError);
+				}
+				const MeshLod range = sub.GetLod(lod);
+
+				auto addDraw = [&](uint32_t firstIndex, uint32_t indexCount)
+					{
+						sorter.AddMesh(mesh, skeleton,
+							vertexStreams,
+							mIndexBuffer.IndexBufferView(range.indexByteOffset + firstIndex * sub.indexSize, indexCount * sub.indexSize, sub.indexSize == sizeof(uint32_t)),
+							indexCount, meshCBV, materialCBV, distance, subIdx);
+					};
+
+				// スキンメッシュはバインドポーズのメッシュレットの境界が使えないのでまとめて描く。
+				// メッシュレットはLOD0のインデックスの範囲なので、粗いLODもまとめて描く
+				if (lod > 0 || mesh.numJoints > 0 || sub.meshletCount <= 1)
+				{
+					addDraw(0, range.indexCount);
+					continue;
+				}
+
+				// メッシュレットをローカル空間で判定し、見える範囲だけを描く
+				Vector3 localViewPosition;
+				BatchTransform::TransformPoints(sphereXform.Inverse(), &sorter.GetViewPosition(), &localViewPosition, 1);
+				meshletVisibility.resize(CullingPlanes::GetMaskWordCount(sub.meshletCount));
+				const uint32_t visibleCount = MeshletCulling::Cull(mMeshletBounds.data() + sub.meshletOffset, sub.meshletCount,
+					sorter.GetLocalCullingPlanes(sphereXform),
+					sorter.IsBackfaceCullingEnabled() ? &localViewPosition : nullptr,
+					meshletVisibility.data());
+				if (visibleCount == 0)
+					continue;
+				if (visibleCount == sub.meshletCount)
+				{
+					addDraw(0, sub.indexCount);
+					continue;
+				}
+
+				// 連続して見えるメッシュレットを1つの範囲にまとめる
+				meshletRanges.clear();
+				const Meshlet* meshlets = mMeshlets.data() + sub.meshletOffset;
+				for (uint32_t m = 0; m < sub.meshletCount; ++m)
+				{
+					if (!CullingPlanes::IsVisible(meshletVisibility.data(), m))
+						continue;
+
+					const uint32_t first = meshlets[m].triangleOffset * 3;
+					const uint32_t count = meshlets[m].triangleCount * 3u;
+					if (!meshletRanges.empty() && meshletRanges.back().first + meshletRanges.back().second == first)
+						meshletRanges.back().second += count;
+					else
+						meshletRanges.emplace_back(first, count);
+				}
+
+				// 描画の数が多すぎる場合は、間の短い範囲同士を見えないメッシュレットごとつなげる
+				if (meshletRanges.size() > kMaxMeshletDrawsPerSubMesh)
+				{
+					meshletGaps.resize(meshletRanges.size() - 1);
+					for (uint32_t r = 0; r + 1 < meshletRanges.size(); ++r)
+						meshletGaps[r] = r;
+					auto gapSize = [&](uint32_t r) { return meshletRanges[r + 1].first - (meshletRanges[r].first + meshletRanges[r].second); };
+					std::stable_sort(meshletGaps.begin(), meshletGaps.end(), [&](uint32_t a, uint32_t b) { return gapSize(a) > gapSize(b); });
+					meshletGaps.resize(kMaxMeshletDrawsPerSubMesh - 1);
+					std::sort(meshletGaps.begin(), meshletGaps.end());
+
+					uint32_t first = meshletRanges.front().first;
+					for (uint32_t split : meshletGaps)
+					{
+						addDraw(first, meshletRanges[split].first + meshletRanges[split].second - first);
+						first = meshletRanges[split + 1].first;
+					}
+					addDraw(first, meshletRanges.back().first + meshletRanges.back().second - first);
+					continue;
+				}
+
+				for (const auto& [first, count] : meshletRanges)
+					addDraw(first, count);
 			}
 		}
 	}
 
 	void Model::Destroy()
 	{
-		mVertexBuffer.Destroy();
+		mPositionBuffer.Destroy();
+		mAttributeBuffer.Destroy();
+		mSkinBuffer.Destroy();
 		mIndexBuffer.Destroy();
 		mMaterialConstants.Destroy();
 		mTextures.clear();
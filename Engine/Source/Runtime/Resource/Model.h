@@ -1,5 +1,6 @@
 #pragma once
 #include "Mesh.h"
+#include "Meshlet.h"
 #include "Animation.h"
 #include "TextureRef.h"
 #include "Material.h"
@@ -12,6 +13,9 @@
 #include "../Core/Math/BoundingBox.h"
 #include "../Core/Math/BoundingSphere.h"
 
+#include "../Function/Animation/AnimationCompression.h"
+#include "../Function/Animation/CpuSkinning.h"
+
 #include <span>
 #include <map>
 
@@ -19,12 +23,6 @@ namespace AtomEngine
 {
 	class RenderQueue;
 
-	struct JointXform
-	{
-		Matrix4x4 posXform;
-		Matrix4x4 nrmXform;
-	};
-
 	struct GraphNode
 	{
 		Matrix4x4 xform;
@@ -45,28 +43,36 @@ namespace AtomEngine
 		
 		void Render(RenderQueue& sorter,
 			const GpuBuffer& meshConstants,
-			const std::vector<Matrix4x4> sphereTransforms,
+			const std::vector<Matrix4x4>& sphereTransforms,
 			const JointXform* skeleton) const;
 
 		void Render(RenderQueue& sorter,
 			const GpuBuffer& meshConstants,
 			const GpuBuffer& materialConstants,
-			const std::vector<Matrix4x4> sphereTransforms,
+			const std::vector<Matrix4x4>& sphereTransforms,
 			const JointXform* skelton)const;
 
 		BoundingSphere mBoundingSphere;
 		AxisAlignedBox mBoundingBox;
 
-		ByteAddressBuffer mVertexBuffer;
+		ByteAddressBuffer mPositionBuffer;     ///< 位置ストリーム（PositionVertex）
+		ByteAddressBuffer mAttributeBuffer;    ///< 属性ストリーム（AttributeVertex）
+		ByteAddressBuffer mSkinBuffer;         ///< スキンストリーム（JointVertex、スキンありのモデルだけ）
 		ByteAddressBuffer mIndexBuffer;
 		ByteAddressBuffer mMaterialConstants;
 
 		std::vector<Material> mMaterials;
 		std::map<uint32_t,std::vector<TextureRef>> mTextures;
 		std::vector<Mesh> mMeshData;
+		std::vector<Meshlet> mMeshlets;             ///< 全サブメッシュのメッシュレット（SubMesh::meshletOffsetから）
+		std::vector<MeshletBounds> mMeshletBounds;  ///< mMeshletsと同じ並び
 		std::vector<uint8_t> mKeyFrameData;
 		std::vector<AnimationClip> mAnimationData;
+		std::vector<CompressedAnimationClip> mCompressedAnimations;    ///< mAnimationDataと同じ並び（無効なものは元のキーを使う）
 		std::vector<Matrix4x4>mJointIBMs;
+		SkinningVertices mSkinningVertices;         ///< CPUスキニング用のバインドポーズの位置と法線（スキンありのモデルだけ）
+		std::vector<JointVertex> mSkinningJoints;   ///< CPUスキニング用のスキンストリーム（mSkinningVerticesと同じ並び）
+		std::vector<JointPose> mBindPose;    ///< スケルトンのバインドポーズ（ブレンドの基準）
 		std::vector<GraphNode> mSceneGraph;
 
 		Skeleton mSkeleton;
@@ -1,4 +1,7 @@
 #include "ModelLoader.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "Runtime/Core/Math/BoundingVolumeBuilder.h"
 #include <map>
 
 namespace AtomEngine
@@ -96,12 +99,20 @@ namespace AtomEngine
 		model.vertices.clear();
 		model.indices.clear();
 		model.rootNode = ProcessNode(model, scene->mRootNode, scene, nullptr);
+		Log("Vertex cache: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f (%llu triangles): %s",
+			model.vertexCacheBefore.GetACMR(), model.vertexCacheAfter.GetACMR(),
+			model.vertexCacheBefore.GetATVR(), model.vertexCacheAfter.GetATVR(),
+			static_cast<unsigned long long>(model.vertexCacheAfter.triangleCount), filePath.c_str());
 		if (model.armatureNode)
 			model.skeleton = ProcessSkeleton(model, model.armatureNode);
+		ProcessSkin(model);
 
 		//アニメーションをプロセス
 		if (scene->HasAnimations())
+		{
 			ProcessAnimations(model, scene);
+			CompressAnimations(model);
+		}
 		//バウンディングボックスを計算
 		ComputeBoundingVolumes(model);
 
@@ -156,7 +167,6 @@ namespace AtomEngine
 		return outNode;
 	}
 
-	std::map<std::string, uint16_t> mJointNameToIndex;
 	Mesh ModelLoader::ProcessMesh(ModelData& model, aiMesh* mesh)
 	{
 		Mesh outMesh;
@@ -169,7 +179,6 @@ namespace AtomEngine
 		model.vertices.reserve(model.vertices.size() + outMesh.vertexCount);
 		model.indices.reserve(model.indices.size() + outMesh.indexCount);
 
-		AxisAlignedBox aabb;
 		for (uint32_t i = 0; i < mesh->mNumVertices; i++)
 		{
 			Vertex v = {};
@@ -196,7 +205,6 @@ namespace AtomEngine
 				v.bitangent = { 0.0f, 0.0f, 0.0f };
 			}
 
-			aabb.AddPoint(v.position);
 			model.vertices.push_back(v);
 		}
 
@@ -208,6 +216,14 @@ namespace AtomEngine
 				model.indices.push_back(static_cast<uint32_t>(face.mIndices[j]));
 		}
 
+		// 頂点キャッシュ・オーバードロー・頂点フェッチの順に並べ替える（ウェイトは並べ替えた後の頂点番号で持つ）
+		std::vector<uint32_t> vertexRemap;
+		VertexCacheStatistics cacheBefore, cacheAfter;
+		MeshOptimizer::Optimize(model.indices.data() + indexBase, outMesh.indexCount,
+			model.vertices.data() + vertexBase, outMesh.vertexCount, vertexRemap, &cacheBefore, &cacheAfter);
+		model.vertexCacheBefore += cacheBefore;
+		model.vertexCacheAfter += cacheAfter;
+
 		if (mesh->HasBones())
 		{
 			outMesh.numJoints = mesh->mNumBones;
@@ -216,31 +232,38 @@ namespace AtomEngine
 			for (uint32_t b = 0; b < mesh->mNumBones; ++b)
 			{
 				aiBone* bone = mesh->mBones[b];
-				aiNode* node = bone->mNode;
+				const aiNode* node = bone->mNode;
 				model.armatureNode = bone->mArmature;
 
-				std::string jointName = node->mName.C_Str();
-				JointWeightData& jwd = model.skinClusterData[jointName];
-				// inverse bind pose
-				aiMatrix4x4 m = bone->mOffsetMatrix;
-				aiVector3D s, t; aiQuaternion r;
-				m.Decompose(s, r, t);
-				jwd.inverseBindPoseMatrix.MakeAffine(
-					{ s.x, s.y, s.z }, { r.x, r.y, r.z, r.w }, { t.x, t.y, t.z });
+				// ボーンはノードで見分ける（複数のメッシュが同じボーンを参照する）
+				auto [it, inserted] = model.boneIndices.emplace(node, static_cast<uint32_t>(model.boneNodes.size()));
+				const uint32_t boneIndex = it->second;
+				if (inserted)
+				{
+					// inverse bind pose
+					aiMatrix4x4 m = bone->mOffsetMatrix;
+					aiVector3D s, t; aiQuaternion r;
+					m.Decompose(s, r, t);
+					Matrix4x4 inverseBindPose;
+					inverseBindPose.MakeAffine(
+						{ s.x, s.y, s.z }, { r.x, r.y, r.z, r.w }, { t.x, t.y, t.z });
+					model.boneNodes.push_back(node);
+					model.boneInverseBindPoses.push_back(inverseBindPose);
+				}
 
 				for (uint32_t w = 0; w < bone->mNumWeights; ++w)
 				{
 					uint32_t localId = bone->mWeights[w].mVertexId;
 					float weight = bone->mWeights[w].mWeight;
-					// ローカル頂点IDをグローバル頂点IDへ変換
-					uint32_t globalId = vertexBase + localId;
-					jwd.vertexWeights.push_back({ weight, globalId });
+					if (localId >= outMesh.vertexCount)
+						continue;
+					// ローカル頂点IDを並べ替え後のグローバル頂点IDへ変換
+					uint32_t globalId = vertexBase + vertexRemap[localId];
+					model.skinInfluences.push_back({ globalId, boneIndex, weight });
 				}
 			}
 		}
 
-		outMesh.boundingBox = aabb;
-
 		if (mesh->mMaterialIndex >= 0 && mesh->mMaterialIndex < model.materials.size())
 		{
 			const Material& mat = model.materials[mesh->mMaterialIndex];
@@ -255,15 +278,22 @@ namespace AtomEngine
 		sub.vertexCount = outMesh.vertexCount;
 		sub.materialIndex = mesh->mMaterialIndex;
 
-		AxisAlignedBox subBounds;
-		for (uint32_t i = 0; i < sub.indexCount; ++i)
-		{
-			uint32_t index = model.indices[sub.indexOffset + i];
-			subBounds.AddPoint(model.vertices[index].position);
-		}
-		sub.bounds = subBounds;
+		// 並べ替えた後の三角形の順でメッシュレットに分ける
+		sub.meshletOffset = static_cast<uint32_t>(model.meshlets.size());
+		MeshletBuilder::Build(model.indices.data() + indexBase, outMesh.indexCount,
+			model.vertices.data() + vertexBase, outMesh.vertexCount, model.meshlets, model.meshletBounds);
+		sub.meshletCount = static_cast<uint32_t>(model.meshlets.size()) - sub.meshletOffset;
+
+		// LOD1以降のインデックスはLOD0の後ろに置く。スキンありは関節をまたいで縮約すると変形が崩れるのでLOD0だけ
+		if (!mesh->HasBones())
+			MeshSimplifier::GenerateLods(model.indices, sub, model.vertices.data() + vertexBase);
+
+		// 境界は頂点配列を直接読んで求める（ローカル空間）
+		const PointArray points(&model.vertices[vertexBase].position, sizeof(Vertex), sub.vertexCount);
+		sub.bounds = BoundingVolumeBuilder::ComputeBox(points);
+		sub.sphere = BoundingVolumeBuilder::ComputeSphere(points);
+		outMesh.boundingBox = sub.bounds;
 		outMesh.subMeshes.push_back(sub);
-		outMesh.boundingBox.AddBoundingBox(subBounds);
 
 		return outMesh;
 	}
@@ -367,9 +397,39 @@ namespace AtomEngine
 		}
 	}
 
+	void ModelLoader::CompressAnimations(ModelData& model)
+	{
+		model.compressedAnimations.clear();
+		model.compressedAnimations.resize(model.animations.size());
+
+		for (size_t i = 0; i < model.animations.size(); ++i)
+		{
+			AnimationClip& clip = model.animations[i];
+			if (!model.compressedAnimations[i].Compress(clip))
+			{
+				// 許容誤差に収まらないクリップは元のキーフレームのまま使う
+				Log("Animation compression exceeded tolerance, keeping source keys: %s", clip.name.c_str());
+				continue;
+			}
+			// キーがもともと疎なクリップはリサンプリングすると大きくなる
+			if (model.compressedAnimations[i].GetMemorySize() >= CompressedAnimationClip::GetSourceMemorySize(clip))
+			{
+				Log("Animation compression did not reduce size, keeping source keys: %s", clip.name.c_str());
+				model.compressedAnimations[i] = CompressedAnimationClip();
+				continue;
+			}
+
+			// 名前と長さだけ残してキーフレームは解放する
+			clip.curves.clear();
+			clip.curves.shrink_to_fit();
+		}
+	}
+
 	Skeleton ModelLoader::ProcessSkeleton(ModelData& model, const aiNode* rootNode)
 	{
 		Skeleton skeleton;
+		model.boneJoints.assign(model.boneNodes.size(), UINT32_MAX);
+		model.jointIBMs.clear();
 
 		// rootNode 自体がボーンでない場合もあるので、CreateJoint は該当ノードがボーンでなければ -1 を返します。
 		int32_t rootIdx = CreateJoint(model, rootNode, std::nullopt, skeleton.joints);
@@ -383,6 +443,67 @@ namespace AtomEngine
 		return skeleton;
 	}
 
+	void ModelLoader::ProcessSkin(ModelData& model)
+	{
+		model.jointVertices.clear();
+		if (model.boneNodes.empty())
+			return;
+
+		const uint32_t jointCount = static_cast<uint32_t>(model.skeleton.joints.size());
+		if (jointCount == 0 || model.boneJoints.size() != model.boneNodes.size())
+		{
+			// スケルトンが作れなければスキンなしとして描く
+			Log("Skin has no skeleton, drawing it unskinned");
+			for (Mesh& mesh : model.meshes)
+			{
+				mesh.psoFlags &= ~kHasSkin;
+				mesh.numJoints = 0;
+			}
+			return;
+		}
+
+		// ボーン番号をジョイント番号に付け替える（スケルトンに入らなかったボーンはjointCountになり、Packで捨てる）
+		for (SkinInfluence& influence : model.skinInfluences)
+			influence.joint = std::min(model.boneJoints[influence.joint], jointCount);
+
+		SkinPackingStatistics stats;
+		SkinPacking::Pack(model.skinInfluences.data(), model.skinInfluences.size(),
+			static_cast<uint32_t>(model.vertices.size()), jointCount,
+			static_cast<uint32_t>(std::max(model.skeleton.rootJoint, 0)), model.jointVertices, &stats);
+		if (stats.truncatedVertices > 0 || stats.droppedInfluences > 0)
+		{
+			Log("Skin: %u vertices over %u influences (max %u, dropped weight up to %.1f%%), %u invalid influences",
+				stats.truncatedVertices, SkinPacking::kMaxInfluences, stats.maxInfluences,
+				stats.maxDroppedWeight * 100.0f, stats.droppedInfluences);
+		}
+
+		// パレットはジョイント0から、メッシュの頂点が参照する最大の番号までを送る
+		for (Mesh& mesh : model.meshes)
+		{
+			if (!(mesh.psoFlags & kHasSkin))
+				continue;
+
+			uint32_t maxJoint = 0;
+			for (const SubMesh& sub : mesh.subMeshes)
+			{
+				for (uint32_t v = sub.vertexOffset; v < sub.vertexOffset + sub.vertexCount; ++v)
+				{
+					const JointVertex& vertex = model.jointVertices[v];
+					for (uint32_t k = 0; k < SkinPacking::kMaxInfluences; ++k)
+					{
+						if (vertex.weights[k] > 0)
+							maxJoint = std::max<uint32_t>(maxJoint, vertex.jointIndices[k]);
+					}
+				}
+			}
+			mesh.startJoint = 0;
+			mesh.numJoints = maxJoint + 1;
+		}
+
+		model.skinInfluences.clear();
+		model.skinInfluences.shrink_to_fit();
+	}
+
 	int32_t ModelLoader::CreateJoint(
 		ModelData& model,
 		const aiNode* node,
@@ -390,7 +511,8 @@ namespace AtomEngine
 		std::vector<Joint>& joints)
 	{
 		std::string nodeName = node->mName.C_Str();
-		bool isBone = (model.skinClusterData.find(nodeName) != model.skinClusterData.end());
+		auto boneIt = model.boneIndices.find(node);
+		bool isBone = boneIt != model.boneIndices.end();
 
 		int32_t myIndex = -1;
 
@@ -408,6 +530,8 @@ namespace AtomEngine
 
 			joints.push_back(joint);
 			myIndex = joint.index;
+			model.boneJoints[boneIt->second] = static_cast<uint32_t>(myIndex);
+			model.jointIBMs.push_back(model.boneInverseBindPoses[boneIt->second]);
 		}
 
 		std::optional<int32_t> childParent = isBone ? std::optional<int32_t>(myIndex) : parentJointIndex;
@@ -425,49 +549,35 @@ namespace AtomEngine
 		return myIndex;
 	}
 
-	float ComputeBoundingSphereRadius(const AxisAlignedBox& box, const std::vector<Vector3>& vertices)
+	void ModelLoader::ComputeBoundingVolumes(ModelData& model)
 	{
-		Vector3 center = box.GetCenter();
-		float radius = 0.0f;
-		for (const auto& v : vertices)
+		if (!model.rootNode)
+			return;
+
+		// ノードのグローバル行列で変換した頂点をまとめて囲む（メッシュの箱を変換して足すより小さくなる）
+		std::vector<PointArray> arrays;
+		std::vector<const Node*> stack = { model.rootNode.get() };
+		while (!stack.empty())
 		{
-			float dist = (v - center).Length();
-			radius = std::max(radius, dist);
-		}
-		return radius;
-	}
+			const Node* node = stack.back();
+			stack.pop_back();
 
-	void ModelLoader::ComputeBoundingVolumes(ModelData& model)
-	{
-		std::function<AxisAlignedBox(const Node*, const Matrix4x4&)> computeBounds =
-			[&](const Node* node, const Matrix4x4& parentTransform) -> AxisAlignedBox
+			for (uint32_t meshIdx : node->meshIndices)
 			{
-				Matrix4x4 localTransform = node->transform.GetMatrix() * parentTransform;
-				AxisAlignedBox bounds;
-
-				for (auto meshIdx : node->meshIndices)
+				for (const SubMesh& sub : model.meshes[meshIdx].subMeshes)
 				{
-					const auto& mesh = model.meshes[meshIdx];
-					AxisAlignedBox transformedBox = mesh.boundingBox;
-					transformedBox.Transform(localTransform);
-					bounds.AddBoundingBox(transformedBox);
+					if (sub.vertexCount == 0)
+						continue;
+					arrays.emplace_back(&model.vertices[sub.vertexOffset].position, sizeof(Vertex),
+						sub.vertexCount, &node->globalTransform);
 				}
+			}
 
-				for (auto& child : node->children)
-					bounds.AddBoundingBox(computeBounds(child.get(), localTransform));
-
-				return bounds;
-			};
-
-		if (model.rootNode)
-		{
-			model.boundingBox = computeBounds(model.rootNode.get(), Matrix4x4::IDENTITY);
-			std::vector<Vector3> allVertices;
-			for (auto& v : model.vertices)
-				allVertices.push_back(v.position);
-			float radius = ComputeBoundingSphereRadius(model.boundingBox, allVertices);
-
-			model.boundingSphere = BoundingSphere(model.boundingBox.GetCenter(), radius);
+			for (const auto& child : node->children)
+				stack.push_back(child.get());
 		}
+
+		model.boundingBox = BoundingVolumeBuilder::ComputeBox(arrays.data(), arrays.size());
+		model.boundingSphere = BoundingVolumeBuilder::ComputeSphere(arrays.data(), arrays.size());
 	}
 }
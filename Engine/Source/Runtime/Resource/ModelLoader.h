@@ -2,10 +2,14 @@
 #include "Model.h"
 #include "Animation.h"
 #include "Material.h"
+#include "MeshOptimizer.h"
+#include "Meshlet.h"
 #include "Skeleton.h"
+#include "SkinPacking.h"
 
 #include <map>
 #include <optional>
+#include <unordered_map>
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -33,10 +37,24 @@ namespace AtomEngine
         std::vector<Mesh> meshes;
 
         std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
+        std::vector<uint32_t> indices;     ///< サブメッシュの頂点範囲の先頭からの番号
+        VertexCacheStatistics vertexCacheBefore;    ///< MeshOptimizerで並べ替える前（全サブメッシュの合計）
+        VertexCacheStatistics vertexCacheAfter;
+        std::vector<Meshlet> meshlets;              ///< 全サブメッシュのメッシュレット（SubMesh::meshletOffsetから）
+        std::vector<MeshletBounds> meshletBounds;   ///< meshletsと同じ並び
 
         std::vector<AnimationClip> animations;
-        std::map<std::string, JointWeightData> skinClusterData;
+        std::vector<CompressedAnimationClip> compressedAnimations;  ///< animationsと同じ並び（圧縮できなかったものは空）
+
+        // スキン。インポート中はボーン（スキンが参照するノード）の番号で持ち、スケルトンを作った後にジョイント番号の配列にする
+        std::vector<const aiNode*> boneNodes;                       ///< ボーン番号順
+        std::vector<Matrix4x4> boneInverseBindPoses;                ///< boneNodesと同じ並び
+        std::unordered_map<const aiNode*, uint32_t> boneIndices;    ///< ノードからボーン番号
+        std::vector<uint32_t> boneJoints;                           ///< ボーン番号からジョイント番号（スケルトンを作るときに決まる）
+        std::vector<SkinInfluence> skinInfluences;                  ///< jointはボーン番号
+        std::vector<JointVertex> jointVertices;     ///< verticesと同じ並び（スキンなしのモデルでは空）
+        std::vector<Matrix4x4> jointIBMs;           ///< ジョイント番号順の逆バインド行列
+
         std::unique_ptr<Node> rootNode = nullptr;
         
         aiNode* armatureNode = nullptr;
@@ -57,7 +75,9 @@ namespace AtomEngine
         static Mesh ProcessMesh(ModelData& model, aiMesh* mesh);
         static void ProcessMaterial(ModelData& model, aiMaterial* mat);
         static void ProcessAnimations(ModelData& model, const aiScene* scene);
+        static void CompressAnimations(ModelData& model);
         static Skeleton ProcessSkeleton(ModelData& model,const aiNode* rootNode);
+        static void ProcessSkin(ModelData& model);
         static int32_t CreateJoint(
             ModelData& model,
             const aiNode* node,
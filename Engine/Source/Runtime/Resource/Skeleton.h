@@ -6,10 +6,18 @@
 namespace AtomEngine
 {
 
+    /// スキンストリーム（WEIGHTがR16G16B16A16_UNORM、INDEXがR16G16B16A16_UINT）。SkinPackingで作る
     struct JointVertex
     {
-        float weights[4];
-        uint32_t jointIndices[4];
+        uint16_t weights[4];        ///< 大きい順。和は65535
+        uint16_t jointIndices[4];   ///< スケルトンのジョイント番号（ウェイト0のスロットは0）
+    };
+
+    /// スキニング行列（逆バインド行列 * スケルトン空間の行列）。シェーダーのパレットと同じ並び
+    struct JointXform
+    {
+        Matrix4x4 posXform;
+        Matrix4x4 nrmXform;     ///< posXformの逆転置（法線用）
     };
 
     struct Joint
@@ -29,18 +37,6 @@ namespace AtomEngine
         std::vector<Joint> joints;
         std::unordered_map<std::string, int32_t> jointMap;
     };
-
-    struct VertexWeightData
-    {
-        float weight;
-        uint32_t vertexIndex;
-    };
-
-    struct JointWeightData
-    {
-        Matrix4x4 inverseBindPoseMatrix;
-        std::vector<VertexWeightData> vertexWeights;
-    };
 }
 
 
@@ -0,0 +1,114 @@
+#include "SkinPacking.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AtomEngine
+{
+	void SkinPacking::Pack(const SkinInfluence* influences, size_t count, uint32_t vertexCount, uint32_t jointCount,
+		uint32_t fallbackJoint, std::vector<JointVertex>& out, SkinPackingStatistics* statistics)
+	{
+		SkinPackingStatistics stats;
+		out.assign(vertexCount, JointVertex{});
+		jointCount = std::min(jointCount, kMaxJoints);
+
+		// 頂点ごとに並べる（数えてから詰める）
+		std::vector<uint32_t> offsets(vertexCount + 1, 0);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const SkinInfluence& influence = influences[i];
+			if (influence.vertex < vertexCount && influence.joint < jointCount && influence.weight > 0.0f)
+				++offsets[influence.vertex + 1];
+			else
+				++stats.droppedInfluences;
+		}
+		for (uint32_t v = 0; v < vertexCount; ++v)
+			offsets[v + 1] += offsets[v];
+
+		std::vector<SkinInfluence> sorted(offsets[vertexCount]);
+		{
+			std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const SkinInfluence& influence = influences[i];
+				if (influence.vertex < vertexCount && influence.joint < jointCount && influence.weight > 0.0f)
+					sorted[fill[influence.vertex]++] = influence;
+			}
+		}
+
+		for (uint32_t v = 0; v < vertexCount; ++v)
+		{
+			JointVertex& vertex = out[v];
+			SkinInfluence* first = sorted.data() + offsets[v];
+			SkinInfluence* last = sorted.data() + offsets[v + 1];
+			if (first == last)
+			{
+				vertex.jointIndices[0] = static_cast<uint16_t>(fallbackJoint < jointCount ? fallbackJoint : 0);
+				vertex.weights[0] = kWeightScale;
+				++stats.unweightedVertices;
+				continue;
+			}
+
+			// 同じジョイントへの影響をまとめてから、ウェイトの大きい順に並べる
+			std::sort(first, last, [](const SkinInfluence& a, const SkinInfluence& b) { return a.joint < b.joint; });
+			SkinInfluence* end = first;
+			for (SkinInfluence* it = first + 1; it != last; ++it)
+			{
+				if (it->joint == end->joint)
+					end->weight += it->weight;
+				else
+					*++end = *it;
+			}
+			++end;
+			std::sort(first, end, [](const SkinInfluence& a, const SkinInfluence& b)
+				{
+					return a.weight != b.weight ? a.weight > b.weight : a.joint < b.joint;
+				});
+
+			const uint32_t influenceCount = static_cast<uint32_t>(end - first);
+			const uint32_t keptCount = std::min(influenceCount, kMaxInfluences);
+			stats.maxInfluences = std::max(stats.maxInfluences, influenceCount);
+
+			double total = 0.0;
+			double kept = 0.0;
+			for (uint32_t k = 0; k < influenceCount; ++k)
+			{
+				total += first[k].weight;
+				if (k < keptCount)
+					kept += first[k].weight;
+			}
+			if (influenceCount > kMaxInfluences)
+			{
+				++stats.truncatedVertices;
+				stats.maxDroppedWeight = std::max(stats.maxDroppedWeight, static_cast<float>((total - kept) / total));
+			}
+
+			// 切り捨ててから、端数の大きいスロットに残りを1ずつ配って和を65535にする
+			double fractions[kMaxInfluences] = {};
+			uint32_t sum = 0;
+			for (uint32_t k = 0; k < keptCount; ++k)
+			{
+				const double scaled = first[k].weight / kept * kWeightScale;
+				const double floored = std::floor(scaled);
+				vertex.jointIndices[k] = static_cast<uint16_t>(first[k].joint);
+				vertex.weights[k] = static_cast<uint16_t>(floored);
+				fractions[k] = scaled - floored;
+				sum += vertex.weights[k];
+			}
+			for (uint32_t remainder = kWeightScale - std::min(sum, kWeightScale); remainder > 0; --remainder)
+			{
+				uint32_t best = 0;
+				for (uint32_t k = 1; k < keptCount; ++k)
+				{
+					if (fractions[k] > fractions[best])
+						best = k;
+				}
+				++vertex.weights[best];
+				fractions[best] = -1.0;
+			}
+		}
+
+		if (statistics)
+			*statistics = stats;
+	}
+}
@@ -0,0 +1,77 @@
+/**
+ * @file SkinPacking.h
+ * @brief インポートしたスキンのウェイトを、頂点ごとに固定4スロットのスキンストリームへ詰める
+ *
+ * JointVertex（16バイト）の形にする。
+ * - 同じジョイントへの影響はまとめ、ウェイトの大きい順に並べる（同じならジョイント番号の小さい順）
+ * - 5つ目以降の影響は捨て、残りのウェイトの和が1になるよう正規化する
+ * - ウェイトは16bit正規化で、和がちょうど65535になるよう丸める（シェーダーでの正規化が要らない）
+ * - 影響のない頂点は代わりのジョイント（スケルトンのルート）に全て割り当てる
+ * GPUのスキニングとCPUのスキニングは同じストリームを読む。
+ */
+
+#pragma once
+#include "Skeleton.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AtomEngine
+{
+	/**
+	 * @struct SkinInfluence
+	 * @brief 1つのジョイントから1つの頂点への影響（インポート時の形）
+	 */
+	struct SkinInfluence
+	{
+		uint32_t vertex = 0;
+		uint32_t joint = 0;
+		float weight = 0.0f;
+	};
+
+	/**
+	 * @struct SkinPackingStatistics
+	 * @brief 詰めたときに失われた情報
+	 */
+	struct SkinPackingStatistics
+	{
+		uint32_t truncatedVertices = 0;     ///< 影響が4つを超えていた頂点の数
+		uint32_t unweightedVertices = 0;    ///< 影響がなく代わりのジョイントに割り当てた頂点の数
+		uint32_t droppedInfluences = 0;     ///< 範囲外の頂点・ジョイント、0以下のウェイトで捨てた影響の数
+		uint32_t maxInfluences = 0;         ///< 1頂点の影響の最大数（まとめた後）
+		float maxDroppedWeight = 0.0f;      ///< 5つ目以降で捨てたウェイトの和の最大値（正規化前の和に対する割合）
+	};
+
+	/**
+	 * @class SkinPacking
+	 * @brief スキンストリームの作成と復元
+	 */
+	class SkinPacking
+	{
+	public:
+		static constexpr uint32_t kMaxInfluences = 4;
+		static constexpr uint32_t kWeightScale = 65535;
+		static constexpr uint32_t kMaxJoints = 0x10000;     ///< ジョイント番号は16bit
+
+		/**
+		 * @brief 影響を頂点ごとに詰める
+		 * @param influences 影響（順不同）
+		 * @param count 影響の数
+		 * @param vertexCount 頂点の数
+		 * @param jointCount ジョイントの数（これ以上の番号の影響は捨てる）
+		 * @param fallbackJoint 影響のない頂点に割り当てるジョイント
+		 * @param out 出力（vertexCount要素）
+		 * @param statistics 失われた情報（不要ならnullptr）
+		 */
+		static void Pack(const SkinInfluence* influences, size_t count, uint32_t vertexCount, uint32_t jointCount,
+			uint32_t fallbackJoint, std::vector<JointVertex>& out, SkinPackingStatistics* statistics = nullptr);
+
+		/// ウェイトを復元する（和は1）
+		static void DecodeWeights(const JointVertex& vertex, float (&weights)[kMaxInfluences])
+		{
+			for (uint32_t k = 0; k < kMaxInfluences; ++k)
+				weights[k] = static_cast<float>(vertex.weights[k]) * (1.0f / kWeightScale);
+		}
+	};
+}
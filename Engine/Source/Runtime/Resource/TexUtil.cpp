@@ -1,40 +1,195 @@
 #include "TexUtil.h"
 #include "../Core/Utility/Utility.h"
+#include "../Core/Job/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
 
 #define GetFlag(f) ((Flags & f) != 0)
 
 using namespace DirectX;
 
+namespace
+{
+	// 確認・変換したソースファイルの記録
+	struct CompiledTexture
+	{
+		std::mutex mutex;                               // 確認と変換を同時に1スレッドだけが行う
+		std::filesystem::file_time_type sourceTime;     // DDSが最新だと確認したときのソースの更新時刻
+		bool upToDate = false;
+	};
+
+	std::mutex sCompiledMutex;
+	std::map<std::wstring, std::shared_ptr<CompiledTexture>> sCompiledTextures;    // キーは正規化したパス
+
+	std::wstring GetTextureKey(const std::wstring& file)
+	{
+		return AtomEngine::ToLower(std::filesystem::path(file).lexically_normal().wstring());
+	}
+
+	std::shared_ptr<CompiledTexture> FindCompiledTexture(const std::wstring& key)
+	{
+		std::lock_guard<std::mutex> guard(sCompiledMutex);
+		auto& entry = sCompiledTextures[key];
+		if (!entry)
+			entry = std::make_shared<CompiledTexture>();
+		return entry;
+	}
+
+	// WICを使うスレッド（ロード用のワーカーなど）ごとにCOMを初期化し、スレッドの終了時に解放する
+	struct ComThreadScope
+	{
+		HRESULT result = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+		~ComThreadScope()
+		{
+			if (SUCCEEDED(result))
+				CoUninitialize();
+		}
+	};
+}
+
 namespace AtomEngine
 {
-	void CompileTextureOnDemand(const std::wstring& originalFile, uint32_t flags)
+	static TextureConversionStatus CompileTexture(const std::wstring& key, const std::wstring& originalFile, uint32_t flags)
 	{
+		std::shared_ptr<CompiledTexture> entry = FindCompiledTexture(key);
+		std::lock_guard<std::mutex> guard(entry->mutex);
+
 		std::wstring ddsFile = RemoveExtension(originalFile) + L".dds";
 
-		bool srcFileExists = std::filesystem::exists(originalFile);
-		bool ddsFileExists = std::filesystem::exists(ddsFile);
+		std::error_code error;
+		bool srcFileExists = std::filesystem::exists(originalFile, error);
+
+		std::filesystem::file_time_type srcLastWriteTime;
+		if (srcFileExists)
+			srcLastWriteTime = std::filesystem::last_write_time(originalFile, error);
+
+		// 前回の確認からソースが変わっていなければ、DDSは調べない
+		if (srcFileExists && entry->upToDate && entry->sourceTime == srcLastWriteTime)
+			return TextureConversionStatus::kUpToDate;
+
+		bool ddsFileExists = std::filesystem::exists(ddsFile, error);
 
 		if (!srcFileExists && !ddsFileExists)
 		{
 			Printf("[Info]Texture %ws is missing.\n", RemoveBasePath(originalFile).c_str());
-			return;
+			return TextureConversionStatus::kMissing;
 		}
 
-		std::filesystem::file_time_type srcLastWriteTime;
 		std::filesystem::file_time_type ddsLastWriteTime;
-
-		if (srcFileExists)
-			srcLastWriteTime = std::filesystem::last_write_time(originalFile);
-
 		if (ddsFileExists)
-			ddsLastWriteTime = std::filesystem::last_write_time(ddsFile);
+			ddsLastWriteTime = std::filesystem::last_write_time(ddsFile, error);
 
+		TextureConversionStatus status = TextureConversionStatus::kUpToDate;
 		if (!ddsFileExists || (srcFileExists && ddsLastWriteTime < srcLastWriteTime))
 		{
 			Printf("[Info]DDS mTexture %ws missing or older than source. Rebuilding.\n", RemoveBasePath(originalFile).c_str());
-			ConvertToDDS(originalFile, flags);
+			status = ConvertToDDS(originalFile, flags) ? TextureConversionStatus::kConverted : TextureConversionStatus::kFailed;
+		}
+
+		entry->upToDate = srcFileExists && status != TextureConversionStatus::kFailed;
+		entry->sourceTime = srcLastWriteTime;
+		return status;
+	}
+
+	void CompileTextureOnDemand(const std::wstring& originalFile, uint32_t flags)
+	{
+		CompileTexture(GetTextureKey(originalFile), originalFile, flags);
+	}
+
+	std::vector<TextureConversionResult> CompileTexturesOnDemand(const std::vector<TextureConversionRequest>& requests, uint32_t maxParallel)
+	{
+		// 呼び出したスレッドと手伝いのタスクが共有する状態
+		// 手伝いのタスクは戻った後に始まることもあるので、shared_ptrで持たせる
+		struct Batch
+		{
+			std::vector<TextureConversionResult> results;
+			std::vector<std::wstring> keys;
+			size_t count = 0;
+			std::atomic<size_t> next{ 0 };
+
+			std::mutex mutex;
+			std::condition_variable finished;
+			size_t remaining = 0;
+
+			/// 次の1枚を処理する（残っていなければfalse）
+			bool RunNext()
+			{
+				const size_t index = next.fetch_add(1);
+				if (index >= count)
+					return false;
+
+				TextureConversionResult& result = results[index];
+				const auto start = std::chrono::steady_clock::now();
+				result.status = CompileTexture(keys[index], result.sourceFile, result.flags);
+				result.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+				std::lock_guard<std::mutex> guard(mutex);
+				if (--remaining == 0)
+					finished.notify_all();
+				return true;
+			}
+		};
+
+		auto batch = std::make_shared<Batch>();
+		std::unordered_set<std::wstring> uniqueKeys;
+		for (const TextureConversionRequest& request : requests)
+		{
+			std::wstring key = GetTextureKey(request.sourceFile);
+			if (!uniqueKeys.insert(key).second)
+				continue;
+
+			TextureConversionResult& result = batch->results.emplace_back();
+			result.sourceFile = request.sourceFile;
+			result.ddsFile = RemoveExtension(request.sourceFile) + L".dds";
+			result.flags = request.flags;
+			batch->keys.push_back(std::move(key));
 		}
+		batch->count = batch->results.size();
+		batch->remaining = batch->count;
+		if (batch->count == 0)
+			return {};
+
+		uint32_t parallel = maxParallel > 0 ? maxParallel : JobSystem::GetWorkerCount();
+		parallel = static_cast<uint32_t>(std::clamp<size_t>(parallel, 1, batch->count));
+
+		// 呼び出したスレッドも処理するので、手伝いはparallel - 1個
+		// 手伝いが始まる前に全て取り出されていれば、そのタスクは何もせずに終わる
+		for (uint32_t i = 1; i < parallel; ++i)
+		{
+			JobSystem::ScheduleBackground([batch]
+				{
+					while (batch->RunNext())
+					{
+					}
+				});
+		}
+		while (batch->RunNext())
+		{
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(batch->mutex);
+			batch->finished.wait(lock, [&batch] { return batch->remaining == 0; });
+		}
+
+		for (const TextureConversionResult& result : batch->results)
+		{
+			if (result.status == TextureConversionStatus::kConverted)
+				Printf("[Info]Converted %ws in %.1f ms.\n", RemoveBasePath(result.sourceFile).c_str(), result.milliseconds);
+			else if (result.status == TextureConversionStatus::kFailed)
+				Printf("[Info]Failed to convert %ws (%.1f ms).\n", RemoveBasePath(result.sourceFile).c_str(), result.milliseconds);
+		}
+
+		// 手伝いのタスクは残っていてもresultsには触れない
+		return std::move(batch->results);
 	}
 
 	bool ConvertToDDS(const std::wstring& filePath, uint32_t Flags)
@@ -50,6 +205,8 @@ namespace AtomEngine
 		ASSERT(!bInterpretAsSRGB || !bContainsNormals);
 		ASSERT(!bPreserveAlpha || !bContainsNormals);
 
+		thread_local ComThreadScope tComScope;
+
 		Printf("Converting file \"%ws\" to DDS.\n", filePath.c_str());
 
 		// 拡張子をutf8（ascii）として取得する
@@ -15,6 +15,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 #include <DirectXTex.h>
 #include "../Platform/DirectX12/D3dUtility/d3dInclude.h"
 
@@ -37,8 +38,43 @@ namespace AtomEngine
     }
 
     // 指定されたテクスチャの DDS バージョンが存在しないか、ソーステクスチャよりも古い場合は、再変換します。
+    // 同じファイルを複数のスレッドから同時に要求しても、変換は1度だけ行われます。
     void CompileTextureOnDemand(const std::wstring& originalFile, uint32_t flags);
 
+    // CompileTexturesOnDemand に渡す1枚分の要求
+    struct TextureConversionRequest
+    {
+        std::wstring sourceFile;    // 変換元のファイル
+        uint32_t flags = 0;         // TexConversionFlags をOR演算したもの
+    };
+
+    enum class TextureConversionStatus : uint8_t
+    {
+        kUpToDate,  // DDS がソースより新しいので変換しなかった
+        kConverted, // 変換した
+        kFailed,    // 変換に失敗した
+        kMissing,   // ソースも DDS もない
+    };
+
+    struct TextureConversionResult
+    {
+        std::wstring sourceFile;
+        std::wstring ddsFile;
+        uint32_t flags = 0;
+        TextureConversionStatus status = TextureConversionStatus::kUpToDate;
+        float milliseconds = 0.0f;  // 確認と変換にかかった時間
+    };
+
+    // 複数のテクスチャをまとめて確認し、必要なものを並列に DDS へ変換します。
+    // 同じソース（正規化したパスが同じもの）は1度だけ処理し、フラグは最初の要求のものを使います。
+    // 一度確認・変換したソースは、更新時刻が変わるまで以降の呼び出しでも確認し直しません。
+    // 変換は呼び出したスレッドとバックグラウンドタスクの最大 maxParallel 本（0 ならワーカー数）で行い、
+    // 全て終わってから戻ります。結果は重複を除いた要求の順に並び、変換したものは時間をログに出します。
+    std::vector<TextureConversionResult> CompileTexturesOnDemand(
+        const std::vector<TextureConversionRequest>& requests,
+        uint32_t maxParallel = 0
+    );
+
     // TGA、PNG、JPGなどの非DDSテクスチャを読み込み、より最適な
     // ミップチェーン全体を含むDDS形式に変換します。結果のファイルは、ファイル拡張子が「DDS」に変更された同じパスになります。
     bool ConvertToDDS(
@@ -0,0 +1,304 @@
+#include "VertexCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace AtomEngine
+{
+	namespace
+	{
+		constexpr float kPositionMax = 65535.0f;
+		constexpr float kNormalMax = 32767.0f;
+		constexpr float kTangentMax = 1023.0f;
+
+		/// 2つの単位ベクトルの角度差（ラジアン）。acosは差が小さいと精度が落ちるので弦の長さから求める
+		float AngleError(const Vector3& a, const Vector3& b)
+		{
+			const float chord = std::min(2.0f, (a - b).Length());
+			return 2.0f * std::asin(chord * 0.5f);
+		}
+
+		bool IsDegenerate(const Vector3& v)
+		{
+			return v.LengthSqr() < 1e-12f;
+		}
+
+		/// 長さ0の法線・接線の代わりに使う方向
+		Vector3 SafeNormalize(const Vector3& v, const Vector3& fallback)
+		{
+			return IsDegenerate(v) ? fallback : v * (1.0f / v.Length());
+		}
+
+		/// 法線と直交する任意の方向（接線がない頂点用）
+		Vector3 AnyPerpendicular(const Vector3& n)
+		{
+			const Vector3 axis = std::fabs(n.x) < 0.9f ? Vector3(1.0f, 0.0f, 0.0f) : Vector3(0.0f, 1.0f, 0.0f);
+			return SafeNormalize(Math::Cross(axis, n), Vector3(0.0f, 0.0f, 1.0f));
+		}
+
+		float DecodeSnorm16(int16_t value)
+		{
+			return std::max(static_cast<float>(value) / kNormalMax, -1.0f);
+		}
+
+		float DecodeUnorm10(uint32_t value)
+		{
+			return static_cast<float>(value) / kTangentMax * 2.0f - 1.0f;
+		}
+
+		/**
+		 * @brief 八面体符号化した値の量子化で、復元後の角度差が最小になる丸め方を選ぶ
+		 *
+		 * 各成分を切り捨て・切り上げした4通りを試す。
+		 * @param direction 単位ベクトル
+		 * @param maxValue 量子化の最大値
+		 * @param toIndex [-1, 1]から量子化前の実数への変換
+		 * @param fromIndex 量子化値から[-1, 1]への変換
+		 */
+		template<typename ToIndex, typename FromIndex>
+		void QuantizeOctahedron(const Vector3& direction, ToIndex toIndex, FromIndex fromIndex, int32_t minValue, int32_t maxValue, int32_t& outX, int32_t& outY)
+		{
+			const Vector2 encoded = VertexCompression::OctEncode(direction);
+			const float fx = toIndex(encoded.x);
+			const float fy = toIndex(encoded.y);
+
+			float bestError = 4.0f;
+			for (int32_t i = 0; i < 4; ++i)
+			{
+				const int32_t x = std::clamp(static_cast<int32_t>((i & 1) ? std::ceil(fx) : std::floor(fx)), minValue, maxValue);
+				const int32_t y = std::clamp(static_cast<int32_t>((i & 2) ? std::ceil(fy) : std::floor(fy)), minValue, maxValue);
+				const Vector3 decoded = VertexCompression::OctDecode(Vector2(fromIndex(x), fromIndex(y)));
+				const float error = (decoded - direction).LengthSqr();
+				if (error < bestError)
+				{
+					bestError = error;
+					outX = x;
+					outY = y;
+				}
+			}
+		}
+	}
+
+	bool VertexCompression::Compress(const std::vector<Vertex>& vertices, std::vector<Mesh>& meshes,
+		CompressedVertices& out, const VertexCompressionSettings& settings)
+	{
+		const size_t vertexCount = vertices.size();
+		out.positions.assign(vertexCount, PositionVertex{});
+		out.attributes.resize(vertexCount);
+		out.error = {};
+
+		// 位置はサブメッシュの頂点範囲ごとに量子化する
+		for (Mesh& mesh : meshes)
+		{
+			for (SubMesh& sub : mesh.subMeshes)
+			{
+				const size_t begin = std::min<size_t>(sub.vertexOffset, vertexCount);
+				const size_t end = std::min<size_t>(begin + sub.vertexCount, vertexCount);
+
+				AxisAlignedBox bounds;
+				for (size_t i = begin; i < end; ++i)
+					bounds.AddPoint(vertices[i].position);
+				if (begin == end)
+					bounds = AxisAlignedBox(Vector3::ZERO, Vector3::ZERO);
+
+				sub.positionDequantization = ComputeDequantization(bounds);
+				for (size_t i = begin; i < end; ++i)
+				{
+					const Vector3& source = vertices[i].position;
+					out.positions[i] = EncodePosition(source, sub.positionDequantization);
+
+					const Vector3 decoded = DecodePosition(out.positions[i], sub.positionDequantization);
+					out.error.position = std::max(out.error.position, std::max(std::max(
+						std::fabs(decoded.x - source.x), std::fabs(decoded.y - source.y)), std::fabs(decoded.z - source.z)));
+				}
+			}
+		}
+
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			const Vertex& source = vertices[i];
+			out.attributes[i] = EncodeAttributes(source);
+
+			Vector2 texcoord;
+			Vector3 normal, tangent, bitangent;
+			DecodeAttributes(out.attributes[i], texcoord, normal, tangent, bitangent);
+
+			out.error.texcoord = std::max(out.error.texcoord,
+				std::max(std::fabs(texcoord.x - source.texcoord.x), std::fabs(texcoord.y - source.texcoord.y)));
+
+			// 法線・接線がない頂点は代わりの方向を入れているので比べない
+			if (!IsDegenerate(source.normal))
+				out.error.normal = std::max(out.error.normal, AngleError(normal, SafeNormalize(source.normal, normal)));
+			if (!IsDegenerate(source.tangent))
+				out.error.tangent = std::max(out.error.tangent, AngleError(tangent, SafeNormalize(source.tangent, tangent)));
+			if (!IsDegenerate(source.bitangent))
+				out.error.bitangent = std::max(out.error.bitangent, AngleError(bitangent, SafeNormalize(source.bitangent, bitangent)));
+		}
+
+		return out.error.position <= settings.positionTolerance &&
+			out.error.normal <= settings.normalTolerance &&
+			out.error.tangent <= settings.tangentTolerance &&
+			out.error.texcoord <= settings.texcoordTolerance;
+	}
+
+	PositionDequantization VertexCompression::ComputeDequantization(const AxisAlignedBox& bounds)
+	{
+		const Vector3 min = bounds.GetMin();
+		const Vector3 size = bounds.GetDimensions();
+
+		PositionDequantization dequantization;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			dequantization.scale[axis] = size[axis];
+			dequantization.offset[axis] = min[axis];
+		}
+		return dequantization;
+	}
+
+	PositionVertex VertexCompression::EncodePosition(const Vector3& position, const PositionDequantization& dequantization)
+	{
+		PositionVertex vertex;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float scale = dequantization.scale[axis];
+			const float t = scale > 0.0f ? std::clamp((position[axis] - dequantization.offset[axis]) / scale, 0.0f, 1.0f) : 0.0f;
+			vertex.position[axis] = static_cast<uint16_t>(t * kPositionMax + 0.5f);
+		}
+		vertex.position[3] = static_cast<uint16_t>(kPositionMax);
+		return vertex;
+	}
+
+	Vector3 VertexCompression::DecodePosition(const PositionVertex& vertex, const PositionDequantization& dequantization)
+	{
+		Vector3 position;
+		for (int axis = 0; axis < 3; ++axis)
+			position[axis] = static_cast<float>(vertex.position[axis]) / kPositionMax * dequantization.scale[axis] + dequantization.offset[axis];
+		return position;
+	}
+
+	AttributeVertex VertexCompression::EncodeAttributes(const Vertex& vertex)
+	{
+		AttributeVertex out;
+		out.texcoord[0] = FloatToHalf(vertex.texcoord.x);
+		out.texcoord[1] = FloatToHalf(vertex.texcoord.y);
+
+		const Vector3 normal = SafeNormalize(vertex.normal, Vector3(0.0f, 0.0f, 1.0f));
+		int32_t nx = 0, ny = 0;
+		QuantizeOctahedron(normal,
+			[](float v) { return v * kNormalMax; },
+			[](int32_t q) { return DecodeSnorm16(static_cast<int16_t>(q)); },
+			-32767, 32767, nx, ny);
+		out.normal[0] = static_cast<int16_t>(nx);
+		out.normal[1] = static_cast<int16_t>(ny);
+
+		const Vector3 tangent = IsDegenerate(vertex.tangent) ? AnyPerpendicular(normal) : SafeNormalize(vertex.tangent, normal);
+		int32_t tx = 0, ty = 0;
+		QuantizeOctahedron(tangent,
+			[](float v) { return (v * 0.5f + 0.5f) * kTangentMax; },
+			[](int32_t q) { return DecodeUnorm10(static_cast<uint32_t>(q)); },
+			0, 1023, tx, ty);
+
+		// 従法線が cross(法線, 接線) と逆向きなら利き手を-1にする
+		const bool positive = IsDegenerate(vertex.bitangent) || Math::Dot(Math::Cross(normal, tangent), vertex.bitangent) >= 0.0f;
+		out.tangent = static_cast<uint32_t>(tx) | (static_cast<uint32_t>(ty) << 10) | ((positive ? 3u : 0u) << 30);
+		return out;
+	}
+
+	void VertexCompression::DecodeAttributes(const AttributeVertex& vertex,
+		Vector2& texcoord, Vector3& normal, Vector3& tangent, Vector3& bitangent)
+	{
+		texcoord = Vector2(HalfToFloat(vertex.texcoord[0]), HalfToFloat(vertex.texcoord[1]));
+		normal = OctDecode(Vector2(DecodeSnorm16(vertex.normal[0]), DecodeSnorm16(vertex.normal[1])));
+		tangent = OctDecode(Vector2(DecodeUnorm10(vertex.tangent & 0x3FF), DecodeUnorm10((vertex.tangent >> 10) & 0x3FF)));
+
+		const float handedness = (vertex.tangent >> 30) != 0 ? 1.0f : -1.0f;
+		bitangent = Math::Cross(normal, tangent) * handedness;
+	}
+
+	Vector2 VertexCompression::OctEncode(const Vector3& direction)
+	{
+		const float l1 = std::fabs(direction.x) + std::fabs(direction.y) + std::fabs(direction.z);
+		if (l1 <= 0.0f)
+			return Vector2(0.0f, 0.0f);
+
+		float x = direction.x / l1;
+		float y = direction.y / l1;
+		if (direction.z < 0.0f)
+		{
+			const float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			const float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = foldedX;
+			y = foldedY;
+		}
+		return Vector2(x, y);
+	}
+
+	Vector3 VertexCompression::OctDecode(const Vector2& encoded)
+	{
+		Vector3 v(encoded.x, encoded.y, 1.0f - std::fabs(encoded.x) - std::fabs(encoded.y));
+		const float t = std::max(-v.z, 0.0f);
+		v.x += v.x >= 0.0f ? -t : t;
+		v.y += v.y >= 0.0f ? -t : t;
+		return v * (1.0f / v.Length());
+	}
+
+	uint16_t VertexCompression::FloatToHalf(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		const uint32_t sign = (bits >> 16) & 0x8000u;
+		bits &= 0x7FFFFFFFu;
+
+		// 65536以上（丸めで無限大になる範囲を含む）、無限大、NaN
+		if (bits >= (143u << 23))
+			return static_cast<uint16_t>(sign | (bits > 0x7F800000u ? 0x7E00u : 0x7C00u));
+
+		// 非正規化数: 仮数の下位ビットが丸められる位置まで値を足して取り出す
+		if (bits < (113u << 23))
+		{
+			constexpr uint32_t kDenormMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+			float magic;
+			std::memcpy(&magic, &kDenormMagic, sizeof(magic));
+			float f;
+			std::memcpy(&f, &bits, sizeof(f));
+			f += magic;
+			std::memcpy(&bits, &f, sizeof(bits));
+			return static_cast<uint16_t>(sign | (bits - kDenormMagic));
+		}
+
+		// 指数を付け替えて最近接偶数に丸める
+		const uint32_t mantissaOdd = (bits >> 13) & 1u;
+		bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFFu + mantissaOdd;
+		return static_cast<uint16_t>(sign | (bits >> 13));
+	}
+
+	float VertexCompression::HalfToFloat(uint16_t value)
+	{
+		const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+		const uint32_t exponent = (value >> 10) & 0x1Fu;
+		const uint32_t mantissa = value & 0x3FFu;
+
+		uint32_t bits;
+		if (exponent == 0)
+		{
+			// 0と非正規化数
+			const float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+			std::memcpy(&bits, &magnitude, sizeof(bits));
+			bits |= sign;
+		}
+		else if (exponent == 31)
+		{
+			bits = sign | 0x7F800000u | (mantissa << 13);
+		}
+		else
+		{
+			bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+		}
+
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+}
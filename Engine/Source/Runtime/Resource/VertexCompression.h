@@ -0,0 +1,99 @@
+/**
+ * @file VertexCompression.h
+ * @brief インポートした頂点を位置ストリームと属性ストリームに分けて量子化する
+ *
+ * Vertex（56バイト）を次の形にする。スキンなしで1頂点20バイト（約1/3）。
+ * - 位置: サブメッシュの頂点の範囲に対する16bit正規化（PositionVertex、8バイト）
+ * - UV: 半精度浮動小数点
+ * - 法線: 八面体符号化の16bit×2
+ * - 接線: 八面体符号化の10bit×2と利き手。従法線は持たず、cross(法線, 接線) * 利き手で求める
+ * （UV・法線・接線でAttributeVertex、12バイト）
+ * 圧縮後に元の頂点と比較して最大誤差を求め、許容値と比べる。
+ */
+
+#pragma once
+#include "Mesh.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace AtomEngine
+{
+	/**
+	 * @struct VertexCompressionSettings
+	 * @brief 圧縮の許容誤差
+	 */
+	struct VertexCompressionSettings
+	{
+		float positionTolerance = 1e-3f;        ///< 位置の許容誤差（各成分の距離）
+		float normalTolerance = 1e-3f;          ///< 法線の許容誤差（ラジアン）
+		float tangentTolerance = 1e-2f;         ///< 接線の許容誤差（ラジアン）
+		float texcoordTolerance = 1.0f / 1024.0f;   ///< UVの許容誤差（各成分）
+	};
+
+	/**
+	 * @struct VertexCompressionError
+	 * @brief 元の頂点に対する最大誤差
+	 */
+	struct VertexCompressionError
+	{
+		float position = 0.0f;
+		float normal = 0.0f;
+		float tangent = 0.0f;
+		float bitangent = 0.0f;     ///< 元の従法線が法線・接線と直交していなければ大きくなるので、判定には使わない
+		float texcoord = 0.0f;
+	};
+
+	/**
+	 * @struct CompressedVertices
+	 * @brief 圧縮した頂点ストリーム（どちらも元の頂点と同じ並び）
+	 */
+	struct CompressedVertices
+	{
+		std::vector<PositionVertex> positions;
+		std::vector<AttributeVertex> attributes;
+		VertexCompressionError error;
+	};
+
+	/**
+	 * @class VertexCompression
+	 * @brief 頂点の量子化と復元
+	 *
+	 * 復元はシェーダーと同じ計算をCPUで行うもので、誤差の確認やCPUでの頂点の利用に使う。
+	 */
+	class VertexCompression
+	{
+	public:
+		/**
+		 * @brief 頂点を圧縮し、各サブメッシュに位置の復元用の値を設定する
+		 *
+		 * 位置は各サブメッシュの頂点範囲（vertexOffset, vertexCount）の境界に対して量子化する。
+		 * 範囲は重ならないこと（ModelLoaderはaiMeshごとに別の範囲を作る）。
+		 * @param vertices 元の頂点
+		 * @param meshes メッシュ（サブメッシュのpositionDequantizationを書き換える）
+		 * @param out 圧縮結果と誤差
+		 * @param settings 許容誤差
+		 * @return 誤差が許容値に収まればtrue（超えた場合も結果は作る）
+		 */
+		static bool Compress(const std::vector<Vertex>& vertices, std::vector<Mesh>& meshes,
+			CompressedVertices& out, const VertexCompressionSettings& settings = {});
+
+		/// 境界ボックスを16bitに割り当てる復元用の値（幅が0の軸は常にminになる）
+		static PositionDequantization ComputeDequantization(const AxisAlignedBox& bounds);
+
+		static PositionVertex EncodePosition(const Vector3& position, const PositionDequantization& dequantization);
+		static Vector3 DecodePosition(const PositionVertex& vertex, const PositionDequantization& dequantization);
+
+		static AttributeVertex EncodeAttributes(const Vertex& vertex);
+		static void DecodeAttributes(const AttributeVertex& vertex,
+			Vector2& texcoord, Vector3& normal, Vector3& tangent, Vector3& bitangent);
+
+		/// 単位ベクトルを八面体符号化する（[-1, 1]^2）
+		static Vector2 OctEncode(const Vector3& direction);
+		static Vector3 OctDecode(const Vector2& encoded);
+
+		/// 半精度浮動小数点への変換（最近接偶数への丸め）
+		static uint16_t FloatToHalf(float value);
+		static float HalfToFloat(uint16_t value);
+	};
+}